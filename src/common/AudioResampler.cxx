@@ -0,0 +1,230 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+
+#include "AudioResampler.hxx"
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+namespace {
+  constexpr double kPi = 3.14159265358979323846;
+
+  // The shape of the Kaiser window; higher values trade a wider transition
+  // band for more attenuation past it (6 gives around 60dB)
+  constexpr double kKaiserBeta = 6.0;
+
+  // The passband as a fraction of the lower of the two Nyquist rates
+  constexpr double kPassband = 0.9;
+
+  // The zeroth order modified Bessel function of the first kind
+  double besselI0(double x)
+  {
+    double sum = 1.0, term = 1.0;
+    for(int k = 1; k < 32; ++k)
+    {
+      term *= (x / (2 * k)) * (x / (2 * k));
+      sum += term;
+    }
+    return sum;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Apply the filter with the given coefficients (moved the given fraction
+  // of the way towards the next phase) to 'taps' samples of each channel
+  inline void filter(const float* left, const float* right,
+                     const float* coefficients, const float* deltas,
+                     float mix, uInt32 taps, float* out)
+  {
+    uInt32 i = 0;
+    float l = 0, r = 0;
+
+#if defined(__AVX2__)
+    __m256 suml = _mm256_setzero_ps(), sumr = _mm256_setzero_ps();
+    const __m256 m = _mm256_set1_ps(mix);
+
+    for(; i + 8 <= taps; i += 8)
+    {
+      const __m256 c = _mm256_add_ps(_mm256_loadu_ps(coefficients + i),
+                         _mm256_mul_ps(_mm256_loadu_ps(deltas + i), m));
+      suml = _mm256_add_ps(suml, _mm256_mul_ps(_mm256_loadu_ps(left + i), c));
+      sumr = _mm256_add_ps(sumr, _mm256_mul_ps(_mm256_loadu_ps(right + i), c));
+    }
+
+    __m128 sum4l = _mm_add_ps(_mm256_castps256_ps128(suml),
+                              _mm256_extractf128_ps(suml, 1));
+    __m128 sum4r = _mm_add_ps(_mm256_castps256_ps128(sumr),
+                              _mm256_extractf128_ps(sumr, 1));
+#elif defined(__SSE2__)
+    __m128 sum4l = _mm_setzero_ps(), sum4r = _mm_setzero_ps();
+    const __m128 m = _mm_set1_ps(mix);
+
+    for(; i + 4 <= taps; i += 4)
+    {
+      const __m128 c = _mm_add_ps(_mm_loadu_ps(coefficients + i),
+                         _mm_mul_ps(_mm_loadu_ps(deltas + i), m));
+      sum4l = _mm_add_ps(sum4l, _mm_mul_ps(_mm_loadu_ps(left + i), c));
+      sum4r = _mm_add_ps(sum4r, _mm_mul_ps(_mm_loadu_ps(right + i), c));
+    }
+#endif
+
+#if defined(__SSE2__)
+    // Add up the four partial sums of each channel
+    __m128 sums = _mm_add_ps(_mm_unpacklo_ps(sum4l, sum4r),
+                             _mm_unpackhi_ps(sum4l, sum4r));
+    sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+
+    float both[4];
+    _mm_storeu_ps(both, sums);
+    l = both[0];
+    r = both[1];
+#endif
+
+    for(; i < taps; ++i)
+    {
+      const float c = coefficients[i] + deltas[i] * mix;
+      l += left[i] * c;
+      r += right[i] * c;
+    }
+
+    out[0] = l;
+    out[1] = r;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AudioResampler::AudioResampler()
+{
+  setRates(31400, 31400);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioResampler::setRates(double inputRate, double outputRate)
+{
+  myRateStep = myStep = inputRate / outputRate;
+
+  // The cutoff, relative to the input Nyquist rate; when downsampling,
+  // it's lowered so nothing is aliased into the output
+  const double cutoff = kPassband * std::min(1.0, outputRate / inputRate);
+  const double half = kTaps / 2.0;
+
+  for(uInt32 phase = 0; phase <= kPhases; ++phase)
+  {
+    // The output sample lies this far past the middle of the taps
+    const double offset = double(phase) / kPhases;
+
+    double sum = 0;
+    double row[kTaps];
+    for(uInt32 i = 0; i < kTaps; ++i)
+    {
+      const double t = i - (half - 1) - offset;
+      const double x = kPi * cutoff * t;
+      const double sinc = x == 0 ? 1.0 : std::sin(x) / x;
+      const double w = t / half;
+      const double window = std::abs(w) >= 1 ? 0.0 :
+          besselI0(kKaiserBeta * std::sqrt(1 - w * w)) / besselI0(kKaiserBeta);
+
+      row[i] = sinc * window;
+      sum += row[i];
+    }
+
+    // Every phase has a gain of exactly one at DC
+    for(uInt32 i = 0; i < kTaps; ++i)
+      myCoefficients[phase][i] = float(row[i] / sum);
+  }
+
+  for(uInt32 phase = 0; phase < kPhases; ++phase)
+    for(uInt32 i = 0; i < kTaps; ++i)
+      myDeltas[phase][i] =
+          myCoefficients[phase + 1][i] - myCoefficients[phase][i];
+
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioResampler::adjustRate(double factor)
+{
+  myStep = myRateStep /
+      BSPF::clamp(factor, 1 - kMaxAdjustment, 1 + kMaxAdjustment);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioResampler::reset()
+{
+  // Start with silence in place of the input before the first sample
+  for(uInt32 i = 0; i < kTaps - 1; ++i)
+    myHistory[0][i] = myHistory[1][i] = 0;
+
+  myHeld = kTaps - 1;
+  myPosition = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioResampler::maxOutput(uInt32 count) const
+{
+  const double step = myRateStep / (1 + kMaxAdjustment);
+  return uInt32(std::ceil((count + kTaps) / step)) + 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioResampler::process(const Int16* in, uInt32 count, float* out)
+{
+  uInt32 produced = 0;
+
+  while(count > 0)
+  {
+    // Take as much of the input as there's room for
+    const uInt32 taken = std::min(count, kTaps + kChunk - myHeld);
+    for(uInt32 i = 0; i < taken; ++i)
+    {
+      myHistory[0][myHeld + i] = in[2 * i];
+      myHistory[1][myHeld + i] = in[2 * i + 1];
+    }
+    myHeld += taken;
+    in += 2 * taken;
+    count -= taken;
+
+    // Produce every output sample for which all the taps are available
+    uInt32 first;
+    while((first = uInt32(myPosition)) + kTaps <= myHeld)
+    {
+      const double fraction = (myPosition - first) * kPhases;
+      const uInt32 phase = uInt32(fraction);
+
+      filter(myHistory[0] + first, myHistory[1] + first,
+             myCoefficients[phase], myDeltas[phase], float(fraction - phase),
+             kTaps, out);
+
+      out += 2;
+      ++produced;
+      myPosition += myStep;
+    }
+
+    // Only keep the samples that are still needed
+    for(uInt32 c = 0; c < 2; ++c)
+      std::copy(myHistory[c] + first, myHistory[c] + myHeld, myHistory[c]);
+
+    myHeld -= first;
+    myPosition -= first;
+  }
+
+  return produced;
+}
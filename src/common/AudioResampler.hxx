@@ -0,0 +1,117 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef AUDIO_RESAMPLER_HXX
+#define AUDIO_RESAMPLER_HXX
+
+#include "bspf.hxx"
+
+/**
+  This class converts stereo samples from one sample rate to another, with
+  a band-limited (windowed sinc) polyphase filter.  The filter for each
+  output sample is interpolated between the two nearest of a fixed number
+  of phases, so any ratio of rates can be used, and the ratio can be
+  changed slightly while running to keep up with the sound device.
+
+  Samples are passed in as they're generated, and the output is produced
+  as soon as all the input it depends on is available; the samples still
+  needed are held between calls.
+*/
+class AudioResampler
+{
+  public:
+    AudioResampler();
+
+  public:
+    /**
+      Set the rate of the samples passed in, and of those produced.  This
+      also clears any samples held from earlier calls.
+
+      @param inputRate   The rate of the input samples, in Hz
+      @param outputRate  The rate of the output samples, in Hz
+    */
+    void setRates(double inputRate, double outputRate);
+
+    /**
+      Produce samples at the given multiple of the output rate set by
+      setRates().  The filter isn't changed, and no samples are cleared,
+      so this is meant for corrections of a fraction of a percent; the
+      factor is limited to within 1% either way.
+
+      @param factor  The multiple of the output rate (1 for no change)
+    */
+    void adjustRate(double factor);
+
+    /**
+      Clear any samples held from earlier calls.
+    */
+    void reset();
+
+    /**
+      Answers the most samples that process() can produce from the given
+      number of input samples, with any adjustment of the rate.
+    */
+    uInt32 maxOutput(uInt32 count) const;
+
+    /**
+      Resample the given stereo samples.  The output buffer must have room
+      for at least maxOutput(count) samples.
+
+      @param in     The input samples, with the two channels interleaved
+      @param count  The number of input samples
+      @param out    The output samples, with the two channels interleaved
+
+      @return  The number of output samples
+    */
+    uInt32 process(const Int16* in, uInt32 count, float* out);
+
+  private:
+    // The filter length for each phase (a multiple of 8, for the SIMD
+    // code), the number of phases, and the number of input samples that
+    // are held in addition to those still needed by the filter
+    static constexpr uInt32 kTaps = 32;
+    static constexpr uInt32 kPhases = 64;
+    static constexpr uInt32 kChunk = 512;
+
+    // The largest adjustment of the output rate
+    static constexpr double kMaxAdjustment = 0.01;
+
+    // The filter coefficients for each phase (the last one is the first,
+    // moved on by one sample), and the difference to those of the next
+    float myCoefficients[kPhases + 1][kTaps];
+    float myDeltas[kPhases][kTaps];
+
+    // The input samples for each channel, and the number held
+    float myHistory[2][kTaps + kChunk];
+    uInt32 myHeld;
+
+    // The position of the next output sample in the held input, and the
+    // distance between output samples, both in input samples (as set by
+    // the rates, and after any adjustment)
+    double myPosition;
+    double myRateStep;
+    double myStep;
+
+  private:
+    // Following constructors and assignment operators not supported
+    AudioResampler(const AudioResampler&) = delete;
+    AudioResampler(AudioResampler&&) = delete;
+    AudioResampler& operator=(const AudioResampler&) = delete;
+    AudioResampler& operator=(AudioResampler&&) = delete;
+};
+
+#endif
@@ -0,0 +1,59 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef EVENTHANDLER_NULL_HXX
+#define EVENTHANDLER_NULL_HXX
+
+#include "EventHandler.hxx"
+
+/**
+  This class implements a Null event handler, for use when Stella is run
+  without any display (headless mode).  There is no backend toolkit to
+  collect events from, so the emulation only sees events generated
+  internally by the core.
+*/
+class EventHandlerNull : public EventHandler
+{
+  public:
+    /**
+      Create a new Null event handler object
+    */
+    EventHandlerNull(OSystem& osystem) : EventHandler(osystem) { }
+    virtual ~EventHandlerNull() = default;
+
+  private:
+    /**
+      Enable/disable text events (distinct from single-key events).
+    */
+    void enableTextEvents(bool enable) override { }
+
+    /**
+      There are no external events to collect in headless mode.
+    */
+    void pollEvent() override { }
+
+  private:
+    // Following constructors and assignment operators not supported
+    EventHandlerNull() = delete;
+    EventHandlerNull(const EventHandlerNull&) = delete;
+    EventHandlerNull(EventHandlerNull&&) = delete;
+    EventHandlerNull& operator=(const EventHandlerNull&) = delete;
+    EventHandlerNull& operator=(EventHandlerNull&&) = delete;
+};
+
+#endif
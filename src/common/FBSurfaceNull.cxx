@@ -0,0 +1,95 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "FBSurfaceNull.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FBSurfaceNull::FBSurfaceNull(uInt32 width, uInt32 height, const uInt32* data)
+  : myWidth(0),
+    myHeight(0)
+{
+  createSurface(width, height, data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::setSrcPos(uInt32 x, uInt32 y)
+{
+  mySrcR.moveTo(x, y);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::setSrcSize(uInt32 w, uInt32 h)
+{
+  mySrcR.setWidth(w);  mySrcR.setHeight(h);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::setDstPos(uInt32 x, uInt32 y)
+{
+  myDstR.moveTo(x, y);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::setDstSize(uInt32 w, uInt32 h)
+{
+  myDstR.setWidth(w);  myDstR.setHeight(h);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::translateCoords(Int32& x, Int32& y) const
+{
+  x -= myDstR.x();
+  y -= myDstR.y();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::invalidate()
+{
+  std::fill(myBuffer.begin(), myBuffer.end(), 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::resize(uInt32 width, uInt32 height)
+{
+  // We will only resize when necessary
+  if(width <= myWidth && height <= myHeight)
+    return;  // don't need to resize at all
+
+  createSurface(width, height, nullptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceNull::createSurface(uInt32 width, uInt32 height,
+                                  const uInt32* data)
+{
+  myWidth = width;
+  myHeight = height;
+  myBuffer.assign(width * height, 0);
+  if(data)
+    std::copy(data, data + width * height, myBuffer.begin());
+
+  // We start out with the src and dst rectangles containing the same
+  // dimensions, indicating no scaling or re-positioning
+  mySrcR = myDstR = GUI::Rect(width, height);
+
+  ////////////////////////////////////////////////////
+  // These *must* be set for the parent class
+  myPixels = myBuffer.data();
+  myPitch = width;
+  ////////////////////////////////////////////////////
+}
@@ -0,0 +1,74 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef FBSURFACE_NULL_HXX
+#define FBSURFACE_NULL_HXX
+
+#include "bspf.hxx"
+#include "FBSurface.hxx"
+
+/**
+  An FBSurface backed by a plain memory buffer, for use with the Null
+  framebuffer.  Drawing operations work as usual (they're implemented in
+  FBSurface), but the results are never presented anywhere.
+*/
+class FBSurfaceNull : public FBSurface
+{
+  public:
+    FBSurfaceNull(uInt32 width, uInt32 height, const uInt32* data);
+    virtual ~FBSurfaceNull() = default;
+
+    uInt32 width() const override  { return myWidth;  }
+    uInt32 height() const override { return myHeight; }
+
+    const GUI::Rect& srcRect() const override { return mySrcR; }
+    const GUI::Rect& dstRect() const override { return myDstR; }
+    void setSrcPos(uInt32 x, uInt32 y) override;
+    void setSrcSize(uInt32 w, uInt32 h) override;
+    void setDstPos(uInt32 x, uInt32 y) override;
+    void setDstSize(uInt32 w, uInt32 h) override;
+    void setVisible(bool visible) override { }
+
+    void translateCoords(Int32& x, Int32& y) const override;
+    bool render() override { return false; }
+    void invalidate() override;
+    void free() override { }
+    void reload() override { }
+    void resize(uInt32 width, uInt32 height) override;
+
+  protected:
+    void applyAttributes(bool immediate) override { }
+
+  private:
+    void createSurface(uInt32 width, uInt32 height, const uInt32* data);
+
+    // Following constructors and assignment operators not supported
+    FBSurfaceNull() = delete;
+    FBSurfaceNull(const FBSurfaceNull&) = delete;
+    FBSurfaceNull(FBSurfaceNull&&) = delete;
+    FBSurfaceNull& operator=(const FBSurfaceNull&) = delete;
+    FBSurfaceNull& operator=(FBSurfaceNull&&) = delete;
+
+  private:
+    vector<uInt32> myBuffer;
+    uInt32 myWidth, myHeight;
+
+    GUI::Rect mySrcR, myDstR;
+};
+
+#endif
@@ -101,7 +101,8 @@ class FilesystemNodeZIP : public AbstractFSNode
     bool _isDirectory, _isFile;
 
     // ZipHandler static reference variable responsible for accessing ZIP files
-    static unique_ptr<ZipHandler> myZipHandler;
+    // (one per thread, since it holds the state of the currently open file)
+    static thread_local unique_ptr<ZipHandler> myZipHandler;
     inline static ZipHandler& open(const string& file)
     {
       myZipHandler->open(file);
@@ -0,0 +1,63 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "bspf.hxx"
+
+#include "OSystem.hxx"
+
+#include "FBSurfaceNull.hxx"
+#include "FrameBufferNull.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameBufferNull::FrameBufferNull(OSystem& osystem)
+  : FrameBuffer(osystem)
+{
+  myOSystem.logMessage("FrameBufferNull::FrameBufferNull (headless mode)", 2);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBufferNull::queryHardware(vector<GUI::Size>& displays,
+                                    VariantList& renderers)
+{
+  // A single virtual display, large enough for any TIA zoom level or
+  // UI mode that may be requested
+  displays.emplace_back(1920, 1080);
+
+  VarList::push_back(renderers, "None", "none");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameBufferNull::about() const
+{
+  return "Video system: none (headless)\n";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<FBSurface> FrameBufferNull::createSurface(uInt32 w, uInt32 h,
+                                          const uInt32* data) const
+{
+  return make_ptr<FBSurfaceNull>(w, h, data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBufferNull::readPixels(uInt8* pixels, uInt32 pitch,
+                                 const GUI::Rect& rect) const
+{
+  for(uInt32 y = 0; y < rect.height(); ++y, pixels += pitch)
+    memset(pixels, 0, rect.width() * 4);
+}
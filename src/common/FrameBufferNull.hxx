@@ -0,0 +1,168 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef FRAMEBUFFER_NULL_HXX
+#define FRAMEBUFFER_NULL_HXX
+
+class OSystem;
+class FBSurfaceNull;
+
+#include "bspf.hxx"
+#include "FrameBuffer.hxx"
+
+/**
+  This class implements a Null framebuffer, for use when Stella is run
+  without any display (headless mode).  No window or renderer is ever
+  created; surfaces are plain memory buffers, so the core can still draw
+  into them (and snapshots still work), but nothing is ever presented.
+*/
+class FrameBufferNull : public FrameBuffer
+{
+  friend class FBSurfaceNull;
+
+  public:
+    /**
+      Creates a new Null framebuffer
+    */
+    FrameBufferNull(OSystem& osystem);
+    virtual ~FrameBufferNull() = default;
+
+    //////////////////////////////////////////////////////////////////////
+    // The following are derived from public methods in FrameBuffer.hxx
+    //////////////////////////////////////////////////////////////////////
+    /**
+      There is no cursor in headless mode.
+    */
+    void showCursor(bool show) override { }
+
+    /**
+      Answers if the display is currently in fullscreen mode.
+    */
+    bool fullScreen() const override { return false; }
+
+    /**
+      This method is called to retrieve the R/G/B data from the given pixel.
+      Pixels are always stored in ARGB8888 format.
+
+      @param pixel  The pixel containing R/G/B data
+      @param r      The red component of the color
+      @param g      The green component of the color
+      @param b      The blue component of the color
+    */
+    inline void getRGB(uInt32 pixel, uInt8* r, uInt8* g, uInt8* b) const override
+    {
+      *r = (pixel >> 16) & 0xff;
+      *g = (pixel >> 8) & 0xff;
+      *b = pixel & 0xff;
+    }
+
+    /**
+      This method is called to map a given R/G/B triple to the screen palette.
+      Pixels are always stored in ARGB8888 format.
+
+      @param r  The red component of the color.
+      @param g  The green component of the color.
+      @param b  The blue component of the color.
+    */
+    inline uInt32 mapRGB(uInt8 r, uInt8 g, uInt8 b) const override
+      { return 0xff000000 | (r << 16) | (g << 8) | b; }
+
+    /**
+      This method is called to get a copy of the specified ARGB data from the
+      viewable FrameBuffer area.  Since nothing is ever presented in headless
+      mode, the buffer is simply cleared.
+
+      @param buffer  A copy of the pixel data in ARGB8888 format
+      @param pitch   The pitch (in bytes) for the pixel data
+      @param rect    The bounding rectangle for the buffer
+    */
+    void readPixels(uInt8* buffer, uInt32 pitch, const GUI::Rect& rect) const override;
+
+  protected:
+    //////////////////////////////////////////////////////////////////////
+    // The following are derived from protected methods in FrameBuffer.hxx
+    //////////////////////////////////////////////////////////////////////
+    /**
+      This method is called to query and initialize the video hardware
+      for desktop and fullscreen resolution information.  Since there is
+      no hardware, a single virtual display is reported.
+    */
+    void queryHardware(vector<GUI::Size>& displays, VariantList& renderers) override;
+
+    /**
+      There is no window, and hence no display index.
+    */
+    Int32 getCurrentDisplayIndex() override { return -1; }
+
+    /**
+      This method is called to change to the given video mode.  Since no
+      window is created, this always succeeds.
+
+      @param title The title for the created window
+      @param mode  The video mode to use
+
+      @return  False on any errors, else true
+    */
+    bool setVideoMode(const string& title, const VideoMode& mode) override
+      { return true; }
+
+    /**
+      There is nothing to invalidate in headless mode.
+    */
+    void invalidate() override { }
+
+    /**
+      This method is called to create a surface with the given attributes.
+
+      @param w     The requested width of the new surface.
+      @param h     The requested height of the new surface.
+      @param data  If non-null, use the given data values as a static surface
+    */
+    unique_ptr<FBSurface> createSurface(uInt32 w, uInt32 h, const uInt32* data)
+        const override;
+
+    /**
+      There is no mouse to grab in headless mode.
+    */
+    void grabMouse(bool grab) override { }
+
+    /**
+      There is no window to set an icon for in headless mode.
+    */
+    void setWindowIcon() override { }
+
+    /**
+      This method is called to provide information about the FrameBuffer.
+    */
+    string about() const override;
+
+    /**
+      There is nothing to present in headless mode.
+    */
+    void postFrameUpdate() override { }
+
+  private:
+    // Following constructors and assignment operators not supported
+    FrameBufferNull() = delete;
+    FrameBufferNull(const FrameBufferNull&) = delete;
+    FrameBufferNull(FrameBufferNull&&) = delete;
+    FrameBufferNull& operator=(const FrameBufferNull&) = delete;
+    FrameBufferNull& operator=(FrameBufferNull&&) = delete;
+};
+
+#endif
@@ -0,0 +1,142 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef LOCK_FREE_QUEUE_HXX
+#define LOCK_FREE_QUEUE_HXX
+
+#include <atomic>
+
+#include "bspf.hxx"
+
+/**
+  A fixed-size queue between two threads, where items are only enqueued
+  by one of them (the producer), and only dequeued by the other (the
+  consumer).  No locking is needed: each side owns one of the indices, and
+  hands it over to the other side with release/acquire ordering.  The
+  capacity never changes, so nothing is allocated after construction.
+*/
+namespace Common {
+
+template <class T, uInt32 CAPACITY>
+class LockFreeQueue
+{
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0,
+                "The capacity must be a power of two");
+
+  public:
+    LockFreeQueue() : myBuffer(make_ptr<T[]>(CAPACITY)), myHead(0), myTail(0) { }
+
+    /**
+      Clear any items stored in the queue.  This must only be called
+      while neither side is using the queue.
+    */
+    void clear()
+    {
+      myHead.store(myTail.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+    }
+
+    /**
+      Enqueue as many of the given items as will fit (producer only).
+
+      @return  The number of items enqueued
+    */
+    uInt32 enqueue(const T* items, uInt32 count)
+    {
+      // Space can only be reused once the consumer is done with it
+      const uInt32 tail = myTail.load(std::memory_order_relaxed);
+      count = std::min(count,
+          CAPACITY - (tail - myHead.load(std::memory_order_acquire)));
+
+      // The items may wrap around the end of the buffer
+      const uInt32 start = tail & (CAPACITY - 1);
+      const uInt32 first = std::min(count, CAPACITY - start);
+      std::copy_n(items, first, myBuffer.get() + start);
+      std::copy_n(items + first, count - first, myBuffer.get());
+
+      myTail.store(tail + count, std::memory_order_release);
+
+      return count;
+    }
+
+    /**
+      Dequeue up to the given number of items (consumer only).  When
+      'items' is nullptr, they're only removed.
+
+      @return  The number of items dequeued
+    */
+    uInt32 dequeue(T* items, uInt32 count)
+    {
+      const uInt32 head = myHead.load(std::memory_order_relaxed);
+      count = std::min(count, myTail.load(std::memory_order_acquire) - head);
+
+      if(items)
+      {
+        const uInt32 start = head & (CAPACITY - 1);
+        const uInt32 first = std::min(count, CAPACITY - start);
+        std::copy_n(myBuffer.get() + start, first, items);
+        std::copy_n(myBuffer.get(), count - first, items + first);
+      }
+
+      myHead.store(head + count, std::memory_order_release);
+
+      return count;
+    }
+
+    /**
+      Answers the item at the given position from the front of the queue,
+      or nullptr if there are no more items (consumer only).
+    */
+    const T* peek(uInt32 index) const
+    {
+      const uInt32 head = myHead.load(std::memory_order_relaxed);
+      return index < myTail.load(std::memory_order_acquire) - head ?
+          &myBuffer[(head + index) & (CAPACITY - 1)] : nullptr;
+    }
+
+    /**
+      Answers the number of items in the queue.
+    */
+    uInt32 size() const
+    {
+      return myTail.load(std::memory_order_acquire) -
+             myHead.load(std::memory_order_acquire);
+    }
+
+    /**
+      Answers the most items the queue can hold.
+    */
+    uInt32 capacity() const { return CAPACITY; }
+
+  private:
+    unique_ptr<T[]> myBuffer;
+
+    // Both of these only ever increase, and wrap around naturally
+    std::atomic<uInt32> myHead;
+    std::atomic<uInt32> myTail;
+
+  private:
+    // Following constructors and assignment operators not supported
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue(LockFreeQueue&&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+};
+
+}  // Namespace Common
+
+#endif
@@ -0,0 +1,54 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "MediaFactory.hxx"
+#include "FrameBufferSDL2.hxx"
+#include "FrameBufferNull.hxx"
+#include "EventHandlerSDL2.hxx"
+#include "EventHandlerNull.hxx"
+#ifdef SOUND_SUPPORT
+  #include "SoundSDL2.hxx"
+#endif
+#include "SoundNull.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<FrameBuffer> MediaFactory::createVideo(OSystem& osystem)
+{
+  if(osystem.settings().getBool("headless"))
+    return make_ptr<FrameBufferNull>(osystem);
+
+  return make_ptr<FrameBufferSDL2>(osystem);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Sound> MediaFactory::createAudio(OSystem& osystem)
+{
+#ifdef SOUND_SUPPORT
+  if(!osystem.settings().getBool("headless"))
+    return make_ptr<SoundSDL2>(osystem);
+#endif
+  return make_ptr<SoundNull>(osystem);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<EventHandler> MediaFactory::createEventHandler(OSystem& osystem)
+{
+  if(osystem.settings().getBool("headless"))
+    return make_ptr<EventHandlerNull>(osystem);
+
+  return make_ptr<EventHandlerSDL2>(osystem);
+}
@@ -42,19 +42,22 @@
   #error Unsupported platform!
 #endif
 
-#include "FrameBufferSDL2.hxx"
-#include "EventHandlerSDL2.hxx"
-#ifdef SOUND_SUPPORT
-  #include "SoundSDL2.hxx"
-#else
-  #include "SoundNull.hxx"
-#endif
+#include "FrameBuffer.hxx"
+#include "EventHandler.hxx"
+#include "Sound.hxx"
 
 /**
   This class deals with the different framebuffer/sound/event
   implementations for the various ports of Stella, and always returns a
   valid object based on the specific port and restrictions on that port.
 
+  When the 'headless' setting is enabled, Null implementations are
+  returned instead, so that no window, renderer or audio device is ever
+  created.  The video, audio and event objects are created in
+  MediaFactory.cxx; libstella (which is always headless) uses
+  MediaFactoryNull.cxx instead, so that it doesn't contain the SDL
+  backends at all.
+
   As of SDL2, this code is greatly simplified.  However, it remains here
   in case we ever have multiple backend implementations again (should
   not be necessary since SDL2 covers this nicely).
@@ -103,24 +106,9 @@ class MediaFactory
     #endif
     }
 
-    static unique_ptr<FrameBuffer> createVideo(OSystem& osystem)
-    {
-      return make_ptr<FrameBufferSDL2>(osystem);
-    }
-
-    static unique_ptr<Sound> createAudio(OSystem& osystem)
-    {
-    #ifdef SOUND_SUPPORT
-      return make_ptr<SoundSDL2>(osystem);
-    #else
-      return make_ptr<SoundNull>(osystem);
-    #endif
-    }
-
-    static unique_ptr<EventHandler> createEventHandler(OSystem& osystem)
-    {
-      return make_ptr<EventHandlerSDL2>(osystem);
-    }
+    static unique_ptr<FrameBuffer> createVideo(OSystem& osystem);
+    static unique_ptr<Sound> createAudio(OSystem& osystem);
+    static unique_ptr<EventHandler> createEventHandler(OSystem& osystem);
 
   private:
     // Following constructors and assignment operators not supported
@@ -17,7 +17,6 @@
 
 #include "Console.hxx"
 #include "Control.hxx"
-#include "Paddles.hxx"
 #include "Props.hxx"
 
 #include "MouseControl.hxx"
@@ -158,13 +157,6 @@ MouseControl::MouseControl(Console& console, const string& mode)
     addLeftControllerModes(noswap);
   }
 
-  // Set range information (currently only for paddles, but may be used
-  // for other controllers in the future)
-  int m_range = 100;
-  if(!(m_axis >> m_range))
-    m_range = 100;
-  Paddles::setPaddleRange(m_range);
-
   // If the mouse isn't used at all, we still need one item in the list
   if(myModeList.size() == 0)
     myModeList.push_back(MouseMode("Mouse not used for current controllers"));
@@ -56,14 +56,6 @@ class SoundNull : public Sound
     */
     void setEnabled(bool enable) override { }
 
-    /**
-      The system cycle counter is being adjusting by the specified amount.  Any
-      members using the system cycle counter should be adjusted as needed.
-
-      @param amount The amount the cycle counter is being adjusted by
-    */
-    void adjustCycleCounter(Int32 amount) override { }
-
     /**
       Sets the number of channels (mono or stereo sound).
 
@@ -71,14 +63,6 @@ class SoundNull : public Sound
     */
     void setChannels(uInt32 channels) override { }
 
-    /**
-      Sets the display framerate.  Sound generation for NTSC and PAL games
-      depends on the framerate, so we need to set it here.
-
-      @param framerate The base framerate depending on NTSC or PAL ROM
-    */
-    void setFrameRate(float framerate) override { }
-
     /**
       Initializes the sound device.  This must be called before any
       calls are made to derived methods.
@@ -104,13 +88,19 @@ class SoundNull : public Sound
     void reset() { }
 
     /**
-      Sets the sound register to a given value.
+      Sets the rate of the samples passed to processSamples().
 
-      @param addr  The register address
-      @param value The value to save into the register
-      @param cycle The system cycle at which the register is being updated
+      @param rate  The rate of the TIA's samples, in Hz
     */
-    void set(uInt16 addr, uInt8 value, Int32 cycle) override { }
+    void setSampleRate(double rate) override { }
+
+    /**
+      Plays the given samples, generated by the TIA at two per scanline.
+
+      @param samples The samples, with the two channels interleaved
+      @param count   The number of samples
+    */
+    void processSamples(const Int16* samples, uInt32 count) override { }
 
     /**
       Sets the volume of the sound device to the specified level.  The
@@ -129,54 +119,15 @@ class SoundNull : public Sound
     */
     void adjustVolume(Int8 direction) override { }
 
-  public:
-    /**
-      Saves the current state of this device to the given Serializer.
-
-      @param out The serializer device to save to.
-      @return The result of the save.  True on success, false on failure.
-    */
-    bool save(Serializer& out) const
-    {
-      out.putString("TIASound");
-
-      for(int i = 0; i < 6; ++i)
-        out.putByte(0);
-
-      // myLastRegisterSetCycle
-      out.putInt(0);
-
-      return true;
-    }
-
     /**
-      Loads the current state of this device from the given Serializer.
-
-      @param in The Serializer device to load from.
-      @return The result of the load.  True on success, false on failure.
+      Answers how full the queue of samples waiting to be played is, and
+      how many times the sound device has run out of samples.
     */
-    bool load(Serializer& in)
+    void queueStats(uInt32& fill, uInt32& underruns) const override
     {
-      if(in.getString() != "TIASound")
-        return false;
-
-      // Read sound registers and discard
-      for(int i = 0; i < 6; ++i)
-        in.getByte();
-
-      // myLastRegisterSetCycle
-      in.getInt();
-
-      return true;
+      fill = underruns = 0;
     }
 
-    /**
-      Get a descriptor for this console class (used in error checking).
-
-      @return The name of the object
-    */
-    string name() const { return "TIASound"; }
-
   private:
     // Following constructors and assignment operators not supported
     SoundNull() = delete;
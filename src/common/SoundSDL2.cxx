@@ -18,12 +18,8 @@
 #ifdef SOUND_SUPPORT
 
 #include <sstream>
-#include <cassert>
-#include <cmath>
 
 #include "SDL_lib.hxx"
-#include "TIASnd.hxx"
-#include "TIATypes.hxx"
 #include "FrameBuffer.hxx"
 #include "Settings.hxx"
 #include "System.hxx"
@@ -31,20 +27,44 @@
 #include "Console.hxx"
 #include "SoundSDL2.hxx"
 
+namespace {
+  // The rate of the samples generated by the TIA (two per scanline) until
+  // the console sets it, which is the rate for NTSC
+  constexpr double kDefaultSampleRate = 2 * 15720.0;
+
+  // The most TIA samples that are resampled at once, and the most that
+  // the TIA passes at once (about two frames)
+  constexpr uInt32 kResampleChunk = 256;
+  constexpr uInt32 kMaxBatch = 1024;
+
+  // The largest correction to the output rate made to keep the queue at
+  // its target level; the TIA's samples arrive at the console's own rate,
+  // so this only has to cover the drift between the clocks of the sound
+  // device and the system, which is far less than this
+  constexpr double kMaxAdjustment = 0.002;
+
+  // How much each new level of the queue counts in its average
+  constexpr double kLevelSmoothing = 0.05;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 SoundSDL2::SoundSDL2(OSystem& osystem)
   : Sound(osystem),
     myIsEnabled(false),
     myIsInitializedFlag(false),
-    myLastRegisterSetCycle(0),
     myNumChannels(0),
-    myFragmentSizeLogBase2(0),
-    myFragmentSizeLogDiv1(0),
-    myFragmentSizeLogDiv2(0),
     myIsMuted(true),
-    myVolume(100)
+    myVolume(100),
+    mySampleRate(0),
+    myTargetLevel(0),
+    myQueueLimit(0),
+    myAverageLevel(0),
+    myIsPlaying(false),
+    myOverflowCount(0),
+    myUnderrunCount(0)
 {
   myOSystem.logMessage("SoundSDL2::SoundSDL2 started ...", 2);
+  myLastSample[0] = myLastSample[1] = 0;
 
   // The sound system is opened only once per program run, to eliminate
   // issues with opening and closing it multiple times
@@ -80,12 +100,14 @@ SoundSDL2::SoundSDL2(OSystem& osystem)
     return;
   }
 
-  // Pre-compute fragment-related variables as much as possible
-  myFragmentSizeLogBase2 = log(myHardwareSpec.samples) / log(2.0);
-  myFragmentSizeLogDiv1 = myFragmentSizeLogBase2 / 60.0;
-  myFragmentSizeLogDiv2 = (myFragmentSizeLogBase2 - 1) / 60.0;
+  // The samples are resampled as they're generated.  When each frame's
+  // samples arrive, two fragments should still be queued, which is enough
+  // to cover the timing of the frames
+  myTargetLevel = 2 * myHardwareSpec.samples * myHardwareSpec.channels;
+  myAverageLevel = myTargetLevel;
 
   myIsInitializedFlag = true;
+  setSampleRate(kDefaultSampleRate);
   SDL_PauseAudio(1);
 
   myOSystem.logMessage("SoundSDL2::SoundSDL2 initialized", 2);
@@ -123,10 +145,8 @@ void SoundSDL2::open()
     return;
   }
 
-  // Now initialize the TIASound object which will actually generate sound
-  myTIASound.outputFrequency(myHardwareSpec.freq);
-  const string& chanResult =
-      myTIASound.channels(myHardwareSpec.channels, myNumChannels == 2);
+  const char* const chanResult = myHardwareSpec.channels == 1 ? "Hardware1" :
+      myNumChannels == 2 ? "Hardware2Stereo" : "Hardware2Mono";
 
   // Adjust volume to that defined in settings
   myVolume = myOSystem.settings().getInt("volume");
@@ -140,6 +160,9 @@ void SoundSDL2::open()
       << "  Frequency:   " << uInt32(myHardwareSpec.freq) << endl
       << "  Channels:    " << uInt32(myHardwareSpec.channels)
                            << " (" << chanResult << ")" << endl
+      << "  Latency:     " << 1000 * (myTargetLevel / myHardwareSpec.channels +
+                                      myHardwareSpec.samples) /
+                              myHardwareSpec.freq << " ms" << endl
       << endl;
   myOSystem.logMessage(buf.str(), 1);
 
@@ -157,9 +180,16 @@ void SoundSDL2::close()
   {
     myIsEnabled = false;
     SDL_PauseAudio(1);
-    myLastRegisterSetCycle = 0;
-    myTIASound.reset();
-    myRegWriteQueue.clear();
+    clearQueue();
+
+    if(myOverflowCount > 0 || myUnderrunCount > 0)
+    {
+      ostringstream buf;
+      buf << "SoundSDL2: " << myOverflowCount << " samples dropped, "
+          << myUnderrunCount << " underruns";
+      myOSystem.logMessage(buf.str(), 1);
+      myOverflowCount = myUnderrunCount = 0;
+    }
     myOSystem.logMessage("SoundSDL2::close", 2);
   }
 }
@@ -180,23 +210,42 @@ void SoundSDL2::reset()
   if(myIsInitializedFlag)
   {
     SDL_PauseAudio(1);
-    myLastRegisterSetCycle = 0;
-    myTIASound.reset();
-    myRegWriteQueue.clear();
+    clearQueue();
     mute(myIsMuted);
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::setSampleRate(double rate)
+{
+  if(!myIsInitializedFlag || rate == mySampleRate)
+    return;
+
+  // The resampler and its buffers are only used by the emulation, so
+  // they can be changed while the callback plays what's already queued
+  mySampleRate = rate;
+  myResampler.setRates(mySampleRate, myHardwareSpec.freq);
+  const uInt32 resampled = myResampler.maxOutput(kResampleChunk);
+  myResampled = make_ptr<float[]>(2 * resampled);
+  myMixed = make_ptr<Int16[]>(2 * resampled);
+
+  // Samples are only dropped if a lot more than the target level builds
+  // up (when the emulation runs too fast)
+  const uInt32 fragment = myHardwareSpec.samples * myHardwareSpec.channels;
+  myQueueLimit = std::min(myTargetLevel + fragment +
+      myResampler.maxOutput(kMaxBatch) * myHardwareSpec.channels,
+      mySampleQueue.capacity());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::setVolume(Int32 percent)
 {
   if(myIsInitializedFlag && (percent >= 0) && (percent <= 100))
   {
+    // The volume is applied as samples are queued, so it takes effect
+    // after the samples already queued have been played
     myOSystem.settings().setValue("volume", percent);
-    SDL_LockAudio();
     myVolume = percent;
-    myTIASound.volume(percent);
-    SDL_UnlockAudio();
   }
 }
 
@@ -226,12 +275,6 @@ void SoundSDL2::adjustVolume(Int8 direction)
   myOSystem.frameBuffer().showMessage(message);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::adjustCycleCounter(Int32 amount)
-{
-  myLastRegisterSetCycle += amount;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::setChannels(uInt32 channels)
 {
@@ -240,279 +283,126 @@ void SoundSDL2::setChannels(uInt32 channels)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::setFrameRate(float framerate)
-{
-  // Recalculate since frame rate has changed
-  // FIXME - should we clear out the queue or adjust the values in it?
-  myFragmentSizeLogDiv1 = myFragmentSizeLogBase2 / framerate;
-  myFragmentSizeLogDiv2 = (myFragmentSizeLogBase2 - 1) / framerate;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::set(uInt16 addr, uInt8 value, Int32 cycle)
-{
-  SDL_LockAudio();
-
-  // First, calculate how many seconds would have past since the last
-  // register write on a real 2600
-  double delta = double(cycle - myLastRegisterSetCycle) / 1193191.66666667;
-
-  // Now, adjust the time based on the frame rate the user has selected. For
-  // the sound to "scale" correctly, we have to know the games real frame
-  // rate (e.g., 50 or 60) and the currently emulated frame rate. We use these
-  // values to "scale" the time before the register change occurs.
-  RegWrite info;
-  info.addr = addr;
-  info.value = value;
-  info.delta = delta;
-  myRegWriteQueue.enqueue(info);
-
-  // Update last cycle counter to the current cycle
-  myLastRegisterSetCycle = cycle;
-
-  SDL_UnlockAudio();
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::processFragment(Int16* stream, uInt32 length)
+void SoundSDL2::processSamples(const Int16* samples, uInt32 count)
 {
-  uInt32 channels = myHardwareSpec.channels;
-  length = length / channels;
-
-  // If there are excessive items on the queue then we'll remove some
-  if(myRegWriteQueue.duration() > myFragmentSizeLogDiv1)
-  {
-    double removed = 0.0;
-    while(removed < myFragmentSizeLogDiv2)
-    {
-      RegWrite& info = myRegWriteQueue.front();
-      removed += info.delta;
-      myTIASound.set(info.addr, info.value);
-      myRegWriteQueue.dequeue();
-    }
-  }
-
-  double position = 0.0;
-  double remaining = length;
+  if(!myIsEnabled)
+    return;
 
-  while(remaining > 0.0)
+  const uInt32 channels = myHardwareSpec.channels;
+  const float gain = myVolume / 100.0f;
+
+  // Playing starts (both at first, and after the queue has run dry) once
+  // the target level is still queued when new samples arrive, so that a
+  // frame's worth of samples is always queued ahead of it
+  const uInt32 level = mySampleQueue.size();
+  if(!myIsPlaying.load(std::memory_order_relaxed) && level >= myTargetLevel)
+    myIsPlaying.store(true, std::memory_order_relaxed);
+
+  // The frames aren't timed by the sound device, so the queue slowly fills
+  // up or runs dry unless the rate is corrected; the correction is in
+  // proportion to how far the level is from its target
+  myAverageLevel += (level - myAverageLevel) * kLevelSmoothing;
+  const double error = BSPF::clamp(
+      (myAverageLevel - myTargetLevel) / myTargetLevel, -1.0, 1.0);
+  myResampler.adjustRate(1 - error * kMaxAdjustment);
+
+  while(count > 0)
   {
-    if(myRegWriteQueue.size() == 0)
+    const uInt32 chunk = std::min(count, kResampleChunk);
+    const uInt32 resampled =
+        myResampler.process(samples, chunk, myResampled.get());
+    samples += 2 * chunk;
+    count -= chunk;
+
+    // Mix the TIA channels for the sound device, and apply the volume
+    const float* in = myResampled.get();
+    Int16* out = myMixed.get();
+    for(uInt32 i = 0; i < resampled; ++i, in += 2)
     {
-      // There are no more pending TIA sound register updates so we'll
-      // use the current settings to finish filling the sound fragment
-      myTIASound.process(stream + (uInt32(position) * channels),
-          length - uInt32(position));
-
-      // Since we had to fill the fragment we'll reset the cycle counter
-      // to zero.  NOTE: This isn't 100% correct, however, it'll do for
-      // now.  We should really remember the overrun and remove it from
-      // the delta of the next write.
-      myLastRegisterSetCycle = 0;
-      break;
-    }
-    else
-    {
-      // There are pending TIA sound register updates so we need to
-      // update the sound buffer to the point of the next register update
-      RegWrite& info = myRegWriteQueue.front();
-
-      // How long will the remaining samples in the fragment take to play
-      double duration = remaining / myHardwareSpec.freq;
-
-      // Does the register update occur before the end of the fragment?
-      if(info.delta <= duration)
+      if(channels == 1)
+        *out++ = Int16(BSPF::clamp((in[0] + in[1]) * gain, -32768.f, 32767.f));
+      else if(myNumChannels == 2)
       {
-        // If the register update time hasn't already passed then
-        // process samples upto the point where it should occur
-        if(info.delta > 0.0)
-        {
-          // Process the fragment upto the next TIA register write.  We
-          // round the count passed to process up if needed.
-          double samples = (myHardwareSpec.freq * info.delta);
-          myTIASound.process(stream + (uInt32(position) * channels),
-              uInt32(samples) + uInt32(position + samples) -
-              (uInt32(position) + uInt32(samples)));
-
-          position += samples;
-          remaining -= samples;
-        }
-        myTIASound.set(info.addr, info.value);
-        myRegWriteQueue.dequeue();
+        *out++ = Int16(BSPF::clamp(in[0] * gain, -32768.f, 32767.f));
+        *out++ = Int16(BSPF::clamp(in[1] * gain, -32768.f, 32767.f));
       }
       else
       {
-        // The next register update occurs in the next fragment so finish
-        // this fragment with the current TIA settings and reduce the register
-        // update delay by the corresponding amount of time
-        myTIASound.process(stream + (uInt32(position) * channels),
-            length - uInt32(position));
-        info.delta -= duration;
-        break;
+        const Int16 mixed =
+            Int16(BSPF::clamp((in[0] + in[1]) * gain, -32768.f, 32767.f));
+        *out++ = mixed;
+        *out++ = mixed;
       }
     }
-  }
-}
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::callback(void* udata, uInt8* stream, int len)
-{
-  SoundSDL2* sound = static_cast<SoundSDL2*>(udata);
-  if(sound->myIsEnabled)
-  {
-    // The callback is requesting 8-bit (unsigned) data, but the TIA sound
-    // emulator deals in 16-bit (signed) data
-    // So, we need to convert the pointer and half the length
-    sound->processFragment(reinterpret_cast<Int16*>(stream), uInt32(len) >> 1);
+    // If the callback isn't keeping up, the newest samples are dropped,
+    // so that the latency doesn't build up
+    const uInt32 values = resampled * channels;
+    const uInt32 room = myQueueLimit - std::min(mySampleQueue.size(), myQueueLimit);
+    const uInt32 queued = mySampleQueue.enqueue(myMixed.get(), std::min(values, room));
+    myOverflowCount += (values - queued) / channels;
   }
-  else
-    SDL_memset(stream, 0, len);  // Write 'silence'
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool SoundSDL2::save(Serializer& out) const
+void SoundSDL2::queueStats(uInt32& fill, uInt32& underruns) const
 {
-  try
-  {
-    out.putString(name());
-
-    // Only get the TIA sound registers if sound is enabled
-    if(myIsInitializedFlag)
-    {
-      out.putByte(myTIASound.get(TIARegister::AUDC0));
-      out.putByte(myTIASound.get(TIARegister::AUDC1));
-      out.putByte(myTIASound.get(TIARegister::AUDF0));
-      out.putByte(myTIASound.get(TIARegister::AUDF1));
-      out.putByte(myTIASound.get(TIARegister::AUDV0));
-      out.putByte(myTIASound.get(TIARegister::AUDV1));
-    }
-    else
-      for(int i = 0; i < 6; ++i)
-        out.putByte(0);
-
-    out.putInt(myLastRegisterSetCycle);
-  }
-  catch(...)
-  {
-    myOSystem.logMessage("ERROR: SoundSDL2::save", 0);
-    return false;
-  }
-
-  return true;
+  fill = myIsEnabled ? uInt32(myAverageLevel * 100 / myTargetLevel + 0.5) : 0;
+  underruns = myUnderrunCount;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool SoundSDL2::load(Serializer& in)
+void SoundSDL2::clearQueue()
 {
-  try
-  {
-    if(in.getString() != name())
-      return false;
-
-    // Only update the TIA sound registers if sound is enabled
-    // Make sure to empty the queue of previous sound fragments
-    if(myIsInitializedFlag)
-    {
-      SDL_PauseAudio(1);
-      myRegWriteQueue.clear();
-      myTIASound.set(TIARegister::AUDC0, in.getByte());
-      myTIASound.set(TIARegister::AUDC1, in.getByte());
-      myTIASound.set(TIARegister::AUDF0, in.getByte());
-      myTIASound.set(TIARegister::AUDF1, in.getByte());
-      myTIASound.set(TIARegister::AUDV0, in.getByte());
-      myTIASound.set(TIARegister::AUDV1, in.getByte());
-      if(!myIsMuted) SDL_PauseAudio(0);
-    }
-    else
-      for(int i = 0; i < 6; ++i)
-        in.getByte();
-
-    myLastRegisterSetCycle = in.getInt();
-  }
-  catch(...)
-  {
-    myOSystem.logMessage("ERROR: SoundSDL2::load", 0);
-    return false;
-  }
-
-  return true;
+  mySampleQueue.clear();
+  myResampler.reset();
+  myResampler.adjustRate(1);
+  myAverageLevel = myTargetLevel;
+  myIsPlaying = false;
+  myLastSample[0] = myLastSample[1] = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-SoundSDL2::RegWriteQueue::RegWriteQueue(uInt32 capacity)
-  : myBuffer(make_ptr<RegWrite[]>(capacity)),
-    myCapacity(capacity),
-    mySize(0),
-    myHead(0),
-    myTail(0)
+void SoundSDL2::processFragment(Int16* stream, uInt32 length)
 {
-}
+  const uInt32 channels = myHardwareSpec.channels;
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::RegWriteQueue::clear()
-{
-  myHead = myTail = mySize = 0;
-}
+  // Once the queue runs dry, it's left to fill up again before playing
+  // resumes, so that one late frame doesn't make it run dry over and over
+  const bool playing = myIsPlaying.load(std::memory_order_relaxed);
+  const uInt32 played = playing ? mySampleQueue.dequeue(stream, length) : 0;
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::RegWriteQueue::dequeue()
-{
-  if(mySize > 0)
+  if(played >= channels)
+    for(uInt32 c = 0; c < channels; ++c)
+      myLastSample[c] = stream[played - channels + c];
+
+  // If the emulation hasn't kept up, hold the last sample rather than
+  // dropping to silence, which would click
+  if(played < length)
   {
-    myHead = (myHead + 1) % myCapacity;
-    --mySize;
+    if(playing)
+    {
+      ++myUnderrunCount;
+      myIsPlaying.store(false, std::memory_order_relaxed);
+    }
+    for(uInt32 i = played; i < length; ++i)
+      stream[i] = myLastSample[(i - played) % channels];
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double SoundSDL2::RegWriteQueue::duration() const
+void SoundSDL2::callback(void* udata, uInt8* stream, int len)
 {
-  double duration = 0.0;
-  for(uInt32 i = 0; i < mySize; ++i)
+  SoundSDL2* sound = static_cast<SoundSDL2*>(udata);
+  if(sound->myIsEnabled)
   {
-    duration += myBuffer[(myHead + i) % myCapacity].delta;
+    // The callback is requesting 8-bit (unsigned) data, but the TIA sound
+    // emulator deals in 16-bit (signed) data
+    // So, we need to convert the pointer and half the length
+    sound->processFragment(reinterpret_cast<Int16*>(stream), uInt32(len) >> 1);
   }
-  return duration;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::RegWriteQueue::enqueue(const RegWrite& info)
-{
-  // If an attempt is made to enqueue more than the queue can hold then
-  // we'll enlarge the queue's capacity.
-  if(mySize == myCapacity)
-    grow();
-
-  myBuffer[myTail] = info;
-  myTail = (myTail + 1) % myCapacity;
-  ++mySize;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-SoundSDL2::RegWrite& SoundSDL2::RegWriteQueue::front() const
-{
-  assert(mySize != 0);
-  return myBuffer[myHead];
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 SoundSDL2::RegWriteQueue::size() const
-{
-  return mySize;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundSDL2::RegWriteQueue::grow()
-{
-  unique_ptr<RegWrite[]> buffer = make_ptr<RegWrite[]>(myCapacity*2);
-  for(uInt32 i = 0; i < mySize; ++i)
-    buffer[i] = myBuffer[(myHead + i) % myCapacity];
-
-  myHead = 0;
-  myTail = mySize;
-  myCapacity *= 2;
-
-  myBuffer = std::move(buffer);
+  else
+    SDL_memset(stream, 0, len);  // Write 'silence'
 }
 
 #endif  // SOUND_SUPPORT
@@ -22,10 +22,13 @@
 
 class OSystem;
 
+#include <atomic>
+
 #include "SDL_lib.hxx"
 
 #include "bspf.hxx"
-#include "TIASnd.hxx"
+#include "AudioResampler.hxx"
+#include "LockFreeQueue.hxx"
 #include "Sound.hxx"
 
 /**
@@ -55,14 +58,6 @@ class SoundSDL2 : public Sound
     */
     void setEnabled(bool state) override;
 
-    /**
-      The system cycle counter is being adjusting by the specified amount. Any
-      members using the system cycle counter should be adjusted as needed.
-
-      @param amount  The amount the cycle counter is being adjusted by
-    */
-    void adjustCycleCounter(Int32 amount) override;
-
     /**
       Sets the number of channels (mono or stereo sound).  Note that this
       determines how the emulation should 'mix' the channels of the TIA sound
@@ -74,14 +69,6 @@ class SoundSDL2 : public Sound
     */
     void setChannels(uInt32 channels) override;
 
-    /**
-      Sets the display framerate.  Sound generation for NTSC and PAL games
-      depends on the framerate, so we need to set it here.
-
-      @param framerate The base framerate depending on NTSC or PAL ROM
-    */
-    void setFrameRate(float framerate) override;
-
     /**
       Initializes the sound device.  This must be called before any
       calls are made to derived methods.
@@ -107,13 +94,21 @@ class SoundSDL2 : public Sound
     void reset() override;
 
     /**
-      Sets the sound register to a given value.
+      Sets the rate of the samples passed to processSamples(), and sets up
+      the resampler and the buffers for it.
 
-      @param addr   The register address
-      @param value  The value to save into the register
-      @param cycle  The system cycle at which the register is being updated
+      @param rate  The rate of the TIA's samples, in Hz
     */
-    void set(uInt16 addr, uInt8 value, Int32 cycle) override;
+    void setSampleRate(double rate) override;
+
+    /**
+      Resamples the given samples from the TIA for the sound device, and
+      queues them to be played.
+
+      @param samples The samples, with the two channels interleaved
+      @param count   The number of samples
+    */
+    void processSamples(const Int16* samples, uInt32 count) override;
 
     /**
       Sets the volume of the sound device to the specified level.  The
@@ -132,143 +127,39 @@ class SoundSDL2 : public Sound
     */
     void adjustVolume(Int8 direction) override;
 
-  public:
     /**
-      Saves the current state of this device to the given Serializer.
-
-      @param out  The serializer device to save to.
-      @return  The result of the save.  True on success, false on failure.
+      Answers how full the queue of samples waiting to be played is, as a
+      percentage of the level it's kept at, and how many times the sound
+      device has run out of samples since the sound was opened.
     */
-    bool save(Serializer& out) const override;
-
-    /**
-      Loads the current state of this device from the given Serializer.
-
-      @param in  The Serializer device to load from.
-      @return  The result of the load.  True on success, false on failure.
-    */
-    bool load(Serializer& in) override;
-
-    /**
-      Get a descriptor for this console class (used in error checking).
-
-      @return  The name of the object
-    */
-    string name() const override { return "TIASound"; }
+    void queueStats(uInt32& fill, uInt32& underruns) const override;
 
   protected:
     /**
-      Invoked by the sound callback to process the next sound fragment.
-      The stream is 16-bits (even though the callback is 8-bits), since
-      the TIASnd class always generates signed 16-bit stereo samples.
+      Invoked by the sound callback to fill the next sound fragment with
+      the queued samples.
 
       @param stream  Pointer to the start of the fragment
-      @param length  Length of the fragment
+      @param length  Length of the fragment, in 16-bit values
     */
     void processFragment(Int16* stream, uInt32 length);
 
-  protected:
-    // Struct to hold information regarding a TIA sound register write
-    struct RegWrite
-    {
-      uInt16 addr;
-      uInt8 value;
-      double delta;
-    };
-
     /**
-      A queue class used to hold TIA sound register writes before being
-      processed while creating a sound fragment.
+      Empty the queue of samples, along with those held by the resampler.
+      This must only be called while the sound callback is paused.
     */
-    class RegWriteQueue
-    {
-      public:
-        /**
-          Create a new queue instance with the specified initial
-          capacity.  If the queue ever reaches its capacity then it will
-          automatically increase its size.
-        */
-        RegWriteQueue(uInt32 capacity = 512);
-
-      public:
-        /**
-          Clear any items stored in the queue.
-        */
-        void clear();
-
-        /**
-          Dequeue the first object in the queue.
-        */
-        void dequeue();
-
-        /**
-          Return the duration of all the items in the queue.
-        */
-        double duration() const;
-
-        /**
-          Enqueue the specified object.
-        */
-        void enqueue(const RegWrite& info);
-
-        /**
-          Return the item at the front on the queue.
-
-          @return  The item at the front of the queue.
-        */
-        RegWrite& front() const;
-
-        /**
-          Answers the number of items currently in the queue.
-
-          @return  The number of items in the queue.
-        */
-        uInt32 size() const;
-
-      private:
-        // Increase the size of the queue
-        void grow();
-
-      private:
-        unique_ptr<RegWrite[]> myBuffer;
-        uInt32 myCapacity;
-        uInt32 mySize;
-        uInt32 myHead;
-        uInt32 myTail;
-
-      private:
-        // Following constructors and assignment operators not supported
-        RegWriteQueue(const RegWriteQueue&) = delete;
-        RegWriteQueue(RegWriteQueue&&) = delete;
-        RegWriteQueue& operator=(const RegWriteQueue&) = delete;
-        RegWriteQueue& operator=(RegWriteQueue&&) = delete;
-    };
+    void clearQueue();
 
   private:
-    // TIASound emulation object
-    TIASound myTIASound;
-
     // Indicates if the sound subsystem is to be initialized
     bool myIsEnabled;
 
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag;
 
-    // Indicates the cycle when a sound register was last set
-    Int32 myLastRegisterSetCycle;
-
     // Indicates the number of channels (mono or stereo)
     uInt32 myNumChannels;
 
-    // Log base 2 of the selected fragment size
-    double myFragmentSizeLogBase2;
-
-    // The myFragmentSizeLogBase2 variable is used in only two places,
-    // both of which involve an expensive division in the sound
-    // processing callback
-    // These are pre-computed to speed up the callback as much as possible
-    double myFragmentSizeLogDiv1, myFragmentSizeLogDiv2;
-
     // Indicates if the sound is currently muted
     bool myIsMuted;
 
@@ -278,8 +169,38 @@ class SoundSDL2 : public Sound
     // Audio specification structure
     SDL_AudioSpec myHardwareSpec;
 
-    // Queue of TIA register writes
-    RegWriteQueue myRegWriteQueue;
+    // Converts the TIA's samples (at the given rate) to the rate of the
+    // sound device, and the buffers that hold them after resampling, and
+    // after mixing
+    double mySampleRate;
+    AudioResampler myResampler;
+    unique_ptr<float[]> myResampled;
+    unique_ptr<Int16[]> myMixed;
+
+    // The samples waiting to be played (enough for the largest fragment
+    // size, 4096 stereo samples, four times over), the level the queue is
+    // kept at when new samples arrive, which sets the latency, and the most
+    // that are queued at any time (all in 16-bit values)
+    Common::LockFreeQueue<Int16, 32768> mySampleQueue;
+    uInt32 myTargetLevel;
+    uInt32 myQueueLimit;
+
+    // The level of the queue when new samples arrive, averaged over the
+    // last few frames
+    double myAverageLevel;
+
+    // Whether the callback is playing the queued samples, or waiting for
+    // enough to be queued; the emulation starts it, and the callback stops
+    // it when the queue runs dry
+    std::atomic<bool> myIsPlaying;
+
+    // The last sample played, which is repeated when the queue runs dry
+    Int16 myLastSample[2];
+
+    // The number of samples that didn't fit in the queue, and the number
+    // of times the queue ran dry while playing
+    uInt32 myOverflowCount;
+    std::atomic<uInt32> myUnderrunCount;
 
   private:
     // Callback function invoked by the SDL Audio library when it needs data
@@ -35,9 +35,9 @@ class Variant
     // Underlying data store is (currently) always a string
     string data;
 
-    // Use singleton so we use only one ostringstream object
+    // Use singleton so we use only one ostringstream object (per thread)
     inline ostringstream& buf() {
-      static ostringstream buf;
+      static thread_local ostringstream buf;
       return buf;
     }
 
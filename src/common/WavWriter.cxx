@@ -0,0 +1,202 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "WavWriter.hxx"
+
+namespace {
+  // The size of each sample in the file (two 16-bit channels)
+  constexpr uInt32 kSampleBytes = 4;
+
+  // The size of the header, and the most samples that fit in a WAV file
+  constexpr uInt32 kHeaderBytes = 44;
+  constexpr uInt64 kMaxSamples = (0xFFFFFFFFull - kHeaderBytes) / kSampleBytes;
+
+  // WAV files are always little-endian
+  inline uInt8* put16(uInt8* out, uInt16 value)
+  {
+    out[0] = uInt8(value);
+    out[1] = uInt8(value >> 8);
+    return out + 2;
+  }
+
+  inline uInt8* put32(uInt8* out, uInt32 value)
+  {
+    return put16(put16(out, uInt16(value)), uInt16(value >> 16));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WavWriter::WavWriter()
+  : mySampleRate(0),
+    myQueued(0),
+    myWritten(0),
+    mySamples(0),
+    myIsGood(false),
+    myIsClosing(false)
+{
+  for(uInt32 i = 0; i < kNumBlocks; ++i)
+  {
+    myBlocks[i] = make_ptr<Int16[]>(2 * kBlockSamples);
+    myBlockSamples[i] = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WavWriter::~WavWriter()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool WavWriter::open(const string& filename, uInt32 rate)
+{
+  close();
+
+  myFile.open(filename, std::ios::binary | std::ios::trunc);
+  if(!myFile.is_open())
+    return false;
+
+  for(uInt32 i = 0; i < kNumBlocks; ++i)
+    myBlockSamples[i] = 0;
+  myQueued = myWritten = 0;
+  mySamples = 0;
+  mySampleRate = rate;
+  myIsGood = true;
+  myIsClosing = false;
+
+  // The sizes in the header are filled in when the file is closed
+  writeHeader(0);
+  myThread = std::thread(&WavWriter::writeBlocks, this);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool WavWriter::close()
+{
+  if(!isOpen())
+    return true;
+
+  // The block being filled is always free, so it can be queued without
+  // waiting, even if it isn't full
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    if(myBlockSamples[myQueued % kNumBlocks] > 0)
+      ++myQueued;
+    myIsClosing = true;
+  }
+  myBlockQueued.notify_one();
+  myThread.join();
+
+  writeHeader(mySamples);
+  myFile.close();
+
+  return myIsGood && !myFile.fail();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WavWriter::captureSamples(const Int16* samples, uInt32 count)
+{
+  if(!isOpen())
+    return;
+
+  mySamples += count;
+
+  while(count > 0)
+  {
+    const uInt32 block = myQueued % kNumBlocks;
+    const uInt32 filled = myBlockSamples[block];
+    const uInt32 taken = std::min(count, kBlockSamples - filled);
+
+    std::copy_n(samples, 2 * taken, myBlocks[block].get() + 2 * filled);
+    myBlockSamples[block] += taken;
+    samples += 2 * taken;
+    count -= taken;
+
+    if(myBlockSamples[block] == kBlockSamples)
+      queueBlock();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WavWriter::queueBlock()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+  ++myQueued;
+  myBlockQueued.notify_one();
+
+  // The next block can only be filled once it's been written
+  myBlockWritten.wait(lock, [this] { return myQueued - myWritten < kNumBlocks; });
+  myBlockSamples[myQueued % kNumBlocks] = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WavWriter::writeBlocks()
+{
+  unique_ptr<uInt8[]> bytes = make_ptr<uInt8[]>(kBlockSamples * kSampleBytes);
+
+  std::unique_lock<std::mutex> lock(myMutex);
+  for(;;)
+  {
+    myBlockQueued.wait(lock, [this] { return myWritten != myQueued || myIsClosing; });
+    if(myWritten == myQueued)
+      break;
+
+    // The block isn't touched by the emulation until it's been written
+    const uInt32 block = myWritten % kNumBlocks;
+    const uInt32 count = myBlockSamples[block];
+    lock.unlock();
+
+    const Int16* in = myBlocks[block].get();
+    uInt8* out = bytes.get();
+    for(uInt32 i = 0; i < 2 * count; ++i)
+      out = put16(out, uInt16(in[i]));
+    myFile.write(reinterpret_cast<const char*>(bytes.get()),
+                 count * kSampleBytes);
+
+    lock.lock();
+    myIsGood = myIsGood && myFile.good();
+    ++myWritten;
+    myBlockWritten.notify_one();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WavWriter::writeHeader(uInt64 samples)
+{
+  const uInt32 dataBytes = uInt32(std::min(samples, kMaxSamples) * kSampleBytes);
+
+  uInt8 header[kHeaderBytes];
+  uInt8* out = header;
+  out = put32(out, 0x46464952);                   // "RIFF"
+  out = put32(out, kHeaderBytes - 8 + dataBytes);
+  out = put32(out, 0x45564157);                   // "WAVE"
+  out = put32(out, 0x20746d66);                   // "fmt "
+  out = put32(out, 16);                           // Size of the format
+  out = put16(out, 1);                            // PCM
+  out = put16(out, 2);                            // Channels
+  out = put32(out, mySampleRate);
+  out = put32(out, mySampleRate * kSampleBytes);  // Bytes per second
+  out = put16(out, kSampleBytes);                 // Bytes per sample
+  out = put16(out, 16);                           // Bits per channel
+  out = put32(out, 0x61746164);                   // "data"
+  put32(out, dataBytes);
+
+  myFile.seekp(0);
+  myFile.write(reinterpret_cast<const char*>(header), kHeaderBytes);
+  myIsGood = myIsGood && myFile.good();
+}
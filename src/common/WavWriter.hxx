@@ -0,0 +1,133 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef WAV_WRITER_HXX
+#define WAV_WRITER_HXX
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "AudioCapture.hxx"
+
+/**
+  This class writes the sound generated by the TIA to a WAV file, as
+  16-bit stereo samples (one channel for each TIA channel) at the rate
+  they're generated, which is twice the console's scanline rate.
+
+  The samples are gathered into a small number of fixed-size blocks, and
+  each full block is written by a background thread, so the emulation
+  doesn't wait for the disk.  If the writer falls behind by all of the
+  blocks, the emulation waits for it; samples are never dropped, so the
+  file always matches the emulation exactly.
+*/
+class WavWriter : public AudioCapture
+{
+  public:
+    WavWriter();
+    virtual ~WavWriter();
+
+  public:
+    /**
+      Start writing a new file, replacing any existing one.
+
+      @param filename  The name of the WAV file
+      @param rate      The sample rate, from Console::audioSampleRate()
+      @return  False if the file couldn't be created, else true
+    */
+    bool open(const string& filename, uInt32 rate);
+
+    /**
+      Write any remaining samples, complete the file and close it.
+
+      @return  False if any part of the file couldn't be written, else true
+    */
+    bool close();
+
+    /**
+      Answers whether a file is being written.
+    */
+    bool isOpen() const { return myThread.joinable(); }
+
+    /**
+      Answers the number of samples passed in since the file was opened.
+    */
+    uInt64 samples() const { return mySamples; }
+
+    /**
+      Queue the given samples to be written to the file.
+
+      @param samples  The samples, with the two channels interleaved
+      @param count    The number of samples
+    */
+    void captureSamples(const Int16* samples, uInt32 count) override;
+
+  private:
+    // Write the WAV header for the given number of samples
+    void writeHeader(uInt64 samples);
+
+    // Hand over the block being filled to the background thread
+    void queueBlock();
+
+    // The background thread, which writes each block as it's queued
+    void writeBlocks();
+
+  private:
+    // The number of samples in each block (about half a second), and the
+    // number of blocks
+    static constexpr uInt32 kBlockSamples = 16384;
+    static constexpr uInt32 kNumBlocks = 4;
+
+    std::ofstream myFile;
+
+    // The sample rate given in the header
+    uInt32 mySampleRate;
+
+    // The blocks of samples, and the number of samples in each
+    unique_ptr<Int16[]> myBlocks[kNumBlocks];
+    uInt32 myBlockSamples[kNumBlocks];
+
+    // The number of blocks queued and written so far; the block after the
+    // last one queued is being filled, once it's been written
+    uInt32 myQueued;
+    uInt32 myWritten;
+
+    // The number of samples passed in, and whether the file was written
+    // without errors
+    uInt64 mySamples;
+    bool myIsGood;
+
+    // Whether the background thread should finish once all the queued
+    // blocks are written
+    bool myIsClosing;
+
+    std::thread myThread;
+    std::mutex myMutex;
+    std::condition_variable myBlockQueued;
+    std::condition_variable myBlockWritten;
+
+  private:
+    // Following constructors and assignment operators not supported
+    WavWriter(const WavWriter&) = delete;
+    WavWriter(WavWriter&&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+    WavWriter& operator=(WavWriter&&) = delete;
+};
+
+#endif
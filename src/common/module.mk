@@ -3,10 +3,15 @@ MODULE := src/common
 MODULE_OBJS := \
 	src/common/main.o \
 	src/common/Base.o \
+	src/common/MediaFactory.o \
 	src/common/EventHandlerSDL2.o \
 	src/common/FrameBufferSDL2.o \
+	src/common/FrameBufferNull.o \
 	src/common/FBSurfaceSDL2.o \
+	src/common/FBSurfaceNull.o \
 	src/common/SoundSDL2.o \
+	src/common/AudioResampler.o \
+	src/common/WavWriter.o \
 	src/common/FSNodeZIP.o \
 	src/common/PNGLibrary.o \
 	src/common/MouseControl.o \
@@ -56,7 +56,7 @@
 #include "TIA.hxx"
 #include "Debugger.hxx"
 
-Debugger* Debugger::myStaticDebugger = nullptr;
+thread_local Debugger* Debugger::myStaticDebugger = nullptr;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 static const char* builtin_functions[][3] = {
@@ -125,11 +125,10 @@ Debugger::Debugger(OSystem& osystem, Console& console)
   myRiotDebug = make_ptr<RiotDebug>(*this, myConsole);
   myTiaDebug  = make_ptr<TIADebug>(*this, myConsole);
 
-  // Allow access to this object from any class
-  // Technically this violates pure OO programming, but since I know
-  // there will only be ever one instance of debugger in Stella,
-  // I don't care :)
-  myStaticDebugger = this;
+  // Allow access to this object from any class (on this thread)
+  // Technically this violates pure OO programming, but it's only ever
+  // used from code running this debugger's console
+  makeCurrent();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -485,6 +484,10 @@ void Debugger::setStartState()
   // Lock the bus each time the debugger is entered, so we don't disturb anything
   lockBankswitchState();
 
+  // The debugger changes the TIA directly, not through register writes,
+  // so the TIA can't tell when a frame could be reused
+  myOSystem.console().tia().enableFrameCache(false);
+
   // Start a new rewind list
   myRewindManager->clear();
 
@@ -500,6 +503,7 @@ void Debugger::setQuitState()
 {
   // Bus must be unlocked for normal operation when leaving debugger mode
   unlockBankswitchState();
+  myOSystem.console().tia().enableFrameCache(true);
 
   // execute one instruction on quit. If we're
   // sitting at a breakpoint/trap, this will get us past it.
@@ -208,9 +208,20 @@ class Debugger : public DialogContainer
       It's basically a hack to prevent the need to pass debugger objects
       everywhere, but I feel it's better to place it here then in
       YaccParser (which technically isn't related to it at all).
+
+      Note that this returns the debugger for the console currently being
+      run on the calling thread (see makeCurrent()).
     */
     static Debugger& debugger() { return *myStaticDebugger; }
 
+    /**
+      Make this the debugger returned by debugger() for the calling thread.
+      The CPU calls this before executing code, so that conditional
+      breakpoints and cart debug hooks see the correct console when
+      several consoles are run on separate threads.
+    */
+    void makeCurrent() { myStaticDebugger = this; }
+
     /* These are now exposed so Expressions can use them. */
     int peek(int addr) { return mySystem.peek(addr); }
     int dpeek(int addr) { return mySystem.peek(addr) | (mySystem.peek(addr+1) << 8); }
@@ -286,7 +297,8 @@ class Debugger : public DialogContainer
     unique_ptr<RiotDebug>      myRiotDebug;
     unique_ptr<TIADebug>       myTiaDebug;
 
-    static Debugger* myStaticDebugger;
+    // The debugger for the console being run on the current thread
+    static thread_local Debugger* myStaticDebugger;
 
     FunctionMap myFunctions;
     FunctionDefMap myFunctionDefs;
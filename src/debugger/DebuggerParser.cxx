@@ -48,6 +48,9 @@ using std::right;
   #include "Cheat.hxx"
   #include "CheatManager.hxx"
 #endif
+#ifdef THUMB_SUPPORT
+  #include "Thumbulator.hxx"
+#endif
 
 #include "DebuggerParser.hxx"
 
@@ -611,6 +614,32 @@ void DebuggerParser::executeA()
   debugger.cpuDebug().setA(uInt8(args[0]));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "armprofile"
+void DebuggerParser::executeArmprofile()
+{
+#ifdef THUMB_SUPPORT
+  Thumbulator* thumbulator = debugger.myConsole.cartridge().thumbulator();
+  if(!thumbulator)
+  {
+    commandResult << red("No ARM code in this cart");
+    return;
+  }
+
+  if(argCount == 1)
+  {
+    thumbulator->enableProfiling(args[0]);
+    commandResult << "ARM profiling " << (args[0] ? "started" : "stopped");
+  }
+  else if(thumbulator->profiler())
+    commandResult << thumbulator->profileReport(20, false);
+  else
+    commandResult << "ARM profiling is off, use 'armprofile 1' to start it";
+#else
+  commandResult << red("ARM emulation not supported");
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "base"
 void DebuggerParser::executeBase()
@@ -1670,6 +1699,17 @@ DebuggerParser::Command DebuggerParser::commands[kNumCommands] = {
     std::mem_fn(&DebuggerParser::executeA)
   },
 
+  {
+    "armprofile",
+    "Show ARM profile, or start (1) or stop (0) it",
+    "Shows the ARM cycles per frame and call, and the busiest addresses\n"
+    "Only for DPC+/CDF/BUS carts\nExample: armprofile 1, armprofile",
+    false,
+    false,
+    { kARG_BOOL, kARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeArmprofile)
+  },
+
   {
     "base",
     "Set default base to <base>",
@@ -68,7 +68,7 @@ class DebuggerParser
     bool saveScriptFile(string file);
 
   private:
-    enum { kNumCommands = 72 };
+    enum { kNumCommands = 73 };
 
     // Constants for argument processing
     enum {
@@ -118,6 +118,7 @@ class DebuggerParser
 
     // List of available command methods
     void executeA();
+    void executeArmprofile();
     void executeBase();
     void executeBreak();
     void executeBreakif();
@@ -39,6 +39,9 @@ class PackedBitArray
 
     bool isInitialized() const { return myInitialized; }
 
+    // Answer whether any bit is actually set (not just initialized)
+    bool any() const { return myInitialized && myBits.any(); }
+
   private:
     // The actual bits
     std::bitset<0x10000> myBits;
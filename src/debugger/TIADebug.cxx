@@ -40,6 +40,9 @@ TIADebug::TIADebug(Debugger& dbg, Console& console)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const DebuggerState& TIADebug::getState()
 {
+  // Make sure the frame shows everything emulated so far
+  myTIA.renderPendingPixels();
+
   myState.ram.clear();
   for(int i = 0; i < 0x010; ++i)
     myState.ram.push_back(myTIA.peek(i));
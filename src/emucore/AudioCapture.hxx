@@ -0,0 +1,53 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef AUDIO_CAPTURE_HXX
+#define AUDIO_CAPTURE_HXX
+
+#include "bspf.hxx"
+
+/**
+  This class provides an interface for receiving a copy of the sound
+  generated by the TIA (see TIA::setAudioCapture()), alongside what's
+  passed on to the sound device.  The samples are exactly those that
+  were generated, two per scanline, whatever the speed of the emulation
+  and whether or not there is a sound device at all.
+*/
+class AudioCapture
+{
+  public:
+    AudioCapture() = default;
+    virtual ~AudioCapture() = default;
+
+    /**
+      Receive the next samples generated by the TIA.  This is called from
+      the emulation, normally once per frame.
+
+      @param samples  The samples, with the two channels interleaved
+      @param count    The number of samples
+    */
+    virtual void captureSamples(const Int16* samples, uInt32 count) = 0;
+
+  private:
+    // Following constructors and assignment operators not supported
+    AudioCapture(const AudioCapture&) = delete;
+    AudioCapture(AudioCapture&&) = delete;
+    AudioCapture& operator=(const AudioCapture&) = delete;
+    AudioCapture& operator=(AudioCapture&&) = delete;
+};
+
+#endif
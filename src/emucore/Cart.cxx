@@ -275,7 +275,7 @@ unique_ptr<Cartridge> Cartridge::create(const BytePtr& img, uInt32 size,
     buf << " (" << size << "B) ";
   else
     buf << " (" << (size/1024) << "K) ";
-  myAboutString = buf.str();
+  cartridge->myAboutString = buf.str();
 
   return cartridge;
 }
@@ -1005,9 +1005,6 @@ bool Cartridge::isProbablyX07(const uInt8* image, uInt32 size)
   return false;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Cartridge::myAboutString= "";
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge::BankswitchType Cartridge::ourBSList[ourNumBSTypes] = {
   { "AUTO",     "Auto-detect"                   },
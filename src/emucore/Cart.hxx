@@ -26,6 +26,7 @@ class Properties;
 class CartDebugWidget;
 class CartRamWidget;
 class GuiObject;
+class Thumbulator;
 
 #include "bspf.hxx"
 #include "Device.hxx"
@@ -73,7 +74,7 @@ class Cartridge : public Device
     /**
       Query some information about this cartridge.
     */
-    static constexpr string& about() { return myAboutString; }
+    const string& about() const { return myAboutString; }
 
     /**
       Save the internal (patched) ROM image.
@@ -164,6 +165,15 @@ class Cartridge : public Device
     */
     virtual const uInt8* getImage(int& size) const = 0;
 
+    /**
+      Access the internal RAM for this cartridge (if any).  This allows
+      external code to observe the cart state without involving the debugger.
+
+      @param size  Set to the size of the internal RAM (0 if there is none)
+      @return  A pointer to the internal RAM, or nullptr if there is none
+    */
+    virtual const uInt8* getRAM(uInt32& size) const { size = 0;  return nullptr; }
+
     /**
       Informs the cartridge about the name of the ROM file used when
       creating this cart.
@@ -179,6 +189,12 @@ class Cartridge : public Device
     */
     virtual uInt32 thumbCallback(uInt8 function, uInt32 value1, uInt32 value2) { return 0; }
 
+    /**
+      Answers the emulator for the ARM code in Harmony/Melody carts (ie,
+      so it can be profiled), or nullptr for carts without one.
+    */
+    virtual Thumbulator* thumbulator() const { return nullptr; }
+
     /**
       Get debugger widget responsible for accessing the inner workings
       of the cart.  This will need to be overridden and implemented by
@@ -420,7 +436,7 @@ class Cartridge : public Device
     bool myBankLocked;
 
     // Contains info about this cartridge in string format
-    static string myAboutString;
+    string myAboutString;
 
     // Following constructors and assignment operators not supported
     Cartridge() = delete;
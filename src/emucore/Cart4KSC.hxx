@@ -76,6 +76,15 @@ class Cartridge4KSC : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Access the internal RAM for this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    const uInt8* getRAM(uInt32& size) const override
+      { size = sizeof(myRAM);  return myRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
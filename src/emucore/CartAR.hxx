@@ -107,6 +107,15 @@ class CartridgeAR : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Access the internal RAM for this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    const uInt8* getRAM(uInt32& size) const override
+      { size = 6 * 1024;  return myImage; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -222,7 +231,7 @@ class CartridgeAR : public Cartridge
     uInt16 myCurrentBank;
 
     // Fake SC-BIOS code to simulate the Supercharger load bars
-    static uInt8 ourDummyROMCode[294];
+    static const uInt8 ourDummyROMCode[294];
 
     // Default 256-byte header to use if one isn't included in the ROM
     // This data comes from z26
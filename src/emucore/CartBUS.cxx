@@ -44,8 +44,7 @@ CartridgeBUS::CartridgeBUS(const uInt8* image, uInt32 size,
                                    const Settings& settings)
   : Cartridge(settings),
     mySystemCycles(0),
-    myARMCycles(0),
-    myFractionalClocks(0.0)
+    myARMCycles(0)
 {
   // Copy the ROM image into my buffer
   memcpy(myImage, image, std::min(32768u, size));
@@ -67,6 +66,7 @@ CartridgeBUS::CartridgeBUS(const uInt8* image, uInt32 size,
   // Create Thumbulator ARM emulator
   myThumbEmulator = make_ptr<Thumbulator>((uInt16*)myImage, (uInt16*)myBUSRAM,
     settings.getBool("thumb.trapfatal"), Thumbulator::ConfigureFor::BUS, this);
+  myThumbEmulator->enableTranslation(settings.getBool("thumb.translate"));
 #endif
   setInitialState();
 }
@@ -83,7 +83,7 @@ void CartridgeBUS::reset()
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
   myARMCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myMusicClock.reset();
 
   setInitialState();
 
@@ -151,9 +151,7 @@ inline void CartridgeBUS::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of BUS OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = Int32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  Int32 wholeClocks = myMusicClock.clocks(cycles);
 
   if(wholeClocks <= 0)
   {
@@ -181,6 +179,8 @@ inline void CartridgeBUS::callFunction(uInt8 value)
         Int32 cycles = mySystem->cycles() - myARMCycles;
         myARMCycles = mySystem->cycles();
         
+        if(ThumbProfiler* profiler = myThumbEmulator->profiler())
+          profiler->startCall(mySystem->tia().frameCount(), mySystem->totalCycles());
         myThumbEmulator->run(cycles);
       }
       catch(const runtime_error& e) {
@@ -573,7 +573,7 @@ bool CartridgeBUS::save(Serializer& out) const
     
     // Save cycles and clocks
     out.putInt(mySystemCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    myMusicClock.save(out);
     out.putInt(myARMCycles);
     
     // Audio info
@@ -617,7 +617,7 @@ bool CartridgeBUS::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     mySystemCycles = (Int32)in.getInt();
-    myFractionalClocks = (double)in.getInt() / 100000000.0;
+    myMusicClock.load(in);
     myARMCycles = (Int32)in.getInt();
     
     // Audio info
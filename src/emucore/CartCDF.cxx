@@ -44,8 +44,7 @@ CartridgeCDF::CartridgeCDF(const uInt8* image, uInt32 size,
                            const Settings& settings)
   : Cartridge(settings),
     myAudioCycles(0),
-    myARMCycles(0),
-    myFractionalClocks(0.0)
+    myARMCycles(0)
 {
   // Copy the ROM image into my buffer
   memcpy(myImage, image, std::min(32768u, size));
@@ -66,6 +65,7 @@ CartridgeCDF::CartridgeCDF(const uInt8* image, uInt32 size,
   // Create Thumbulator ARM emulator
   myThumbEmulator = make_ptr<Thumbulator>((uInt16*)myImage, (uInt16*)myCDFRAM,
       settings.getBool("thumb.trapfatal"), Thumbulator::ConfigureFor::CDF, this);
+  myThumbEmulator->enableTranslation(settings.getBool("thumb.translate"));
 #endif
   setInitialState();
 }
@@ -82,7 +82,7 @@ void CartridgeCDF::reset()
   // Update cycles to the current system cycles
   myAudioCycles = mySystem->cycles();
   myARMCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myMusicClock.reset();
 
   setInitialState();
 
@@ -147,9 +147,7 @@ inline void CartridgeCDF::updateMusicModeDataFetchers()
   myAudioCycles = mySystem->cycles();
 
   // Calculate the number of CDF OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = Int32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  Int32 wholeClocks = myMusicClock.clocks(cycles);
 
   if(wholeClocks <= 0)
     return;
@@ -173,6 +171,8 @@ inline void CartridgeCDF::callFunction(uInt8 value)
         Int32 cycles = mySystem->cycles() - myARMCycles;
         myARMCycles = mySystem->cycles();
 
+        if(ThumbProfiler* profiler = myThumbEmulator->profiler())
+          profiler->startCall(mySystem->tia().frameCount(), mySystem->totalCycles());
         myThumbEmulator->run(cycles);
       }
       catch(const runtime_error& e) {
@@ -512,7 +512,7 @@ bool CartridgeCDF::save(Serializer& out) const
 
     // Save cycles and clocks
     out.putInt(myAudioCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    myMusicClock.save(out);
     out.putInt(myARMCycles);
   }
   catch(...)
@@ -555,7 +555,7 @@ bool CartridgeCDF::load(Serializer& in)
 
     // Get cycles and clocks
     myAudioCycles = (Int32)in.getInt();
-    myFractionalClocks = (double)in.getInt() / 100000000.0;
+    myMusicClock.load(in);
     myARMCycles = (Int32)in.getInt();
   }
   catch(...)
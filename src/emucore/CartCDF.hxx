@@ -28,6 +28,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "MusicClock.hxx"
 
 /**
   Cartridge class used for CDF.
@@ -122,6 +123,15 @@ class CartridgeCDF : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Access the internal RAM for this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    const uInt8* getRAM(uInt32& size) const override
+      { size = sizeof(myCDFRAM);  return myCDFRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -152,6 +162,13 @@ class CartridgeCDF : public Cartridge
     */
     uInt32 thumbCallback(uInt8 function, uInt32 value1, uInt32 value2) override;
 
+#ifdef THUMB_SUPPORT
+    /**
+      Answers the emulator for the ARM code in this cart.
+    */
+    Thumbulator* thumbulator() const override { return myThumbEmulator.get(); }
+#endif
+
 #ifdef DEBUGGER_SUPPORT
     /**
       Get debugger widget responsible for accessing the inner workings
@@ -268,8 +285,8 @@ class CartridgeCDF : public Cartridge
     // The music waveform sizes
     uInt8 myMusicWaveformSize[3];
 
-    // Fractional CDF music, OSC clocks unused during the last update
-    double myFractionalClocks;
+    // CDF music OSC clocks, with the part unused during the last update
+    MusicClock myMusicClock;
 
     // Controls mode, lower nybble sets Fast Fetch, upper nybble sets audio
     // -0 = Fast Fetch ON
@@ -31,7 +31,6 @@ CartridgeCTY::CartridgeCTY(const uInt8* image, uInt32 size, const OSystem& osyst
     myRandomNumber(0x2B435044),
     myRamAccessTimeout(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0),
     myCurrentBank(0)
 {
   // Copy the ROM image into my buffer
@@ -54,7 +53,7 @@ void CartridgeCTY::reset()
 
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myMusicClock.reset();
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -296,7 +295,7 @@ bool CartridgeCTY::save(Serializer& out) const
     out.putBool(myLDAimmediate);
     out.putInt(myRandomNumber);
     out.putInt(mySystemCycles);
-    out.putInt(uInt32(myFractionalClocks * 100000000.0));
+    myMusicClock.save(out);
 
   }
   catch(...)
@@ -325,7 +324,7 @@ bool CartridgeCTY::load(Serializer& in)
     myLDAimmediate = in.getBool();
     myRandomNumber = in.getInt();
     mySystemCycles = in.getInt();
-    myFractionalClocks = double(in.getInt()) / 100000000.0;
+    myMusicClock.load(in);
   }
   catch(...)
   {
@@ -473,17 +472,19 @@ void CartridgeCTY::saveScore(uInt8 index)
     // Add 60B RAM to score table @ given index (first 4 bytes are ignored)
     memcpy(scoreRAM + (index << 6) + 4, myRAM+4, 60);
 
-    // Save score RAM
+    // Save score RAM, making sure it reaches the file
     serializer.reset();
+    bool saved = false;
     try
     {
       serializer.putByteArray(scoreRAM, 256);
+      saved = serializer.flush();
     }
     catch(...)
     {
-      // Maybe add logging here that save failed?
-      cerr << name() << ": ERROR saving score table " << int(index) << endl;
     }
+    if(!saved)
+      cerr << name() << ": ERROR saving score table " << int(index) << endl;
   }
 }
 
@@ -496,15 +497,17 @@ void CartridgeCTY::wipeAllScores()
     // Erase score RAM
     uInt8 scoreRAM[256];
     memset(scoreRAM, 0, 256);
+    bool wiped = false;
     try
     {
       serializer.putByteArray(scoreRAM, 256);
+      wiped = serializer.flush();
     }
     catch(...)
     {
-      // Maybe add logging here that save failed?
-      cerr << name() << ": ERROR wiping score tables" << endl;
     }
+    if(!wiped)
+      cerr << name() << ": ERROR wiping score tables" << endl;
   }
 }
 
@@ -516,9 +519,7 @@ inline void CartridgeCTY::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = Int32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  Int32 wholeClocks = myMusicClock.clocks(cycles);
 
   if(wholeClocks <= 0)
     return;
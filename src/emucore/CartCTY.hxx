@@ -22,6 +22,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "MusicClock.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartCTYWidget.hxx"
 #endif
@@ -177,6 +178,15 @@ class CartridgeCTY : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Access the internal RAM for this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    const uInt8* getRAM(uInt32& size) const override
+      { size = sizeof(myRAM);  return myRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -300,8 +310,8 @@ class CartridgeCTY : public Cartridge
     // System cycle count when the last update to music data fetchers occurred
     Int32 mySystemCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // DPC music OSC clocks, with the part unused during the last update
+    MusicClock myMusicClock;
 
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
@@ -24,7 +24,6 @@ CartridgeDPC::CartridgeDPC(const uInt8* image, uInt32 size,
   : Cartridge(settings),
     mySize(size),
     mySystemCycles(0),
-    myFractionalClocks(0.0),
     myCurrentBank(0)
 {
   // Make a copy of the entire image
@@ -56,7 +55,7 @@ void CartridgeDPC::reset()
 {
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myMusicClock.reset();
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -109,9 +108,7 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = Int32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  Int32 wholeClocks = myMusicClock.clocks(cycles);
 
   if(wholeClocks <= 0)
   {
@@ -483,7 +480,7 @@ bool CartridgeDPC::save(Serializer& out) const
     out.putByte(myRandomNumber);
 
     out.putInt(mySystemCycles);
-    out.putInt(uInt32(myFractionalClocks * 100000000.0));
+    myMusicClock.save(out);
   }
   catch(...)
   {
@@ -526,7 +523,7 @@ bool CartridgeDPC::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     mySystemCycles = Int32(in.getInt());
-    myFractionalClocks = double(in.getInt()) / 100000000.0;
+    myMusicClock.load(in);
   }
   catch(...)
   {
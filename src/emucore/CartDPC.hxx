@@ -22,6 +22,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "MusicClock.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartDPCWidget.hxx"
 #endif
@@ -205,8 +206,8 @@ class CartridgeDPC : public Cartridge
     // System cycle count when the last update to music data fetchers occurred
     Int32 mySystemCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // DPC music OSC clocks, with the part unused during the last update
+    MusicClock myMusicClock;
 
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
@@ -31,7 +31,6 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
     myLDAimmediate(false),
     myParameterPointer(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0),
     myARMCycles(0),
     myCurrentBank(0)
 {
@@ -60,6 +59,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
        settings.getBool("thumb.trapfatal"),
        Thumbulator::ConfigureFor::DPCplus,
        this);
+  myThumbEmulator->enableTranslation(settings.getBool("thumb.translate"));
 #endif
   setInitialState();
 
@@ -73,7 +73,7 @@ void CartridgeDPCPlus::reset()
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
   myARMCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myMusicClock.reset();
 
   setInitialState();
 
@@ -157,9 +157,7 @@ inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = Int32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  Int32 wholeClocks = myMusicClock.clocks(cycles);
 
   if(wholeClocks <= 0)
     return;
@@ -198,6 +196,8 @@ inline void CartridgeDPCPlus::callFunction(uInt8 value)
         Int32 cycles = mySystem->cycles() - myARMCycles;
         myARMCycles = mySystem->cycles();
 
+        if(ThumbProfiler* profiler = myThumbEmulator->profiler())
+          profiler->startCall(mySystem->tia().frameCount(), mySystem->totalCycles());
         myThumbEmulator->run(cycles);
       }
       catch(const runtime_error& e) {
@@ -692,7 +692,7 @@ bool CartridgeDPCPlus::save(Serializer& out) const
 
     // Get system cycles and fractional clocks
     out.putInt(mySystemCycles);
-    out.putInt(uInt32(myFractionalClocks * 100000000.0));
+    myMusicClock.save(out);
 
     // Clock info for Thumbulator
     out.putInt(myARMCycles);
@@ -756,7 +756,7 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     mySystemCycles = in.getInt();
-    myFractionalClocks = double(in.getInt()) / 100000000.0;
+    myMusicClock.load(in);
 
     // Clock info for Thumbulator
     myARMCycles = in.getInt();
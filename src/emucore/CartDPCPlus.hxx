@@ -28,6 +28,7 @@ class System;
 
 #include "bspf.hxx"
 #include "Cart.hxx"
+#include "MusicClock.hxx"
 
 /**
   Cartridge class used for DPC+, derived from Pitfall II.  There are six 4K
@@ -120,6 +121,15 @@ class CartridgeDPCPlus : public Cartridge
     */
     const uInt8* getImage(int& size) const override;
 
+    /**
+      Access the internal RAM for this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    const uInt8* getRAM(uInt32& size) const override
+      { size = sizeof(myDPCRAM);  return myDPCRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -143,6 +153,13 @@ class CartridgeDPCPlus : public Cartridge
     */
     string name() const override { return "CartridgeDPC+"; }
 
+#ifdef THUMB_SUPPORT
+    /**
+      Answers the emulator for the ARM code in this cart.
+    */
+    Thumbulator* thumbulator() const override { return myThumbEmulator.get(); }
+#endif
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Get debugger widget responsible for accessing the inner workings
@@ -266,8 +283,8 @@ class CartridgeDPCPlus : public Cartridge
     // System cycle count when the last update to music data fetchers occurred
     Int32 mySystemCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // DPC music OSC clocks, with the part unused during the last update
+    MusicClock myMusicClock;
 
     // System cycle count when the last Thumbulator::run() occurred
     Int32 myARMCycles;
@@ -373,15 +373,17 @@ uInt8 CartridgeFA2::ramReadWrite()
       }
       else if(myRAM[255] == 2)  // write
       {
+        bool saved = false;
         try
         {
           serializer.putByteArray(myRAM, 256);
+          saved = serializer.flush();
         }
         catch(...)
         {
-          // Maybe add logging here that save failed?
-          cerr << name() << ": ERROR saving score table" << endl;
         }
+        if(!saved)
+          cerr << name() << ": ERROR saving score table" << endl;
         myRamAccessTimeout += 101000;  // Add 101 ms delay for write
       }
     }
@@ -413,15 +415,19 @@ void CartridgeFA2::flash(uInt8 operation)
   {
     if(operation == 0)       // erase
     {
+      bool erased = false;
       try
       {
         uInt8 buf[256];
         memset(buf, 0, 256);
         serializer.putByteArray(buf, 256);
+        erased = serializer.flush();
       }
       catch(...)
       {
       }
+      if(!erased)
+        cerr << name() << ": ERROR erasing score table" << endl;
     }
     else if(operation == 1)  // read
     {
@@ -436,15 +442,17 @@ void CartridgeFA2::flash(uInt8 operation)
     }
     else if(operation == 2)  // write
     {
+      bool saved = false;
       try
       {
         serializer.putByteArray(myRAM, 256);
+        saved = serializer.flush();
       }
       catch(...)
       {
-        // Maybe add logging here that save failed?
-        cerr << name() << ": ERROR saving score table" << endl;
       }
+      if(!saved)
+        cerr << name() << ": ERROR saving score table" << endl;
     }
   }
 }
@@ -79,7 +79,10 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
     myFramerate(0.0),     // Unknown framerate @ start
     myCurrentFormat(0),   // Unknown format @ start
     myUserPaletteDefined(false),
-    myConsoleTiming(ConsoleTiming::ntsc)
+    myConsoleTiming(ConsoleTiming::ntsc),
+    myUserNTSCPalette(),
+    myUserPALPalette(),
+    myUserSECAMPalette()
 {
   // Load user-defined palette for this ROM
   loadUserPalette();
@@ -322,6 +325,7 @@ void Console::toggleFormat(int direction)
 
   // Let the other devices know about the console change
   mySystem->consoleChanged(myConsoleTiming);
+  myOSystem.sound().setSampleRate(audioSampleRate());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -394,10 +398,10 @@ void Console::setPalette(const string& type)
 {
   // Look at all the palettes, since we don't know which one is
   // currently active
-  static uInt32* palettes[3][3] = {
-    { &ourNTSCPalette[0],     &ourPALPalette[0],     &ourSECAMPalette[0]     },
-    { &ourNTSCPaletteZ26[0],  &ourPALPaletteZ26[0],  &ourSECAMPaletteZ26[0]  },
-    { &ourUserNTSCPalette[0], &ourUserPALPalette[0], &ourUserSECAMPalette[0] }
+  const uInt32* palettes[3][3] = {
+    { &ourNTSCPalette[0],    &ourPALPalette[0],    &ourSECAMPalette[0]    },
+    { &ourNTSCPaletteZ26[0], &ourPALPaletteZ26[0], &ourSECAMPaletteZ26[0] },
+    { &myUserNTSCPalette[0], &myUserPALPalette[0], &myUserSECAMPalette[0] }
   };
 
   // See which format we should be using
@@ -491,13 +495,42 @@ void Console::initializeAudio()
 
   myOSystem.sound().close();
   myOSystem.sound().setChannels(sound == "STEREO" ? 2 : 1);
-  myOSystem.sound().setFrameRate(myFramerate);
+  myOSystem.sound().setSampleRate(audioSampleRate());
   myOSystem.sound().open();
 
   // Make sure auto-frame calculation is only enabled when necessary
   myTIA->enableAutoFrame(framerate <= 0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::initializePaddles()
+{
+  // The range is given after the mouse axis mode
+  istringstream m_axis(myProperties.get(Controller_MouseAxis));
+  string m_mode;
+  int m_range = 100;
+  if(!(m_axis >> m_mode >> m_range))
+    m_range = 100;
+
+  for(Controller* control: { myLeftControl.get(), myRightControl.get() })
+  {
+    if(control->type() != Controller::Paddles)
+      continue;
+
+    Paddles& paddles = static_cast<Paddles&>(*control);
+    paddles.setDigitalSensitivity(myOSystem.settings().getInt("dsense"));
+    paddles.setMouseSensitivity(myOSystem.settings().getInt("msense"));
+    paddles.setPaddleRange(m_range);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Console::audioSampleRate() const
+{
+  // The same scanline rates as the TIA uses for the frame rate
+  return 2 * (myConsoleTiming == ConsoleTiming::ntsc ? 15720.0 : 15600.0);
+}
+
 /* Original frying research and code by Fred Quimby.
    I've tried the following variations on this code:
    - Both OR and Exclusive OR instead of AND. This generally crashes the game
@@ -799,6 +832,8 @@ void Console::setControllers(const string& rommd5)
     myLeftControl  = std::move(rightC);
     myRightControl = std::move(leftC);
   }
+
+  initializePaddles();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -828,13 +863,13 @@ void Console::loadUserPalette()
   {
     in.read(reinterpret_cast<char*>(pixbuf), 3);
     uInt32 pixel = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
-    ourUserNTSCPalette[(i<<1)] = pixel;
+    myUserNTSCPalette[(i<<1)] = pixel;
   }
   for(int i = 0; i < 128; i++)  // PAL palette
   {
     in.read(reinterpret_cast<char*>(pixbuf), 3);
     uInt32 pixel = (int(pixbuf[0]) << 16) + (int(pixbuf[1]) << 8) + int(pixbuf[2]);
-    ourUserPALPalette[(i<<1)] = pixel;
+    myUserPALPalette[(i<<1)] = pixel;
   }
 
   uInt32 secam[16];  // All 8 24-bit pixels, plus 8 colorloss pixels
@@ -845,7 +880,7 @@ void Console::loadUserPalette()
     secam[(i<<1)]   = pixel;
     secam[(i<<1)+1] = 0;
   }
-  uInt32* ptr = ourUserSECAMPalette;
+  uInt32* ptr = myUserSECAMPalette;
   for(int i = 0; i < 16; ++i)
   {
     uInt32* s = secam;
@@ -859,36 +894,40 @@ void Console::loadUserPalette()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::generateColorLossPalette()
 {
-  // Look at all the palettes, since we don't know which one is
-  // currently active
-  uInt32* palette[9] = {
-    &ourNTSCPalette[0],    &ourPALPalette[0],    &ourSECAMPalette[0],
-    &ourNTSCPaletteZ26[0], &ourPALPaletteZ26[0], &ourSECAMPaletteZ26[0],
-    0, 0, 0
-  };
+  // The built-in palettes are shared by all consoles, so they only need
+  // to be processed once (initialization of a local static is thread-safe)
+  static const bool builtinDone = []() {
+    uInt32* palette[6] = {
+      &ourNTSCPalette[0],    &ourPALPalette[0],    &ourSECAMPalette[0],
+      &ourNTSCPaletteZ26[0], &ourPALPaletteZ26[0], &ourSECAMPaletteZ26[0]
+    };
+    for(int i = 0; i < 6; ++i)
+      fillColorLossPalette(palette[i]);
+    return true;
+  }();
+  (void)builtinDone;
+
   if(myUserPaletteDefined)
   {
-    palette[6] = &ourUserNTSCPalette[0];
-    palette[7] = &ourUserPALPalette[0];
-    palette[8] = &ourUserSECAMPalette[0];
+    fillColorLossPalette(&myUserNTSCPalette[0]);
+    fillColorLossPalette(&myUserPALPalette[0]);
+    fillColorLossPalette(&myUserSECAMPalette[0]);
   }
+}
 
-  for(int i = 0; i < 9; ++i)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::fillColorLossPalette(uInt32* palette)
+{
+  // Fill the odd numbered palette entries with gray values (calculated
+  // using the standard RGB -> grayscale conversion formula)
+  for(int j = 0; j < 128; ++j)
   {
-    if(palette[i] == 0)
-      continue;
-
-    // Fill the odd numbered palette entries with gray values (calculated
-    // using the standard RGB -> grayscale conversion formula)
-    for(int j = 0; j < 128; ++j)
-    {
-      uInt32 pixel = palette[i][(j<<1)];
-      uInt8 r = (pixel >> 16) & 0xff;
-      uInt8 g = (pixel >> 8)  & 0xff;
-      uInt8 b = (pixel >> 0)  & 0xff;
-      uInt8 sum = uInt8((r * 0.2989) + (g * 0.5870) + (b * 0.1140));
-      palette[i][(j<<1)+1] = (sum << 16) + (sum << 8) + sum;
-    }
+    uInt32 pixel = palette[(j<<1)];
+    uInt8 r = (pixel >> 16) & 0xff;
+    uInt8 g = (pixel >> 8)  & 0xff;
+    uInt8 b = (pixel >> 0)  & 0xff;
+    uInt8 sum = uInt8((r * 0.2989) + (g * 0.5870) + (b * 0.1140));
+    palette[(j<<1)+1] = (sum << 16) + (sum << 8) + sum;
   }
 }
 
@@ -897,7 +936,6 @@ void Console::setFramerate(float framerate)
 {
   myFramerate = framerate;
   myOSystem.setFramerate(framerate);
-  myOSystem.sound().setFrameRate(framerate);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1181,12 +1219,3 @@ uInt32 Console::ourSECAMPaletteZ26[256] = {
   0x000000, 0, 0x2121ff, 0, 0xf03c79, 0, 0xff3cff, 0,
   0x7fff00, 0, 0x7fffff, 0, 0xffff3f, 0, 0xffffff, 0
 };
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Console::ourUserNTSCPalette[256]  = { 0 }; // filled from external file
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Console::ourUserPALPalette[256]   = { 0 }; // filled from external file
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Console::ourUserSECAMPalette[256] = { 0 }; // filled from external file
@@ -175,6 +175,13 @@ class Console : public Serializable
     */
     ConsoleTiming timing() const { return myConsoleTiming; }
 
+    /**
+      The rate the TIA generates sound samples at, which is twice the
+      scanline rate for the console's timing: 31440Hz for NTSC, and 31200Hz
+      for PAL and SECAM.
+    */
+    double audioSampleRate() const;
+
     /**
       Set up the console to use the debugger.
     */
@@ -233,6 +240,13 @@ class Console : public Serializable
     */
     void initializeAudio();
 
+    /**
+      Set the speed of any paddles (for digital and mouse movement) from
+      the settings, and the range of their movement from the properties.
+      This is required any time those settings change.
+    */
+    void initializePaddles();
+
     /**
       "Fry" the Atari (mangle memory/TIA contents)
     */
@@ -321,6 +335,12 @@ class Console : public Serializable
     */
     void generateColorLossPalette();
 
+    /**
+      Fills the odd-numbered entries of the given palette with gray values,
+      used for the PAL color-loss effect.
+    */
+    static void fillColorLossPalette(uInt32* palette);
+
     /**
       Returns a pointer to the palette data for the palette currently defined
       by the ROM properties.
@@ -384,6 +404,12 @@ class Console : public Serializable
     // Contains timing information for this console
     ConsoleTiming myConsoleTiming;
 
+    // Table of RGB values for NTSC, PAL and SECAM - user-defined
+    // (these are per-console, since they're loaded along with the ROM)
+    uInt32 myUserNTSCPalette[256];
+    uInt32 myUserPALPalette[256];
+    uInt32 myUserSECAMPalette[256];
+
     // Table of RGB values for NTSC, PAL and SECAM
     static uInt32 ourNTSCPalette[256];
     static uInt32 ourPALPalette[256];
@@ -394,11 +420,6 @@ class Console : public Serializable
     static uInt32 ourPALPaletteZ26[256];
     static uInt32 ourSECAMPaletteZ26[256];
 
-    // Table of RGB values for NTSC, PAL and SECAM - user-defined
-    static uInt32 ourUserNTSCPalette[256];
-    static uInt32 ourUserPALPalette[256];
-    static uInt32 ourUserSECAMPalette[256];
-
   private:
     // Following constructors and assignment operators not supported
     Console() = delete;
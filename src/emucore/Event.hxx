@@ -70,7 +70,7 @@ class Event
       MouseAxisXValue, MouseAxisYValue,
       MouseButtonLeftValue, MouseButtonRightValue,
 
-      ChangeState, LoadState, SaveState, TakeSnapshot, Quit,
+      ChangeState, LoadState, SaveState, TakeSnapshot, Rewind, Quit,
       PauseMode, MenuMode, CmdMenuMode, DebuggerMode, LauncherMode,
       Fry, VolumeDecrease, VolumeIncrease,
 
@@ -30,8 +30,6 @@
 #include "Launcher.hxx"
 #include "Menu.hxx"
 #include "OSystem.hxx"
-#include "Joystick.hxx"
-#include "Paddles.hxx"
 #include "PropsSet.hxx"
 #include "ListWidget.hxx"
 #include "ScrollBarWidget.hxx"
@@ -59,6 +57,7 @@ EventHandler::EventHandler(OSystem& osystem)
     myOverlay(nullptr),
     myState(S_NONE),
     myAllowAllDirectionsFlag(false),
+    myJoyDeadZone(3200),
     myFryingFlag(false),
     myUseCtrlKeyFlag(true),
     mySkipMouseMotion(true),
@@ -91,9 +90,7 @@ void EventHandler::initialize()
 
   myUseCtrlKeyFlag = myOSystem.settings().getBool("ctrlcombo");
 
-  Joystick::setDeadZone(myOSystem.settings().getInt("joydeadzone"));
-  Paddles::setDigitalSensitivity(myOSystem.settings().getInt("dsense"));
-  Paddles::setMouseSensitivity(myOSystem.settings().getInt("msense"));
+  setJoyDeadZone(myOSystem.settings().getInt("joydeadzone"));
 
   // Set quick select delay when typing characters in listwidgets
   ListWidget::setQuickSelectDelay(myOSystem.settings().getInt("listdelay"));
@@ -116,7 +113,9 @@ void EventHandler::reset(State state)
   // Reset events almost immediately after starting emulation mode
   // We wait a little while, since 'hold' events may be present, and we want
   // time for the ROM to process them
-  if(state == S_EMULATE)
+  // In headless mode the timer would fire at an arbitrary point in the
+  // emulation, so the caller releases them with clearEvents() instead
+  if(state == S_EMULATE && !myOSystem.settings().getBool("headless"))
     SDL_AddTimer(500, resetEventsCallback, static_cast<void*>(this));
 }
 
@@ -194,18 +193,16 @@ void EventHandler::poll(uInt64 time)
   // related to emulation
   if(myState == S_EMULATE)
   {
+    // First check if the StateManager should be saving or loading state,
+    // since a movie records or sets the input the controllers read
+    if(myOSystem.state().isActive())
+      myOSystem.state().update(myEvent);
+
     myOSystem.console().riot().update();
 
-#if 0
-    // Now check if the StateManager should be saving or loading state
-    // Per-frame cheats are disabled if the StateManager is active, since
-    // it would interfere with proper playback
-    if(myOSystem.state().isActive())
-    {
-      myOSystem.state().update();
-    }
-    else
-#endif
+    // Per-frame cheats are disabled if the StateManager is playing back,
+    // since they would interfere with proper playback
+    if(!myOSystem.state().isPlayingBack())
     {
     #ifdef CHEATCODE_SUPPORT
       for(auto& cheat: myOSystem.cheat().perFrame())
@@ -696,9 +693,9 @@ void EventHandler::handleJoyAxisEvent(int stick, int axis, int value)
           default:
           {
             // Otherwise, we know the event is digital
-            if(value > Joystick::deadzone())
+            if(value > myJoyDeadZone)
               handleEvent(eventAxisPos, 1);
-            else if(value < -Joystick::deadzone())
+            else if(value < -myJoyDeadZone)
               handleEvent(eventAxisNeg, 1);
             else
             {
@@ -724,9 +721,9 @@ void EventHandler::handleJoyAxisEvent(int stick, int axis, int value)
       {
         // First, clamp the values to simulate digital input
         // (the only thing that the underlying code understands)
-        if(value > Joystick::deadzone())
+        if(value > myJoyDeadZone)
           value = 32000;
-        else if(value < -Joystick::deadzone())
+        else if(value < -myJoyDeadZone)
           value = -32000;
         else
           value = 0;
@@ -902,6 +899,10 @@ void EventHandler::handleEvent(Event::Type event, int state)
       if(state) takeSnapshot();
       return;
 
+    case Event::Rewind:
+      myOSystem.state().rewind(bool(state));
+      return;
+
     case Event::LauncherMode:
       if((myState == S_EMULATE || myState == S_CMDMENU ||
           myState == S_DEBUGGER) && state)
@@ -1538,6 +1539,7 @@ void EventHandler::setDefaultKeymap(Event::Type event, EventMode mode)
       setDefaultKey( KBDK_F10,       Event::ChangeState       );
       setDefaultKey( KBDK_F11,       Event::LoadState         );
       setDefaultKey( KBDK_F12,       Event::TakeSnapshot      );
+      setDefaultKey( KBDK_R,         Event::Rewind            );
       setDefaultKey( KBDK_BACKSPACE, Event::Fry               );
       setDefaultKey( KBDK_PAUSE,     Event::PauseMode         );
       setDefaultKey( KBDK_TAB,       Event::MenuMode          );
@@ -1913,6 +1915,14 @@ void EventHandler::setMouseControllerMode(const string& enable)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandler::setJoyDeadZone(int deadzone)
+{
+  deadzone = BSPF::clamp(deadzone, 0, 29);
+
+  myJoyDeadZone = 3200 + deadzone * 1000;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandler::setContinuousSnapshots(uInt32 interval)
 {
@@ -2079,6 +2089,7 @@ EventHandler::ActionList EventHandler::ourEmulActionList[kEmulActionListSize] =
   { Event::ChangeState,            "Change State",             "", false },
   { Event::LoadState,              "Load State",               "", false },
   { Event::TakeSnapshot,           "Snapshot",                 "", false },
+  { Event::Rewind,                 "Rewind (hold)",            "", false },
   { Event::Fry,                    "Fry cartridge",            "", false },
   { Event::VolumeDecrease,         "Decrease volume",          "", false },
   { Event::VolumeIncrease,         "Increase volume",          "", false },
@@ -101,6 +101,13 @@ class EventHandler
       @return The event object
     */
     const Event& event() const { return myEvent; }
+    Event& event() { return myEvent; }
+
+    /**
+      Release all currently active events (including any 'hold' events
+      set on the commandline).
+    */
+    void clearEvents() { myEvent.clear(); }
 
     /**
       Initialize state of this eventhandler.
@@ -314,6 +321,16 @@ class EventHandler
     */
     void allowAllDirections(bool allow) { myAllowAllDirectionsFlag = allow; }
 
+    /**
+      Sets the deadzone amount for real analog joysticks, within which
+      their axes are treated as centred.
+
+      @param deadzone  Value from 0 to 29, with larger values giving a
+                       larger deadzone
+    */
+    void setJoyDeadZone(int deadzone);
+    int joyDeadZone() const { return myJoyDeadZone; }
+
     /**
       Determines whether the given controller must use the mouse (aka,
       whether the controller generates analog output).
@@ -501,7 +518,7 @@ class EventHandler
     enum {
       kComboSize          = 16,
       kEventsPerCombo     = 8,
-      kEmulActionListSize = 78 + kComboSize,
+      kEmulActionListSize = 79 + kComboSize,
       kMenuActionListSize = 14
     };
 
@@ -569,6 +586,9 @@ class EventHandler
     // Indicates whether the joystick emulates 'impossible' directions
     bool myAllowAllDirectionsFlag;
 
+    // The value of an analog joystick axis beyond which it's moved
+    int myJoyDeadZone;
+
     // Indicates whether or not we're in frying mode
     bool myFryingFlag;
 
@@ -33,6 +33,7 @@
 #include "Menu.hxx"
 #include "OSystem.hxx"
 #include "Settings.hxx"
+#include "Sound.hxx"
 #include "TIA.hxx"
 
 #include "FBSurface.hxx"
@@ -219,8 +220,8 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
 
   // Create surfaces for TIA statistics and general messages
   myStatsMsg.color = kBtnTextColor;
-  myStatsMsg.w = infoFont().getMaxCharWidth() * 24 + 2;
-  myStatsMsg.h = (infoFont().getFontHeight() + 2) * 2;
+  myStatsMsg.w = infoFont().getMaxCharWidth() * kStatsLineChars + 2;
+  myStatsMsg.h = (infoFont().getFontHeight() + 2) * 4;
 
   if(!myStatsMsg.surface)
     myStatsMsg.surface = allocateSurface(myStatsMsg.w, myStatsMsg.h);
@@ -265,6 +266,10 @@ void FrameBuffer::update()
       if(myOSystem.eventHandler().frying())
         myOSystem.console().fry();
 
+      // Nothing has changed on the screen if the frame wasn't drawn
+      if(myOSystem.console().tia().frameSkipped())
+        return;
+
       // And update the screen
       myTIASurface->render();
 
@@ -272,8 +277,8 @@ void FrameBuffer::update()
       if(myStatsMsg.enabled)
       {
         const ConsoleInfo& info = myOSystem.console().about();
-        char msg[30];
-        std::snprintf(msg, 30, "%3u @ %3.2ffps => %s",
+        char msg[kStatsLineChars + 1];
+        std::snprintf(msg, sizeof(msg), "%3u @ %3.2ffps => %s",
                 myOSystem.console().tia().scanlinesLastFrame(),
                 myOSystem.console().getFramerate(), info.DisplayFormat.c_str());
         myStatsMsg.surface->fillRect(0, 0, myStatsMsg.w, myStatsMsg.h, kBGColor);
@@ -281,6 +286,24 @@ void FrameBuffer::update()
           msg, 1, 1, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
         myStatsMsg.surface->drawString(infoFont(),
           info.BankSwitch, 1, 15, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
+
+        uInt32 fill, underruns;
+        myOSystem.sound().queueStats(fill, underruns);
+        // At most 'Snd 999% U:4294967295', so this always fits on the line
+        std::snprintf(msg, sizeof(msg), "Snd %3u%% U:%u",
+                      std::min(fill, 999u), underruns);
+        myStatsMsg.surface->drawString(infoFont(),
+          msg, 1, 29, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
+
+        // The frames reused from the one before; at most
+        // 'Cache 100% of 4294967295'
+        uInt32 reused, frames;
+        myOSystem.console().tia().frameCacheStats(reused, frames);
+        std::snprintf(msg, sizeof(msg), "Cache %3u%% of %u",
+                      frames > 0 ? uInt32(uInt64(reused) * 100 / frames) : 0,
+                      frames);
+        myStatsMsg.surface->drawString(infoFont(),
+          msg, 1, 43, myStatsMsg.w, myStatsMsg.color, kTextAlignLeft);
         myStatsMsg.surface->setDirty();
         myStatsMsg.surface->setDstPos(myImageRect.x() + 1, myImageRect.y() + 1);
         myStatsMsg.surface->render();
@@ -526,6 +526,9 @@ class FrameBuffer
     Message myMsg;
     Message myStatsMsg;
 
+    // The width of each line of frame statistics, in characters
+    static constexpr uInt32 kStatsLineChars = 24;
+
     // The list of all available video modes for this framebuffer
     VideoModeList* myCurrentModeList;
     VideoModeList myWindowedModeList;
@@ -0,0 +1,258 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Serializer.hxx"
+#include "InputMovie.hxx"
+
+// The order of these is part of the movie format, so new events must be
+// added at the end
+const Event::Type InputMovie::ourInputs[] = {
+  Event::ConsoleColor, Event::ConsoleBlackWhite,
+  Event::ConsoleLeftDiffA, Event::ConsoleLeftDiffB,
+  Event::ConsoleRightDiffA, Event::ConsoleRightDiffB,
+  Event::ConsoleSelect, Event::ConsoleReset,
+
+  Event::JoystickZeroUp, Event::JoystickZeroDown, Event::JoystickZeroLeft,
+  Event::JoystickZeroRight, Event::JoystickZeroFire, Event::JoystickZeroFire5,
+  Event::JoystickZeroFire9,
+  Event::JoystickOneUp, Event::JoystickOneDown, Event::JoystickOneLeft,
+  Event::JoystickOneRight, Event::JoystickOneFire, Event::JoystickOneFire5,
+  Event::JoystickOneFire9,
+
+  Event::PaddleZeroDecrease, Event::PaddleZeroIncrease, Event::PaddleZeroFire,
+  Event::PaddleOneDecrease, Event::PaddleOneIncrease, Event::PaddleOneFire,
+  Event::PaddleTwoDecrease, Event::PaddleTwoIncrease, Event::PaddleTwoFire,
+  Event::PaddleThreeDecrease, Event::PaddleThreeIncrease,
+  Event::PaddleThreeFire,
+
+  Event::KeyboardZero1, Event::KeyboardZero2, Event::KeyboardZero3,
+  Event::KeyboardZero4, Event::KeyboardZero5, Event::KeyboardZero6,
+  Event::KeyboardZero7, Event::KeyboardZero8, Event::KeyboardZero9,
+  Event::KeyboardZeroStar, Event::KeyboardZero0, Event::KeyboardZeroPound,
+  Event::KeyboardOne1, Event::KeyboardOne2, Event::KeyboardOne3,
+  Event::KeyboardOne4, Event::KeyboardOne5, Event::KeyboardOne6,
+  Event::KeyboardOne7, Event::KeyboardOne8, Event::KeyboardOne9,
+  Event::KeyboardOneStar, Event::KeyboardOne0, Event::KeyboardOnePound,
+
+  Event::SALeftAxis0Value, Event::SALeftAxis1Value,
+  Event::SARightAxis0Value, Event::SARightAxis1Value,
+
+  Event::MouseAxisXValue, Event::MouseAxisYValue,
+  Event::MouseButtonLeftValue, Event::MouseButtonRightValue
+};
+const uInt32 InputMovie::ourNumInputs =
+    sizeof(InputMovie::ourInputs) / sizeof(InputMovie::ourInputs[0]);
+
+namespace {
+  // Counts and values are stored 7 bits per byte, lowest first, with the
+  // top bit set on all but the last byte; values are 'zigzag' encoded
+  // first, so small negative values (ie, from the mouse) are short too
+  void putCount(vector<uInt8>& out, uInt32 count)
+  {
+    while(count >= 0x80)
+    {
+      out.push_back(uInt8(count | 0x80));
+      count >>= 7;
+    }
+    out.push_back(uInt8(count));
+  }
+
+  inline uInt32 zigzag(Int32 value)
+  {
+    return (uInt32(value) << 1) ^ uInt32(value >> 31);
+  }
+
+  inline Int32 unzigzag(uInt32 value)
+  {
+    return Int32(value >> 1) ^ -Int32(value & 1);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+InputMovie::InputMovie()
+  : myFrames(0),
+    myValues(ourNumInputs, 0),
+    myUnchanged(0),
+    myPlayPos(0),
+    myPlayRepeat(0),
+    myPlayed(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::clear()
+{
+  myData.clear();
+  myFrames = myUnchanged = 0;
+  std::fill(myValues.begin(), myValues.end(), 0);
+  myPlayPos = myPlayRepeat = myPlayed = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::record(const Event& event)
+{
+  ++myFrames;
+
+  uInt32 changes = 0;
+  for(uInt32 i = 0; i < ourNumInputs; ++i)
+    if(event.get(ourInputs[i]) != myValues[i])
+      ++changes;
+
+  if(changes == 0)
+  {
+    ++myUnchanged;
+    return;
+  }
+
+  putCount(myData, myUnchanged);
+  putCount(myData, changes);
+  for(uInt32 i = 0; i < ourNumInputs; ++i)
+  {
+    const Int32 value = event.get(ourInputs[i]);
+    if(value != myValues[i])
+    {
+      putCount(myData, i);
+      putCount(myData, zigzag(value));
+      myValues[i] = value;
+    }
+  }
+  myUnchanged = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::restart()
+{
+  std::fill(myValues.begin(), myValues.end(), 0);
+  myPlayPos = myPlayed = 0;
+
+  // The frames after the last change don't change anything either
+  myPlayRepeat = nextCount(~0u);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::play(Event& event)
+{
+  if(!advance())
+    return false;
+
+  for(uInt32 i = 0; i < ourNumInputs; ++i)
+    event.set(ourInputs[i], myValues[i]);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::seek(uInt32 frame)
+{
+  if(frame > myFrames)
+    return false;
+
+  if(frame < myPlayed)
+    restart();
+  while(myPlayed < frame)
+    if(!advance())
+      return false;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::advance()
+{
+  if(myPlayed >= myFrames)
+    return false;
+
+  if(myPlayRepeat > 0)
+    --myPlayRepeat;
+  else
+  {
+    for(uInt32 changes = nextCount(0); changes > 0; --changes)
+    {
+      const uInt32 input = nextCount(ourNumInputs);
+      if(input >= ourNumInputs)  // the movie is corrupt
+      {
+        myPlayed = myFrames;
+        return false;
+      }
+      myValues[input] = unzigzag(nextCount(0));
+    }
+    myPlayRepeat = nextCount(~0u);
+  }
+  ++myPlayed;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 InputMovie::nextCount(uInt32 end)
+{
+  uInt32 count = 0;
+  for(uInt32 shift = 0; myPlayPos < myData.size() && shift < 32; shift += 7)
+  {
+    const uInt8 byte = myData[myPlayPos++];
+    count |= uInt32(byte & 0x7F) << shift;
+    if(!(byte & 0x80))
+      return count;
+  }
+
+  myPlayPos = uInt32(myData.size());
+  return end;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::save(Serializer& out) const
+{
+  try
+  {
+    out.putInt(ourNumInputs);
+    out.putInt(myFrames);
+    out.putString(string(myData.begin(), myData.end()));
+  }
+  catch(...)
+  {
+    cerr << "ERROR: InputMovie::save" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::load(Serializer& in)
+{
+  clear();
+
+  try
+  {
+    if(in.getInt() != ourNumInputs)
+      return false;
+
+    const uInt32 frames = in.getInt();
+    const string& data = in.getString();
+    myData.assign(data.begin(), data.end());
+    myFrames = frames;
+  }
+  catch(...)
+  {
+    cerr << "ERROR: InputMovie::load" << endl;
+    clear();
+    return false;
+  }
+
+  restart();
+  return true;
+}
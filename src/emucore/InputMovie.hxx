@@ -0,0 +1,144 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef INPUT_MOVIE_HXX
+#define INPUT_MOVIE_HXX
+
+class Serializer;
+
+#include "bspf.hxx"
+#include "Event.hxx"
+
+/**
+  This class holds the input to the console for each frame of a movie:
+  the values of all the events read by the controllers and the console
+  switches.  Played back from the same starting state, it runs the
+  emulation exactly as it was recorded.
+
+  Only the inputs that change from one frame to the next are kept, as a
+  pair of (input, new value), and a run of frames where nothing changes
+  is kept as a single count.  Most frames don't change any input at all,
+  so a movie takes a few bytes per frame at most.
+*/
+class InputMovie
+{
+  public:
+    /**
+      Create an empty movie
+    */
+    InputMovie();
+
+  public:
+    /**
+      Drop all the frames, so recording starts again from the beginning.
+    */
+    void clear();
+
+    /**
+      Add a frame, with the input in the given events.
+    */
+    void record(const Event& event);
+
+    /**
+      Start playing the movie from its first frame.
+    */
+    void restart();
+
+    /**
+      Set the given events to the input of the next frame.
+
+      @return  False if there are no frames left to play, else true
+    */
+    bool play(Event& event);
+
+    /**
+      Skip to the given frame, so it's the next one played.  Only the input
+      is decoded, so this takes a fraction of the time playing the frames
+      would.
+
+      @return  False if the movie doesn't have that many frames, else true
+    */
+    bool seek(uInt32 frame);
+
+    /**
+      Answers the number of frames in the movie.
+    */
+    uInt32 frames() const { return myFrames; }
+
+    /**
+      Answers the number of frames played since the movie was restarted.
+    */
+    uInt32 played() const { return myPlayed; }
+
+    /**
+      Answers the size of the (encoded) frames, in bytes.
+    */
+    uInt32 size() const { return uInt32(myData.size()); }
+
+    /**
+      Save the frames to the given Serializer.
+
+      @return  False on any errors, else true
+    */
+    bool save(Serializer& out) const;
+
+    /**
+      Load the frames from the given Serializer, and restart the movie.
+
+      @return  False on any errors, else true
+    */
+    bool load(Serializer& in);
+
+  private:
+    // Decode the input of the next frame into myValues, answering false
+    // if there are no frames left
+    bool advance();
+
+    // Decode the next count, or the given value if there's no more data
+    uInt32 nextCount(uInt32 end);
+
+  private:
+    // The events kept for each frame
+    static const Event::Type ourInputs[];
+    static const uInt32 ourNumInputs;
+
+    // The encoded frames: for each frame with a change, the number of
+    // frames without one before it, then the number of inputs that
+    // changed, and an (input, value) pair for each
+    vector<uInt8> myData;
+    uInt32 myFrames;
+
+    // The input of the last frame recorded or played, and the number of
+    // frames without a change since the last one recorded
+    vector<Int32> myValues;
+    uInt32 myUnchanged;
+
+    // The position of the next frame to play, the number of frames to play
+    // before it, and the number of frames played
+    uInt32 myPlayPos;
+    uInt32 myPlayRepeat;
+    uInt32 myPlayed;
+
+  private:
+    // Following constructors and assignment operators not supported
+    InputMovie(const InputMovie&) = delete;
+    InputMovie(InputMovie&&) = delete;
+    InputMovie& operator=(const InputMovie&) = delete;
+    InputMovie& operator=(InputMovie&&) = delete;
+};
+
+#endif
@@ -130,14 +130,3 @@ bool Joystick::setMouseControl(
 
   return true;
 }
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Joystick::setDeadZone(int deadzone)
-{
-  deadzone = BSPF::clamp(deadzone, 0, 29);
-
-  _DEAD_ZONE = 3200 + deadzone * 1000;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Joystick::_DEAD_ZONE = 3200;
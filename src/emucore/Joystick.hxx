@@ -66,14 +66,6 @@ class Joystick : public Controller
     bool setMouseControl(
       Controller::Type xtype, int xid, Controller::Type ytype, int yid) override;
 
-    /**
-      Sets the deadzone amount for real analog joysticks.
-      Technically, this isn't really used by the Joystick class at all,
-      but it seemed like the best place to put it.
-    */
-    static void setDeadZone(int deadzone);
-    inline static int deadzone() { return _DEAD_ZONE; }
-
   private:
     // Pre-compute the events we care about based on given port
     // This will eliminate test for left or right port in update()
@@ -83,8 +75,6 @@ class Joystick : public Controller
     // Controller to emulate in normal mouse axis mode
     int myControlID;
 
-    static int _DEAD_ZONE;
-
   private:
     // Following constructors and assignment operators not supported
     Joystick() = delete;
@@ -38,10 +38,40 @@
   #define DISASM_NONE  0
 #endif
 #include "Settings.hxx"
+#include "Profiler.hxx"
 #include "Vec.hxx"
 
 #include "M6502.hxx"
 
+// Use threaded dispatch where the compiler supports taking the address of
+// a label; each instruction then ends with its own indirect jump to the
+// next one, which branch predictors handle much better than the single
+// jump of a switch statement
+#if defined(__GNUC__) && !defined(M6502_SWITCH_DISPATCH)
+  #define M6502_THREADED_DISPATCH
+#endif
+
+#ifdef M6502_THREADED_DISPATCH
+  #define M6502_OPCODE(_op) op##_op:
+
+  // Unless execution has to stop (or the debugger has something to check),
+  // fetch the next instruction and jump straight to its code
+  #define M6502_NEXT \
+    if(!debugging && number > 1 && !myExecutionStatus) \
+    { \
+      --number; \
+      operandAddress = intermediateAddress = 0; \
+      operand = 0; \
+      myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0; \
+      IR = peek<debugging>(PC++, DISASM_CODE); \
+      goto *ourOpcodes[IR]; \
+    } \
+    goto nextInstruction;
+#else
+  #define M6502_OPCODE(_op) case _op:
+  #define M6502_NEXT break;
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::M6502(const Settings& settings)
   : myExecutionStatus(0),
@@ -105,6 +135,7 @@ void M6502::reset()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
 inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 {
   ////////////////////////////////////////////////
@@ -118,7 +149,7 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
   mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
 
 #ifdef DEBUGGER_SUPPORT
-  if(myReadTraps.isInitialized() && myReadTraps.isSet(address))
+  if(debugging && myReadTraps.isInitialized() && myReadTraps.isSet(address))
   {
     myJustHitTrapFlag = true;
     myHitTrapInfo.message = "RTrap: ";
@@ -133,6 +164,7 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
 inline void M6502::poke(uInt16 address, uInt8 value)
 {
   ////////////////////////////////////////////////
@@ -146,7 +178,7 @@ inline void M6502::poke(uInt16 address, uInt8 value)
   mySystem->incrementCycles(SYSTEM_CYCLES_PER_CPU);
 
 #ifdef DEBUGGER_SUPPORT
-  if(myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
+  if(debugging && myWriteTraps.isInitialized() && myWriteTraps.isSet(address))
   {
     myJustHitTrapFlag = true;
     myHitTrapInfo.message = "WTrap: ";
@@ -162,6 +194,37 @@ inline void M6502::poke(uInt16 address, uInt8 value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::execute(uInt32 number)
 {
+  Profiler::Scope profile(Profiler::kCPU);
+
+#ifdef DEBUGGER_SUPPORT
+  // Any expressions evaluated while running must see our own debugger
+  if(myDebugger)
+    myDebugger->makeCurrent();
+
+  // Only pay for the debugger checks when there is something to check;
+  // breakpoints, traps and conditions can only be changed from within
+  // the debugger, so they can't appear partway through this call
+  if(myJustHitTrapFlag || myBreakPoints.any() || myReadTraps.any() ||
+     myWriteTraps.any() || !myBreakConds.empty())
+    return _execute<true>(number);
+#endif
+
+  return _execute<false>(number);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debugging>
+bool M6502::_execute(uInt32 number)
+{
+#ifdef M6502_THREADED_DISPATCH
+  // The code for each opcode, as generated by the M4 macro file
+  static const void* const ourOpcodes[256] = {
+    #define M6502_OPCODE_TABLE
+    #include "M6502.ins"
+    #undef M6502_OPCODE_TABLE
+  };
+#endif
+
   // Clear all of the execution status bits except for the fatal error bit
   myExecutionStatus &= FatalErrorBit;
 
@@ -171,25 +234,28 @@ bool M6502::execute(uInt32 number)
     for(; !myExecutionStatus && (number != 0); --number)
     {
 #ifdef DEBUGGER_SUPPORT
-      if(myJustHitTrapFlag)
+      if(debugging)
       {
-        if(myDebugger && myDebugger->start(myHitTrapInfo.message, myHitTrapInfo.address))
+        if(myJustHitTrapFlag)
         {
-          myJustHitTrapFlag = false;
-          return true;
+          if(myDebugger && myDebugger->start(myHitTrapInfo.message, myHitTrapInfo.address))
+          {
+            myJustHitTrapFlag = false;
+            return true;
+          }
         }
-      }
 
-      if(myBreakPoints.isInitialized() && myBreakPoints.isSet(PC))
-        if(myDebugger && myDebugger->start("BP: ", PC))
-          return true;
+        if(myBreakPoints.isInitialized() && myBreakPoints.isSet(PC))
+          if(myDebugger && myDebugger->start("BP: ", PC))
+            return true;
 
-      int cond = evalCondBreaks();
-      if(cond > -1)
-      {
-        string buf = "CBP: " + myBreakCondNames[cond];
-        if(myDebugger && myDebugger->start(buf))
-          return true;
+        int cond = evalCondBreaks();
+        if(cond > -1)
+        {
+          string buf = "CBP: " + myBreakCondNames[cond];
+          if(myDebugger && myDebugger->start(buf))
+            return true;
+        }
       }
 #endif  // DEBUGGER_SUPPORT
 
@@ -200,9 +266,22 @@ bool M6502::execute(uInt32 number)
       myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0;
 
       // Fetch instruction at the program counter
-      IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+      IR = peek<debugging>(PC++, DISASM_CODE);  // This address represents a code section
 
       // Call code to execute the instruction
+#ifdef M6502_THREADED_DISPATCH
+      goto *ourOpcodes[IR];
+
+      // 6502 instruction emulation is generated by an M4 macro file
+      #include "M6502.ins"
+
+    opIllegal:
+      // Oops, illegal instruction executed so set fatal error flag
+      myExecutionStatus |= FatalErrorBit;
+
+    nextInstruction:
+      ;
+#else
       switch(IR)
       {
         // 6502 instruction emulation is generated by an M4 macro file
@@ -212,6 +291,7 @@ bool M6502::execute(uInt32 number)
           // Oops, illegal instruction executed so set fatal error flag
           myExecutionStatus |= FatalErrorBit;
       }
+#endif
     }
 
     // See if we need to handle an interrupt
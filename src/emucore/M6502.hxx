@@ -203,6 +203,17 @@ class M6502 : public Serializable
 #endif  // DEBUGGER_SUPPORT
 
   private:
+    /**
+      The actual instruction loop for execute().  When 'debugging' is false,
+      all checks for breakpoints, traps and conditional breaks are compiled
+      out; that version is used whenever none of them are set.
+
+      @param number Indicates the number of instructions to execute
+      @return true iff execution stops normally
+    */
+    template<bool debugging>
+    bool _execute(uInt32 number);
+
     /**
       Get the byte at the specified address and update the cycle count.
       Addresses marked as code are hints to the debugger/disassembler to
@@ -215,6 +226,7 @@ class M6502 : public Serializable
 
       @return The byte at the specified address
     */
+    template<bool debugging>
     uInt8 peek(uInt16 address, uInt8 flags);
 
     /**
@@ -224,6 +236,7 @@ class M6502 : public Serializable
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
+    template<bool debugging>
     void poke(uInt16 address, uInt8 value);
 
     /**
@@ -18,12 +18,27 @@
 /**
   Code and cases to emulate each of the 6502 instructions.
 
+  Each instruction starts with M6502_OPCODE(opcode) and ends with
+  M6502_NEXT, which M6502.cxx defines as either a case label and break
+  (switch dispatch), or a label and a jump to the next instruction
+  (threaded dispatch).  For the latter, the table of labels for all 256
+  opcodes is generated first, and is used when M6502_OPCODE_TABLE is
+  defined.
+
+  The code is included into M6502::_execute<debugging>(), and its
+  memory accesses use that function's debugging policy.
+
   Recompile with the following:
     'm4 M6502.m4 > M6502.ins'
 
   @author  Bradford W. Mott and Stephen Anthony
 */
 
+dnl The instructions are collected in diversion 2, and output after the
+dnl dispatch table (see the end of this file)
+divert(2)dnl
+#ifndef M6502_OPCODE_TABLE
+
 #ifndef NOTSAMEPAGE
   #define NOTSAMEPAGE(_addr1, _addr2) (((_addr1) ^ (_addr2)) & 0xff00)
 #endif
@@ -53,222 +68,232 @@
 #endif
 
 
+dnl Start the instruction for the given opcode, and remember that it's
+dnl been defined for the dispatch table
+define(M6502_CASE, `define(`M6502_DEFINED_$1')M6502_OPCODE($1)')
+
+dnl Output the dispatch table entries for opcodes $1 to 255, eight per line
+define(M6502_TABLE, `ifelse(eval($1 < 256), 1,
+`ifdef(`M6502_DEFINED_0x'eval($1, 16, 2),
+`&&op0x'eval($1, 16, 2), `&&opIllegal'),ifelse(eval($1 % 8), 7, `
+', ` ')M6502_TABLE(incr($1))')')
+
 define(M6502_IMPLIED, `{
-  peek(PC, DISASM_NONE);
+  peek<debugging>(PC, DISASM_NONE);
 }')
 
 define(M6502_IMMEDIATE_READ, `{
-  operand = peek(PC++, DISASM_CODE);
+  operand = peek<debugging>(PC++, DISASM_CODE);
 }')
 
 define(M6502_ABSOLUTE_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  intermediateAddress |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  intermediateAddress |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ABSOLUTE_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operandAddress |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  operandAddress |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
 }')
 
 define(M6502_ABSOLUTE_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operandAddress |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  operandAddress |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 define(M6502_ABSOLUTEX_READ, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
   intermediateAddress = high | uInt8(low + X);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   if((low + X) > 0xFF)
   {
     intermediateAddress = (high | low) + X;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_ABSOLUTEX_WRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + X), DISASM_DATA);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + X), DISASM_DATA);
   operandAddress = (high | low) + X;
 }')
 
 define(M6502_ABSOLUTEX_READMODIFYWRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + X), DISASM_DATA);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + X), DISASM_DATA);
   operandAddress = (high | low) + X;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 define(M6502_ABSOLUTEY_READ, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
   intermediateAddress = high | uInt8(low + Y);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   if((low + Y) > 0xFF)
   {
     intermediateAddress = (high | low) + Y;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_ABSOLUTEY_WRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + Y), DISASM_DATA);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
 }')
 
 define(M6502_ABSOLUTEY_READMODIFYWRITE, `{
-  uInt16 low = peek(PC++, DISASM_CODE);
-  uInt16 high = (uInt16(peek(PC++, DISASM_CODE)) << 8);
-  peek(high | uInt8(low + Y), DISASM_DATA);
+  uInt16 low = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 high = (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 define(M6502_ZERO_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZERO_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
 }')
 
 define(M6502_ZERO_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 define(M6502_ZEROX_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(intermediateAddress, DISASM_DATA);
   intermediateAddress += X;
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZEROX_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + X) & 0xFF;
 }')
 
 define(M6502_ZEROX_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + X) & 0xFF;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 define(M6502_ZEROY_READ, `{
-  intermediateAddress = peek(PC++, DISASM_CODE);
-  peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(intermediateAddress, DISASM_DATA);
   intermediateAddress += Y;
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_ZEROY_WRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + Y) & 0xFF;
 }')
 
 define(M6502_ZEROY_READMODIFYWRITE, `{
-  operandAddress = peek(PC++, DISASM_CODE);
-  peek(operandAddress, DISASM_DATA);
+  operandAddress = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(operandAddress, DISASM_DATA);
   operandAddress = (operandAddress + Y) & 0xFF;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 define(M6502_INDIRECT, `{
-  uInt16 addr = peek(PC++, DISASM_CODE);
-  addr |= (uInt16(peek(PC++, DISASM_CODE)) << 8);
+  uInt16 addr = peek<debugging>(PC++, DISASM_CODE);
+  addr |= (uInt16(peek<debugging>(PC++, DISASM_CODE)) << 8);
 
   // Simulate the error in the indirect addressing mode!
   uInt16 high = NOTSAMEPAGE(addr, addr + 1) ? (addr & 0xff00) : (addr + 1);
 
-  operandAddress = peek(addr, DISASM_DATA);
-  operandAddress |= (uInt16(peek(high, DISASM_DATA)) << 8);
+  operandAddress = peek<debugging>(addr, DISASM_DATA);
+  operandAddress |= (uInt16(peek<debugging>(high, DISASM_DATA)) << 8);
 }')
 
 define(M6502_INDIRECTX_READ, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_DATA);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(pointer, DISASM_DATA);
   pointer += X;
-  intermediateAddress = peek(pointer++, DISASM_DATA);
-  intermediateAddress |= (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  intermediateAddress = peek<debugging>(pointer++, DISASM_DATA);
+  intermediateAddress |= (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
 }')
 
 define(M6502_INDIRECTX_WRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_DATA);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(pointer, DISASM_DATA);
   pointer += X;
-  operandAddress = peek(pointer++, DISASM_DATA);
-  operandAddress |= (uInt16(peek(pointer, DISASM_DATA)) << 8);
+  operandAddress = peek<debugging>(pointer++, DISASM_DATA);
+  operandAddress |= (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
 }')
 
 define(M6502_INDIRECTX_READMODIFYWRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  peek(pointer, DISASM_DATA);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(pointer, DISASM_DATA);
   pointer += X;
-  operandAddress = peek(pointer++, DISASM_DATA);
-  operandAddress |= (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operandAddress = peek<debugging>(pointer++, DISASM_DATA);
+  operandAddress |= (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 define(M6502_INDIRECTY_READ, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = (uInt16(peek(pointer, DISASM_DATA)) << 8);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 low = peek<debugging>(pointer++, DISASM_DATA);
+  uInt16 high = (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
   intermediateAddress = high | uInt8(low + Y);
-  operand = peek(intermediateAddress, DISASM_DATA);
+  operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   if((low + Y) > 0xFF)
   {
     intermediateAddress = (high | low) + Y;
-    operand = peek(intermediateAddress, DISASM_DATA);
+    operand = peek<debugging>(intermediateAddress, DISASM_DATA);
   }
 }')
 
 define(M6502_INDIRECTY_WRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  peek(high | uInt8(low + Y), DISASM_DATA);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 low = peek<debugging>(pointer++, DISASM_DATA);
+  uInt16 high = (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
 }')
 
 define(M6502_INDIRECTY_READMODIFYWRITE, `{
-  uInt8 pointer = peek(PC++, DISASM_CODE);
-  uInt16 low = peek(pointer++, DISASM_DATA);
-  uInt16 high = (uInt16(peek(pointer, DISASM_DATA)) << 8);
-  peek(high | uInt8(low + Y), DISASM_DATA);
+  uInt8 pointer = peek<debugging>(PC++, DISASM_CODE);
+  uInt16 low = peek<debugging>(pointer++, DISASM_DATA);
+  uInt16 high = (uInt16(peek<debugging>(pointer, DISASM_DATA)) << 8);
+  peek<debugging>(high | uInt8(low + Y), DISASM_DATA);
   operandAddress = (high | low) + Y;
-  operand = peek(operandAddress, DISASM_DATA);
-  poke(operandAddress, operand);
+  operand = peek<debugging>(operandAddress, DISASM_DATA);
+  poke<debugging>(operandAddress, operand);
 }')
 
 
 define(M6502_BCC, `{
   if(!C)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -276,10 +301,10 @@ define(M6502_BCC, `{
 define(M6502_BCS, `{
   if(C)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -287,10 +312,10 @@ define(M6502_BCS, `{
 define(M6502_BEQ, `{
   if(!notZ)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -298,10 +323,10 @@ define(M6502_BEQ, `{
 define(M6502_BMI, `{
   if(N)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -309,10 +334,10 @@ define(M6502_BMI, `{
 define(M6502_BNE, `{
   if(notZ)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -320,10 +345,10 @@ define(M6502_BNE, `{
 define(M6502_BPL, `{
   if(!N)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -331,10 +356,10 @@ define(M6502_BPL, `{
 define(M6502_BVC, `{
   if(!V)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -342,10 +367,10 @@ define(M6502_BVC, `{
 define(M6502_BVS, `{
   if(V)
   {
-    peek(PC, DISASM_NONE);
+    peek<debugging>(PC, DISASM_NONE);
     uInt16 address = PC + Int8(operand);
     if(NOTSAMEPAGE(PC, address))
-      peek((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
+      peek<debugging>((PC & 0xFF00) | (address & 0x00FF), DISASM_NONE);
     PC = address;
   }
 }')
@@ -449,7 +474,7 @@ define(M6502_ASL, `{
   C = operand & 0x80;
 
   operand <<= 1;
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -484,18 +509,18 @@ define(M6502_BIT, `{
 }')
 
 define(M6502_BRK, `{
-  peek(PC++, DISASM_CODE);
+  peek<debugging>(PC++, DISASM_CODE);
 
   B = true;
 
-  poke(0x0100 + SP--, PC >> 8);
-  poke(0x0100 + SP--, PC & 0x00ff);
-  poke(0x0100 + SP--, PS());
+  poke<debugging>(0x0100 + SP--, PC >> 8);
+  poke<debugging>(0x0100 + SP--, PC & 0x00ff);
+  poke<debugging>(0x0100 + SP--, PS());
 
   I = true;
 
-  PC = peek(0xfffe, DISASM_NONE);
-  PC |= (uInt16(peek(0xffff, DISASM_NONE)) << 8);
+  PC = peek<debugging>(0xfffe, DISASM_NONE);
+  PC |= (uInt16(peek<debugging>(0xffff, DISASM_NONE)) << 8);
 }')
 
 define(M6502_CLC, `{
@@ -540,7 +565,7 @@ define(M6502_CPY, `{
 
 define(M6502_DCP, `{
   uInt8 value = operand - 1;
-  poke(operandAddress, value);
+  poke<debugging>(operandAddress, value);
 
   uInt16 value2 = uInt16(A) - uInt16(value);
   notZ = value2;
@@ -550,7 +575,7 @@ define(M6502_DCP, `{
 
 define(M6502_DEC, `{
   uInt8 value = operand - 1;
-  poke(operandAddress, value);
+  poke<debugging>(operandAddress, value);
 
   notZ = value;
   N = value & 0x80;
@@ -579,7 +604,7 @@ define(M6502_EOR, `{
 
 define(M6502_INC, `{
   uInt8 value = operand + 1;
-  poke(operandAddress, value);
+  poke<debugging>(operandAddress, value);
 
   notZ = value;
   N = value & 0x80;
@@ -599,7 +624,7 @@ define(M6502_INY, `{
 
 define(M6502_ISB, `{
   operand = operand + 1;
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   // N, V, Z, C flags are the same in either mode (C calculated at the end)
   Int32 sum = A - operand - (C ? 0 : 1);
@@ -633,16 +658,16 @@ define(M6502_JMP, `{
 }')
 
 define(M6502_JSR, `{
-  uInt8 low = peek(PC++, DISASM_CODE);
-  peek(0x0100 + SP, DISASM_NONE);
+  uInt8 low = peek<debugging>(PC++, DISASM_CODE);
+  peek<debugging>(0x0100 + SP, DISASM_NONE);
 
   // It seems that the 650x does not push the address of the next instruction
   // on the stack it actually pushes the address of the next instruction
   // minus one.  This is compensated for in the RTS instruction
-  poke(0x0100 + SP--, PC >> 8);
-  poke(0x0100 + SP--, PC & 0xff);
+  poke<debugging>(0x0100 + SP--, PC >> 8);
+  poke<debugging>(0x0100 + SP--, PC & 0xff);
 
-  PC = (low | (uInt16(peek(PC, DISASM_CODE)) << 8));
+  PC = (low | (uInt16(peek<debugging>(PC, DISASM_CODE)) << 8));
 }')
 
 define(M6502_LAS, `{
@@ -681,7 +706,7 @@ define(M6502_LSR, `{
   C = operand & 0x01;
 
   operand = (operand >> 1) & 0x7f;
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -716,28 +741,28 @@ define(M6502_ORA, `{
 }')
 
 define(M6502_PHA, `{
-  poke(0x0100 + SP--, A);
+  poke<debugging>(0x0100 + SP--, A);
 }')
 
 define(M6502_PHP, `{
-  poke(0x0100 + SP--, PS());
+  poke<debugging>(0x0100 + SP--, PS());
 }')
 
 define(M6502_PLA, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  A = peek(0x0100 + SP, DISASM_NONE);
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  A = peek<debugging>(0x0100 + SP, DISASM_NONE);
   notZ = A;
   N = A & 0x80;
 }')
 
 define(M6502_PLP, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PS(peek(0x0100 + SP, DISASM_NONE));
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PS(peek<debugging>(0x0100 + SP, DISASM_NONE));
 }')
 
 define(M6502_RLA, `{
   uInt8 value = (operand << 1) | (C ? 1 : 0);
-  poke(operandAddress, value);
+  poke<debugging>(operandAddress, value);
 
   A &= value;
   C = operand & 0x80;
@@ -752,7 +777,7 @@ define(M6502_ROL, `{
   C = operand & 0x80;
 
   operand = (operand << 1) | (oldC ? 1 : 0);
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -777,7 +802,7 @@ define(M6502_ROR, `{
   C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   notZ = operand;
   N = operand & 0x80;
@@ -802,7 +827,7 @@ define(M6502_RRA, `{
   C = operand & 0x01;
 
   operand = ((operand >> 1) & 0x7f) | (oldC ? 0x80 : 0x00);
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   if(!D)
   {
@@ -835,21 +860,21 @@ define(M6502_RRA, `{
 }')
 
 define(M6502_RTI, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PS(peek(0x0100 + SP++, DISASM_NONE));
-  PC = peek(0x0100 + SP++, DISASM_NONE);
-  PC |= (uInt16(peek(0x0100 + SP, DISASM_NONE)) << 8);
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PS(peek<debugging>(0x0100 + SP++, DISASM_NONE));
+  PC = peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PC |= (uInt16(peek<debugging>(0x0100 + SP, DISASM_NONE)) << 8);
 }')
 
 define(M6502_RTS, `{
-  peek(0x0100 + SP++, DISASM_NONE);
-  PC = peek(0x0100 + SP++, DISASM_NONE);
-  PC |= (uInt16(peek(0x0100 + SP, DISASM_NONE)) << 8);
-  peek(PC++, DISASM_CODE);
+  peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PC = peek<debugging>(0x0100 + SP++, DISASM_NONE);
+  PC |= (uInt16(peek<debugging>(0x0100 + SP, DISASM_NONE)) << 8);
+  peek<debugging>(PC++, DISASM_CODE);
 }')
 
 define(M6502_SAX, `{
-  poke(operandAddress, A & X);
+  poke<debugging>(operandAddress, A & X);
 }')
 
 define(M6502_SBC, `{
@@ -904,26 +929,26 @@ define(M6502_SEI, `{
 define(M6502_SHA, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1));
+  poke<debugging>(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SHS, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
   SP = A & X;
-  poke(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1));
+  poke<debugging>(operandAddress, A & X & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SHX, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, X & (((operandAddress >> 8) & 0xff) + 1));
+  poke<debugging>(operandAddress, X & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SHY, `{
   // NOTE: There are mixed reports on the actual operation
   // of this instruction!
-  poke(operandAddress, Y & (((operandAddress >> 8) & 0xff) + 1));
+  poke<debugging>(operandAddress, Y & (((operandAddress >> 8) & 0xff) + 1));
 }')
 
 define(M6502_SLO, `{
@@ -931,7 +956,7 @@ define(M6502_SLO, `{
   C = operand & 0x80;
 
   operand <<= 1;
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   A |= operand;
   notZ = A;
@@ -943,7 +968,7 @@ define(M6502_SRE, `{
   C = operand & 0x01;
 
   operand = (operand >> 1) & 0x7f;
-  poke(operandAddress, operand);
+  poke<debugging>(operandAddress, operand);
 
   A ^= operand;
   notZ = A;
@@ -951,15 +976,15 @@ define(M6502_SRE, `{
 }')
 
 define(M6502_STA, `{
-  poke(operandAddress, A);
+  poke<debugging>(operandAddress, A);
 }')
 
 define(M6502_STX, `{
-  poke(operandAddress, X);
+  poke<debugging>(operandAddress, X);
 }')
 
 define(M6502_STY, `{
-  poke(operandAddress, Y);
+  poke<debugging>(operandAddress, Y);
 }')
 
 define(M6502_TAX, `{
@@ -997,1278 +1022,1284 @@ define(M6502_TYA, `{
 }')
 
 
-case 0x69:
+M6502_CASE(0x69)
 M6502_IMMEDIATE_READ
 M6502_ADC
-break;
+M6502_NEXT
 
-case 0x65:
+M6502_CASE(0x65)
 M6502_ZERO_READ
 M6502_ADC
-break;
+M6502_NEXT
 
-case 0x75:
+M6502_CASE(0x75)
 M6502_ZEROX_READ
 M6502_ADC
-break;
+M6502_NEXT
 
-case 0x6d:
+M6502_CASE(0x6d)
 M6502_ABSOLUTE_READ
 M6502_ADC
-break;
+M6502_NEXT
 
-case 0x7d:
+M6502_CASE(0x7d)
 M6502_ABSOLUTEX_READ
 M6502_ADC
-break;
+M6502_NEXT
 
-case 0x79:
+M6502_CASE(0x79)
 M6502_ABSOLUTEY_READ
 M6502_ADC
-break;
+M6502_NEXT
 
-case 0x61:
+M6502_CASE(0x61)
 M6502_INDIRECTX_READ
 M6502_ADC
-break;
+M6502_NEXT
 
-case 0x71:
+M6502_CASE(0x71)
 M6502_INDIRECTY_READ
 M6502_ADC
-break;
+M6502_NEXT
 
 
-case 0x4b:
+M6502_CASE(0x4b)
 M6502_IMMEDIATE_READ
 M6502_ASR
-break;
+M6502_NEXT
 
 
-case 0x0b:
-case 0x2b:
+M6502_CASE(0x0b)
+M6502_CASE(0x2b)
 M6502_IMMEDIATE_READ
 M6502_ANC
-break;
+M6502_NEXT
 
 
-case 0x29:
+M6502_CASE(0x29)
 M6502_IMMEDIATE_READ
 M6502_AND
-break;
+M6502_NEXT
 
-case 0x25:
+M6502_CASE(0x25)
 M6502_ZERO_READ
 M6502_AND
-break;
+M6502_NEXT
 
-case 0x35:
+M6502_CASE(0x35)
 M6502_ZEROX_READ
 M6502_AND
-break;
+M6502_NEXT
 
-case 0x2d:
+M6502_CASE(0x2d)
 M6502_ABSOLUTE_READ
 M6502_AND
-break;
+M6502_NEXT
 
-case 0x3d:
+M6502_CASE(0x3d)
 M6502_ABSOLUTEX_READ
 M6502_AND
-break;
+M6502_NEXT
 
-case 0x39:
+M6502_CASE(0x39)
 M6502_ABSOLUTEY_READ
 M6502_AND
-break;
+M6502_NEXT
 
-case 0x21:
+M6502_CASE(0x21)
 M6502_INDIRECTX_READ
 M6502_AND
-break;
+M6502_NEXT
 
-case 0x31:
+M6502_CASE(0x31)
 M6502_INDIRECTY_READ
 M6502_AND
-break;
+M6502_NEXT
 
 
-case 0x8b:
+M6502_CASE(0x8b)
 M6502_IMMEDIATE_READ
 M6502_ANE
-break;
+M6502_NEXT
 
 
-case 0x6b:
+M6502_CASE(0x6b)
 M6502_IMMEDIATE_READ
 M6502_ARR
-break;
+M6502_NEXT
 
 
-case 0x0a:
+M6502_CASE(0x0a)
 M6502_IMPLIED
 M6502_ASLA
-break;
+M6502_NEXT
 
-case 0x06:
+M6502_CASE(0x06)
 M6502_ZERO_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_NEXT
 
-case 0x16:
+M6502_CASE(0x16)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_NEXT
 
-case 0x0e:
+M6502_CASE(0x0e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_NEXT
 
-case 0x1e:
+M6502_CASE(0x1e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ASL
-break;
+M6502_NEXT
 
 
-case 0x90:
+M6502_CASE(0x90)
 M6502_IMMEDIATE_READ
 M6502_BCC
-break;
+M6502_NEXT
 
 
-case 0xb0:
+M6502_CASE(0xb0)
 M6502_IMMEDIATE_READ
 M6502_BCS
-break;
+M6502_NEXT
 
 
-case 0xf0:
+M6502_CASE(0xf0)
 M6502_IMMEDIATE_READ
 M6502_BEQ
-break;
+M6502_NEXT
 
 
-case 0x24:
+M6502_CASE(0x24)
 M6502_ZERO_READ
 M6502_BIT
-break;
+M6502_NEXT
 
-case 0x2C:
+M6502_CASE(0x2c)
 M6502_ABSOLUTE_READ
 M6502_BIT
-break;
+M6502_NEXT
 
 
-case 0x30:
+M6502_CASE(0x30)
 M6502_IMMEDIATE_READ
 M6502_BMI
-break;
+M6502_NEXT
 
 
-case 0xD0:
+M6502_CASE(0xd0)
 M6502_IMMEDIATE_READ
 M6502_BNE
-break;
+M6502_NEXT
 
 
-case 0x10:
+M6502_CASE(0x10)
 M6502_IMMEDIATE_READ
 M6502_BPL
-break;
+M6502_NEXT
 
 
-case 0x00:
+M6502_CASE(0x00)
 M6502_BRK
-break;
+M6502_NEXT
 
 
-case 0x50:
+M6502_CASE(0x50)
 M6502_IMMEDIATE_READ
 M6502_BVC
-break;
+M6502_NEXT
 
 
-case 0x70:
+M6502_CASE(0x70)
 M6502_IMMEDIATE_READ
 M6502_BVS
-break;
+M6502_NEXT
 
 
-case 0x18:
+M6502_CASE(0x18)
 M6502_IMPLIED
 M6502_CLC
-break;
+M6502_NEXT
 
 
-case 0xd8:
+M6502_CASE(0xd8)
 M6502_IMPLIED
 M6502_CLD
-break;
+M6502_NEXT
 
 
-case 0x58:
+M6502_CASE(0x58)
 M6502_IMPLIED
 M6502_CLI
-break;
+M6502_NEXT
 
 
-case 0xb8:
+M6502_CASE(0xb8)
 M6502_IMPLIED
 M6502_CLV
-break;
+M6502_NEXT
 
 
-case 0xc9:
+M6502_CASE(0xc9)
 M6502_IMMEDIATE_READ
 M6502_CMP
-break;
+M6502_NEXT
 
-case 0xc5:
+M6502_CASE(0xc5)
 M6502_ZERO_READ
 M6502_CMP
-break;
+M6502_NEXT
 
-case 0xd5:
+M6502_CASE(0xd5)
 M6502_ZEROX_READ
 M6502_CMP
-break;
+M6502_NEXT
 
-case 0xcd:
+M6502_CASE(0xcd)
 M6502_ABSOLUTE_READ
 M6502_CMP
-break;
+M6502_NEXT
 
-case 0xdd:
+M6502_CASE(0xdd)
 M6502_ABSOLUTEX_READ
 M6502_CMP
-break;
+M6502_NEXT
 
-case 0xd9:
+M6502_CASE(0xd9)
 M6502_ABSOLUTEY_READ
 M6502_CMP
-break;
+M6502_NEXT
 
-case 0xc1:
+M6502_CASE(0xc1)
 M6502_INDIRECTX_READ
 M6502_CMP
-break;
+M6502_NEXT
 
-case 0xd1:
+M6502_CASE(0xd1)
 M6502_INDIRECTY_READ
 M6502_CMP
-break;
+M6502_NEXT
 
 
-case 0xe0:
+M6502_CASE(0xe0)
 M6502_IMMEDIATE_READ
 M6502_CPX
-break;
+M6502_NEXT
 
-case 0xe4:
+M6502_CASE(0xe4)
 M6502_ZERO_READ
 M6502_CPX
-break;
+M6502_NEXT
 
-case 0xec:
+M6502_CASE(0xec)
 M6502_ABSOLUTE_READ
 M6502_CPX
-break;
+M6502_NEXT
 
 
-case 0xc0:
+M6502_CASE(0xc0)
 M6502_IMMEDIATE_READ
 M6502_CPY
-break;
+M6502_NEXT
 
-case 0xc4:
+M6502_CASE(0xc4)
 M6502_ZERO_READ
 M6502_CPY
-break;
+M6502_NEXT
 
-case 0xcc:
+M6502_CASE(0xcc)
 M6502_ABSOLUTE_READ
 M6502_CPY
-break;
+M6502_NEXT
 
 
-case 0xcf:
+M6502_CASE(0xcf)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_NEXT
 
-case 0xdf:
+M6502_CASE(0xdf)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_NEXT
 
-case 0xdb:
+M6502_CASE(0xdb)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_NEXT
 
-case 0xc7:
+M6502_CASE(0xc7)
 M6502_ZERO_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_NEXT
 
-case 0xd7:
+M6502_CASE(0xd7)
 M6502_ZEROX_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_NEXT
 
-case 0xc3:
+M6502_CASE(0xc3)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_NEXT
 
-case 0xd3:
+M6502_CASE(0xd3)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_DCP
-break;
+M6502_NEXT
 
 
-case 0xc6:
+M6502_CASE(0xc6)
 M6502_ZERO_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_NEXT
 
-case 0xd6:
+M6502_CASE(0xd6)
 M6502_ZEROX_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_NEXT
 
-case 0xce:
+M6502_CASE(0xce)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_NEXT
 
-case 0xde:
+M6502_CASE(0xde)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_DEC
-break;
+M6502_NEXT
 
 
-case 0xca:
+M6502_CASE(0xca)
 M6502_IMPLIED
 M6502_DEX
-break;
+M6502_NEXT
 
 
-case 0x88:
+M6502_CASE(0x88)
 M6502_IMPLIED
 M6502_DEY
-break;
+M6502_NEXT
 
 
-case 0x49:
+M6502_CASE(0x49)
 M6502_IMMEDIATE_READ
 M6502_EOR
-break;
+M6502_NEXT
 
-case 0x45:
+M6502_CASE(0x45)
 M6502_ZERO_READ
 M6502_EOR
-break;
+M6502_NEXT
 
-case 0x55:
+M6502_CASE(0x55)
 M6502_ZEROX_READ
 M6502_EOR
-break;
+M6502_NEXT
 
-case 0x4d:
+M6502_CASE(0x4d)
 M6502_ABSOLUTE_READ
 M6502_EOR
-break;
+M6502_NEXT
 
-case 0x5d:
+M6502_CASE(0x5d)
 M6502_ABSOLUTEX_READ
 M6502_EOR
-break;
+M6502_NEXT
 
-case 0x59:
+M6502_CASE(0x59)
 M6502_ABSOLUTEY_READ
 M6502_EOR
-break;
+M6502_NEXT
 
-case 0x41:
+M6502_CASE(0x41)
 M6502_INDIRECTX_READ
 M6502_EOR
-break;
+M6502_NEXT
 
-case 0x51:
+M6502_CASE(0x51)
 M6502_INDIRECTY_READ
 M6502_EOR
-break;
+M6502_NEXT
 
 
-case 0xe6:
+M6502_CASE(0xe6)
 M6502_ZERO_READMODIFYWRITE
 M6502_INC
-break;
+M6502_NEXT
 
-case 0xf6:
+M6502_CASE(0xf6)
 M6502_ZEROX_READMODIFYWRITE
 M6502_INC
-break;
+M6502_NEXT
 
-case 0xee:
+M6502_CASE(0xee)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_INC
-break;
+M6502_NEXT
 
-case 0xfe:
+M6502_CASE(0xfe)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_INC
-break;
+M6502_NEXT
 
 
-case 0xe8:
+M6502_CASE(0xe8)
 M6502_IMPLIED
 M6502_INX
-break;
+M6502_NEXT
 
 
-case 0xc8:
+M6502_CASE(0xc8)
 M6502_IMPLIED
 M6502_INY
-break;
+M6502_NEXT
 
 
-case 0xef:
+M6502_CASE(0xef)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_NEXT
 
-case 0xff:
+M6502_CASE(0xff)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_NEXT
 
-case 0xfb:
+M6502_CASE(0xfb)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_NEXT
 
-case 0xe7:
+M6502_CASE(0xe7)
 M6502_ZERO_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_NEXT
 
-case 0xf7:
+M6502_CASE(0xf7)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_NEXT
 
-case 0xe3:
+M6502_CASE(0xe3)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_NEXT
 
-case 0xf3:
+M6502_CASE(0xf3)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_ISB
-break;
+M6502_NEXT
 
 
-case 0x4c:
+M6502_CASE(0x4c)
 M6502_ABSOLUTE_WRITE
 M6502_JMP
-break;
+M6502_NEXT
 
-case 0x6c:
+M6502_CASE(0x6c)
 M6502_INDIRECT
 M6502_JMP
-break;
+M6502_NEXT
 
 
-case 0x20:
+M6502_CASE(0x20)
 M6502_JSR
-break;
+M6502_NEXT
 
 
-case 0xbb:
+M6502_CASE(0xbb)
 M6502_ABSOLUTEY_READ
 M6502_LAS
-break;
+M6502_NEXT
 
 
 //////////////////////////////////////////////////
 // LAX
-case 0xaf:
+M6502_CASE(0xaf)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_NEXT
 
-case 0xbf:
+M6502_CASE(0xbf)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_NEXT
 
-case 0xa7:
+M6502_CASE(0xa7)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_NEXT
 
-case 0xb7:
+M6502_CASE(0xb7)
 M6502_ZEROY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)  // TODO - check this
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LAX
-break;
+M6502_NEXT
 
-case 0xa3:
+M6502_CASE(0xa3)
 M6502_INDIRECTX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)  // TODO - check this
 M6502_LAX
-break;
+M6502_NEXT
 
-case 0xb3:
+M6502_CASE(0xb3)
 M6502_INDIRECTY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)  // TODO - check this
 M6502_LAX
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // LDA
-case 0xa9:
+M6502_CASE(0xa9)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressA)
 M6502_LDA
-break;
+M6502_NEXT
 
-case 0xa5:
+M6502_CASE(0xa5)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_NEXT
 
-case 0xb5:
+M6502_CASE(0xb5)
 M6502_ZEROX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_NEXT
 
-case 0xad:
+M6502_CASE(0xad)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_NEXT
 
-case 0xbd:
+M6502_CASE(0xbd)
 M6502_ABSOLUTEX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_NEXT
 
-case 0xb9:
+M6502_CASE(0xb9)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_NEXT
 
-case 0xa1:
+M6502_CASE(0xa1)
 M6502_INDIRECTX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_NEXT
 
-case 0xb1:
+M6502_CASE(0xb1)
 M6502_INDIRECTY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_LDA
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // LDX
-case 0xa2:
+M6502_CASE(0xa2)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressX)
 M6502_LDX
-break;
+M6502_NEXT
 
-case 0xa6:
+M6502_CASE(0xa6)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_NEXT
 
-case 0xb6:
+M6502_CASE(0xb6)
 M6502_ZEROY_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_NEXT
 
-case 0xae:
+M6502_CASE(0xae)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_NEXT
 
-case 0xbe:
+M6502_CASE(0xbe)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressX, intermediateAddress)
 M6502_LDX
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // LDY
-case 0xa0:
+M6502_CASE(0xa0)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressY)
 M6502_LDY
-break;
+M6502_NEXT
 
-case 0xa4:
+M6502_CASE(0xa4)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_NEXT
 
-case 0xb4:
+M6502_CASE(0xb4)
 M6502_ZEROX_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_NEXT
 
-case 0xac:
+M6502_CASE(0xac)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_NEXT
 
-case 0xbc:
+M6502_CASE(0xbc)
 M6502_ABSOLUTEX_READ
 SET_LAST_PEEK(myLastSrcAddressY, intermediateAddress)
 M6502_LDY
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
-case 0x4a:
+M6502_CASE(0x4a)
 M6502_IMPLIED
 M6502_LSRA
-break;
+M6502_NEXT
 
 
-case 0x46:
+M6502_CASE(0x46)
 M6502_ZERO_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_NEXT
 
-case 0x56:
+M6502_CASE(0x56)
 M6502_ZEROX_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_NEXT
 
-case 0x4e:
+M6502_CASE(0x4e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_NEXT
 
-case 0x5e:
+M6502_CASE(0x5e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_LSR
-break;
+M6502_NEXT
 
 
-case 0xab:
+M6502_CASE(0xab)
 M6502_IMMEDIATE_READ
 M6502_LXA
-break;
+M6502_NEXT
 
 
-case 0x1a:
-case 0x3a:
-case 0x5a:
-case 0x7a:
-case 0xda:
-case 0xea:
-case 0xfa:
+M6502_CASE(0x1a)
+M6502_CASE(0x3a)
+M6502_CASE(0x5a)
+M6502_CASE(0x7a)
+M6502_CASE(0xda)
+M6502_CASE(0xea)
+M6502_CASE(0xfa)
 M6502_IMPLIED
 M6502_NOP
-break;
+M6502_NEXT
 
-case 0x80:
-case 0x82:
-case 0x89:
-case 0xc2:
-case 0xe2:
+M6502_CASE(0x80)
+M6502_CASE(0x82)
+M6502_CASE(0x89)
+M6502_CASE(0xc2)
+M6502_CASE(0xe2)
 M6502_IMMEDIATE_READ
 M6502_NOP
-break;
+M6502_NEXT
 
-case 0x04:
-case 0x44:
-case 0x64:
+M6502_CASE(0x04)
+M6502_CASE(0x44)
+M6502_CASE(0x64)
 M6502_ZERO_READ
 M6502_NOP
-break;
-
-case 0x14:
-case 0x34:
-case 0x54:
-case 0x74:
-case 0xd4:
-case 0xf4:
+M6502_NEXT
+
+M6502_CASE(0x14)
+M6502_CASE(0x34)
+M6502_CASE(0x54)
+M6502_CASE(0x74)
+M6502_CASE(0xd4)
+M6502_CASE(0xf4)
 M6502_ZEROX_READ
 M6502_NOP
-break;
+M6502_NEXT
 
-case 0x0c:
+M6502_CASE(0x0c)
 M6502_ABSOLUTE_READ
 M6502_NOP
-break;
-
-case 0x1c:
-case 0x3c:
-case 0x5c:
-case 0x7c:
-case 0xdc:
-case 0xfc:
+M6502_NEXT
+
+M6502_CASE(0x1c)
+M6502_CASE(0x3c)
+M6502_CASE(0x5c)
+M6502_CASE(0x7c)
+M6502_CASE(0xdc)
+M6502_CASE(0xfc)
 M6502_ABSOLUTEX_READ
 M6502_NOP
-break;
+M6502_NEXT
 
 
 //////////////////////////////////////////////////
 // ORA
-case 0x09:
+M6502_CASE(0x09)
 M6502_IMMEDIATE_READ
 CLEAR_LAST_PEEK(myLastSrcAddressA)
 M6502_ORA
-break;
+M6502_NEXT
 
-case 0x05:
+M6502_CASE(0x05)
 M6502_ZERO_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_NEXT
 
-case 0x15:
+M6502_CASE(0x15)
 M6502_ZEROX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_NEXT
 
-case 0x0d:
+M6502_CASE(0x0d)
 M6502_ABSOLUTE_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_NEXT
 
-case 0x1d:
+M6502_CASE(0x1d)
 M6502_ABSOLUTEX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_NEXT
 
-case 0x19:
+M6502_CASE(0x19)
 M6502_ABSOLUTEY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_NEXT
 
-case 0x01:
+M6502_CASE(0x01)
 M6502_INDIRECTX_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_NEXT
 
-case 0x11:
+M6502_CASE(0x11)
 M6502_INDIRECTY_READ
 SET_LAST_PEEK(myLastSrcAddressA, intermediateAddress)
 M6502_ORA
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
-case 0x48:
+M6502_CASE(0x48)
 M6502_IMPLIED
 // TODO - add tracking for this opcode
 M6502_PHA
-break;
+M6502_NEXT
 
 
-case 0x08:
+M6502_CASE(0x08)
 M6502_IMPLIED
 // TODO - add tracking for this opcode
 M6502_PHP
-break;
+M6502_NEXT
 
 
-case 0x68:
+M6502_CASE(0x68)
 M6502_IMPLIED
 // TODO - add tracking for this opcode
 M6502_PLA
-break;
+M6502_NEXT
 
 
-case 0x28:
+M6502_CASE(0x28)
 M6502_IMPLIED
 // TODO - add tracking for this opcode
 M6502_PLP
-break;
+M6502_NEXT
 
 
-case 0x2f:
+M6502_CASE(0x2f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_NEXT
 
-case 0x3f:
+M6502_CASE(0x3f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_NEXT
 
-case 0x3b:
+M6502_CASE(0x3b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_NEXT
 
-case 0x27:
+M6502_CASE(0x27)
 M6502_ZERO_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_NEXT
 
-case 0x37:
+M6502_CASE(0x37)
 M6502_ZEROX_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_NEXT
 
-case 0x23:
+M6502_CASE(0x23)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_NEXT
 
-case 0x33:
+M6502_CASE(0x33)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_RLA
-break;
+M6502_NEXT
 
 
-case 0x2a:
+M6502_CASE(0x2a)
 M6502_IMPLIED
 M6502_ROLA
-break;
+M6502_NEXT
 
 
-case 0x26:
+M6502_CASE(0x26)
 M6502_ZERO_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_NEXT
 
-case 0x36:
+M6502_CASE(0x36)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_NEXT
 
-case 0x2e:
+M6502_CASE(0x2e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_NEXT
 
-case 0x3e:
+M6502_CASE(0x3e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ROL
-break;
+M6502_NEXT
 
 
-case 0x6a:
+M6502_CASE(0x6a)
 M6502_IMPLIED
 M6502_RORA
-break;
+M6502_NEXT
 
-case 0x66:
+M6502_CASE(0x66)
 M6502_ZERO_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_NEXT
 
-case 0x76:
+M6502_CASE(0x76)
 M6502_ZEROX_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_NEXT
 
-case 0x6e:
+M6502_CASE(0x6e)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_NEXT
 
-case 0x7e:
+M6502_CASE(0x7e)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_ROR
-break;
+M6502_NEXT
 
 
-case 0x6f:
+M6502_CASE(0x6f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_NEXT
 
-case 0x7f:
+M6502_CASE(0x7f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_NEXT
 
-case 0x7b:
+M6502_CASE(0x7b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_NEXT
 
-case 0x67:
+M6502_CASE(0x67)
 M6502_ZERO_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_NEXT
 
-case 0x77:
+M6502_CASE(0x77)
 M6502_ZEROX_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_NEXT
 
-case 0x63:
+M6502_CASE(0x63)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_NEXT
 
-case 0x73:
+M6502_CASE(0x73)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_RRA
-break;
+M6502_NEXT
 
 
-case 0x40:
+M6502_CASE(0x40)
 M6502_IMPLIED
 M6502_RTI
-break;
+M6502_NEXT
 
 
-case 0x60:
+M6502_CASE(0x60)
 M6502_IMPLIED
 M6502_RTS
-break;
+M6502_NEXT
 
 
-case 0x8f:
+M6502_CASE(0x8f)
 M6502_ABSOLUTE_WRITE
 M6502_SAX
-break;
+M6502_NEXT
 
-case 0x87:
+M6502_CASE(0x87)
 M6502_ZERO_WRITE
 M6502_SAX
-break;
+M6502_NEXT
 
-case 0x97:
+M6502_CASE(0x97)
 M6502_ZEROY_WRITE
 M6502_SAX
-break;
+M6502_NEXT
 
-case 0x83:
+M6502_CASE(0x83)
 M6502_INDIRECTX_WRITE
 M6502_SAX
-break;
+M6502_NEXT
 
 
-case 0xe9:
-case 0xeb:
+M6502_CASE(0xe9)
+M6502_CASE(0xeb)
 M6502_IMMEDIATE_READ
 M6502_SBC
-break;
+M6502_NEXT
 
-case 0xe5:
+M6502_CASE(0xe5)
 M6502_ZERO_READ
 M6502_SBC
-break;
+M6502_NEXT
 
-case 0xf5:
+M6502_CASE(0xf5)
 M6502_ZEROX_READ
 M6502_SBC
-break;
+M6502_NEXT
 
-case 0xed:
+M6502_CASE(0xed)
 M6502_ABSOLUTE_READ
 M6502_SBC
-break;
+M6502_NEXT
 
-case 0xfd:
+M6502_CASE(0xfd)
 M6502_ABSOLUTEX_READ
 M6502_SBC
-break;
+M6502_NEXT
 
-case 0xf9:
+M6502_CASE(0xf9)
 M6502_ABSOLUTEY_READ
 M6502_SBC
-break;
+M6502_NEXT
 
-case 0xe1:
+M6502_CASE(0xe1)
 M6502_INDIRECTX_READ
 M6502_SBC
-break;
+M6502_NEXT
 
-case 0xf1:
+M6502_CASE(0xf1)
 M6502_INDIRECTY_READ
 M6502_SBC
-break;
+M6502_NEXT
 
 
-case 0xcb:
+M6502_CASE(0xcb)
 M6502_IMMEDIATE_READ
 M6502_SBX
-break;
+M6502_NEXT
 
 
-case 0x38:
+M6502_CASE(0x38)
 M6502_IMPLIED
 M6502_SEC
-break;
+M6502_NEXT
 
 
-case 0xf8:
+M6502_CASE(0xf8)
 M6502_IMPLIED
 M6502_SED
-break;
+M6502_NEXT
 
 
-case 0x78:
+M6502_CASE(0x78)
 M6502_IMPLIED
 M6502_SEI
-break;
+M6502_NEXT
 
 
-case 0x9f:
+M6502_CASE(0x9f)
 M6502_ABSOLUTEY_WRITE
 M6502_SHA
-break;
+M6502_NEXT
 
-case 0x93:
+M6502_CASE(0x93)
 M6502_INDIRECTY_WRITE
 M6502_SHA
-break;
+M6502_NEXT
 
 
-case 0x9b:
+M6502_CASE(0x9b)
 M6502_ABSOLUTEY_WRITE
 M6502_SHS
-break;
+M6502_NEXT
 
 
-case 0x9e:
+M6502_CASE(0x9e)
 M6502_ABSOLUTEY_WRITE
 M6502_SHX
-break;
+M6502_NEXT
 
 
-case 0x9c:
+M6502_CASE(0x9c)
 M6502_ABSOLUTEX_WRITE
 M6502_SHY
-break;
+M6502_NEXT
 
 
-case 0x0f:
+M6502_CASE(0x0f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_NEXT
 
-case 0x1f:
+M6502_CASE(0x1f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_NEXT
 
-case 0x1b:
+M6502_CASE(0x1b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_NEXT
 
-case 0x07:
+M6502_CASE(0x07)
 M6502_ZERO_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_NEXT
 
-case 0x17:
+M6502_CASE(0x17)
 M6502_ZEROX_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_NEXT
 
-case 0x03:
+M6502_CASE(0x03)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_NEXT
 
-case 0x13:
+M6502_CASE(0x13)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_SLO
-break;
+M6502_NEXT
 
 
-case 0x4f:
+M6502_CASE(0x4f)
 M6502_ABSOLUTE_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_NEXT
 
-case 0x5f:
+M6502_CASE(0x5f)
 M6502_ABSOLUTEX_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_NEXT
 
-case 0x5b:
+M6502_CASE(0x5b)
 M6502_ABSOLUTEY_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_NEXT
 
-case 0x47:
+M6502_CASE(0x47)
 M6502_ZERO_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_NEXT
 
-case 0x57:
+M6502_CASE(0x57)
 M6502_ZEROX_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_NEXT
 
-case 0x43:
+M6502_CASE(0x43)
 M6502_INDIRECTX_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_NEXT
 
-case 0x53:
+M6502_CASE(0x53)
 M6502_INDIRECTY_READMODIFYWRITE
 M6502_SRE
-break;
+M6502_NEXT
 
 
 //////////////////////////////////////////////////
 // STA
-case 0x85:
+M6502_CASE(0x85)
 M6502_ZERO_WRITE
 SET_LAST_POKE(myLastSrcAddressA)
 M6502_STA
-break;
+M6502_NEXT
 
-case 0x95:
+M6502_CASE(0x95)
 M6502_ZEROX_WRITE
 M6502_STA
-break;
+M6502_NEXT
 
-case 0x8d:
+M6502_CASE(0x8d)
 M6502_ABSOLUTE_WRITE
 M6502_STA
-break;
+M6502_NEXT
 
-case 0x9d:
+M6502_CASE(0x9d)
 M6502_ABSOLUTEX_WRITE
 M6502_STA
-break;
+M6502_NEXT
 
-case 0x99:
+M6502_CASE(0x99)
 M6502_ABSOLUTEY_WRITE
 M6502_STA
-break;
+M6502_NEXT
 
-case 0x81:
+M6502_CASE(0x81)
 M6502_INDIRECTX_WRITE
 M6502_STA
-break;
+M6502_NEXT
 
-case 0x91:
+M6502_CASE(0x91)
 M6502_INDIRECTY_WRITE
 M6502_STA
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // STX
-case 0x86:
+M6502_CASE(0x86)
 M6502_ZERO_WRITE
 SET_LAST_POKE(myLastSrcAddressX)
 M6502_STX
-break;
+M6502_NEXT
 
-case 0x96:
+M6502_CASE(0x96)
 M6502_ZEROY_WRITE
 M6502_STX
-break;
+M6502_NEXT
 
-case 0x8e:
+M6502_CASE(0x8e)
 M6502_ABSOLUTE_WRITE
 M6502_STX
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // STY
-case 0x84:
+M6502_CASE(0x84)
 M6502_ZERO_WRITE
 SET_LAST_POKE(myLastSrcAddressY)
 M6502_STY
-break;
+M6502_NEXT
 
-case 0x94:
+M6502_CASE(0x94)
 M6502_ZEROX_WRITE
 M6502_STY
-break;
+M6502_NEXT
 
-case 0x8c:
+M6502_CASE(0x8c)
 M6502_ABSOLUTE_WRITE
 M6502_STY
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
 
 
 //////////////////////////////////////////////////
 // Remaining MOVE opcodes
-case 0xaa:
+M6502_CASE(0xaa)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressX, myLastSrcAddressA)
 M6502_TAX
-break;
+M6502_NEXT
 
 
-case 0xa8:
+M6502_CASE(0xa8)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressY, myLastSrcAddressA)
 M6502_TAY
-break;
+M6502_NEXT
 
 
-case 0xba:
+M6502_CASE(0xba)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressX, myLastSrcAddressS)
 M6502_TSX
-break;
+M6502_NEXT
 
 
-case 0x8a:
+M6502_CASE(0x8a)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressA, myLastSrcAddressX)
 M6502_TXA
-break;
+M6502_NEXT
 
 
-case 0x9a:
+M6502_CASE(0x9a)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressS, myLastSrcAddressX)
 M6502_TXS
-break;
+M6502_NEXT
 
 
-case 0x98:
+M6502_CASE(0x98)
 M6502_IMPLIED
 SET_LAST_PEEK(myLastSrcAddressA, myLastSrcAddressY)
 M6502_TYA
-break;
+M6502_NEXT
 //////////////////////////////////////////////////
+
+#endif
+divert(0)dnl
+#ifdef M6502_OPCODE_TABLE
+M6502_TABLE(0)dnl
+#endif
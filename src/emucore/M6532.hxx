@@ -114,6 +114,14 @@ class M6532 : public Device
     */
     string name() const override { return "M6532"; }
 
+    /**
+      Access the 128 bytes of internal RAM, for observing the state of
+      the system without involving the debugger.
+
+      @return  A pointer to the internal RAM
+    */
+    const uInt8* getRAM() const { return myRAM; }
+
    public:
     /**
       Get the byte at the specified address
@@ -0,0 +1,90 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MUSIC_CLOCK_HXX
+#define MUSIC_CLOCK_HXX
+
+#include "bspf.hxx"
+#include "Serializer.hxx"
+
+/**
+  The 20kHz oscillator that clocks the music data fetchers of the DPC,
+  DPC+, CDF, BUS and CTY carts, counted in step with the 6507.
+
+  Each 6507 cycle (at 1193191.666... Hz, or 7159150/6) is worth exactly
+  2400/143183 of a clock, so the clocks are counted in units of 1/143183,
+  and the part of a clock left over from each update is a whole number
+  of units.  Nothing is rounded, and the count can be saved exactly.
+*/
+class MusicClock
+{
+  public:
+    MusicClock() : myUnits(0) { }
+
+  public:
+    /**
+      Answers the number of whole clocks in the given number of 6507
+      cycles, together with what was left over from earlier calls.  No
+      time passes when the number of cycles isn't positive.
+    */
+    uInt32 clocks(Int32 cycles)
+    {
+      if(cycles <= 0)
+        return 0;
+
+      const uInt64 units = myUnits + uInt64(cycles) * kUnitsPerCycle;
+
+      // Most updates are less than a clock apart
+      if(units < kUnitsPerClock)
+      {
+        myUnits = uInt32(units);
+        return 0;
+      }
+
+      const uInt64 clocks = units / kUnitsPerClock;
+      myUnits = uInt32(units - clocks * kUnitsPerClock);
+      return uInt32(clocks);
+    }
+
+    /**
+      Drop the part of a clock left over.
+    */
+    void reset() { myUnits = 0; }
+
+    /**
+      Save and load the part of a clock left over.  Loading anything that
+      isn't less than a clock (such as the fraction of a clock saved by
+      older versions, in units of 1e-8) throws a runtime_error exception.
+    */
+    void save(Serializer& out) const { out.putInt(myUnits); }
+    void load(Serializer& in)
+    {
+      const uInt32 units = in.getInt();
+      if(units >= kUnitsPerClock)
+        throw runtime_error("MusicClock: invalid part of a clock");
+      myUnits = units;
+    }
+
+  private:
+    static constexpr uInt32 kUnitsPerCycle = 2400;
+    static constexpr uInt32 kUnitsPerClock = 143183;
+
+    // The part of a clock left over, in units
+    uInt32 myUnits;
+};
+
+#endif
@@ -48,10 +48,15 @@
 #include "Launcher.hxx"
 #include "Widget.hxx"
 #include "Console.hxx"
-#include "Random.hxx"
+#include "TIA.hxx"
+#include "TIASurface.hxx"
+#include "Profiler.hxx"
+#include "System.hxx"
 #include "SerialPort.hxx"
 #include "StateManager.hxx"
 #include "Version.hxx"
+#include "WavWriter.hxx"
+#include "Thumbulator.hxx"
 
 #include "OSystem.hxx"
 
@@ -88,12 +93,15 @@ OSystem::OSystem()
   myBuildInfo = info.str();
 
   mySettings = MediaFactory::createSettings(*this);
-  myRandom = make_ptr<Random>(*this);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 OSystem::~OSystem()
 {
+  // A movie being recorded is written when it stops, which may log an
+  // error, so it's stopped while the log is still around
+  if(myStateManager)
+    myStateManager->stopMovie();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -150,9 +158,6 @@ bool OSystem::create()
   // a real serial port on the system
   mySerialPort = MediaFactory::createSerialPort();
 
-  // Re-initialize random seed
-  myRandom->initSeed();
-
   // Create PNG handler
   myPNGLib = make_ptr<PNGLibrary>(*myFrameBuffer);
 
@@ -320,78 +325,114 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
     return buf.str();
   }
 
-  if(myConsole)
+  return myConsole ? initializeConsole(showmessage, type, id) : EmptyString;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string OSystem::createConsole(const uInt8* image, uInt32 size, const string& md5)
+{
+  myRomMD5 = md5;
+  mySettings->setValue("romloadcount", 0);
+
+  // Create an instance of the 2600 game console
+  string type, id;
+  try
   {
-  #ifdef DEBUGGER_SUPPORT
-    myDebugger = make_ptr<Debugger>(*this, *myConsole);
-    myDebugger->initialize();
-    myConsole->attachDebugger(*myDebugger);
-  #endif
-  #ifdef CHEATCODE_SUPPORT
-    myCheatManager->loadCheats(myRomMD5);
-  #endif
-    myEventHandler->reset(EventHandler::S_EMULATE);
-    myEventHandler->setMouseControllerMode(mySettings->getString("usemouse"));
-    if(createFrameBuffer() != kSuccess)  // Takes care of initializeVideo()
-    {
-      logMessage("ERROR: Couldn't create framebuffer for console", 0);
-      myEventHandler->reset(EventHandler::S_LAUNCHER);
-      return "ERROR: Couldn't create framebuffer for console";
-    }
-    myConsole->initializeAudio();
+    closeConsole();
+    BytePtr rom = make_ptr<uInt8[]>(size);
+    std::copy(image, image + size, rom.get());
+    myConsole = openConsole(rom, size, myRomMD5, type, id);
 
-    if(showmessage)
-    {
-      if(id == "")
-        myFrameBuffer->showMessage("New console created");
-      else
-        myFrameBuffer->showMessage("Multicart " + type + ", loading ROM" + id);
-    }
-    buf << "Game console created:" << endl
-        << "  ROM file: " << myRomFile.getShortPath() << endl << endl
-        << getROMInfo(*myConsole) << endl;
-    logMessage(buf.str(), 1);
+    // There's no file backing this ROM, so name it after its MD5sum
+    // (used for naming snapshots, debugger files, etc)
+    myRomFile = FilesystemNode(myRomMD5 + ".bin");
+  }
+  catch(const runtime_error& e)
+  {
+    ostringstream buf;
+    buf << "ERROR: Couldn't create console (" << e.what() << ")";
+    logMessage(buf.str(), 0);
+    return buf.str();
+  }
 
-    // Update the timing info for a new console run
-    resetLoopTiming();
+  return myConsole ? initializeConsole(false, type, id) :
+                     "ERROR: Couldn't create console";
+}
 
-    myFrameBuffer->setCursorState();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string OSystem::initializeConsole(bool showmessage, const string& type,
+                                  const string& id)
+{
+#ifdef DEBUGGER_SUPPORT
+  myDebugger = make_ptr<Debugger>(*this, *myConsole);
+  myDebugger->initialize();
+  myConsole->attachDebugger(*myDebugger);
+#endif
+#ifdef CHEATCODE_SUPPORT
+  myCheatManager->loadCheats(myRomMD5);
+#endif
+  myEventHandler->reset(EventHandler::S_EMULATE);
+  myEventHandler->setMouseControllerMode(mySettings->getString("usemouse"));
+  if(createFrameBuffer() != kSuccess)  // Takes care of initializeVideo()
+  {
+    logMessage("ERROR: Couldn't create framebuffer for console", 0);
+    myEventHandler->reset(EventHandler::S_LAUNCHER);
+    return "ERROR: Couldn't create framebuffer for console";
+  }
+  myConsole->initializeAudio();
 
-    // Also check if certain virtual buttons should be held down
-    // These must be checked each time a new console is being created
-    if(mySettings->getBool("holdreset"))
-      myEventHandler->handleEvent(Event::ConsoleReset, 1);
-    if(mySettings->getBool("holdselect"))
-      myEventHandler->handleEvent(Event::ConsoleSelect, 1);
-
-    const string& holdjoy0 = mySettings->getString("holdjoy0");
-    if(BSPF::containsIgnoreCase(holdjoy0, "U"))
-      myEventHandler->handleEvent(Event::JoystickZeroUp, 1);
-    if(BSPF::containsIgnoreCase(holdjoy0, "D"))
-      myEventHandler->handleEvent(Event::JoystickZeroDown, 1);
-    if(BSPF::containsIgnoreCase(holdjoy0, "L"))
-      myEventHandler->handleEvent(Event::JoystickZeroLeft, 1);
-    if(BSPF::containsIgnoreCase(holdjoy0, "R"))
-      myEventHandler->handleEvent(Event::JoystickZeroRight, 1);
-    if(BSPF::containsIgnoreCase(holdjoy0, "F"))
-      myEventHandler->handleEvent(Event::JoystickZeroFire, 1);
-
-    const string& holdjoy1 = mySettings->getString("holdjoy1");
-    if(BSPF::containsIgnoreCase(holdjoy1, "U"))
-      myEventHandler->handleEvent(Event::JoystickOneUp, 1);
-    if(BSPF::containsIgnoreCase(holdjoy1, "D"))
-      myEventHandler->handleEvent(Event::JoystickOneDown, 1);
-    if(BSPF::containsIgnoreCase(holdjoy1, "L"))
-      myEventHandler->handleEvent(Event::JoystickOneLeft, 1);
-    if(BSPF::containsIgnoreCase(holdjoy1, "R"))
-      myEventHandler->handleEvent(Event::JoystickOneRight, 1);
-    if(BSPF::containsIgnoreCase(holdjoy1, "F"))
-      myEventHandler->handleEvent(Event::JoystickOneFire, 1);
-  #ifdef DEBUGGER_SUPPORT
-    if(mySettings->getBool("debug"))
-      myEventHandler->enterDebugMode();
-  #endif
+  if(showmessage)
+  {
+    if(id == "")
+      myFrameBuffer->showMessage("New console created");
+    else
+      myFrameBuffer->showMessage("Multicart " + type + ", loading ROM" + id);
   }
+  ostringstream buf;
+  buf << "Game console created:" << endl
+      << "  ROM file: " << myRomFile.getShortPath() << endl << endl
+      << getROMInfo(*myConsole) << endl;
+  logMessage(buf.str(), 1);
+
+  // Update the timing info for a new console run
+  resetLoopTiming();
+
+  myFrameBuffer->setCursorState();
+
+  // Also check if certain virtual buttons should be held down
+  // These must be checked each time a new console is being created
+  if(mySettings->getBool("holdreset"))
+    myEventHandler->handleEvent(Event::ConsoleReset, 1);
+  if(mySettings->getBool("holdselect"))
+    myEventHandler->handleEvent(Event::ConsoleSelect, 1);
+
+  const string& holdjoy0 = mySettings->getString("holdjoy0");
+  if(BSPF::containsIgnoreCase(holdjoy0, "U"))
+    myEventHandler->handleEvent(Event::JoystickZeroUp, 1);
+  if(BSPF::containsIgnoreCase(holdjoy0, "D"))
+    myEventHandler->handleEvent(Event::JoystickZeroDown, 1);
+  if(BSPF::containsIgnoreCase(holdjoy0, "L"))
+    myEventHandler->handleEvent(Event::JoystickZeroLeft, 1);
+  if(BSPF::containsIgnoreCase(holdjoy0, "R"))
+    myEventHandler->handleEvent(Event::JoystickZeroRight, 1);
+  if(BSPF::containsIgnoreCase(holdjoy0, "F"))
+    myEventHandler->handleEvent(Event::JoystickZeroFire, 1);
+
+  const string& holdjoy1 = mySettings->getString("holdjoy1");
+  if(BSPF::containsIgnoreCase(holdjoy1, "U"))
+    myEventHandler->handleEvent(Event::JoystickOneUp, 1);
+  if(BSPF::containsIgnoreCase(holdjoy1, "D"))
+    myEventHandler->handleEvent(Event::JoystickOneDown, 1);
+  if(BSPF::containsIgnoreCase(holdjoy1, "L"))
+    myEventHandler->handleEvent(Event::JoystickOneLeft, 1);
+  if(BSPF::containsIgnoreCase(holdjoy1, "R"))
+    myEventHandler->handleEvent(Event::JoystickOneRight, 1);
+  if(BSPF::containsIgnoreCase(holdjoy1, "F"))
+    myEventHandler->handleEvent(Event::JoystickOneFire, 1);
+#ifdef DEBUGGER_SUPPORT
+  if(mySettings->getBool("debug"))
+    myEventHandler->enterDebugMode();
+#endif
   return EmptyString;
 }
 
@@ -481,62 +522,73 @@ unique_ptr<Console> OSystem::openConsole(const FilesystemNode& romfile,
   BytePtr image;
   uInt32 size  = 0;
   if((image = openROM(romfile, md5, size)) != nullptr)
-  {
-    // Get a valid set of properties, including any entered on the commandline
-    // For initial creation of the Cart, we're only concerned with the BS type
-    Properties props;
-    myPropSet->getMD5(md5, props);
+    console = openConsole(image, size, md5, type, id);
 
-    auto CMDLINE_PROPS_UPDATE = [&](const string& name, PropertyType prop)
-    {
-      const string& s = mySettings->getString(name);
-      if(s != "") props.set(prop, s);
-    };
-
-    CMDLINE_PROPS_UPDATE("bs", Cartridge_Type);
-    CMDLINE_PROPS_UPDATE("type", Cartridge_Type);
-
-    // Now create the cartridge
-    string cartmd5 = md5;
-    type = props.get(Cartridge_Type);
-    unique_ptr<Cartridge> cart =
-      Cartridge::create(image, size, cartmd5, type, id, *this, *mySettings);
-
-    // It's possible that the cart created was from a piece of the image,
-    // and that the md5 (and hence the cart) has changed
-    if(props.get(Cartridge_MD5) != cartmd5)
+  return console;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Console> OSystem::openConsole(const BytePtr& image, uInt32 size,
+                                         string& md5, string& type, string& id)
+{
+  unique_ptr<Console> console;
+  if(md5 == "")
+    md5 = MD5::hash(image, size);
+
+  // Get a valid set of properties, including any entered on the commandline
+  // For initial creation of the Cart, we're only concerned with the BS type
+  Properties props;
+  myPropSet->getMD5(md5, props);
+
+  auto CMDLINE_PROPS_UPDATE = [&](const string& name, PropertyType prop)
+  {
+    const string& s = mySettings->getString(name);
+    if(s != "") props.set(prop, s);
+  };
+
+  CMDLINE_PROPS_UPDATE("bs", Cartridge_Type);
+  CMDLINE_PROPS_UPDATE("type", Cartridge_Type);
+
+  // Now create the cartridge
+  string cartmd5 = md5;
+  type = props.get(Cartridge_Type);
+  unique_ptr<Cartridge> cart =
+    Cartridge::create(image, size, cartmd5, type, id, *this, *mySettings);
+
+  // It's possible that the cart created was from a piece of the image,
+  // and that the md5 (and hence the cart) has changed
+  if(props.get(Cartridge_MD5) != cartmd5)
+  {
+    if(!myPropSet->getMD5(cartmd5, props))
     {
-      if(!myPropSet->getMD5(cartmd5, props))
-      {
-        // Cart md5 wasn't found, so we create a new props for it
-        props.set(Cartridge_MD5, cartmd5);
-        props.set(Cartridge_Name, props.get(Cartridge_Name)+id);
-        myPropSet->insert(props, false);
-      }
+      // Cart md5 wasn't found, so we create a new props for it
+      props.set(Cartridge_MD5, cartmd5);
+      props.set(Cartridge_Name, props.get(Cartridge_Name)+id);
+      myPropSet->insert(props, false);
     }
-
-    CMDLINE_PROPS_UPDATE("channels", Cartridge_Sound);
-    CMDLINE_PROPS_UPDATE("ld", Console_LeftDifficulty);
-    CMDLINE_PROPS_UPDATE("rd", Console_RightDifficulty);
-    CMDLINE_PROPS_UPDATE("tv", Console_TelevisionType);
-    CMDLINE_PROPS_UPDATE("sp", Console_SwapPorts);
-    CMDLINE_PROPS_UPDATE("lc", Controller_Left);
-    CMDLINE_PROPS_UPDATE("rc", Controller_Right);
-    const string& s = mySettings->getString("bc");
-    if(s != "") { props.set(Controller_Left, s); props.set(Controller_Right, s); }
-    CMDLINE_PROPS_UPDATE("cp", Controller_SwapPaddles);
-    CMDLINE_PROPS_UPDATE("ma", Controller_MouseAxis);
-    CMDLINE_PROPS_UPDATE("format", Display_Format);
-    CMDLINE_PROPS_UPDATE("ystart", Display_YStart);
-    CMDLINE_PROPS_UPDATE("height", Display_Height);
-    CMDLINE_PROPS_UPDATE("pp", Display_Phosphor);
-    CMDLINE_PROPS_UPDATE("ppblend", Display_PPBlend);
-
-    // Finally, create the cart with the correct properties
-    if(cart)
-      console = make_ptr<Console>(*this, cart, props);
   }
 
+  CMDLINE_PROPS_UPDATE("channels", Cartridge_Sound);
+  CMDLINE_PROPS_UPDATE("ld", Console_LeftDifficulty);
+  CMDLINE_PROPS_UPDATE("rd", Console_RightDifficulty);
+  CMDLINE_PROPS_UPDATE("tv", Console_TelevisionType);
+  CMDLINE_PROPS_UPDATE("sp", Console_SwapPorts);
+  CMDLINE_PROPS_UPDATE("lc", Controller_Left);
+  CMDLINE_PROPS_UPDATE("rc", Controller_Right);
+  const string& s = mySettings->getString("bc");
+  if(s != "") { props.set(Controller_Left, s); props.set(Controller_Right, s); }
+  CMDLINE_PROPS_UPDATE("cp", Controller_SwapPaddles);
+  CMDLINE_PROPS_UPDATE("ma", Controller_MouseAxis);
+  CMDLINE_PROPS_UPDATE("format", Display_Format);
+  CMDLINE_PROPS_UPDATE("ystart", Display_YStart);
+  CMDLINE_PROPS_UPDATE("height", Display_Height);
+  CMDLINE_PROPS_UPDATE("pp", Display_Phosphor);
+  CMDLINE_PROPS_UPDATE("ppblend", Display_PPBlend);
+
+  // Finally, create the cart with the correct properties
+  if(cart)
+    console = make_ptr<Console>(*this, cart, props);
+
   return console;
 }
 
@@ -596,6 +648,56 @@ string OSystem::getROMInfo(const Console& console)
   return buf.str();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string OSystem::benchmarkReport(const Profiler& profiler, uInt64 cycles) const
+{
+  // Strings from the properties are user-editable, so quote them properly
+  auto quote = [](const string& str) {
+    ostringstream q;
+    q << '"';
+    for(char c: str)
+    {
+      if(c == '"' || c == '\\')  q << '\\' << c;
+      else if(uInt8(c) < 0x20)   q << ' ';
+      else                       q << c;
+    }
+    q << '"';
+    return q.str();
+  };
+
+  const ConsoleInfo& info = myConsole->about();
+  const uInt64 frames = myTimingInfo.totalFrames;
+  const double wall = profiler.totalSeconds();
+  const double fps = wall > 0 ? frames / wall : 0;
+  const double mhz = wall > 0 ? cycles / wall / 1e6 : 0;  // 1 CPU cycle per system cycle
+  uInt32 reused, drawn;
+  myConsole->tia().frameCacheStats(reused, drawn);
+
+  ostringstream buf;
+  buf << "{" << endl
+      << "  \"version\": " << quote(STELLA_VERSION) << "," << endl
+      << "  \"rom\": " << quote(info.CartName) << "," << endl
+      << "  \"md5\": " << quote(info.CartMD5) << "," << endl
+      << "  \"bankswitch\": " << quote(info.BankSwitch) << "," << endl
+      << "  \"format\": " << quote(info.DisplayFormat) << "," << endl
+      << "  \"frames\": " << frames << "," << endl
+      << "  \"cycles\": " << cycles << "," << endl
+      << "  \"wall_seconds\": " << wall << "," << endl
+      << "  \"fps\": " << fps << "," << endl
+      << "  \"cpu_mhz\": " << mhz << "," << endl
+      << "  \"reused_frames\": " << reused << "," << endl
+      << "  \"seconds\": {";
+  for(int i = 0; i < Profiler::kNumSections; ++i)
+  {
+    Profiler::Section section = Profiler::Section(i);
+    buf << (i > 0 ? ", " : " ") << "\"" << Profiler::name(section) << "\": "
+        << profiler.seconds(section);
+  }
+  buf << " }" << endl << "}";
+
+  return buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::resetLoopTiming()
 {
@@ -640,7 +742,124 @@ uInt64 OSystem::getTicks() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::mainLoop()
 {
-  if(mySettings->getString("timing") == "sleep")
+  if(mySettings->getBool("headless"))
+  {
+    // Headless: no rendering and no wait between frames, so throughput is
+    // bounded only by the emulation core
+    uInt64 maxFrames = uInt64(std::max(mySettings->getInt("maxframes"), 0));
+
+    // 'Hold' events are released after half a second of emulated time,
+    // rather than by the (wallclock-based) event reset timer; a framerate
+    // that isn't known (or was set to 0) is taken to be NTSC's
+    const float framerate = myConsole->getFramerate() > 0 ?
+                            myConsole->getFramerate() : 60;
+    uInt64 releaseFrame = std::max(uInt64(framerate / 2), uInt64(1));
+
+    // When benchmarking, each frame is also rendered (to an offscreen
+    // surface), and the time spent in each subsystem is measured
+    bool benchmark = mySettings->getInt("benchmark") > 0;
+    Profiler profiler;
+    uInt64 startCycles = myConsole->system().totalCycles();
+    if(benchmark)
+      profiler.start();
+
+    // The sound can be written to a file, since there's no sound device
+    WavWriter wavWriter;
+    const string& wavFile = mySettings->getString("wavfile");
+    if(wavFile != "")
+    {
+      if(wavWriter.open(wavFile, uInt32(myConsole->audioSampleRate())))
+        myConsole->tia().setAudioCapture(&wavWriter);
+      else
+        logMessage("ERROR: Couldn't create WAV file " + wavFile, 0);
+    }
+
+    // A hash of the state after each frame can be written, to check that
+    // two runs are the same
+    const string& hashFile = mySettings->getString("hashfile");
+    ofstream hashes;
+    if(hashFile != "")
+    {
+      hashes.open(hashFile);
+      if(!hashes)
+        logMessage("ERROR: Couldn't create hash file " + hashFile, 0);
+    }
+
+    // The ARM code in Harmony/Melody carts can be profiled
+    const string& armProfile = mySettings->getString("armprofile");
+  #ifdef THUMB_SUPPORT
+    Thumbulator* thumbulator = myConsole->cartridge().thumbulator();
+    if(armProfile != "")
+    {
+      if(thumbulator)
+        thumbulator->enableProfiling(true);
+      else
+        logMessage("ERROR: There's no ARM code to profile", 0);
+    }
+  #endif
+
+    const bool movie = myStateManager->isPlayingMovie();
+    for(;;)
+    {
+      myTimingInfo.start = getTicks();
+      myEventHandler->poll(myTimingInfo.start);
+      if(myQuitLoop) break;  // Exit if the user wants to quit
+
+      // A movie being played back runs until it ends
+      if(movie && !myStateManager->isPlayingMovie()) break;
+
+      // There's no UI to leave any other mode, so we're done once
+      // emulation stops (ie, a breakpoint was hit)
+      if(myEventHandler->state() != EventHandler::S_EMULATE) break;
+
+      myConsole->tia().update();
+      if(myEventHandler->frying())
+        myConsole->fry();
+      if(benchmark && !myConsole->tia().frameSkipped())
+        myFrameBuffer->tiaSurface().render();
+
+      myTimingInfo.totalTime += (getTicks() - myTimingInfo.start);
+      if(hashes.is_open())
+        hashes << myTimingInfo.totalFrames << " "
+               << myStateManager->stateHash() << "\n";
+      if(++myTimingInfo.totalFrames == releaseFrame)
+        myEventHandler->clearEvents();
+      if(myTimingInfo.totalFrames == maxFrames) break;
+    }
+
+    if(benchmark)
+    {
+      profiler.stop();
+      cout << benchmarkReport(profiler,
+                myConsole->system().totalCycles() - startCycles) << endl;
+    }
+
+    if(hashes.is_open())
+    {
+      hashes.close();
+      if(!hashes)
+        logMessage("ERROR: Couldn't write hash file " + hashFile, 0);
+    }
+
+    if(wavWriter.isOpen())
+    {
+      myConsole->tia().setAudioCapture(nullptr);
+      if(!wavWriter.close())
+        logMessage("ERROR: Couldn't write WAV file " + wavFile, 0);
+    }
+
+  #ifdef THUMB_SUPPORT
+    if(armProfile != "" && thumbulator)
+    {
+      ofstream out(armProfile);
+      out << thumbulator->profileReport(0, true);
+      if(!out)
+        logMessage("ERROR: Couldn't write ARM profile " + armProfile, 0);
+      thumbulator->enableProfiling(false);
+    }
+  #endif
+  }
+  else if(mySettings->getString("timing") == "sleep")
   {
     // Sleep-based wait: good for CPU, bad for graphical sync
     for(;;)
@@ -28,7 +28,7 @@ class Launcher;
 class Menu;
 class Properties;
 class PropertiesSet;
-class Random;
+class Profiler;
 class SerialPort;
 class Settings;
 class Sound;
@@ -99,13 +99,6 @@ class OSystem
     */
     Settings& settings() const { return *mySettings; }
 
-    /**
-      Get the random object of the system.
-
-      @return The random object
-    */
-    Random& random() const { return *myRandom; }
-
     /**
       Get the set of game properties for the system.
 
@@ -295,6 +288,20 @@ class OSystem
     string createConsole(const FilesystemNode& rom, const string& md5 = "",
                          bool newrom = true);
 
+    /**
+      Creates a new game console from the given ROM image (which is already
+      in memory), and correctly initializes the system state to start
+      emulation of the Console.  This is used when there is no ROM file,
+      ie, when Stella is embedded in another application.
+
+      @param image  The ROM image data (a copy is made)
+      @param size   The size of the ROM image data
+      @param md5    The MD5sum of the ROM (calculated when empty)
+
+      @return  String indicating any error message (EmptyString for no errors)
+    */
+    string createConsole(const uInt8* image, uInt32 size, const string& md5 = "");
+
     /**
       Reloads the current console (essentially deletes and re-creates it).
       This can be thought of as a real console off/on toggle.
@@ -437,9 +444,6 @@ class OSystem
     // Pointer to the Settings object
     unique_ptr<Settings> mySettings;
 
-    // Pointer to the Random object
-    unique_ptr<Random> myRandom;
-
     // Pointer to the PropertiesSet object
     unique_ptr<PropertiesSet> myPropSet;
 
@@ -539,6 +543,33 @@ class OSystem
     unique_ptr<Console> openConsole(const FilesystemNode& romfile, string& md5,
                                     string& type, string& id);
 
+    /**
+      Creates an actual Console object based on the given ROM image.
+
+      @param image  The ROM image data
+      @param size   The size of the ROM image data
+      @param md5    The MD5sum of the ROM (calculated when empty)
+      @param type   The bankswitch type of the ROM
+      @param id     The additional id (if any) used by the ROM
+
+      @return  The actual Console object, otherwise nullptr.
+    */
+    unique_ptr<Console> openConsole(const BytePtr& image, uInt32 size,
+                                    string& md5, string& type, string& id);
+
+    /**
+      Finishes setting up a newly created console (debugger, cheats,
+      video/audio, held buttons, etc), so that emulation can start.
+
+      @param showmessage  Whether to show an onscreen message
+      @param type         The bankswitch type of the ROM
+      @param id           The additional id (if any) used by the ROM
+
+      @return  String indicating any error message (EmptyString for no errors)
+    */
+    string initializeConsole(bool showmessage, const string& type,
+                             const string& id);
+
     /**
       Close and finalize any currently open console.
     */
@@ -572,6 +603,16 @@ class OSystem
     */
     void resetLoopTiming();
 
+    /**
+      Creates the report for a benchmark run, in JSON format.
+
+      @param profiler  The profiler used during the run
+      @param cycles    The number of system cycles emulated during the run
+
+      @return  The JSON text of the report
+    */
+    string benchmarkReport(const Profiler& profiler, uInt64 cycles) const;
+
     /**
       Validate the directory name, and create it if necessary.
       Also, update the settings with the new name.  For now, validation
@@ -24,7 +24,9 @@ Paddles::Paddles(Jack jack, const Event& event, const System& system,
   : Controller(jack, event, system, Controller::Paddles),
     myMPaddleID(-1),
     myMPaddleIDX(-1),
-    myMPaddleIDY(-1)
+    myMPaddleIDY(-1),
+    mySwapDir(swapdir),
+    myTrigRange(TRIGMAX)
 {
   // We must start with minimum resistance; see commit
   // 38b452e1a047a0dca38c5bcce7c271d40f76736e for more information
@@ -197,9 +199,9 @@ Paddles::Paddles(Jack jack, const Event& event, const System& system,
   }
 
   // The following are independent of whether or not the port
-  // is left or right
-  MOUSE_SENSITIVITY = swapdir ? -abs(MOUSE_SENSITIVITY) :
-                                 abs(MOUSE_SENSITIVITY);
+  // is left or right; the console sets the sensitivity from its settings
+  setDigitalSensitivity(MAX_DIGITAL_SENSE / 2);
+  setMouseSensitivity(MAX_MOUSE_SENSE / 2);
   if(!swapaxis)
   {
     myAxisMouseMotion = Event::MouseAxisXValue;
@@ -222,7 +224,7 @@ Paddles::Paddles(Jack jack, const Event& event, const System& system,
   myKeyRepeat0 = myKeyRepeat1 = false;
   myPaddleRepeat0 = myPaddleRepeat1 = myLastAxisX = myLastAxisY = 0;
 
-  myCharge[0] = myCharge[1] = TRIGRANGE / 2;
+  myCharge[0] = myCharge[1] = myTrigRange / 2;
   myLastCharge[0] = myLastCharge[1] = 0;
 }
 
@@ -279,8 +281,8 @@ void Paddles::update()
   {
     // We're in auto mode, where a single axis is used for one paddle only
     myCharge[myMPaddleID] = BSPF::clamp(myCharge[myMPaddleID] -
-        (myEvent.get(myAxisMouseMotion) * MOUSE_SENSITIVITY),
-        TRIGMIN, TRIGRANGE);
+        (myEvent.get(myAxisMouseMotion) * myMouseSensitivity),
+        TRIGMIN, myTrigRange);
     if(myEvent.get(Event::MouseButtonLeftValue) ||
        myEvent.get(Event::MouseButtonRightValue))
       myDigitalPinState[ourButtonPin[myMPaddleID]] = false;
@@ -292,16 +294,16 @@ void Paddles::update()
     if(myMPaddleIDX > -1)
     {
       myCharge[myMPaddleIDX] = BSPF::clamp(myCharge[myMPaddleIDX] -
-          (myEvent.get(Event::MouseAxisXValue) * MOUSE_SENSITIVITY),
-          TRIGMIN, TRIGRANGE);
+          (myEvent.get(Event::MouseAxisXValue) * myMouseSensitivity),
+          TRIGMIN, myTrigRange);
       if(myEvent.get(Event::MouseButtonLeftValue))
         myDigitalPinState[ourButtonPin[myMPaddleIDX]] = false;
     }
     if(myMPaddleIDY > -1)
     {
       myCharge[myMPaddleIDY] = BSPF::clamp(myCharge[myMPaddleIDY] -
-          (myEvent.get(Event::MouseAxisYValue) * MOUSE_SENSITIVITY),
-          TRIGMIN, TRIGRANGE);
+          (myEvent.get(Event::MouseAxisYValue) * myMouseSensitivity),
+          TRIGMIN, myTrigRange);
       if(myEvent.get(Event::MouseButtonRightValue))
         myDigitalPinState[ourButtonPin[myMPaddleIDY]] = false;
     }
@@ -312,14 +314,14 @@ void Paddles::update()
   if(myKeyRepeat0)
   {
     myPaddleRepeat0++;
-    if(myPaddleRepeat0 > DIGITAL_SENSITIVITY)
-      myPaddleRepeat0 = DIGITAL_DISTANCE;
+    if(myPaddleRepeat0 > myDigitalSensitivity)
+      myPaddleRepeat0 = myDigitalDistance;
   }
   if(myKeyRepeat1)
   {
     myPaddleRepeat1++;
-    if(myPaddleRepeat1 > DIGITAL_SENSITIVITY)
-      myPaddleRepeat1 = DIGITAL_DISTANCE;
+    if(myPaddleRepeat1 > myDigitalSensitivity)
+      myPaddleRepeat1 = myDigitalDistance;
   }
 
   myKeyRepeat0 = false;
@@ -334,7 +336,7 @@ void Paddles::update()
   if(myEvent.get(myP0IncEvent1) || myEvent.get(myP0IncEvent2))
   {
     myKeyRepeat0 = true;
-    if((myCharge[myAxisDigitalZero] + myPaddleRepeat0) < TRIGRANGE)
+    if((myCharge[myAxisDigitalZero] + myPaddleRepeat0) < myTrigRange)
       myCharge[myAxisDigitalZero] += myPaddleRepeat0;
   }
   if(myEvent.get(myP1DecEvent1) || myEvent.get(myP1DecEvent2))
@@ -346,7 +348,7 @@ void Paddles::update()
   if(myEvent.get(myP1IncEvent1) || myEvent.get(myP1IncEvent2))
   {
     myKeyRepeat1 = true;
-    if((myCharge[myAxisDigitalOne] + myPaddleRepeat1) < TRIGRANGE)
+    if((myCharge[myAxisDigitalOne] + myPaddleRepeat1) < myTrigRange)
       myCharge[myAxisDigitalOne] += myPaddleRepeat1;
   }
 
@@ -399,28 +401,24 @@ bool Paddles::setMouseControl(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Paddles::setDigitalSensitivity(int sensitivity)
 {
-  DIGITAL_SENSITIVITY = BSPF::clamp(sensitivity, 1, MAX_DIGITAL_SENSE);
-  DIGITAL_DISTANCE = 20 + (DIGITAL_SENSITIVITY << 3);
+  myDigitalSensitivity = BSPF::clamp(sensitivity, 1, MAX_DIGITAL_SENSE);
+  myDigitalDistance = 20 + (myDigitalSensitivity << 3);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Paddles::setMouseSensitivity(int sensitivity)
 {
-  MOUSE_SENSITIVITY = BSPF::clamp(sensitivity, 1, MAX_MOUSE_SENSE);
+  myMouseSensitivity = BSPF::clamp(sensitivity, 1, MAX_MOUSE_SENSE);
+  if(mySwapDir)
+    myMouseSensitivity = -myMouseSensitivity;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Paddles::setPaddleRange(int range)
 {
   range = BSPF::clamp(range, 1, 100);
-  TRIGRANGE = int(TRIGMAX * (range / 100.0));
+  myTrigRange = int(TRIGMAX * (range / 100.0));
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-int Paddles::TRIGRANGE = Paddles::TRIGMAX;
-int Paddles::DIGITAL_SENSITIVITY = -1;
-int Paddles::DIGITAL_DISTANCE = -1;
-int Paddles::MOUSE_SENSITIVITY = -1;
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const Controller::DigitalPin Paddles::ourButtonPin[2] = { Four, Three };
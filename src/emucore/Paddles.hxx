@@ -82,7 +82,7 @@ class Paddles : public Controller
       @param sensitivity  Value from 1 to MAX_DIGITAL_SENSE, with larger
                           values causing more movement
     */
-    static void setDigitalSensitivity(int sensitivity);
+    void setDigitalSensitivity(int sensitivity);
 
     /**
       Sets the sensitivity for analog emulation of paddle movement
@@ -91,7 +91,7 @@ class Paddles : public Controller
       @param sensitivity  Value from 1 to MAX_MOUSE_SENSE, with larger
                           values causing more movement
     */
-    static void setMouseSensitivity(int sensitivity);
+    void setMouseSensitivity(int sensitivity);
 
     /**
       Sets the maximum upper range for digital/mouse emulation of paddle
@@ -99,10 +99,10 @@ class Paddles : public Controller
       range of movement).  Note that this specfically does not apply to
       Stelladaptor-like devices, which uses an absolute value range.
 
-      @param sensitivity  Value from 1 to 100, representing the percentage
-                          of the range to use
+      @param range  Value from 1 to 100, representing the percentage
+                    of the range to use
     */
-    static void setPaddleRange(int range);
+    void setPaddleRange(int range);
 
     static constexpr double MAX_RESISTANCE = 1400000.0;
 
@@ -124,17 +124,18 @@ class Paddles : public Controller
     int myCharge[2], myLastCharge[2];
     int myLastAxisX, myLastAxisY;
     int myAxisDigitalZero, myAxisDigitalOne;
+    bool mySwapDir;
 
     // Range of values over which digital and mouse movement is scaled
     // to paddle resistance
     static const int TRIGMIN = 1;
     static const int TRIGMAX = 4096;
-    static int TRIGRANGE;  // This one is variable for the upper range
+    int myTrigRange;  // This one is variable for the upper range
 
     static const int MAX_DIGITAL_SENSE = 20;
     static const int MAX_MOUSE_SENSE = 20;
-    static int DIGITAL_SENSITIVITY, DIGITAL_DISTANCE;
-    static int MOUSE_SENSITIVITY;
+    int myDigitalSensitivity, myDigitalDistance;
+    int myMouseSensitivity;  // Negative when the direction is swapped
 
     // Lookup table for associating paddle buttons with controller pins
     // Yes, this is hideously complex
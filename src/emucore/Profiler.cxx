@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "Profiler.hxx"
+
+thread_local Profiler* Profiler::ourCurrent = nullptr;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Profiler::Profiler()
+  : myActive(kOther),
+    myClockCost(Clock::duration::zero()),
+    myRandom(1)
+{
+  for(auto& total: myTotals)
+    total = Clock::duration::zero();
+  resetSampling();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Profiler::~Profiler()
+{
+  if(ourCurrent == this)
+    ourCurrent = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Profiler::start()
+{
+  for(auto& total: myTotals)
+    total = Clock::duration::zero();
+
+  // Measure how long it takes to read the clock, so sampled sections
+  // aren't charged for it many times over
+  constexpr int kClockReads = 1000;
+  const Clock::time_point first = Clock::now();
+  for(int i = 1; i < kClockReads; ++i)
+    myMark = Clock::now();
+  myClockCost = (myMark - first) / (kClockReads - 1);
+
+  myActive = kOther;
+  myMark = Clock::now();
+  myRandom = 1;
+  resetSampling();
+  ourCurrent = this;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Profiler::stop()
+{
+  if(ourCurrent == this)
+  {
+    enter(kOther);
+    ourCurrent = nullptr;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Profiler::nextSample(Sampling& sampling)
+{
+  // The intervals vary between 1 and 2 * kSampleInterval - 1 calls, so that
+  // the samples can't keep falling on the same kind of call
+  const uInt32 weight = sampling.interval;
+  myRandom = myRandom * 1103515245 + 12345;
+  sampling.interval = 1 + (myRandom >> 16) % (2 * kSampleInterval - 1);
+  sampling.countdown = sampling.interval;
+
+  return weight;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Profiler::resetSampling()
+{
+  for(auto& sections: mySampling)
+    for(auto& sampling: sections)
+      sampling.countdown = sampling.interval = 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Profiler::seconds(Section section) const
+{
+  return std::chrono::duration<double>(myTotals[section]).count();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Profiler::totalSeconds() const
+{
+  Clock::duration total = Clock::duration::zero();
+  for(const auto& t: myTotals)
+    total += t;
+
+  return std::chrono::duration<double>(total).count();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* Profiler::name(Section section)
+{
+  static const char* const ourNames[kNumSections] = {
+    "other", "cpu", "tia", "render", "arm", "audio"
+  };
+  return ourNames[section];
+}
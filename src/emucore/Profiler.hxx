@@ -0,0 +1,252 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef PROFILER_HXX
+#define PROFILER_HXX
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  A simple wallclock profiler, used for benchmarking the emulation core.
+
+  Each subsystem of interest marks its entry point with a Profiler::Scope
+  object.  Time is charged exclusively, so time spent in a nested section
+  (ie, the TIA being updated from within the CPU) is only charged to the
+  innermost section.
+
+  A profiler only collects data for the thread that started it, and
+  scopes entered while no profiler is active cost a single test.
+
+  Code that runs too often (and too briefly) to read the clock every time
+  uses a SampledScope instead, which only times some of the calls, and
+  charges each of those for the calls in between.
+*/
+class Profiler
+{
+  public:
+    enum Section {
+      kOther,   // anything not covered below (event handling, etc)
+      kCPU,     // M6502::execute
+      kTIA,     // TIA::cycle (sampled)
+      kRender,  // TIASurface::render
+      kARM,     // Thumbulator::run
+      kAudio,   // TIA sound generation (sampled) and Sound::processSamples
+      kNumSections
+    };
+
+    /**
+      Charges all time from its creation until its destruction to the
+      given section of the active profiler (if any).
+    */
+    class Scope
+    {
+      public:
+        explicit Scope(Section section)
+          : myProfiler(ourCurrent), myPrevious(kOther)
+        {
+          if(myProfiler)
+            myPrevious = myProfiler->enter(section);
+        }
+        ~Scope()
+        {
+          if(myProfiler)
+            myProfiler->enter(myPrevious);
+        }
+
+      private:
+        Profiler* myProfiler;
+        Section myPrevious;
+
+      private:
+        // Following constructors and assignment operators not supported
+        Scope() = delete;
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+    /**
+      Like Scope, but only times about one in every kSampleInterval calls,
+      and charges each of those for all the calls since the previous one.
+      The calls that aren't timed are charged to the section they're made
+      from, so the calls are counted separately for each enclosing section,
+      and the extra time of a sample comes off the section it's made from.
+    */
+    class SampledScope
+    {
+      public:
+        explicit SampledScope(Section section)
+          : myProfiler(ourCurrent), myPrevious(kOther), myWeight(0)
+        {
+          if(myProfiler)
+          {
+            Sampling& sampling =
+                myProfiler->mySampling[section][myProfiler->myActive];
+            if(--sampling.countdown > 0)
+              myProfiler = nullptr;
+            else
+            {
+              myWeight = myProfiler->nextSample(sampling);
+              myPrevious = myProfiler->enter(section);
+            }
+          }
+        }
+        ~SampledScope()
+        {
+          if(myProfiler)
+            myProfiler->leave(myPrevious, myWeight);
+        }
+
+      private:
+        Profiler* myProfiler;
+        Section myPrevious;
+        uInt32 myWeight;
+
+      private:
+        // Following constructors and assignment operators not supported
+        SampledScope() = delete;
+        SampledScope(const SampledScope&) = delete;
+        SampledScope(SampledScope&&) = delete;
+        SampledScope& operator=(const SampledScope&) = delete;
+        SampledScope& operator=(SampledScope&&) = delete;
+    };
+
+  public:
+    Profiler();
+    ~Profiler();
+
+  public:
+    /**
+      Clear all statistics, and start collecting data for the calling
+      thread.  Any profiler previously active on this thread is stopped.
+    */
+    void start();
+
+    /**
+      Stop collecting data.
+    */
+    void stop();
+
+    /**
+      Answer the time (in seconds) charged to the given section.
+    */
+    double seconds(Section section) const;
+
+    /**
+      Answer the time (in seconds) charged to all sections.
+    */
+    double totalSeconds() const;
+
+    /**
+      Answer a short (lowercase) name for the given section.
+    */
+    static const char* name(Section section);
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    // The calls left until the next sample of a sampled section, and the
+    // number of calls in the current interval
+    struct Sampling
+    {
+      uInt32 countdown;
+      uInt32 interval;
+    };
+
+    /**
+      Charge the time since the last transition to the active section,
+      and make the given section active.
+
+      @return  The previously active section
+    */
+    Section enter(Section section)
+    {
+      const Clock::time_point now = Clock::now();
+      myTotals[myActive] += now - myMark;
+      myMark = now;
+
+      Section previous = myActive;
+      myActive = section;
+      return previous;
+    }
+
+    /**
+      Charge the time since the last transition to the active section, as
+      if it had been spent 'weight' times (the difference comes off the
+      given previous section), and make that section active again.
+      The cost of reading the clock is only charged once, since the calls
+      that weren't timed didn't read it.
+    */
+    void leave(Section previous, uInt32 weight)
+    {
+      const Clock::time_point now = Clock::now();
+      const Clock::duration spent = now - myMark;
+      const Clock::duration extra = spent > myClockCost ?
+          (spent - myClockCost) * (weight - 1) : Clock::duration::zero();
+      myTotals[myActive] += spent + extra;
+      myTotals[previous] -= extra;
+      myMark = now;
+      myActive = previous;
+    }
+
+    /**
+      Pick the number of calls until the next sample.
+
+      @return  The number of calls the current sample stands for
+    */
+    uInt32 nextSample(Sampling& sampling);
+
+    /**
+      Start sampling every section from its first call.
+    */
+    void resetSampling();
+
+  private:
+    // The average number of calls between samples in a SampledScope
+    static constexpr uInt32 kSampleInterval = 16;
+
+    // Time charged to each section so far
+    Clock::duration myTotals[kNumSections];
+
+    // The section currently being charged, and since when
+    Section myActive;
+    Clock::time_point myMark;
+
+    // The average time taken to read the clock (measured by start())
+    Clock::duration myClockCost;
+
+    // The sampling of each sampled section, from each enclosing section,
+    // and the state used to vary the intervals
+    Sampling mySampling[kNumSections][kNumSections];
+    uInt32 myRandom;
+
+    // The profiler collecting data for this thread (if any)
+    static thread_local Profiler* ourCurrent;
+
+  private:
+    // Following constructors and assignment operators not supported
+    Profiler(const Profiler&) = delete;
+    Profiler(Profiler&&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    Profiler& operator=(Profiler&&) = delete;
+};
+
+#endif
@@ -18,16 +18,21 @@
 #ifndef RANDOM_HXX
 #define RANDOM_HXX
 
-#include <time.h>
-
 #include "bspf.hxx"
 #include "OSystem.hxx"
+#include "Settings.hxx"
+#include "Serializer.hxx"
 
 /**
   This is a quick-and-dirty random number generator.  It is based on
   information in Chapter 7 of "Numerical Recipes in C".  It's a simple
   linear congruential generator.
 
+  Each console has its own generator, which is part of its state, so a
+  state that's loaded again gives the same numbers.  When the 'seed'
+  setting isn't 0, every console starts from that seed, so runs with the
+  same input are identical; otherwise the seed is taken from the time.
+
   @author  Bradford W. Mott
 */
 class Random
@@ -40,11 +45,13 @@ class Random
 
     /**
       Re-initialize the random number generator with a new seed,
-      to generate a different set of random numbers.
+      to generate a different set of random numbers (or the same set
+      again, when the seed is set).
     */
     void initSeed()
     {
-      myValue = uInt32(myOSystem.getTicks());
+      const Int32 seed = myOSystem.settings().getInt("seed");
+      myValue = seed != 0 ? uInt32(seed) : uInt32(myOSystem.getTicks());
     }
 
     /**
@@ -57,6 +64,12 @@ class Random
       return (myValue = (myValue * 2416 + 374441) % 1771875);
     }
 
+    /**
+      Save and load the state of the generator.
+    */
+    void save(Serializer& out) const { out.putInt(myValue); }
+    void load(Serializer& in) { myValue = in.getInt(); }
+
   private:
     // Set the OSystem we're using
     const OSystem& myOSystem;
@@ -0,0 +1,257 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "RewindBuffer.hxx"
+
+namespace {
+  // A run of this many identical bytes ends a run of differing bytes,
+  // since it takes less space to start a new pair of runs
+  constexpr uInt32 kMinSameRun = 4;
+
+  // The reference for keyframes, which are encoded against all zeros
+  const vector<uInt8> ourNoReference;
+
+  inline uInt8* putCount(uInt8* out, uInt32 count)
+  {
+    while(count >= 0x80)
+    {
+      *out++ = uInt8(count | 0x80);
+      count >>= 7;
+    }
+    *out++ = uInt8(count);
+
+    return out;
+  }
+
+  inline uInt32 getCount(const uInt8*& in)
+  {
+    uInt32 count = 0;
+    for(uInt32 shift = 0; ; shift += 7)
+    {
+      const uInt8 byte = *in++;
+      count |= uInt32(byte & 0x7F) << shift;
+      if(!(byte & 0x80))
+        return count;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindBuffer::RewindBuffer(uInt64 budget, uInt32 keyframeInterval)
+  : myBudget(budget),
+    myMemoryUsed(0),
+    myStateBytes(0),
+    myKeyframeInterval(std::max(keyframeInterval, 1u)),
+    mySinceKeyframe(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindBuffer::clear()
+{
+  myEntries.clear();
+  myMemoryUsed = myStateBytes = 0;
+  myKeyframe.clear();
+  mySinceKeyframe = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindBuffer::setBudget(uInt64 budget)
+{
+  myBudget = budget;
+  trim();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindBuffer::add(const uInt8* state, uInt32 size)
+{
+  const bool keyframe = myEntries.empty() ||
+                        mySinceKeyframe + 1 >= myKeyframeInterval;
+
+  Entry entry;
+  entry.size = encode(state, size, keyframe ? ourNoReference : myKeyframe);
+  entry.stateSize = size;
+  entry.keyframe = keyframe;
+  entry.data = make_ptr<uInt8[]>(entry.size);
+  memcpy(entry.data.get(), myScratch.data(), entry.size);
+
+  if(keyframe)
+  {
+    myKeyframe.assign(state, state + size);
+    mySinceKeyframe = 0;
+  }
+  else
+    ++mySinceKeyframe;
+
+  myMemoryUsed += entry.size + sizeof(Entry);
+  myStateBytes += size;
+  myEntries.push_back(std::move(entry));
+
+  trim();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindBuffer::last(vector<uInt8>& state)
+{
+  if(myEntries.empty())
+    return false;
+
+  const Entry& entry = myEntries.back();
+  decode(entry, entry.keyframe ? ourNoReference : myKeyframe, state);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindBuffer::removeLast()
+{
+  if(myEntries.empty())
+    return;
+
+  const Entry& entry = myEntries.back();
+  const bool keyframe = entry.keyframe;
+  myMemoryUsed -= entry.size + sizeof(Entry);
+  myStateBytes -= entry.stateSize;
+  myEntries.pop_back();
+
+  if(keyframe)
+    findKeyframe();
+  else
+    --mySinceKeyframe;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindBuffer::encode(const uInt8* state, uInt32 size,
+                            const vector<uInt8>& ref)
+{
+  // The difference from the reference is zero wherever they're the same
+  const uInt32 common = std::min(size, uInt32(ref.size()));
+  myDiff.resize(size);
+  uInt8* diff = myDiff.data();
+  uInt32 i = 0;
+  for(uInt64 a, b; i + 8 <= common; i += 8)
+  {
+    memcpy(&a, state + i, 8);
+    memcpy(&b, ref.data() + i, 8);
+    a ^= b;
+    memcpy(diff + i, &a, 8);
+  }
+  for(; i < common; ++i)
+    diff[i] = state[i] ^ ref[i];
+  memcpy(diff + common, state + common, size - common);
+
+  // At worst, there's a pair of counts (of at most 5 bytes each) for every
+  // kMinSameRun differing bytes
+  myScratch.resize(size + (size / kMinSameRun + 1) * 10);
+  uInt8* out = myScratch.data();
+
+  for(uInt32 pos = 0; pos < size; )
+  {
+    // A run of identical bytes, checked a word at a time where possible
+    uInt32 start = pos;
+    for(uInt64 word; pos + 8 <= size; pos += 8)
+    {
+      memcpy(&word, diff + pos, 8);
+      if(word != 0)
+        break;
+    }
+    while(pos < size && diff[pos] == 0)
+      ++pos;
+    out = putCount(out, pos - start);
+
+    // Then the differing bytes, up to the next long enough run of
+    // identical ones (which is left for the next pair)
+    start = pos;
+    uInt32 end = pos, same = 0;
+    while(pos < size && same < kMinSameRun)
+    {
+      if(diff[pos++] == 0)
+        ++same;
+      else
+      {
+        same = 0;
+        end = pos;
+      }
+    }
+    pos = end;
+
+    out = putCount(out, end - start);
+    memcpy(out, diff + start, end - start);
+    out += end - start;
+  }
+
+  return uInt32(out - myScratch.data());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindBuffer::decode(const Entry& entry, const vector<uInt8>& ref,
+                          vector<uInt8>& state)
+{
+  const uInt32 size = entry.stateSize;
+  const uInt32 common = std::min(size, uInt32(ref.size()));
+  state.resize(size);
+  uInt8* out = state.data();
+  memcpy(out, ref.data(), common);
+  memset(out + common, 0, size - common);
+
+  const uInt8* in = entry.data.get();
+  for(uInt32 pos = 0; pos < size; )
+  {
+    pos += getCount(in);
+
+    const uInt32 count = getCount(in);
+    for(uInt32 i = 0; i < count; ++i)
+      out[pos + i] ^= in[i];
+    in += count;
+    pos += count;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindBuffer::findKeyframe()
+{
+  myKeyframe.clear();
+  mySinceKeyframe = 0;
+
+  for(auto entry = myEntries.rbegin(); entry != myEntries.rend(); ++entry)
+  {
+    if(entry->keyframe)
+    {
+      decode(*entry, ourNoReference, myKeyframe);
+      return;
+    }
+    ++mySinceKeyframe;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindBuffer::trim()
+{
+  // The states from the newest keyframe on are always kept
+  while(myMemoryUsed > myBudget && myEntries.size() > mySinceKeyframe + 1)
+  {
+    do
+    {
+      const Entry& entry = myEntries.front();
+      myMemoryUsed -= entry.size + sizeof(Entry);
+      myStateBytes -= entry.stateSize;
+      myEntries.pop_front();
+    }
+    while(!myEntries.front().keyframe);
+  }
+}
@@ -0,0 +1,151 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef REWIND_BUFFER_HXX
+#define REWIND_BUFFER_HXX
+
+#include <deque>
+
+#include "bspf.hxx"
+
+/**
+  This class holds a history of saved states, for rewinding the emulation,
+  within a fixed amount of memory.  States are added as they're captured,
+  and taken back, newest first, while rewinding.
+
+  Every so often, a state is kept as a keyframe; the states in between are
+  only kept as the difference from the keyframe before them (the bytes
+  that differ, found by XOR, with the runs of identical bytes left out).
+  Most of a state doesn't change from one frame to the next, so these are
+  a small fraction of the size of the state.  Keyframes are run-length
+  encoded the same way, as the difference from all zeros.
+
+  When the memory is used up, the oldest keyframe is dropped, together
+  with the states that depend on it.
+*/
+class RewindBuffer
+{
+  public:
+    /**
+      Create a buffer that holds at most the given number of bytes of
+      (encoded) states, with a keyframe every given number of states.
+    */
+    RewindBuffer(uInt64 budget, uInt32 keyframeInterval);
+
+  public:
+    /**
+      Drop all the states.
+    */
+    void clear();
+
+    /**
+      Change the most memory to use; the oldest states are dropped if
+      they no longer fit.
+    */
+    void setBudget(uInt64 budget);
+
+    /**
+      Add a state, as the newest one.
+    */
+    void add(const uInt8* state, uInt32 size);
+
+    /**
+      Get a copy of the newest state.
+
+      @return  False if there are no states, else true
+    */
+    bool last(vector<uInt8>& state);
+
+    /**
+      Drop the newest state, so the one before it becomes the newest.
+    */
+    void removeLast();
+
+    /**
+      Answers the number of states held.
+    */
+    uInt32 size() const { return uInt32(myEntries.size()); }
+
+    /**
+      Answers the memory used by the (encoded) states, in bytes.
+    */
+    uInt64 memoryUsed() const { return myMemoryUsed; }
+
+    /**
+      Answers the total size of the states held, before they were encoded.
+    */
+    uInt64 stateBytes() const { return myStateBytes; }
+
+  private:
+    struct Entry {
+      unique_ptr<uInt8[]> data;
+      uInt32 size;       // encoded size
+      uInt32 stateSize;  // size of the state itself
+      bool keyframe;
+    };
+
+    // Encode the difference between the given state and reference (which
+    // is taken to be zeros past its end) into myScratch, answering the
+    // encoded size
+    uInt32 encode(const uInt8* state, uInt32 size, const vector<uInt8>& ref);
+
+    // Decode an entry, against the given reference, into 'state'
+    static void decode(const Entry& entry, const vector<uInt8>& ref,
+                       vector<uInt8>& state);
+
+    // Set myKeyframe and mySinceKeyframe from the newest keyframe held
+    void findKeyframe();
+
+    // Drop the oldest keyframe and the states that depend on it, until
+    // the memory used fits within the budget (the newest keyframe is
+    // always kept)
+    void trim();
+
+  private:
+    // The states, oldest first; the first one is always a keyframe
+    std::deque<Entry> myEntries;
+
+    // The most memory to use, the memory used (including the bookkeeping
+    // for each state), and the size of the states before they were encoded
+    uInt64 myBudget;
+    uInt64 myMemoryUsed;
+    uInt64 myStateBytes;
+
+    // The number of states from one keyframe to the next
+    uInt32 myKeyframeInterval;
+
+    // The newest keyframe held (decoded), which later states are encoded
+    // against, and the number of states held after it
+    vector<uInt8> myKeyframe;
+    uInt32 mySinceKeyframe;
+
+    // The difference from the reference, and its encoding, for the state
+    // being added
+    vector<uInt8> myDiff;
+    vector<uInt8> myScratch;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RewindBuffer() = delete;
+    RewindBuffer(const RewindBuffer&) = delete;
+    RewindBuffer(RewindBuffer&&) = delete;
+    RewindBuffer& operator=(const RewindBuffer&) = delete;
+    RewindBuffer& operator=(RewindBuffer&&) = delete;
+};
+
+#endif
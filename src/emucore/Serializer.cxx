@@ -16,31 +16,23 @@
 //============================================================================
 
 #include <fstream>
-#include <sstream>
 
 #include "FSNode.hxx"
 #include "Serializer.hxx"
 
 using std::ios;
-using std::ios_base;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer(const string& filename, bool readonly)
-  : myStream(nullptr)
+  : Serializer()
 {
+  myValid = false;
+
   if(readonly)
   {
     FilesystemNode node(filename);
-    if(node.isFile() && node.isReadable())
-    {
-      unique_ptr<fstream> str = make_ptr<fstream>(filename, ios::in | ios::binary);
-      if(str && str->is_open())
-      {
-        myStream = std::move(str);
-        myStream->exceptions( ios_base::failbit | ios_base::badbit | ios_base::eofbit );
-        reset();
-      }
-    }
+    if(!node.isFile() || !node.isReadable())
+      return;
   }
   else
   {
@@ -53,164 +45,183 @@ Serializer::Serializer(const string& filename, bool readonly)
     // already exists
     fstream temp(filename, ios::out | ios::app);
     temp.close();
-
-    unique_ptr<fstream> str = make_ptr<fstream>(filename, ios::in | ios::out | ios::binary);
-    if(str && str->is_open())
-    {
-      myStream = std::move(str);
-      myStream->exceptions( ios_base::failbit | ios_base::badbit | ios_base::eofbit );
-      reset();
-    }
   }
-}
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Serializer::Serializer()
-  : myStream(nullptr)
-{
-  myStream = make_ptr<stringstream>(ios::in | ios::out | ios::binary);
+  // The whole file is read into memory, and written back (if it was
+  // changed) when we're destroyed
+  ifstream in(filename, ios::in | ios::binary);
+  if(!in.is_open())
+    return;
 
-  // For some reason, Windows and possibly OSX needs to store something in
-  // the stream before it is used for the first time
-  if(myStream)
+  in.seekg(0, ios::end);
+  const std::streamoff length = in.tellg();
+  in.seekg(0, ios::beg);
+  if(length < 0)
+    return;
+
+  reserve(uInt32(length));
+  if(length > 0 && !in.read(reinterpret_cast<char*>(myData), length))
+    return;
+
+  myEnd = uInt32(length);
+  myValid = true;
+  if(readonly)
   {
-    myStream->exceptions( ios_base::failbit | ios_base::badbit | ios_base::eofbit );
-    putBool(true);
-    reset();
+    myCapacity = 0;
+    myReadOnly = true;
   }
+  else
+    myFilename = filename;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::reset()
+Serializer::Serializer()
+  : myData(nullptr),
+    myCapacity(0),
+    myEnd(0),
+    myReadPos(0),
+    myWritePos(0),
+    myValid(true),
+    myReadOnly(false),
+    myChanged(false)
 {
-  myStream->clear();
-  myStream->seekg(ios_base::beg);
-  myStream->seekp(ios_base::beg);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 Serializer::getByte() const
+Serializer::Serializer(const uInt8* data, uInt32 size)
+  : myData(const_cast<uInt8*>(data)),
+    myCapacity(0),
+    myEnd(size),
+    myReadPos(0),
+    myWritePos(0),
+    myValid(data != nullptr),
+    myReadOnly(true),
+    myChanged(false)
 {
-  char buf;
-  myStream->read(&buf, 1);
-
-  return buf;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getByteArray(uInt8* array, uInt32 size) const
+Serializer::~Serializer()
 {
-  myStream->read(reinterpret_cast<char*>(array), size);
+  flush();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt16 Serializer::getShort() const
+bool Serializer::flush()
 {
-  uInt16 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt16));
+  if(!myChanged || myFilename == "")
+    return true;
+
+  ofstream out(myFilename, ios::out | ios::binary | ios::trunc);
+  out.write(reinterpret_cast<const char*>(myData), myEnd);
+  out.close();
+  if(out.fail())
+    return false;
 
-  return val;
+  myChanged = false;
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getShortArray(uInt16* array, uInt32 size) const
+void Serializer::reset()
 {
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt16)*size);
+  myReadPos = myWritePos = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Serializer::getInt() const
+void Serializer::reserve(uInt32 size)
 {
-  uInt32 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt32));
+  if(size <= myCapacity - myWritePos)
+    return;
+
+  if(myReadOnly)
+    throw runtime_error("Serializer: can't write to read-only data");
+  if(size > 0xFFFFFFFFu - myWritePos)
+    throw runtime_error("Serializer: data too large");
 
-  return val;
+  // Grow by at least half again, so a series of writes only copies the
+  // data a few times
+  uInt32 capacity = std::max(myWritePos + size, 4096u);
+  if(myCapacity < 0x80000000u)
+    capacity = std::max(capacity, myCapacity + myCapacity / 2);
+
+  unique_ptr<uInt8[]> buffer = make_ptr<uInt8[]>(capacity);
+  if(myEnd > 0)
+    std::memcpy(buffer.get(), myData, myEnd);
+
+  myBuffer = std::move(buffer);
+  myData = myBuffer.get();
+  myCapacity = capacity;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getIntArray(uInt32* array, uInt32 size) const
+void Serializer::readError() const
 {
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt32)*size);
+  throw runtime_error("Serializer: read past the end of the data");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Serializer::getDouble() const
+void Serializer::getByteArray(uInt8* array, uInt32 size) const
 {
-  double val = 0.0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(double));
+  if(size > myEnd - myReadPos)
+    readError();
 
-  return val;
+  std::memcpy(array, myData + myReadPos, size);
+  myReadPos += size;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Serializer::getString() const
+void Serializer::getShortArray(uInt16* array, uInt32 size) const
 {
-  int len = getInt();
-  string str;
-  str.resize(len);
-  myStream->read(&str[0], len);
-
-  return str;
+  getByteArray(reinterpret_cast<uInt8*>(array), sizeof(uInt16)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Serializer::getBool() const
+void Serializer::getIntArray(uInt32* array, uInt32 size) const
 {
-  return getByte() == TruePattern;
+  getByteArray(reinterpret_cast<uInt8*>(array), sizeof(uInt32)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByte(uInt8 value)
+string Serializer::getString() const
 {
-  myStream->write(reinterpret_cast<char*>(&value), 1);
+  const uInt32 len = getInt();
+  if(len > myEnd - myReadPos)
+    readError();
+
+  string str(reinterpret_cast<const char*>(myData + myReadPos), len);
+  myReadPos += len;
+
+  return str;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putByteArray(const uInt8* array, uInt32 size)
 {
-  myStream->write(reinterpret_cast<const char*>(array), size);
-}
+  reserve(size);
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShort(uInt16 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt16));
+  std::memcpy(myData + myWritePos, array, size);
+  myWritePos += size;
+  myEnd = std::max(myEnd, myWritePos);
+  myChanged = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putShortArray(const uInt16* array, uInt32 size)
 {
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt16)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putInt(uInt32 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt32));
+  putByteArray(reinterpret_cast<const uInt8*>(array), sizeof(uInt16)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putIntArray(const uInt32* array, uInt32 size)
 {
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt32)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putDouble(double value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(double));
+  putByteArray(reinterpret_cast<const uInt8*>(array), sizeof(uInt32)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putString(const string& str)
 {
-  int len = int(str.length());
+  const uInt32 len = uInt32(str.length());
   putInt(len);
-  myStream->write(str.data(), len);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putBool(bool b)
-{
-  putByte(b ? TruePattern: FalsePattern);
+  putByteArray(reinterpret_cast<const uInt8*>(str.data()), len);
 }
@@ -18,13 +18,13 @@
 #ifndef SERIALIZER_HXX
 #define SERIALIZER_HXX
 
-#include <iostream>
 #include "bspf.hxx"
 
 /**
   This class implements a Serializer device, whereby data is serialized and
   read from/written to a binary stream in a system-independent way.  The
-  stream can be either an actual file, or an in-memory structure.
+  stream can be either an actual file, an in-memory structure, or a block
+  of memory supplied by the caller (which can only be read).
 
   Bytes are written as characters, shorts as 2 characters (16-bits),
   integers as 4 characters (32-bits), strings are written as characters
@@ -34,6 +34,14 @@
   All bytes, shorts and ints should be cast to their appropriate data type upon
   method return.
 
+  The data is always held in one contiguous block of memory, which grows as
+  needed, and single values are read and written inline, so saving and
+  loading a complete state is little more than a series of copies.  A file
+  is read into memory when it's opened, and written back by flush(), or
+  when the Serializer is destroyed, if anything was written to it.  Reading past
+  the end of the data, or writing to data that's read-only, throws a
+  runtime_error exception.
+
   @author  Stephen Anthony
 */
 class Serializer
@@ -53,18 +61,51 @@ class Serializer
     Serializer(const string& filename, bool readonly = false);
     Serializer();
 
+    /**
+      Creates a new Serializer device for reading the given block of
+      memory, which is used in place (not copied), and so must remain
+      valid while the Serializer is being used.  It can't be written to.
+
+      @param data  The data to read
+      @param size  The size of the data, in bytes
+    */
+    Serializer(const uInt8* data, uInt32 size);
+
+    ~Serializer();
+
   public:
     /**
       Answers whether the serializer is currently initialized for reading
       and writing.
     */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const { return myValid; }
 
     /**
       Resets the read/write location to the beginning of the stream.
     */
     void reset();
 
+    /**
+      Answer the current write location (ie, the number of bytes written
+      since the last reset).
+    */
+    uInt32 size() const { return myWritePos; }
+
+    /**
+      Answer the data held (ie, the bytes written since the last reset are
+      the first size() bytes).
+    */
+    const uInt8* data() const { return myData; }
+
+    /**
+      Writes the data back to the file it was read from, if anything was
+      written since it was opened (or last flushed).  Otherwise, and for
+      data that isn't from a file, there's nothing to do.
+
+      @return  False if the file couldn't be written
+    */
+    bool flush();
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -198,8 +239,40 @@ class Serializer
     void putBool(bool b);
 
   private:
-    // The stream to send the serialized data to.
-    unique_ptr<iostream> myStream;
+    // Read or write a single value, in the machine's byte order
+    template<typename T> T get() const;
+    template<typename T> void put(T value);
+
+    // Make sure there's room to write the given number of bytes, growing
+    // the buffer as necessary
+    void reserve(uInt32 size);
+
+    // Throw an exception for a read past the end of the data
+    [[noreturn]] void readError() const;
+
+  private:
+    // The data; it's either owned and grows as needed, or (for read-only
+    // data supplied by the caller) the caller's memory
+    unique_ptr<uInt8[]> myBuffer;
+    uInt8* myData;
+
+    // The room for writing, which is always 0 for read-only data, so
+    // every write goes through reserve()
+    uInt32 myCapacity;
+
+    // The number of bytes of data held, and the read and write locations
+    uInt32 myEnd;
+    mutable uInt32 myReadPos;
+    uInt32 myWritePos;
+
+    // Whether the serializer could be opened, can't be written to, and has
+    // been written to
+    bool myValid;
+    bool myReadOnly;
+    bool myChanged;
+
+    // The file the data is written back to, if any
+    string myFilename;
 
     enum {
       TruePattern  = 0xfe,
@@ -214,4 +287,54 @@ class Serializer
     Serializer& operator=(Serializer&&) = delete;
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename T>
+inline T Serializer::get() const
+{
+  if(sizeof(T) > myEnd - myReadPos)
+    readError();
+
+  T value;
+  std::memcpy(&value, myData + myReadPos, sizeof(T));
+  myReadPos += sizeof(T);
+
+  return value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename T>
+inline void Serializer::put(T value)
+{
+  if(sizeof(T) > myCapacity - myWritePos)
+    reserve(sizeof(T));
+
+  std::memcpy(myData + myWritePos, &value, sizeof(T));
+  myWritePos += sizeof(T);
+  myEnd = std::max(myEnd, myWritePos);
+  myChanged = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt8 Serializer::getByte() const    { return get<uInt8>();  }
+inline uInt16 Serializer::getShort() const  { return get<uInt16>(); }
+inline uInt32 Serializer::getInt() const    { return get<uInt32>(); }
+inline double Serializer::getDouble() const { return get<double>(); }
+
+inline void Serializer::putByte(uInt8 value)    { put(value); }
+inline void Serializer::putShort(uInt16 value)  { put(value); }
+inline void Serializer::putInt(uInt32 value)    { put(value); }
+inline void Serializer::putDouble(double value) { put(value); }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool Serializer::getBool() const
+{
+  return getByte() == TruePattern;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Serializer::putBool(bool b)
+{
+  putByte(b ? TruePattern : FalsePattern);
+}
+
 #endif
@@ -72,7 +72,7 @@ Settings::Settings(OSystem& osystem)
 
   // Sound options
   setInternal("sound", "true");
-  setInternal("fragsize", "512");
+  setInternal("fragsize", "256");
   setInternal("freq", "31400");
   setInternal("volume", "100");
 
@@ -127,6 +127,9 @@ Settings::Settings(OSystem& osystem)
 
   // Misc options
   setInternal("autoslot", "false");
+  setInternal("rewind", "true");
+  setInternal("rewindint", "4");
+  setInternal("rewindsize", "64");
   setInternal("loglevel", "1");
   setInternal("logtoconsole", "0");
   setInternal("tiadriven", "false");
@@ -137,6 +140,17 @@ Settings::Settings(OSystem& osystem)
   setInternal("fastscbios", "false");
   setExternal("romloadcount", "0");
   setExternal("maxres", "");
+  setExternal("headless", "false");
+  setExternal("maxframes", "0");
+  setExternal("wavfile", "");
+  setExternal("armprofile", "");
+  setExternal("recordmovie", "");
+  setExternal("playmovie", "");
+  setExternal("movieseek", "0");
+  setExternal("hashfile", "");
+  setExternal("seed", "0");
+  setExternal("frameskip", "0");
+  setExternal("benchmark", "0");
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger/disassembly options
@@ -152,6 +166,9 @@ Settings::Settings(OSystem& osystem)
   // Thumb ARM emulation options
   setInternal("thumb.trapfatal", "true");
 #endif
+#ifdef THUMB_SUPPORT
+  setInternal("thumb.translate", "true");
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -219,7 +236,7 @@ string Settings::loadCommandLine(int argc, char** argv)
       // Take care of arguments without an option or ones that shouldn't
       // be saved to the config file
       if(key == "rominfo" || key == "debug" || key == "holdreset" ||
-         key == "holdselect" || key == "takesnapshot")
+         key == "holdselect" || key == "takesnapshot" || key == "headless")
       {
         setExternal(key, "true");
         continue;
@@ -307,6 +324,14 @@ void Settings::validate()
   if(i < 1)        setInternal("ssinterval", "2");
   else if(i > 10)  setInternal("ssinterval", "10");
 
+  i = getInt("rewindint");
+  if(i < 1)        setInternal("rewindint", "1");
+  else if(i > 60)  setInternal("rewindint", "60");
+
+  i = getInt("rewindsize");
+  if(i < 1)          setInternal("rewindsize", "1");
+  else if(i > 1024)  setInternal("rewindsize", "1024");
+
   s = getString("palette");
   if(s != "standard" && s != "z26" && s != "user")
     setInternal("palette", "standard");
@@ -322,6 +347,15 @@ void Settings::validate()
   i = getInt("loglevel");
   if(i < 0 || i > 2)
     setInternal("loglevel", "1");
+
+  // A benchmark is simply a headless run for a fixed number of frames
+  i = getInt("benchmark");
+  if(i < 0)  setExternal("benchmark", "0");
+  else if(i > 0)
+  {
+    setExternal("headless", "true");
+    setExternal("maxframes", getString("benchmark"));
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -400,6 +434,9 @@ void Settings::usage() const
     << "  -saport       <lr|rl>        How to assign virtual ports to multiple Stelladaptor/2600-daptors\n"
     << "  -ctrlcombo    <1|0>          Use key combos involving the Control key (Control-Q for quit may be disabled!)\n"
     << "  -autoslot     <1|0>          Automatically switch to next save slot when state saving\n"
+    << "  -rewind       <1|0>          Keep a history of states, for rewinding while a key is held\n"
+    << "  -rewindint    <frames>       Number of frames between the states kept for rewinding\n"
+    << "  -rewindsize   <MB>           Most memory to use for the states kept for rewinding\n"
     << "  -stats        <1|0>          Overlay console info during emulation\n"
     << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
     << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
@@ -437,6 +474,17 @@ void Settings::usage() const
     << "  -cpurandom    <1|0>          Randomize the contents of CPU registers on reset\n"
     << "  -ramrandom    <1|0>          Randomize the contents of RAM on reset\n"
     << "  -maxres       <WxH>          Used by developers to force the maximum size of the application window\n"
+    << "  -headless                    Run the given ROM with no window, sound or frame pacing\n"
+    << "  -maxframes    <number>       Exit headless mode after the given number of frames (0 for no limit)\n"
+    << "  -wavfile      <filename>     In headless mode, write the sound generated to the given WAV file\n"
+    << "  -armprofile   <filename>     In headless mode, write a profile of the ARM code (DPC+/CDF/BUS) to the given file\n"
+    << "  -hashfile     <filename>     In headless mode, write a hash of the state after each frame to the given file\n"
+    << "  -seed         <number>       Seed the random numbers used by the emulation, so runs with the same input are identical (0 uses the time)\n"
+    << "  -recordmovie  <filename>     Record a movie of the input while playing the given ROM into the given file\n"
+    << "  -playmovie    <filename>     Play back a movie recorded with -recordmovie (in headless mode, exit when it ends)\n"
+    << "  -movieseek    <frame>        Start playing back the movie (-playmovie) from the given frame\n"
+    << "  -frameskip    <number>       Emulate the given number of frames without drawing them, after each one drawn\n"
+    << "  -benchmark    <number>       Run headless for the given number of frames, and print timing statistics as JSON\n"
     << "  -help                        Show the text you're now reading\n"
   #ifdef DEBUGGER_SUPPORT
     << endl
@@ -20,7 +20,6 @@
 
 class OSystem;
 
-#include "Serializable.hxx"
 #include "bspf.hxx"
 
 /**
@@ -29,7 +28,7 @@ class OSystem;
 
   @author Stephen Anthony
 */
-class Sound : public Serializable
+class Sound
 {
   public:
     /**
@@ -47,14 +46,6 @@ class Sound : public Serializable
     */
     virtual void setEnabled(bool enable) = 0;
 
-    /**
-      The system cycle counter is being adjusting by the specified amount.  Any
-      members using the system cycle counter should be adjusted as needed.
-
-      @param amount The amount the cycle counter is being adjusted by
-    */
-    virtual void adjustCycleCounter(Int32 amount) = 0;
-
     /**
       Sets the number of channels (mono or stereo sound).
 
@@ -62,14 +53,6 @@ class Sound : public Serializable
     */
     virtual void setChannels(uInt32 channels) = 0;
 
-    /**
-      Sets the display framerate.  Sound generation for NTSC and PAL games
-      depends on the framerate, so we need to set it here.
-
-      @param framerate The base framerate depending on NTSC or PAL ROM
-    */
-    virtual void setFrameRate(float framerate) = 0;
-
     /**
       Start the sound system, initializing it if necessary.  This must be
       called before any calls are made to derived methods.
@@ -95,13 +78,23 @@ class Sound : public Serializable
     virtual void reset() = 0;
 
     /**
-      Sets the sound register to a given value.
+      Sets the rate of the samples passed to processSamples(), which is
+      twice the console's scanline rate (see Console::audioSampleRate()).
+      Any samples not yet resampled are dropped.
 
-      @param addr  The register address
-      @param value The value to save into the register
-      @param cycle The system cycle at which the register is being updated
+      @param rate  The rate of the TIA's samples, in Hz
     */
-    virtual void set(uInt16 addr, uInt8 value, Int32 cycle) = 0;
+    virtual void setSampleRate(double rate) = 0;
+
+    /**
+      Plays the given samples, generated by the TIA at two per scanline
+      (see setSampleRate()).  Each sample holds the output level of both TIA
+      sound channels.  This is called from the emulation.
+
+      @param samples The samples, with the two channels interleaved
+      @param count   The number of samples
+    */
+    virtual void processSamples(const Int16* samples, uInt32 count) = 0;
 
     /**
       Sets the volume of the sound device to the specified level.  The
@@ -120,6 +113,13 @@ class Sound : public Serializable
     */
     virtual void adjustVolume(Int8 direction) = 0;
 
+    /**
+      Answers how full the queue of samples waiting to be played is, as a
+      percentage of the level it's kept at, and how many times the sound
+      device has run out of samples since the sound was opened.
+    */
+    virtual void queueStats(uInt32& fill, uInt32& underruns) const = 0;
+
   protected:
     // The OSystem for this sound object
     OSystem& myOSystem;
@@ -16,6 +16,8 @@
 //============================================================================
 
 #include <sstream>
+#include <fstream>
+#include <zlib.h>
 
 #include "OSystem.hxx"
 #include "Settings.hxx"
@@ -25,136 +27,367 @@
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Serializable.hxx"
+#include "Event.hxx"
+#include "EventHandler.hxx"
+#include "M6532.hxx"
+#include "MD5.hxx"
+#include "TIA.hxx"
 
 #include "StateManager.hxx"
 
-#define STATE_HEADER "04090700state"
-#define MOVIE_HEADER "03030000movie"
+#define STATE_HEADER "04090701state"
+#define MOVIE_HEADER "04090701movie"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
   : myOSystem(osystem),
     myCurrentSlot(0),
-    myActiveMode(kOffMode)
+    myActiveMode(kOffMode),
+    myMovieSeek(0),
+    myRewindBuffer(0, kRewindKeyframeInterval),
+    myRewindInterval(1),
+    myRewindFrames(0),
+    myRewindCaptures(0),
+    myRewindCaptureTime(0)
 {
   reset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool StateManager::toggleRecordMode()
+StateManager::~StateManager()
 {
-#if 0
-  if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
-  {
-    myActiveMode = kOffMode;
+  stopMovie();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::recordMovie(const string& filename)
+{
+  stopMovie();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  // The state the movie starts from is its first keyframe
+  myMovie.clear();
+  myMovieKeyframes.clear();
+  if(!addMovieKeyframe())
+    return false;
+
+  // The header is known when recording starts; the frames and keyframes
+  // are added when it stops
+  const Console& console = myOSystem.console();
+  myMovieWriter.reset();
+  myMovieWriter.putString(MOVIE_HEADER);
+  myMovieWriter.putString(console.properties().get(Cartridge_MD5));
+  myMovieWriter.putString(console.leftController().name());
+  myMovieWriter.putString(console.rightController().name());
+
+  // Movies take precedence over rewinding
+  myRewindBuffer.clear();
+  myMovieFile = filename;
+  myActiveMode = kMovieRecordMode;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::playMovie(const string& filename)
+{
+  stopMovie();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  Serializer in(filename, true);
+  if(!in)
+    return false;
 
-    string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
+  try
+  {
+    // The movie must have been recorded with the same ROM and controllers
+    const Console& console = myOSystem.console();
+    if(in.getString() != MOVIE_HEADER ||
+       in.getString() != console.properties().get(Cartridge_MD5) ||
+       in.getString() != console.leftController().name() ||
+       in.getString() != console.rightController().name())
       return false;
 
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
+    if(!myMovie.load(in))
+      return false;
 
-    if(!myOSystem.console().save(myMovieWriter))
+    // The index of the keyframes, in order, then the keyframes themselves;
+    // the sizes are checked here, since they're used to allocate memory
+    // when seeking; there can't be more than one for each frame
+    const uInt32 keyframes = in.getInt();
+    if(keyframes == 0 || keyframes > myMovie.frames() + 1)
       return false;
 
-    // Save controller types for this ROM
-    // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
-    // controllers.
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Left).name());
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Right).name());
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMovieRecordMode;
+    myMovieKeyframes.resize(keyframes);
+    for(uInt32 i = 0; i < myMovieKeyframes.size(); ++i)
+    {
+      myMovieKeyframes[i].frame = in.getInt();
+      myMovieKeyframes[i].size = in.getInt();
+      if(myMovieKeyframes[i].size == 0 ||
+         myMovieKeyframes[i].size > kMaxMovieStateSize ||
+         myMovieKeyframes[i].frame > myMovie.frames() ||
+         (i == 0 ? myMovieKeyframes[i].frame != 0 :
+          myMovieKeyframes[i].frame <= myMovieKeyframes[i - 1].frame))
+        return false;
+    }
+    for(auto& keyframe: myMovieKeyframes)
+      keyframe.data = in.getString();
+
+    if(!loadMovieKeyframe(0))
+      return false;
   }
-  else  // Turn off movie record mode
+  catch(...)
   {
-    myActiveMode = kOffMode;
-    myMovieWriter.close();
     return false;
   }
 
-  return myActiveMode == kMovieRecordMode;
-#endif
-  return false;
+  myRewindBuffer.clear();
+  myMovieFile = filename;
+  myActiveMode = kMoviePlaybackMode;
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool StateManager::toggleRewindMode()
+bool StateManager::seekMovie(uInt32 frame)
 {
-  // FIXME - For now, I'm going to use this to activate movie playback
-#if 0
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
+  if(myActiveMode != kMoviePlaybackMode || frame > myMovie.frames())
+    return false;
 
-  if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
+  // Go back to the keyframe at or before the frame, unless the frame is
+  // closer, and play the frames from there without the usual per-frame
+  // work (polling, timing, cheats, snapshots)
+  const auto next = std::upper_bound(myMovieKeyframes.begin(),
+      myMovieKeyframes.end(), frame,
+      [](uInt32 f, const MovieKeyframe& keyframe) { return f < keyframe.frame; });
+  const uInt32 keyframe = uInt32(next - myMovieKeyframes.begin()) - 1;
+  if(frame < myMovie.played() ||
+     myMovieKeyframes[keyframe].frame > myMovie.played())
   {
+    if(!loadMovieKeyframe(keyframe))
+      return false;
+  }
+
+  // The sound of the frames skipped isn't captured
+  Event& event = myOSystem.eventHandler().event();
+  TIA& tia = myOSystem.console().tia();
+  AudioCapture* capture = tia.audioCapture();
+  tia.setAudioCapture(nullptr);
+  while(myMovie.played() < frame && myMovie.play(event))
+  {
+    myOSystem.console().riot().update();
+    tia.update();
+  }
+  tia.setAudioCapture(capture);
+
+  return myMovie.played() == frame;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopMovie()
+{
+  if(myActiveMode == kMovieRecordMode)
+  {
+    myMovie.save(myMovieWriter);
+    myMovieWriter.putInt(uInt32(myMovieKeyframes.size()));
+    for(const auto& keyframe: myMovieKeyframes)
+    {
+      myMovieWriter.putInt(keyframe.frame);
+      myMovieWriter.putInt(keyframe.size);
+    }
+    for(const auto& keyframe: myMovieKeyframes)
+      myMovieWriter.putString(keyframe.data);
+
+    ofstream file(myMovieFile, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(myMovieWriter.data()),
+               myMovieWriter.size());
+    if(!file)
+      myOSystem.logMessage("ERROR: Couldn't write movie " + myMovieFile, 0);
+  }
+
+  if(myActiveMode == kMovieRecordMode || myActiveMode == kMoviePlaybackMode)
     myActiveMode = kOffMode;
+  myMovie.clear();
+  myMovieKeyframes.clear();
+}
 
-    string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
-      return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::addMovieKeyframe()
+{
+  Serializer state;
+  if(!saveState(state))
+    return false;
 
-    // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem.console().properties().get(Cartridge_MD5))
-      return false;
+  uLongf size = compressBound(state.size());
+  unique_ptr<Bytef[]> buffer = make_ptr<Bytef[]>(size);
+  if(compress2(buffer.get(), &size, state.data(), state.size(),
+               Z_BEST_SPEED) != Z_OK)
+    return false;
 
-    if(!myOSystem.console().load(myMovieReader))
-      return false;
+  MovieKeyframe keyframe;
+  keyframe.frame = myMovie.frames();
+  keyframe.size = state.size();
+  keyframe.data.assign(reinterpret_cast<const char*>(buffer.get()), size);
+  myMovieKeyframes.push_back(std::move(keyframe));
 
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
+  return true;
+}
 
-    if(left != myOSystem.console().controller(Controller::Left).name() ||
-       right != myOSystem.console().controller(Controller::Right).name())
-      return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::loadMovieKeyframe(uInt32 index)
+{
+  if(index >= myMovieKeyframes.size())
+    return false;
 
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMoviePlaybackMode;
-  }
-  else  // Turn off movie playback mode
+  const MovieKeyframe& keyframe = myMovieKeyframes[index];
+  vector<uInt8> state(keyframe.size);
+  uLongf size = keyframe.size;
+  if(uncompress(state.data(), &size,
+                reinterpret_cast<const Bytef*>(keyframe.data.data()),
+                uLong(keyframe.data.size())) != Z_OK || size != keyframe.size)
+    return false;
+
+  Serializer in(state.data(), keyframe.size);
+  return loadState(in) && myMovie.seek(keyframe.frame);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateManager::toggleRewindMode()
+{
+  myRewindBuffer.clear();
+  myRewindFrames = myRewindCaptures = myRewindCaptureTime = 0;
+
+  if(myActiveMode == kRewindRecordMode || myActiveMode == kRewindPlaybackMode)
   {
     myActiveMode = kOffMode;
-    myMovieReader.close();
     return false;
   }
+  else if(myActiveMode != kOffMode)  // Movies take precedence
+    return false;
 
-  return myActiveMode == kMoviePlaybackMode;
-#endif
-  return false;
+  const Settings& settings = myOSystem.settings();
+  myRewindInterval = settings.getInt("rewindint");
+  myRewindBuffer.setBudget(uInt64(settings.getInt("rewindsize")) << 20);
+  myActiveMode = kRewindRecordMode;
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void StateManager::update()
+void StateManager::rewind(bool rewind)
+{
+  if(rewind && myActiveMode == kRewindRecordMode)
+  {
+    myActiveMode = kRewindPlaybackMode;
+    myOSystem.frameBuffer().showMessage(rewindInfo());
+  }
+  else if(!rewind && myActiveMode == kRewindPlaybackMode)
+  {
+    // Carry on from the state we went back to
+    myActiveMode = kRewindRecordMode;
+    myRewindFrames = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateManager::rewindInfo() const
+{
+  const float framerate = myOSystem.hasConsole() &&
+      myOSystem.console().getFramerate() > 0 ?
+      myOSystem.console().getFramerate() : 60;
+
+  ostringstream buf;
+  buf << std::fixed << std::setprecision(1) << "Rewind "
+      << myRewindBuffer.size() * myRewindInterval / framerate << "s, "
+      << myRewindBuffer.memoryUsed() / 1048576.0 << " MB, "
+      << std::setprecision(0)
+      << (myRewindCaptures > 0 ? double(myRewindCaptureTime) /
+                                 myRewindCaptures : 0.0) << " us/state";
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::captureRewindState()
+{
+  const uInt64 start = myOSystem.getTicks();
+
+  myRewindState.reset();
+  if(saveState(myRewindState))
+    myRewindBuffer.add(myRewindState.data(), myRewindState.size());
+
+  myRewindCaptureTime += myOSystem.getTicks() - start;
+  ++myRewindCaptures;
+  myRewindFrames = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::rewindState()
+{
+  // The oldest state is kept, so rewinding stops there
+  if(myRewindBuffer.last(myRewindData))
+  {
+    Serializer in(myRewindData.data(), uInt32(myRewindData.size()));
+    loadState(in);
+
+    if(myRewindBuffer.size() > 1)
+      myRewindBuffer.removeLast();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateManager::stateHash()
+{
+  myHashState.reset();
+  if(!saveState(myHashState))
+    return EmptyString;
+
+  const TIA& tia = myOSystem.console().tia();
+  myHashState.putByteArray(tia.previousFrameBuffer(),
+                           tia.width() * tia.height());
+
+  return MD5::hash(myHashState.data(), myHashState.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::update(Event& event)
 {
-#if 0
   switch(myActiveMode)
   {
+    case kRewindRecordMode:
+      if(++myRewindFrames >= myRewindInterval)
+        captureRewindState();
+      break;
+
+    case kRewindPlaybackMode:
+      rewindState();
+      break;
+
     case kMovieRecordMode:
-      myOSystem.console().controller(Controller::Left).save(myMovieWriter);
-      myOSystem.console().controller(Controller::Right).save(myMovieWriter);
-      myOSystem.console().switches().save(myMovieWriter);
+      if(myMovie.frames() > 0 &&
+         myMovie.frames() % kMovieKeyframeInterval == 0)
+        addMovieKeyframe();
+      myMovie.record(event);
       break;
 
     case kMoviePlaybackMode:
-      myOSystem.console().controller(Controller::Left).load(myMovieReader);
-      myOSystem.console().controller(Controller::Right).load(myMovieReader);
-      myOSystem.console().switches().load(myMovieReader);
+      if(myMovieSeek > 0)
+      {
+        seekMovie(myMovieSeek);
+        myMovieSeek = 0;
+      }
+      if(!myMovie.play(event))
+      {
+        stopMovie();
+        myOSystem.frameBuffer().showMessage("Movie finished");
+      }
       break;
 
     default:
       break;
   }
-#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -243,9 +476,10 @@ void StateManager::saveState(int slot)
       return;
     }
 
-    // Do a complete state save using the Console
+    // Do a complete state save using the Console, and make sure it
+    // reaches the file before saying so
     buf.str("");
-    if(myOSystem.console().save(out))
+    if(myOSystem.console().save(out) && out.flush())
     {
       buf << "State " << slot << " saved";
       if(myOSystem.settings().getBool("autoslot"))
@@ -330,22 +564,36 @@ bool StateManager::saveState(Serializer& out)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
-#if 0
-  myCurrentSlot = 0;
+  stopMovie();
+  myActiveMode = kOffMode;
 
-  switch(myActiveMode)
+  // A movie given on the commandline starts with the ROM
+  const Settings& settings = myOSystem.settings();
+  if(myOSystem.hasConsole())
   {
-    case kMovieRecordMode:
-      myMovieWriter.close();
-      break;
-
-    case kMoviePlaybackMode:
-      myMovieReader.close();
-      break;
-
-    default:
-      break;
+    const string& play = settings.getString("playmovie");
+    const string& record = settings.getString("recordmovie");
+    if(play != "")
+    {
+      // Seeking emulates frames, so it waits for the first frame
+      if(playMovie(play))
+      {
+        myMovieSeek = uInt32(std::max(settings.getInt("movieseek"), 0));
+        return;
+      }
+      myOSystem.logMessage("ERROR: Couldn't play movie " + play, 0);
+    }
+    else if(record != "")
+    {
+      if(recordMovie(record))
+        return;
+      myOSystem.logMessage("ERROR: Couldn't record movie " + record, 0);
+    }
   }
-  myActiveMode = kOffMode;
-#endif
+
+  // Rewinding needs a key to be held, so it's only on when there's a UI
+  if(settings.getBool("rewind") && !settings.getBool("headless"))
+    toggleRewindMode();
+  else
+    myRewindBuffer.clear();
 }
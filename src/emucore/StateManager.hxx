@@ -20,7 +20,11 @@
 
 class OSystem;
 
+class Event;
+
 #include "Serializer.hxx"
+#include "RewindBuffer.hxx"
+#include "InputMovie.hxx"
 
 /**
   This class provides an interface to all things related to emulation state.
@@ -37,19 +41,127 @@ class StateManager
     */
     StateManager(OSystem& osystem);
 
+    /**
+      Write any movie being recorded
+    */
+    ~StateManager();
+
   public:
     /**
       Answers whether the manager is in record or playback mode
     */
     bool isActive() const { return myActiveMode != kOffMode; }
 
-    bool toggleRecordMode();
+    /**
+      Answers whether the manager is in a playback mode, where it sets the
+      state of the system itself
+    */
+    bool isPlayingBack() const {
+      return myActiveMode == kMoviePlaybackMode ||
+             myActiveMode == kRewindPlaybackMode;
+    }
+
+    /**
+      Answers whether a movie is being played back.
+    */
+    bool isPlayingMovie() const { return myActiveMode == kMoviePlaybackMode; }
+
+    /**
+      Starts recording a movie of the current ROM, from its current state;
+      it's written to the given file when recording stops (when the ROM
+      is closed, or another movie is started).
+
+      @param filename  The file to write the movie to
+
+      @return  False if the movie can't be recorded, else true
+    */
+    bool recordMovie(const string& filename);
+
+    /**
+      Starts playing back a movie recorded with the current ROM.  The
+      emulation goes back to the state the movie started from, and each
+      frame after that gets its input from the movie rather than the user,
+      until the movie ends.
+
+      @param filename  The file to read the movie from
+
+      @return  False if the movie can't be played, else true
+    */
+    bool playMovie(const string& filename);
+
+    /**
+      Skips to the given frame of the movie being played back, so it's the
+      next one played.  The emulation goes back to the nearest keyframe
+      (a state saved while recording) before the frame, and the frames
+      from there are emulated as fast as possible.
+
+      @param frame  The frame to skip to
+
+      @return  False if there's no movie being played back, or it doesn't
+               have that many frames, else true
+    */
+    bool seekMovie(uInt32 frame);
+
+    /**
+      Answers the number of frames in the movie being recorded or played
+      back, and the next frame to be recorded or played.
+    */
+    uInt32 movieFrames() const { return myMovie.frames(); }
+    uInt32 movieFrame() const {
+      return myActiveMode == kMoviePlaybackMode ? myMovie.played() :
+                                                  myMovie.frames();
+    }
+
+    /**
+      Stops recording or playing back a movie; a movie being recorded is
+      written to its file.
+    */
+    void stopMovie();
+
+    /**
+      Turns the capture of states for rewinding on or off; any states
+      already captured are dropped.
+
+      @return  True if rewinding is now on, else false
+    */
     bool toggleRewindMode();
 
     /**
-      Updates the state of the system based on the currently active mode
+      Starts or stops rewinding (normally while a key is held).  While
+      rewinding, each frame starts from the previous state captured, so
+      the emulation runs backwards, at the speed set by 'rewindint'.
+
+      @param rewind  Whether to rewind
+    */
+    void rewind(bool rewind);
+
+    /**
+      Answers a description of the states captured for rewinding: the
+      time they cover, the memory they take, and how long each took to
+      capture.
     */
-    void update();
+    string rewindInfo() const;
+
+    /**
+      Answers a hash (the MD5 digest) of the current state of the system,
+      including the last frame drawn.  With a fixed random seed (the 'seed'
+      setting), the same ROM and input always give the same hash for each
+      frame, so this can be used to check that a run is exactly the same
+      as another.
+
+      @return  The hash, or an empty string if there's no console
+    */
+    string stateHash();
+
+    /**
+      Updates the state of the system based on the currently active mode,
+      at the start of each frame (before the controllers are updated).  A
+      movie records the input for the frame from the given events, or sets
+      them to the input it recorded.
+
+      @param event  The events the controllers read their input from
+    */
+    void update(Event& event);
 
     /**
       Load a state into the current system
@@ -105,9 +217,37 @@ class StateManager
     };
 
     enum {
-      kVersion = 001
+      kVersion = 001,
+
+      // The number of rewind states from one keyframe to the next
+      kRewindKeyframeInterval = 30,
+
+      // The number of movie frames from one keyframe to the next (five
+      // seconds of NTSC), so seeking never emulates more than this
+      kMovieKeyframeInterval = 300,
+
+      // The largest state a movie keyframe may hold; states are all well
+      // under 1MB, so a larger size means the movie is corrupt
+      kMaxMovieStateSize = 16 << 20
     };
 
+    // A state saved while recording a movie, compressed with zlib, with
+    // the frame it was saved before and its size before compression
+    struct MovieKeyframe {
+      uInt32 frame;
+      uInt32 size;
+      string data;
+    };
+
+    // Capture the current state, or go back to the previous one
+    void captureRewindState();
+    void rewindState();
+
+    // Add the current state as the keyframe before the next movie frame,
+    // or go back to the given keyframe
+    bool addMovieKeyframe();
+    bool loadMovieKeyframe(uInt32 index);
+
     // The parent OSystem object
     OSystem& myOSystem;
 
@@ -117,12 +257,33 @@ class StateManager
     // Whether the manager is in record or playback mode
     Mode myActiveMode;
 
-    // MD5 of the currently active ROM (either in movie or rewind mode)
-    string myMD5;
-
-    // Serializer classes used to save/load the eventstream
+    // The movie being recorded or played back, and the file it's recorded
+    // into, with everything but the frames already written
+    InputMovie myMovie;
+    string myMovieFile;
     Serializer myMovieWriter;
-    Serializer myMovieReader;
+
+    // The keyframes of the movie, in order (the first one is the state it
+    // starts from), and the frame to skip to when playback starts
+    vector<MovieKeyframe> myMovieKeyframes;
+    uInt32 myMovieSeek;
+
+    // The states captured for rewinding, every so many frames, with the
+    // number of frames since the last one
+    RewindBuffer myRewindBuffer;
+    uInt32 myRewindInterval;
+    uInt32 myRewindFrames;
+
+    // Reused for capturing and restoring the rewind states
+    Serializer myRewindState;
+    vector<uInt8> myRewindData;
+
+    // Reused for the state hashed by stateHash()
+    Serializer myHashState;
+
+    // The number of rewind states captured, and the total time it took
+    uInt64 myRewindCaptures;
+    uInt64 myRewindCaptureTime;
 
   private:
     // Following constructors and assignment operators not supported
@@ -33,14 +33,13 @@ System::System(const OSystem& osystem, M6502& m6502, M6532& m6532,
     myM6532(m6532),
     myTIA(mTIA),
     myCart(mCart),
+    myRandom(osystem),
     myCycles(0),
+    myTotalCycles(0),
     myDataBusState(0),
     myDataBusLocked(false),
     mySystemInAutodetect(false)
 {
-  // Re-initialize random generator
-  randGenerator().initSeed();
-
   // Initialize page access table
   PageAccess access(&myNullDevice, System::PA_READ);
   for(int page = 0; page < NUM_PAGES; ++page)
@@ -91,6 +90,7 @@ void System::resetCycles()
   myCart.systemCyclesReset();
 
   // Now, we reset cycle count to zero
+  myTotalCycles += myCycles;
   myCycles = 0;
 }
 
@@ -211,6 +211,7 @@ bool System::save(Serializer& out) const
     out.putString(name());
     out.putInt(myCycles);
     out.putByte(myDataBusState);
+    myRandom.save(out);
 
     // Save the state of each device
     if(!myM6502.save(out))
@@ -241,6 +242,7 @@ bool System::load(Serializer& in)
 
     myCycles = in.getInt();
     myDataBusState = in.getByte();
+    myRandom.load(in);
 
     // Load the state of each device
     if(!myM6502.load(in))
@@ -113,7 +113,7 @@ class System : public Serializable
 
       @return The random generator
     */
-    Random& randGenerator() const { return myOSystem.random(); }
+    Random& randGenerator() const { return myRandom; }
 
     /**
       Get the null device associated with the system.  Every system
@@ -133,6 +133,15 @@ class System : public Serializable
     */
     uInt32 cycles() const { return myCycles; }
 
+    /**
+      Get the number of system cycles which have passed since the system
+      was created (ie, including all cycle resets).  This is only used for
+      statistics, and isn't part of the saved state.
+
+      @return The total number of system cycles which have passed
+    */
+    uInt64 totalCycles() const { return myTotalCycles + myCycles; }
+
     /**
       Increment the system cycles by the specified number of cycles.
 
@@ -396,9 +405,16 @@ class System : public Serializable
     // Cartridge device attached to the system
     Cartridge& myCart;
 
+    // The random generator of the system (used by peeks of undriven pins,
+    // so it changes even when the system is otherwise const)
+    mutable Random myRandom;
+
     // Number of system cycles executed since the last reset
     uInt32 myCycles;
 
+    // Number of system cycles executed before the last reset
+    uInt64 myTotalCycles;
+
     // Null device to use for page which are not installed
     NullDevice myNullDevice;
 
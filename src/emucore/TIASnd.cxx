@@ -15,16 +15,12 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
-#include "System.hxx"
+#include "Serializer.hxx"
 #include "TIATypes.hxx"
 #include "TIASnd.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TIASound::TIASound(Int32 outputFrequency)
-  : myChannelMode(Hardware2Stereo),
-    myOutputFrequency(outputFrequency),
-    myOutputCounter(0),
-    myVolumePercentage(100)
+TIASound::TIASound()
 {
   reset();
 }
@@ -51,31 +47,6 @@ void TIASound::reset()
     myP5[chan] = 0;
     myP9[chan] = 0;
   }
-
-  myOutputCounter = 0;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIASound::outputFrequency(Int32 freq)
-{
-  myOutputFrequency = freq;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string TIASound::channels(uInt32 hardware, bool stereo)
-{
-  if(hardware == 1)
-    myChannelMode = Hardware1;
-  else
-    myChannelMode = stereo ? Hardware2Stereo : Hardware2Mono;
-
-  switch(myChannelMode)
-  {
-    case Hardware1:       return "Hardware1";
-    case Hardware2Mono:   return "Hardware2Mono";
-    case Hardware2Stereo: return "Hardware2Stereo";
-    default:              return EmptyString;
-  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -111,7 +82,7 @@ void TIASound::set(uInt16 address, uInt8 value)
     // Indicate the clock is zero so no processing will occur,
     // and set the output to the selected volume
     newVal = 0;
-    myVolume[chan] = (myAUDV[chan] * myVolumePercentage) / 100;
+    myVolume[chan] = myAUDV[chan];
   }
   else
   {
@@ -151,13 +122,6 @@ uInt8 TIASound::get(uInt16 address) const
   }
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void TIASound::volume(uInt32 percent)
-{
-  if(percent <= 100)
-    myVolumePercentage = percent;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::process(Int16* buffer, uInt32 samples)
 {
@@ -167,12 +131,10 @@ void TIASound::process(Int16* buffer, uInt32 samples)
   uInt8 div_n_cnt0 = myDivNCnt[0], div_n_cnt1 = myDivNCnt[1];
   Int16 v0 = myVolume[0], v1 = myVolume[1];
 
-  // Take external volume into account
-  Int16 audv0 = (myAUDV[0] * myVolumePercentage) / 100,
-        audv1 = (myAUDV[1] * myVolumePercentage) / 100;
+  Int16 audv0 = myAUDV[0], audv1 = myAUDV[1];
 
   // Loop until the sample buffer is full
-  while(samples > 0)
+  while(samples-- > 0)
   {
     // Process channel 0
     if (div_n_cnt0 > 1)
@@ -321,40 +283,8 @@ void TIASound::process(Int16* buffer, uInt32 samples)
       }
     }
 
-    myOutputCounter += myOutputFrequency;
-
-    switch(myChannelMode)
-    {
-      case Hardware2Mono:  // mono sampling with 2 hardware channels
-        while((samples > 0) && (myOutputCounter >= 31400))
-        {
-          Int16 byte = v0 + v1;
-          *(buffer++) = byte;
-          *(buffer++) = byte;
-          myOutputCounter -= 31400;
-          samples--;
-        }
-        break;
-
-      case Hardware2Stereo:  // stereo sampling with 2 hardware channels
-        while((samples > 0) && (myOutputCounter >= 31400))
-        {
-          *(buffer++) = v0;
-          *(buffer++) = v1;
-          myOutputCounter -= 31400;
-          samples--;
-        }
-        break;
-
-      case Hardware1:  // mono/stereo sampling with only 1 hardware channel
-        while((samples > 0) && (myOutputCounter >= 31400))
-        {
-          *(buffer++) = v0 + v1;
-          myOutputCounter -= 31400;
-          samples--;
-        }
-        break;
-    }
+    *(buffer++) = v0;
+    *(buffer++) = v1;
   }
 
   // Save for next round
@@ -366,6 +296,67 @@ void TIASound::process(Int16* buffer, uInt32 samples)
   myDivNCnt[1] = div_n_cnt1;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIASound::save(Serializer& out) const
+{
+  try
+  {
+    out.putString(name());
+
+    for(int chan = 0; chan <= 1; ++chan)
+    {
+      out.putByte(myAUDC[chan]);
+      out.putByte(myAUDF[chan]);
+      out.putShort(myAUDV[chan]);
+      out.putShort(myVolume[chan]);
+      out.putByte(myP4[chan]);
+      out.putByte(myP5[chan]);
+      out.putShort(myP9[chan]);
+      out.putByte(myDivNCnt[chan]);
+      out.putByte(myDivNMax[chan]);
+      out.putByte(myDiv3Cnt[chan]);
+    }
+  }
+  catch(...)
+  {
+    cerr << "ERROR: TIASound::save" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIASound::load(Serializer& in)
+{
+  try
+  {
+    if(in.getString() != name())
+      return false;
+
+    for(int chan = 0; chan <= 1; ++chan)
+    {
+      myAUDC[chan] = in.getByte();
+      myAUDF[chan] = in.getByte();
+      myAUDV[chan] = in.getShort();
+      myVolume[chan] = in.getShort();
+      myP4[chan] = in.getByte();
+      myP5[chan] = in.getByte();
+      myP9[chan] = in.getShort();
+      myDivNCnt[chan] = in.getByte();
+      myDivNMax[chan] = in.getByte();
+      myDiv3Cnt[chan] = in.getByte();
+    }
+  }
+  catch(...)
+  {
+    cerr << "ERROR: TIASound::load" << endl;
+    return false;
+  }
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::polyInit(uInt8* poly, int size, int f0, int f1)
 {
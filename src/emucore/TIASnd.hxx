@@ -18,24 +18,28 @@
 #ifndef TIASOUND_HXX
 #define TIASOUND_HXX
 
+#include "Serializable.hxx"
 #include "bspf.hxx"
 
 /**
   This class implements a fairly accurate emulation of the TIA sound
   hardware.  This class uses code/ideas from z26 and MESS.
 
-  Currently, the sound generation routines work at 31400Hz only.
-  Resampling can be done by passing in a different output frequency.
+  The TIA clocks its sound circuits twice per scanline (31440Hz for NTSC,
+  31200Hz for PAL), and one sample is generated for each of those clocks;
+  the TIA class drives this as it runs, so the sound is locked to the rest
+  of the emulation.  Mixing and resampling for the sound device are left to
+  the Sound class.
 
   @author  Bradford W. Mott, Stephen Anthony, z26 and MESS teams
 */
-class TIASound
+class TIASound : public Serializable
 {
   public:
     /**
-      Create a new TIA Sound object using the specified output frequency
+      Create a new TIA Sound object
     */
-    TIASound(Int32 outputFrequency = 31400);
+    TIASound();
 
   public:
     /**
@@ -43,23 +47,6 @@ class TIASound
     */
     void reset();
 
-    /**
-      Set the frequency output samples should be generated at
-    */
-    void outputFrequency(Int32 freq);
-
-    /**
-      Selects the number of audio channels per sample.  There are two factors
-      to consider: hardware capability and desired mixing.
-
-      @param hardware  The number of channels supported by the sound system
-      @param stereo    Whether to output the internal sound signals into 1
-                       or 2 channels
-
-      @return  Status of the channel configuration used
-    */
-    string channels(uInt32 hardware, bool stereo);
-
   public:
     /**
       Sets the specified sound register to the given value
@@ -77,9 +64,10 @@ class TIASound
     uInt8 get(uInt16 address) const;
 
     /**
-      Create sound samples based on the current sound register settings
-      in the specified buffer. NOTE: If channels is set to stereo then
-      the buffer will need to be twice as long as the number of samples.
+      Clock the sound circuits the given number of times, creating a sample
+      for each, based on the current sound register settings.  Each sample
+      holds the output level of both channels, so the buffer needs to be
+      twice as long as the number of samples.
 
       @param buffer The location to store generated samples
       @param samples The number of samples to generate
@@ -87,9 +75,27 @@ class TIASound
     void process(Int16* buffer, uInt32 samples);
 
     /**
-      Set the volume of the samples created (0-100)
+      Saves the current state of this device to the given Serializer.
+
+      @param out  The serializer device to save to.
+      @return  The result of the save.  True on success, false on failure.
+    */
+    bool save(Serializer& out) const override;
+
+    /**
+      Loads the current state of this device from the given Serializer.
+
+      @param in  The Serializer device to load from.
+      @return  The result of the load.  True on success, false on failure.
+    */
+    bool load(Serializer& in) override;
+
+    /**
+      Get a descriptor for this device (used in error checking).
+
+      @return  The name of the object
     */
-    void volume(uInt32 percent);
+    string name() const override { return "TIASound"; }
 
   private:
     void polyInit(uInt8* poly, int size, int f0, int f1);
@@ -125,12 +131,6 @@ class TIASound
                           // then another 8 for 16-bit sound
     };
 
-    enum ChannelMode {
-      Hardware2Mono,    // mono sampling with 2 hardware channels
-      Hardware2Stereo,  // stereo sampling with 2 hardware channels
-      Hardware1         // mono/stereo sampling with only 1 hardware channel
-    };
-
   private:
     // Structures to hold the 6 tia sound control bytes
     uInt8 myAUDC[2];    // AUDCx (15, 16)
@@ -147,11 +147,6 @@ class TIASound
     uInt8 myDivNMax[2]; // Divide by n maximum, one for each channel
     uInt8 myDiv3Cnt[2]; // Div 3 counter, used for POLY5_DIV3 mode
 
-    ChannelMode myChannelMode;
-    Int32  myOutputFrequency;
-    Int32  myOutputCounter;
-    uInt32 myVolumePercentage;
-
     /*
       Initialize the bit patterns for the polynomials (at runtime).
 
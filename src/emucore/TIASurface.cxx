@@ -22,6 +22,7 @@
 #include "OSystem.hxx"
 #include "Console.hxx"
 #include "TIA.hxx"
+#include "Profiler.hxx"
 
 #include "TIASurface.hxx"
 
@@ -299,6 +300,8 @@ string TIASurface::effectsInfo() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::render()
 {
+  Profiler::Scope profile(Profiler::kRender);
+
   // Copy the mediasource framebuffer to the RGB texture
   // In hardware rendering mode, it's faster to just assume that the screen
   // is dirty and always do an update
@@ -0,0 +1,222 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Base.hxx"
+#include "ThumbProfiler.hxx"
+
+using Common::Base;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbProfiler::ThumbProfiler(uInt32 romSize, uInt32 ramSize)
+  : myRomHalfwords(romSize / 2),
+    myCounts((romSize + ramSize) / 2)
+{
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::reset()
+{
+  std::fill(myCounts.begin(), myCounts.end(), Counts{0, 0});
+
+  myCall = Counts{0, 0};
+  myFrame = myTotal = myPeak = Frame{0, 0, 0, 0, 0};
+  myCallStarted = myFrameStarted = false;
+
+  for(Calls& calls: myCalls)
+    calls = Calls{0, 0, 0, 0};
+  myPeakLoad = 0;
+  myFrameCount = 0;
+  myFrames.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::startCall(uInt32 frame, uInt64 cpuCycles)
+{
+  if(myCallStarted)
+    endCall();
+
+  if(!myFrameStarted || frame != myFrame.frame)
+  {
+    if(myFrameStarted)
+      endFrame(cpuCycles, frame);
+
+    myFrame = Frame{frame, 0, 0, 0, cpuCycles};
+    myFrameStarted = true;
+  }
+
+  ++myFrame.calls;
+  myCall = Counts{0, 0};
+  myCallStarted = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::endCall()
+{
+  Calls& calls = myCalls[std::min(myFrame.calls, kMaxCalls) - 1];
+  ++calls.calls;
+  calls.instructions += myCall.instructions;
+  calls.cycles += myCall.cycles;
+  calls.maxCycles = std::max(calls.maxCycles, myCall.cycles);
+
+  myFrame.instructions += myCall.instructions;
+  myFrame.cycles += myCall.cycles;
+  myCallStarted = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::endFrame(uInt64 cpuCycles, uInt32 next)
+{
+  // Frames in which the ARM code wasn't called at all share the time
+  // until the next call; after a reset, the frame number can go back
+  const uInt32 frames = next > myFrame.frame ? next - myFrame.frame : 1;
+  myFrame.cpuCycles = (cpuCycles - myFrame.cpuCycles) / frames;
+
+  ++myFrameCount;
+  myTotal.calls += myFrame.calls;
+  myTotal.instructions += myFrame.instructions;
+  myTotal.cycles += myFrame.cycles;
+  myTotal.cpuCycles += myFrame.cpuCycles;
+
+  myPeak.calls = std::max(myPeak.calls, myFrame.calls);
+  myPeak.instructions = std::max(myPeak.instructions, myFrame.instructions);
+  myPeak.cycles = std::max(myPeak.cycles, myFrame.cycles);
+  myPeak.cpuCycles = std::max(myPeak.cpuCycles, myFrame.cpuCycles);
+  if(myFrame.cpuCycles > 0)
+    myPeakLoad = std::max(myPeakLoad,
+                          double(myFrame.cycles) / myFrame.cpuCycles);
+
+  myFrames.push_back(myFrame);
+  if(myFrames.size() > kMaxFrames)
+    myFrames.pop_front();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ThumbProfiler::address(uInt32 halfword) const
+{
+  return halfword < myRomHalfwords ? halfword * 2 :
+         0x40000000 + (halfword - myRomHalfwords) * 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ThumbProfiler::report(double cyclesPerCpuCycle, uInt32 maxAddresses,
+                             bool listFrames) const
+{
+  ostringstream buf;
+  buf << std::fixed;
+
+  // Only the frames and calls that have ended are in the totals, while
+  // the flat profile has every instruction counted so far
+  uInt32 calls = 0;
+  for(const Calls& call: myCalls)
+    calls += call.calls;
+  buf << "ARM profile of " << myFrameCount << " frames, "
+      << calls << " calls" << endl << endl;
+
+  if(myFrameCount > 0)
+  {
+    const double n = myFrameCount;
+    const double cpu = double(myTotal.cycles) / cyclesPerCpuCycle;
+
+    buf << "Per frame            average          peak" << endl
+        << "  calls         " << std::setw(14) << std::setprecision(1)
+        << myTotal.calls / n << std::setw(14) << myPeak.calls << endl
+        << "  instructions  " << std::setw(14) << std::setprecision(0)
+        << myTotal.instructions / n
+        << std::setw(14) << myPeak.instructions << endl
+        << "  ARM cycles    " << std::setw(14)
+        << myTotal.cycles / n << std::setw(14) << myPeak.cycles << endl
+        << "  6507 cycles   " << std::setw(14)
+        << cpu / n << std::setw(14) << myPeak.cycles / cyclesPerCpuCycle << endl
+        << "  frame length  " << std::setw(14)
+        << myTotal.cpuCycles / n << std::setw(14) << myPeak.cpuCycles << endl;
+    if(myTotal.cpuCycles > 0)
+      buf << "  % of frame    " << std::setw(14) << std::setprecision(1)
+          << 100 * cpu / myTotal.cpuCycles
+          << std::setw(14) << 100 * myPeakLoad / cyclesPerCpuCycle << endl;
+    buf << endl;
+
+    buf << "Call in frame      calls  instructions    ARM cycles"
+           "   peak cycles   6507 cycles" << endl;
+    for(uInt32 i = 0; i < kMaxCalls; ++i)
+    {
+      const Calls& call = myCalls[i];
+      if(call.calls == 0)
+        continue;
+
+      const double c = call.calls;
+      buf << "  " << std::setw(2) << (i + 1) << (i + 1 == kMaxCalls ? "+" : " ")
+          << std::setw(16) << call.calls << std::setprecision(0)
+          << std::setw(14) << call.instructions / c
+          << std::setw(14) << call.cycles / c
+          << std::setw(14) << call.maxCycles
+          << std::setw(14) << call.cycles / c / cyclesPerCpuCycle << endl;
+    }
+    buf << endl;
+  }
+
+  // The flat profile, by the number of cycles at each address
+  vector<uInt32> halfwords;
+  uInt64 totalCycles = 0;
+  for(uInt32 i = 0; i < myCounts.size(); ++i)
+  {
+    if(myCounts[i].instructions > 0)
+    {
+      halfwords.push_back(i);
+      totalCycles += myCounts[i].cycles;
+    }
+  }
+  std::stable_sort(halfwords.begin(), halfwords.end(),
+    [this](uInt32 a, uInt32 b) {
+      return myCounts[a].cycles > myCounts[b].cycles;
+    });
+  if(maxAddresses > 0 && halfwords.size() > maxAddresses)
+    halfwords.resize(maxAddresses);
+
+  buf << "Address     instructions    ARM cycles  % cycles  cumulative" << endl;
+  uInt64 cumulative = 0;
+  for(uInt32 halfword: halfwords)
+  {
+    const Counts& counts = myCounts[halfword];
+    cumulative += counts.cycles;
+    buf << "  " << Base::HEX8 << address(halfword)
+        << std::setfill(' ') << std::dec << std::fixed
+        << std::setw(14) << counts.instructions
+        << std::setw(14) << counts.cycles << std::setprecision(2)
+        << std::setw(10) << 100.0 * counts.cycles / totalCycles
+        << std::setw(12) << 100.0 * cumulative / totalCycles << endl;
+  }
+
+  if(listFrames && !myFrames.empty())
+  {
+    buf << endl
+        << "     Frame calls  instructions    ARM cycles   6507 cycles"
+           "  frame length  % of frame" << endl;
+    for(const Frame& frame: myFrames)
+    {
+      const double cpu = frame.cycles / cyclesPerCpuCycle;
+      const double load = frame.cpuCycles > 0 ? 100 * cpu / frame.cpuCycles : 0;
+      buf << std::setw(10) << frame.frame << std::setw(6) << frame.calls
+          << std::setw(14) << frame.instructions
+          << std::setw(14) << frame.cycles << std::setprecision(0)
+          << std::setw(14) << cpu << std::setw(14) << frame.cpuCycles
+          << std::setprecision(1) << std::setw(12) << load << endl;
+    }
+  }
+
+  return buf.str();
+}
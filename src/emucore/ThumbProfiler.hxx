@@ -0,0 +1,151 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THUMB_PROFILER_HXX
+#define THUMB_PROFILER_HXX
+
+#include <deque>
+
+#include "bspf.hxx"
+
+/**
+  This class collects a profile of the ARM code run by the Thumbulator:
+  the number of instructions and (estimated) cycles run at each address
+  of ROM and RAM, and the totals for each call into the ARM code, which
+  are gathered by the order of the call within each frame of the 6507.
+
+  The cycles are those of the ARM7TDMI core, without any wait states for
+  the flash memory (see Thumbulator::instructionCycles()).  Together with
+  the number of ARM cycles per 6507 cycle, they show how much of each
+  frame the ARM code would take up on real hardware.
+*/
+class ThumbProfiler
+{
+  public:
+    /**
+      Create a profiler for the given number of bytes of ROM (at address
+      0) and RAM (at address 0x40000000).
+    */
+    ThumbProfiler(uInt32 romSize, uInt32 ramSize);
+
+  public:
+    /**
+      Clear all statistics.
+    */
+    void reset();
+
+    /**
+      Start a call into the ARM code.  The frame number and the total
+      number of 6507 cycles so far are used to group the calls by frame,
+      and to measure the length of each frame.
+    */
+    void startCall(uInt32 frame, uInt64 cpuCycles);
+
+    /**
+      Count an instruction, at the given halfword of ROM, or of RAM
+      following the ROM, that took the given number of cycles.
+    */
+    void count(uInt32 halfword, uInt32 cycles)
+    {
+      Counts& counts = myCounts[halfword];
+      ++counts.instructions;
+      counts.cycles += cycles;
+
+      ++myCall.instructions;
+      myCall.cycles += cycles;
+    }
+
+    /**
+      Answers a flat profile of the ARM code: the totals per frame and
+      per call, and the addresses that took the most cycles.
+
+      @param cyclesPerCpuCycle  The number of ARM cycles per 6507 cycle
+      @param maxAddresses       The most addresses to list (0 for all)
+      @param listFrames         Whether to list the totals for every frame
+    */
+    string report(double cyclesPerCpuCycle, uInt32 maxAddresses,
+                  bool listFrames) const;
+
+  private:
+    struct Counts {
+      uInt64 instructions;
+      uInt64 cycles;
+    };
+
+    // The totals for one frame, including its length in 6507 cycles
+    struct Frame {
+      uInt32 frame;
+      uInt32 calls;
+      uInt64 instructions;
+      uInt64 cycles;
+      uInt64 cpuCycles;
+    };
+
+    // The totals for the calls made at the same point of each frame
+    struct Calls {
+      uInt32 calls;
+      uInt64 instructions;
+      uInt64 cycles;
+      uInt64 maxCycles;
+    };
+
+    // Calls made later in a frame than this are all counted with the last
+    static constexpr uInt32 kMaxCalls = 8;
+
+    // Only the totals for this many of the most recent frames are kept
+    static constexpr uInt32 kMaxFrames = 65536;
+
+    // Add the call in progress to the current frame, and the current frame
+    // (which ran until the given number of 6507 cycles, and is followed by
+    // the given frame) to the totals
+    void endCall();
+    void endFrame(uInt64 cpuCycles, uInt32 next);
+
+    // Answers the address of the given halfword
+    uInt32 address(uInt32 halfword) const;
+
+  private:
+    uInt32 myRomHalfwords;
+    vector<Counts> myCounts;
+
+    // The call and frame in progress (the frame's length holds the number
+    // of 6507 cycles when it started), and whether either has started
+    Counts myCall;
+    Frame myFrame;
+    bool myCallStarted;
+    bool myFrameStarted;
+
+    // The totals for every call and frame that has ended, the largest
+    // values of each for any frame (and of the ARM cycles per 6507 cycle),
+    // and the most recent frames
+    Calls myCalls[kMaxCalls];
+    Frame myTotal;
+    Frame myPeak;
+    double myPeakLoad;
+    uInt32 myFrameCount;
+    std::deque<Frame> myFrames;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThumbProfiler() = delete;
+    ThumbProfiler(const ThumbProfiler&) = delete;
+    ThumbProfiler(ThumbProfiler&&) = delete;
+    ThumbProfiler& operator=(const ThumbProfiler&) = delete;
+    ThumbProfiler& operator=(ThumbProfiler&&) = delete;
+};
+
+#endif
@@ -26,6 +26,7 @@
 
 #include "bspf.hxx"
 #include "Base.hxx"
+#include "Profiler.hxx"
 #include "Thumbulator.hxx"
 using Common::Base;
 
@@ -58,24 +59,65 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, bool traponfata
                          Thumbulator::ConfigureFor configurefor, Cartridge* cartridge)
   : rom(rom_ptr),
     ram(ram_ptr),
+    myRegions{},
+    reg_norm{},
     T1TCR(0),
     T1TC(0),
+    trapOnFatal(traponfatal),
     configuration(configurefor),
-    myCartridge(cartridge)
+    myCartridge(cartridge),
+    opTable(decodeTable())
 {
+  // Code can't be fetched from the vectors at the start of ROM, and the
+  // bootstrap and driver at the start of RAM are protected from writes
+  // (only the first few words of the bootstrap can be written, which is
+  // left to write16_checked())
+  const uInt32 driverSize =
+      configuration == ConfigureFor::DPCplus ? 0x0C00 : 0x0800;
+
+  myRegions[0x0] = { rom, nullptr, 0x50, ROMSIZE - 0x50, ROMSIZE, 0, 0, 0 };
+  myRegions[0x4] = { ram, ram, 0, RAMSIZE, RAMSIZE,
+                     driverSize, RAMSIZE - driverSize, ROMSIZE / 2 };
+
   setConsoleTiming(ConsoleTiming::ntsc);
-  trapFatalErrors(traponfatal);
+  enableTranslation(true);
   reset();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::enableTranslation(bool enable)
+{
+  translateBlocks = enable;
+  flushTranslations();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::enableProfiling(bool enable)
+{
+  if(enable)
+    myProfiler = make_ptr<ThumbProfiler>(ROMSIZE, RAMSIZE);
+  else
+    myProfiler.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string Thumbulator::profileReport(uInt32 maxAddresses, bool listFrames) const
+{
+  return myProfiler ?
+      myProfiler->report(timing_factor, maxAddresses, listFrames) : EmptyString;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::run()
 {
+  Profiler::Scope profile(Profiler::kARM);
+
   reset();
   for(;;)
   {
-    if(execute()) break;
-    if(instructions > 500000) // way more than would otherwise be possible
+    if(myProfiler ? executeProfiled() :
+       translateBlocks ? executeBlock() : execute()) break;
+    if(instructions > kMaxInstructions) // way more than would otherwise be possible
       throw runtime_error("instructions > 500000");
   }
 #if defined(THUMB_DISS) || defined(THUMB_DBUG)
@@ -167,7 +209,79 @@ void Thumbulator::dump_regs()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Thumbulator::fetch16(uInt32 addr)
+inline uInt32 Thumbulator::fetch16(uInt32 addr)
+{
+  // The low bit of the address is ignored
+  const Region& region = myRegions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
+  if(offset - region.fetchStart < region.fetchSize)
+  {
+    fetches++;
+    return CONV_RAMROM(region.read[offset >> 1]);
+  }
+  return fetch16_checked(addr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 Thumbulator::read16(uInt32 addr)
+{
+  const Region& region = myRegions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
+  if(!(addr & 1) && offset < region.readSize)
+  {
+    reads++;
+    return CONV_RAMROM(region.read[offset >> 1]);
+  }
+  return read16_checked(addr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 Thumbulator::read32(uInt32 addr)
+{
+  const Region& region = myRegions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
+  if(!(addr & 3) && offset < region.readSize)
+  {
+    // Counted as two reads, as when it's done a halfword at a time
+    reads += 2;
+    uInt32 low  = CONV_RAMROM(region.read[offset >> 1]);
+    uInt32 high = CONV_RAMROM(region.read[(offset >> 1) + 1]);
+    return low | (high << 16);
+  }
+  return read32_checked(addr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Thumbulator::write16(uInt32 addr, uInt32 data)
+{
+  const Region& region = myRegions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
+  if(!(addr & 1) && offset - region.writeStart < region.writeSize)
+  {
+    writes++;
+    region.write[offset >> 1] = CONV_DATA(data);
+    return;
+  }
+  write16_checked(addr, data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Thumbulator::write32(uInt32 addr, uInt32 data)
+{
+  const Region& region = myRegions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
+  if(!(addr & 3) && offset - region.writeStart < region.writeSize)
+  {
+    writes += 2;
+    region.write[offset >> 1] = CONV_DATA(data);
+    region.write[(offset >> 1) + 1] = CONV_DATA(data >> 16);
+    return;
+  }
+  write32_checked(addr, data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Thumbulator::fetch16_checked(uInt32 addr)
 {
   fetches++;
 
@@ -220,7 +334,7 @@ uInt32 Thumbulator::fetch32(uInt32 addr)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::write16(uInt32 addr, uInt32 data)
+void Thumbulator::write16_checked(uInt32 addr, uInt32 data)
 {
   if((addr > 0x40001fff) && (addr < 0x50000000))
     fatalError("write16", addr, "abort - out of range");
@@ -274,7 +388,7 @@ void Thumbulator::write16(uInt32 addr, uInt32 data)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::write32(uInt32 addr, uInt32 data)
+void Thumbulator::write32_checked(uInt32 addr, uInt32 data)
 {
   if(addr & 3)
     fatalError("write32", addr, "abort - misaligned");
@@ -355,7 +469,7 @@ void Thumbulator::write32(uInt32 addr, uInt32 data)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Thumbulator::read16(uInt32 addr)
+uInt32 Thumbulator::read16_checked(uInt32 addr)
 {
   uInt32 data;
 
@@ -395,7 +509,7 @@ uInt32 Thumbulator::read16(uInt32 addr)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Thumbulator::read32(uInt32 addr)
+uInt32 Thumbulator::read32_checked(uInt32 addr)
 {
   if(addr & 3)
     fatalError("read32", addr, "abort - misaligned");
@@ -523,10 +637,135 @@ void Thumbulator::do_vflag_bit(uInt32 x)
   if(x) cpsr |= CPSR_V;  else cpsr &= ~CPSR_V;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Thumbulator::conditionPassed(uInt32 cond) const
+{
+  const bool n = cpsr & CPSR_N, z = cpsr & CPSR_Z,
+             c = cpsr & CPSR_C, v = cpsr & CPSR_V;
+
+  switch(cond)
+  {
+    case 0x0: return z;              // eq
+    case 0x1: return !z;             // ne
+    case 0x2: return c;              // cs
+    case 0x3: return !c;             // cc
+    case 0x4: return n;              // mi
+    case 0x5: return !n;             // pl
+    case 0x6: return v;              // vs
+    case 0x7: return !v;             // vc
+    case 0x8: return c && !z;        // hi
+    case 0x9: return !c || z;        // ls
+    case 0xA: return n == v;         // ge
+    case 0xB: return n != v;         // lt
+    case 0xC: return !z && n == v;   // gt
+    case 0xD: return z || n != v;    // le
+    default:  return false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Thumbulator::Op Thumbulator::decodeInstructionWord(uInt16 inst)
+{
+  // These are tested in the same order as the original decoder, since
+  // some of the masks overlap
+  if((inst & 0xFFC0) == 0x4140) return Op::ADC;
+  // ADD(1) with an immediate of 0 is MOV(2)
+  if((inst & 0xFE00) == 0x1C00 && (inst & 0x01C0)) return Op::ADD1;
+  if((inst & 0xF800) == 0x3000) return Op::ADD2;
+  if((inst & 0xFE00) == 0x1800) return Op::ADD3;
+  if((inst & 0xFF00) == 0x4400) return Op::ADD4;
+  if((inst & 0xF800) == 0xA000) return Op::ADD5;
+  if((inst & 0xF800) == 0xA800) return Op::ADD6;
+  if((inst & 0xFF80) == 0xB000) return Op::ADD7;
+  if((inst & 0xFFC0) == 0x4000) return Op::AND;
+  if((inst & 0xF800) == 0x1000) return Op::ASR1;
+  if((inst & 0xFFC0) == 0x4100) return Op::ASR2;
+  // B(1) conditions 0xE (undefined) and 0xF (SWI) aren't branches
+  if((inst & 0xF000) == 0xD000 && (inst & 0x0E00) != 0x0E00) return Op::B1;
+  if((inst & 0xF800) == 0xE000) return Op::B2;
+  if((inst & 0xFFC0) == 0x4380) return Op::BIC;
+  if((inst & 0xFF00) == 0xBE00) return Op::BKPT;
+  if((inst & 0xE000) == 0xE000) return Op::BL;
+  if((inst & 0xFF87) == 0x4780) return Op::BLX2;
+  if((inst & 0xFF87) == 0x4700) return Op::BX;
+  if((inst & 0xFFC0) == 0x42C0) return Op::CMN;
+  if((inst & 0xF800) == 0x2800) return Op::CMP1;
+  if((inst & 0xFFC0) == 0x4280) return Op::CMP2;
+  if((inst & 0xFF00) == 0x4500) return Op::CMP3;
+  if((inst & 0xFFE8) == 0xB660) return Op::CPS;
+  if((inst & 0xFFC0) == 0x4600) return Op::CPY;
+  if((inst & 0xFFC0) == 0x4040) return Op::EOR;
+  if((inst & 0xF800) == 0xC800) return Op::LDMIA;
+  if((inst & 0xF800) == 0x6800) return Op::LDR1;
+  if((inst & 0xFE00) == 0x5800) return Op::LDR2;
+  if((inst & 0xF800) == 0x4800) return Op::LDR3;
+  if((inst & 0xF800) == 0x9800) return Op::LDR4;
+  if((inst & 0xF800) == 0x7800) return Op::LDRB1;
+  if((inst & 0xFE00) == 0x5C00) return Op::LDRB2;
+  if((inst & 0xF800) == 0x8800) return Op::LDRH1;
+  if((inst & 0xFE00) == 0x5A00) return Op::LDRH2;
+  if((inst & 0xFE00) == 0x5600) return Op::LDRSB;
+  if((inst & 0xFE00) == 0x5E00) return Op::LDRSH;
+  if((inst & 0xF800) == 0x0000) return Op::LSL1;
+  if((inst & 0xFFC0) == 0x4080) return Op::LSL2;
+  if((inst & 0xF800) == 0x0800) return Op::LSR1;
+  if((inst & 0xFFC0) == 0x40C0) return Op::LSR2;
+  if((inst & 0xF800) == 0x2000) return Op::MOV1;
+  if((inst & 0xFFC0) == 0x1C00) return Op::MOV2;
+  if((inst & 0xFF00) == 0x4600) return Op::MOV3;
+  if((inst & 0xFFC0) == 0x4340) return Op::MUL;
+  if((inst & 0xFFC0) == 0x43C0) return Op::MVN;
+  if((inst & 0xFFC0) == 0x4240) return Op::NEG;
+  if((inst & 0xFFC0) == 0x4300) return Op::ORR;
+  if((inst & 0xFE00) == 0xBC00) return Op::POP;
+  if((inst & 0xFE00) == 0xB400) return Op::PUSH;
+  if((inst & 0xFFC0) == 0xBA00) return Op::REV;
+  if((inst & 0xFFC0) == 0xBA40) return Op::REV16;
+  if((inst & 0xFFC0) == 0xBAC0) return Op::REVSH;
+  if((inst & 0xFFC0) == 0x41C0) return Op::ROR;
+  if((inst & 0xFFC0) == 0x4180) return Op::SBC;
+  if((inst & 0xFFF7) == 0xB650) return Op::SETEND;
+  if((inst & 0xF800) == 0xC000) return Op::STMIA;
+  if((inst & 0xF800) == 0x6000) return Op::STR1;
+  if((inst & 0xFE00) == 0x5000) return Op::STR2;
+  if((inst & 0xF800) == 0x9000) return Op::STR3;
+  if((inst & 0xF800) == 0x7000) return Op::STRB1;
+  if((inst & 0xFE00) == 0x5400) return Op::STRB2;
+  if((inst & 0xF800) == 0x8000) return Op::STRH1;
+  if((inst & 0xFE00) == 0x5200) return Op::STRH2;
+  if((inst & 0xFE00) == 0x1E00) return Op::SUB1;
+  if((inst & 0xF800) == 0x3800) return Op::SUB2;
+  if((inst & 0xFE00) == 0x1A00) return Op::SUB3;
+  if((inst & 0xFF80) == 0xB080) return Op::SUB4;
+  if((inst & 0xFF00) == 0xDF00) return Op::SWI;
+  if((inst & 0xFFC0) == 0xB240) return Op::SXTB;
+  if((inst & 0xFFC0) == 0xB200) return Op::SXTH;
+  if((inst & 0xFFC0) == 0x4200) return Op::TST;
+  if((inst & 0xFFC0) == 0xB2C0) return Op::UXTB;
+  if((inst & 0xFFC0) == 0xB280) return Op::UXTH;
+
+  return Op::INVALID;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const Thumbulator::Op* Thumbulator::decodeTable()
+{
+  // Built the first time it's used, and shared by every instance
+  static const struct Table {
+    Table() {
+      for(uInt32 inst = 0; inst < 0x10000; ++inst)
+        ops[inst] = decodeInstructionWord(uInt16(inst));
+    }
+    Op ops[0x10000];
+  } table;
+
+  return table.ops;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Thumbulator::execute()
 {
-  uInt32 pc, sp, inst, ra, rb, rc, rm, rd, rn, rs, op;
+  uInt32 pc, inst;
 
   pc = read_register(15);
 
@@ -596,33 +835,42 @@ int Thumbulator::execute()
 
   instructions++;
 
-  //ADC
-  if((inst & 0xFFC0) == 0x4140)
-  {
-    rd = (inst >> 0) & 0x07;
-    rm = (inst >> 3) & 0x07;
-    DO_DISS(statusMsg << "adc r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra + rb;
-    if(cpsr & CPSR_C)
-      rc++;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    if(cpsr & CPSR_C) { do_cflag(ra, rb, 1); do_vflag(ra, rb, 1); }
-    else              { do_cflag(ra, rb, 0); do_vflag(ra, rb, 0); }
-    return 0;
-  }
+  return execute(opTable[inst], inst, pc);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Thumbulator::execute(Op decoded, uInt32 inst, uInt32 pc)
+{
+  uInt32 sp, ra, rb, rc, rm, rd, rn, rs, op;
 
-  //ADD(1) small immediate two registers
-  if((inst & 0xFE00) == 0x1C00)
+  switch(decoded)
   {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rb = (inst >> 6) & 0x7;
-    if(rb)
+    //ADC
+    case Op::ADC:
+    {
+      rd = (inst >> 0) & 0x07;
+      rm = (inst >> 3) & 0x07;
+      DO_DISS(statusMsg << "adc r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra + rb;
+      if(cpsr & CPSR_C)
+        rc++;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      if(cpsr & CPSR_C) { do_cflag(ra, rb, 1); do_vflag(ra, rb, 1); }
+      else              { do_cflag(ra, rb, 0); do_vflag(ra, rb, 0); }
+      return 0;
+    }
+
+    //ADD(1) small immediate two registers
+    case Op::ADD1:
     {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rb = (inst >> 6) & 0x7;
+      //an immediate of 0 is decoded as a mov
       DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ","
                         << "#0x" << Base::HEX2 << rb << endl);
       ra = read_register(rn);
@@ -635,1623 +883,1874 @@ int Thumbulator::execute()
       do_vflag(ra, rb, 0);
       return 0;
     }
-    else
+
+    //ADD(2) big immediate one register
+    case Op::ADD2:
     {
-      //this is a mov
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x7;
+      DO_DISS(statusMsg << "adds r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(rd);
+      rc = ra + rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, rb, 0);
+      do_vflag(ra, rb, 0);
+      return 0;
     }
-  }
-
-  //ADD(2) big immediate one register
-  if((inst & 0xF800) == 0x3000)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x7;
-    DO_DISS(statusMsg << "adds r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(rd);
-    rc = ra + rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, rb, 0);
-    do_vflag(ra, rb, 0);
-    return 0;
-  }
 
-  //ADD(3) three registers
-  if((inst & 0xFE00) == 0x1800)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ",r" << rm << endl);
-    ra = read_register(rn);
-    rb = read_register(rm);
-    rc = ra + rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, rb, 0);
-    do_vflag(ra, rb, 0);
-    return 0;
-  }
-
-  //ADD(4) two registers one or both high no flags
-  if((inst & 0xFF00) == 0x4400)
-  {
-    if((inst >> 6) & 3)
+    //ADD(3) three registers
+    case Op::ADD3:
     {
-      //UNPREDICTABLE
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "adds r" << dec << rd << ",r" << dec << rn << ",r" << rm << endl);
+      ra = read_register(rn);
+      rb = read_register(rm);
+      rc = ra + rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, rb, 0);
+      do_vflag(ra, rb, 0);
+      return 0;
     }
-    rd  = (inst >> 0) & 0x7;
-    rd |= (inst >> 4) & 0x8;
-    rm  = (inst >> 3) & 0xF;
-    DO_DISS(statusMsg << "add r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra + rb;
-    if(rd == 15)
+
+    //ADD(4) two registers one or both high no flags
+    case Op::ADD4:
     {
-      if((rc & 1) == 0)
-        fatalError("add pc", pc, rc, " produced an arm address");
+      if((inst >> 6) & 3)
+      {
+        //UNPREDICTABLE
+      }
+      rd  = (inst >> 0) & 0x7;
+      rd |= (inst >> 4) & 0x8;
+      rm  = (inst >> 3) & 0xF;
+      DO_DISS(statusMsg << "add r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra + rb;
+      if(rd == 15)
+      {
+        if((rc & 1) == 0)
+          fatalError("add pc", pc, rc, " produced an arm address");
 
-      rc &= ~1; //write_register may do this as well
-      rc += 2;  //The program counter is special
+        rc &= ~1; //write_register may do this as well
+        rc += 2;  //The program counter is special
+      }
+      //fprintf(stderr,"0x%08X = 0x%08X + 0x%08X\n",rc,ra,rb);
+      write_register(rd, rc);
+      return 0;
     }
-    //fprintf(stderr,"0x%08X = 0x%08X + 0x%08X\n",rc,ra,rb);
-    write_register(rd, rc);
-    return 0;
-  }
 
-  //ADD(5) rd = pc plus immediate
-  if((inst & 0xF800) == 0xA000)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x7;
-    rb <<= 2;
-    DO_DISS(statusMsg << "add r" << dec << rd << ",PC,#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(15);
-    rc = (ra & (~3u)) + rb;
-    write_register(rd, rc);
-    return 0;
-  }
+    //ADD(5) rd = pc plus immediate
+    case Op::ADD5:
+    {
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x7;
+      rb <<= 2;
+      DO_DISS(statusMsg << "add r" << dec << rd << ",PC,#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(15);
+      rc = (ra & (~3u)) + rb;
+      write_register(rd, rc);
+      return 0;
+    }
 
-  //ADD(6) rd = sp plus immediate
-  if((inst & 0xF800) == 0xA800)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x7;
-    rb <<= 2;
-    DO_DISS(statusMsg << "add r" << dec << rd << ",SP,#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(13);
-    rc = ra + rb;
-    write_register(rd, rc);
-    return 0;
-  }
+    //ADD(6) rd = sp plus immediate
+    case Op::ADD6:
+    {
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x7;
+      rb <<= 2;
+      DO_DISS(statusMsg << "add r" << dec << rd << ",SP,#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(13);
+      rc = ra + rb;
+      write_register(rd, rc);
+      return 0;
+    }
 
-  //ADD(7) sp plus immediate
-  if((inst & 0xFF80) == 0xB000)
-  {
-    rb = (inst >> 0) & 0x7F;
-    rb <<= 2;
-    DO_DISS(statusMsg << "add SP,#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(13);
-    rc = ra + rb;
-    write_register(13, rc);
-    return 0;
-  }
+    //ADD(7) sp plus immediate
+    case Op::ADD7:
+    {
+      rb = (inst >> 0) & 0x7F;
+      rb <<= 2;
+      DO_DISS(statusMsg << "add SP,#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(13);
+      rc = ra + rb;
+      write_register(13, rc);
+      return 0;
+    }
 
-  //AND
-  if((inst & 0xFFC0) == 0x4000)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "ands r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra & rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
+    //AND
+    case Op::AND:
+    {
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "ands r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra & rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
+    }
 
-  //ASR(1) two register immediate
-  if((inst & 0xF800) == 0x1000)
-  {
-    rd = (inst >> 0) & 0x07;
-    rm = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
-    rc = read_register(rm);
-    if(rb == 0)
+    //ASR(1) two register immediate
+    case Op::ASR1:
     {
-      if(rc & 0x80000000)
+      rd = (inst >> 0) & 0x07;
+      rm = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
+      rc = read_register(rm);
+      if(rb == 0)
       {
-        do_cflag_bit(1);
-        rc = ~0;
+        if(rc & 0x80000000)
+        {
+          do_cflag_bit(1);
+          rc = ~0;
+        }
+        else
+        {
+          do_cflag_bit(0);
+          rc = 0;
+        }
       }
       else
       {
-        do_cflag_bit(0);
-        rc = 0;
+        do_cflag_bit(rc & (1 << (rb-1)));
+        ra = rc & 0x80000000;
+        rc >>= rb;
+        if(ra) //asr, sign is shifted in
+          rc |= (~0u) << (32-rb);
       }
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    else
-    {
-      do_cflag_bit(rc & (1 << (rb-1)));
-      ra = rc & 0x80000000;
-      rc >>= rb;
-      if(ra) //asr, sign is shifted in
-        rc |= (~0u) << (32-rb);
-    }
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
 
-  //ASR(2) two register
-  if((inst & 0xFFC0) == 0x4100)
-  {
-    rd = (inst >> 0) & 0x07;
-    rs = (inst >> 3) & 0x07;
-    DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rs << endl);
-    rc = read_register(rd);
-    rb = read_register(rs);
-    rb &= 0xFF;
-    if(rb == 0)
-    {
-    }
-    else if(rb < 32)
+    //ASR(2) two register
+    case Op::ASR2:
     {
-      do_cflag_bit(rc & (1 << (rb-1)));
-      ra = rc & 0x80000000;
-      rc >>= rb;
-      if(ra) //asr, sign is shifted in
+      rd = (inst >> 0) & 0x07;
+      rs = (inst >> 3) & 0x07;
+      DO_DISS(statusMsg << "asrs r" << dec << rd << ",r" << dec << rs << endl);
+      rc = read_register(rd);
+      rb = read_register(rs);
+      rb &= 0xFF;
+      if(rb == 0)
       {
-        rc |= (~0u) << (32-rb);
       }
-    }
-    else
-    {
-      if(rc & 0x80000000)
+      else if(rb < 32)
       {
-        do_cflag_bit(1);
-        rc = (~0u);
+        do_cflag_bit(rc & (1 << (rb-1)));
+        ra = rc & 0x80000000;
+        rc >>= rb;
+        if(ra) //asr, sign is shifted in
+        {
+          rc |= (~0u) << (32-rb);
+        }
       }
       else
       {
-        do_cflag_bit(0);
-        rc = 0;
+        if(rc & 0x80000000)
+        {
+          do_cflag_bit(1);
+          rc = (~0u);
+        }
+        else
+        {
+          do_cflag_bit(0);
+          rc = 0;
+        }
       }
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
-
-  //B(1) conditional branch
-  if((inst & 0xF000) == 0xD000)
-  {
-    rb = (inst >> 0) & 0xFF;
-    if(rb & 0x80)
-      rb |= (~0u) << 8;
-    op=(inst >> 8) & 0xF;
-    rb <<= 1;
-    rb += pc;
-    rb += 2;
-    switch(op)
-    {
-      case 0x0: //b eq  z set
-        DO_DISS(statusMsg << "beq 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr & CPSR_Z)
-          write_register(15, rb);
-        return 0;
-
-      case 0x1: //b ne  z clear
-        DO_DISS(statusMsg << "bne 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr & CPSR_Z))
-          write_register(15, rb);
-        return 0;
-
-      case 0x2: //b cs c set
-        DO_DISS(statusMsg << "bcs 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr & CPSR_C)
-          write_register(15, rb);
-        return 0;
-
-      case 0x3: //b cc c clear
-        DO_DISS(statusMsg << "bcc 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr & CPSR_C))
-          write_register(15, rb);
-        return 0;
-
-      case 0x4: //b mi n set
-        DO_DISS(statusMsg << "bmi 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr & CPSR_N)
-          write_register(15, rb);
-        return 0;
-
-      case 0x5: //b pl n clear
-        DO_DISS(statusMsg << "bpl 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr & CPSR_N))
-          write_register(15, rb);
-        return 0;
-
-      case 0x6: //b vs v set
-        DO_DISS(statusMsg << "bvs 0x" << Base::HEX8 << (rb-3) << endl);
-        if(cpsr & CPSR_V)
-          write_register(15,rb);
-        return 0;
-
-      case 0x7: //b vc v clear
-        DO_DISS(statusMsg << "bvc 0x" << Base::HEX8 << (rb-3) << endl);
-        if(!(cpsr & CPSR_V))
-          write_register(15, rb);
-        return 0;
-
-      case 0x8: //b hi c set z clear
-        DO_DISS(statusMsg << "bhi 0x" << Base::HEX8 << (rb-3) << endl);
-        if((cpsr & CPSR_C) && (!(cpsr & CPSR_Z)))
-          write_register(15, rb);
-        return 0;
-
-      case 0x9: //b ls c clear or z set
-        DO_DISS(statusMsg << "bls 0x" << Base::HEX8 << (rb-3) << endl);
-        if((cpsr & CPSR_Z) || (!(cpsr & CPSR_C)))
-          write_register(15, rb);
-        return 0;
-
-      case 0xA: //b ge N == V
-        DO_DISS(statusMsg << "bge 0x" << Base::HEX8 << (rb-3) << endl);
-        ra = 0;
-        if(  (cpsr & CPSR_N)  &&   (cpsr & CPSR_V) ) ra++;
-        if((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))) ra++;
-        if(ra)
-          write_register(15, rb);
-        return 0;
-
-      case 0xB: //b lt N != V
-        DO_DISS(statusMsg << "blt 0x" << Base::HEX8 << (rb-3) << endl);
-        ra = 0;
-        if((!(cpsr & CPSR_N)) && (cpsr & CPSR_V)) ra++;
-        if((!(cpsr & CPSR_V)) && (cpsr & CPSR_N)) ra++;
-        if(ra)
-          write_register(15, rb);
-        return 0;
-
-      case 0xC: //b gt Z==0 and N == V
-        DO_DISS(statusMsg << "bgt 0x" << Base::HEX8 << (rb-3) << endl);
-        ra = 0;
-        if(  (cpsr & CPSR_N)  &&   (cpsr & CPSR_V) ) ra++;
-        if((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))) ra++;
-        if(cpsr & CPSR_Z) ra = 0;
-        if(ra)
-          write_register(15, rb);
-        return 0;
-
-      case 0xD: //b le Z==1 or N != V
-        DO_DISS(statusMsg << "ble 0x" << Base::HEX8 << (rb-3) << endl);
-        ra = 0;
-        if((!(cpsr & CPSR_N)) && (cpsr & CPSR_V)) ra++;
-        if((!(cpsr & CPSR_V)) && (cpsr & CPSR_N)) ra++;
-        if(cpsr & CPSR_Z) ra++;
-        if(ra)
-          write_register(15, rb);
-        return 0;
-
-      case 0xE:
-        //undefined instruction
-        break;
-
-      case 0xF:
-        //swi
-        break;
-    }
-  }
-
-  //B(2) unconditional branch
-  if((inst & 0xF800) == 0xE000)
-  {
-    rb = (inst >> 0) & 0x7FF;
-    if(rb & (1 << 10))
-      rb |= (~0u) << 11;
-    rb <<= 1;
-    rb += pc;
-    rb += 2;
-    DO_DISS(statusMsg << "B 0x" << Base::HEX8 << (rb-3) << endl);
-    write_register(15, rb);
-    return 0;
-  }
-
-  //BIC
-  if((inst & 0xFFC0) == 0x4380)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "bics r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra & (~rb);
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
-
-  //BKPT
-  if((inst & 0xFF00) == 0xBE00)
-  {
-    rb = (inst >> 0) & 0xFF;
-    statusMsg << "bkpt 0x" << Base::HEX2 << rb << endl;
-    return 1;
-  }
 
-  //BL/BLX(1)
-  if((inst & 0xE000) == 0xE000) //BL,BLX
-  {
-    if((inst & 0x1800) == 0x1000) //H=b10
+    //B(1) conditional branch
+    case Op::B1:
     {
-      DO_DISS(statusMsg << endl);
-      rb = inst & ((1 << 11) - 1);
-      if(rb & 1<<10) rb |= (~((1 << 11) - 1)); //sign extend
-      rb <<= 12;
+      rb = (inst >> 0) & 0xFF;
+      if(rb & 0x80)
+        rb |= (~0u) << 8;
+      op=(inst >> 8) & 0xF;
+      rb <<= 1;
       rb += pc;
-      write_register(14, rb);
-      return 0;
-    }
-    else if((inst & 0x1800) == 0x1800) //H=b11
-    {
-      //branch to thumb
-      rb = read_register(14);
-      rb += (inst & ((1 << 11) - 1)) << 1;;
       rb += 2;
-      DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
-      write_register(14, (pc-2) | 1);
-      write_register(15, rb);
-      return 0;
+      switch(op)
+      {
+        case 0x0: //b eq  z set
+          DO_DISS(statusMsg << "beq 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr & CPSR_Z)
+            write_register(15, rb);
+          return 0;
+
+        case 0x1: //b ne  z clear
+          DO_DISS(statusMsg << "bne 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr & CPSR_Z))
+            write_register(15, rb);
+          return 0;
+
+        case 0x2: //b cs c set
+          DO_DISS(statusMsg << "bcs 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr & CPSR_C)
+            write_register(15, rb);
+          return 0;
+
+        case 0x3: //b cc c clear
+          DO_DISS(statusMsg << "bcc 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr & CPSR_C))
+            write_register(15, rb);
+          return 0;
+
+        case 0x4: //b mi n set
+          DO_DISS(statusMsg << "bmi 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr & CPSR_N)
+            write_register(15, rb);
+          return 0;
+
+        case 0x5: //b pl n clear
+          DO_DISS(statusMsg << "bpl 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr & CPSR_N))
+            write_register(15, rb);
+          return 0;
+
+        case 0x6: //b vs v set
+          DO_DISS(statusMsg << "bvs 0x" << Base::HEX8 << (rb-3) << endl);
+          if(cpsr & CPSR_V)
+            write_register(15,rb);
+          return 0;
+
+        case 0x7: //b vc v clear
+          DO_DISS(statusMsg << "bvc 0x" << Base::HEX8 << (rb-3) << endl);
+          if(!(cpsr & CPSR_V))
+            write_register(15, rb);
+          return 0;
+
+        case 0x8: //b hi c set z clear
+          DO_DISS(statusMsg << "bhi 0x" << Base::HEX8 << (rb-3) << endl);
+          if((cpsr & CPSR_C) && (!(cpsr & CPSR_Z)))
+            write_register(15, rb);
+          return 0;
+
+        case 0x9: //b ls c clear or z set
+          DO_DISS(statusMsg << "bls 0x" << Base::HEX8 << (rb-3) << endl);
+          if((cpsr & CPSR_Z) || (!(cpsr & CPSR_C)))
+            write_register(15, rb);
+          return 0;
+
+        case 0xA: //b ge N == V
+          DO_DISS(statusMsg << "bge 0x" << Base::HEX8 << (rb-3) << endl);
+          ra = 0;
+          if(  (cpsr & CPSR_N)  &&   (cpsr & CPSR_V) ) ra++;
+          if((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))) ra++;
+          if(ra)
+            write_register(15, rb);
+          return 0;
+
+        case 0xB: //b lt N != V
+          DO_DISS(statusMsg << "blt 0x" << Base::HEX8 << (rb-3) << endl);
+          ra = 0;
+          if((!(cpsr & CPSR_N)) && (cpsr & CPSR_V)) ra++;
+          if((!(cpsr & CPSR_V)) && (cpsr & CPSR_N)) ra++;
+          if(ra)
+            write_register(15, rb);
+          return 0;
+
+        case 0xC: //b gt Z==0 and N == V
+          DO_DISS(statusMsg << "bgt 0x" << Base::HEX8 << (rb-3) << endl);
+          ra = 0;
+          if(  (cpsr & CPSR_N)  &&   (cpsr & CPSR_V) ) ra++;
+          if((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))) ra++;
+          if(cpsr & CPSR_Z) ra = 0;
+          if(ra)
+            write_register(15, rb);
+          return 0;
+
+        case 0xD: //b le Z==1 or N != V
+          DO_DISS(statusMsg << "ble 0x" << Base::HEX8 << (rb-3) << endl);
+          ra = 0;
+          if((!(cpsr & CPSR_N)) && (cpsr & CPSR_V)) ra++;
+          if((!(cpsr & CPSR_V)) && (cpsr & CPSR_N)) ra++;
+          if(cpsr & CPSR_Z) ra++;
+          if(ra)
+            write_register(15, rb);
+          return 0;
+
+        case 0xE:
+          //undefined instruction
+          break;
+
+        case 0xF:
+          //swi
+          break;
+      }
+      //neither of the last two is decoded as a conditional branch
+      break;
     }
-    else if((inst & 0x1800) == 0x0800) //H=b01
+
+    //B(2) unconditional branch
+    case Op::B2:
     {
-      //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
-      // fxq: this should exit the code without having to detect it
-      rb = read_register(14);
-      rb += (inst & ((1 << 11) - 1)) << 1;;
-      rb &= 0xFFFFFFFC;
+      rb = (inst >> 0) & 0x7FF;
+      if(rb & (1 << 10))
+        rb |= (~0u) << 11;
+      rb <<= 1;
+      rb += pc;
       rb += 2;
-      DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
-      write_register(14, (pc-2) | 1);
+      DO_DISS(statusMsg << "B 0x" << Base::HEX8 << (rb-3) << endl);
       write_register(15, rb);
       return 0;
     }
-  }
 
-  //BLX(2)
-  if((inst & 0xFF87) == 0x4780)
-  {
-    rm = (inst >> 3) & 0xF;
-    DO_DISS(statusMsg << "blx r" << dec << rm << endl);
-    rc = read_register(rm);
-    //fprintf(stderr,"blx r%u 0x%X 0x%X\n",rm,rc,pc);
-    rc += 2;
-    if(rc & 1)
+    //BIC
+    case Op::BIC:
     {
-      write_register(14, (pc-2) | 1);
-      rc &= ~1;
-      write_register(15, rc);
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "bics r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra & (~rb);
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
       return 0;
     }
-    else
+
+    //BKPT
+    case Op::BKPT:
     {
-      //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
-      // fxq: this could serve as exit code
+      rb = (inst >> 0) & 0xFF;
+      statusMsg << "bkpt 0x" << Base::HEX2 << rb << endl;
       return 1;
     }
-  }
 
-  //BX
-  if((inst & 0xFF87) == 0x4700)
-  {
-    rm = (inst >> 3) & 0xF;
-    DO_DISS(statusMsg << "bx r" << dec << rm << endl);
-    rc = read_register(rm);
-    rc += 2;
-    //fprintf(stderr,"bx r%u 0x%X 0x%X\n",rm,rc,pc);
-    if(rc & 1)
+    //BL/BLX(1)
+    case Op::BL:
     {
-      // branch to odd address denotes 16 bit ARM code
-      rc &= ~1;
-      write_register(15, rc);
-      return 0;
+      if((inst & 0x1800) == 0x1000) //H=b10
+      {
+        DO_DISS(statusMsg << endl);
+        rb = inst & ((1 << 11) - 1);
+        if(rb & 1<<10) rb |= (~((1 << 11) - 1)); //sign extend
+        rb <<= 12;
+        rb += pc;
+        write_register(14, rb);
+        return 0;
+      }
+      else if((inst & 0x1800) == 0x1800) //H=b11
+      {
+        //branch to thumb
+        rb = read_register(14);
+        rb += (inst & ((1 << 11) - 1)) << 1;;
+        rb += 2;
+        DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
+        write_register(14, (pc-2) | 1);
+        write_register(15, rb);
+        return 0;
+      }
+      else if((inst & 0x1800) == 0x0800) //H=b01
+      {
+        //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
+        // fxq: this should exit the code without having to detect it
+        rb = read_register(14);
+        rb += (inst & ((1 << 11) - 1)) << 1;;
+        rb &= 0xFFFFFFFC;
+        rb += 2;
+        DO_DISS(statusMsg << "bl 0x" << Base::HEX8 << (rb-3) << endl);
+        write_register(14, (pc-2) | 1);
+        write_register(15, rb);
+        return 0;
+      }
+      //H=b00 is decoded as B(2)
+      break;
     }
-    else
+
+    //BLX(2)
+    case Op::BLX2:
     {
-      // branch to even address denotes 32 bit ARM code, which the Thumbulator
-      // class does not support. So capture relavent information and hand it
-      // off to the Cartridge class for it to handle.
-
-      bool handled = false;
-
-      switch(configuration)
-      {
-        case ConfigureFor::BUS:
-          // this subroutine interface is used in the BUS driver,
-          // it starts at address 0x000006d8
-          // _SetNote:
-          //   ldr     r4, =NoteStore
-          //   bx      r4   // bx instruction at 0x000006da
-          // _ResetWave:
-          //   ldr     r4, =ResetWaveStore
-          //   bx      r4   // bx instruction at 0x000006de
-          // _GetWavePtr:
-          //   ldr     r4, =WavePtrFetch
-          //   bx      r4   // bx instruction at 0x000006e2
-          // _SetWaveSize:
-          //   ldr     r4, =WaveSizeStore
-          //   bx      r4   // bx instruction at 0x000006e6
-          
-          // address to test for is + 4 due to pipelining
-          
-#define BUS_SetNote     (0x000006da + 4)
-#define BUS_ResetWave   (0x000006de + 4)
-#define BUS_GetWavePtr  (0x000006e2 + 4)
-#define BUS_SetWaveSize (0x000006e6 + 4)
-          
-          if      (pc == BUS_SetNote)
-          {
-            myCartridge->thumbCallback(0, read_register(2), read_register(3));
-            handled = true;
-          }
-          else if (pc == BUS_ResetWave)
-          {
-            myCartridge->thumbCallback(1, read_register(2), 0);
-            handled = true;
-          }
-          else if (pc == BUS_GetWavePtr)
-          {
-            write_register(2, myCartridge->thumbCallback(2, read_register(2), 0));
-            handled = true;
-          }
-          else if (pc == BUS_SetWaveSize)
-          {
-            myCartridge->thumbCallback(3, read_register(2), read_register(3));
-            handled = true;
-          }
-          else if (pc == 0x0000083a)
-          {
-            // exiting Custom ARM code, returning to BUS Driver control
-          }
-          else
-          {
-#if 0  // uncomment this for testing
-            uInt32 r0 = read_register(0);
-            uInt32 r1 = read_register(1);
-            uInt32 r2 = read_register(2);
-            uInt32 r3 = read_register(3);
-            uInt32 r4 = read_register(4);
-#endif
-            myCartridge->thumbCallback(255, 0, 0);
-          }
-          
-          break;
-          
-        case ConfigureFor::CDF:
-          // this subroutine interface is used in the CDF driver,
-          // it starts at address 0x000006e0
-          // _SetNote:
-          //   ldr     r4, =NoteStore
-          //   bx      r4   // bx instruction at 0x000006e2
-          // _ResetWave:
-          //   ldr     r4, =ResetWaveStore
-          //   bx      r4   // bx instruction at 0x000006e6
-          // _GetWavePtr:
-          //   ldr     r4, =WavePtrFetch
-          //   bx      r4   // bx instruction at 0x000006ea
-          // _SetWaveSize:
-          //   ldr     r4, =WaveSizeStore
-          //   bx      r4   // bx instruction at 0x000006ee
-
-          // address to test for is + 4 due to pipelining
-
-        #define CDF_SetNote     (0x000006e2 + 4)
-        #define CDF_ResetWave   (0x000006e6 + 4)
-        #define CDF_GetWavePtr  (0x000006ea + 4)
-        #define CDF_SetWaveSize (0x000006ee + 4)
-
-          if      (pc == CDF_SetNote)
-          {
-            myCartridge->thumbCallback(0, read_register(2), read_register(3));
-            handled = true;
-          }
-          else if (pc == CDF_ResetWave)
-          {
-            myCartridge->thumbCallback(1, read_register(2), 0);
-            handled = true;
-          }
-          else if (pc == CDF_GetWavePtr)
-          {
-            write_register(2, myCartridge->thumbCallback(2, read_register(2), 0));
-            handled = true;
-          }
-          else if (pc == CDF_SetWaveSize)
-          {
-            myCartridge->thumbCallback(3, read_register(2), read_register(3));
-            handled = true;
-          }
-          else if (pc == 0x0000083a)
-          {
-            // exiting Custom ARM code, returning to BUS Driver control
-          }
-          else
-          {
-          #if 0  // uncomment this for testing
-            uInt32 r0 = read_register(0);
-            uInt32 r1 = read_register(1);
-            uInt32 r2 = read_register(2);
-            uInt32 r3 = read_register(3);
-            uInt32 r4 = read_register(4);
-          #endif
-            myCartridge->thumbCallback(255, 0, 0);
-          }
-
-          break;
-
-        case ConfigureFor::DPCplus:
-          // no 32-bit subroutines in DPC+
-          break;
+      rm = (inst >> 3) & 0xF;
+      DO_DISS(statusMsg << "blx r" << dec << rm << endl);
+      rc = read_register(rm);
+      //fprintf(stderr,"blx r%u 0x%X 0x%X\n",rm,rc,pc);
+      rc += 2;
+      if(rc & 1)
+      {
+        write_register(14, (pc-2) | 1);
+        rc &= ~1;
+        write_register(15, rc);
+        return 0;
+      }
+      else
+      {
+        //fprintf(stderr,"cannot branch to arm 0x%08X 0x%04X\n",pc,inst);
+        // fxq: this could serve as exit code
+        return 1;
       }
+    }
 
-      if (handled)
+    //BX
+    case Op::BX:
+    {
+      rm = (inst >> 3) & 0xF;
+      DO_DISS(statusMsg << "bx r" << dec << rm << endl);
+      rc = read_register(rm);
+      rc += 2;
+      //fprintf(stderr,"bx r%u 0x%X 0x%X\n",rm,rc,pc);
+      if(rc & 1)
       {
-        rc = read_register(14); // lr
-        rc += 2;
+        // branch to odd address denotes 16 bit ARM code
         rc &= ~1;
         write_register(15, rc);
         return 0;
       }
+      else
+      {
+        // branch to even address denotes 32 bit ARM code, which the Thumbulator
+        // class does not support. So capture relavent information and hand it
+        // off to the Cartridge class for it to handle.
 
-      return 1;
-    }
-  }
-
-  //CMN
-  if((inst & 0xFFC0) == 0x42C0)
-  {
-    rn = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "cmns r" << dec << rn << ",r" << dec << rm << endl);
-    ra = read_register(rn);
-    rb = read_register(rm);
-    rc = ra + rb;
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, rb, 0);
-    do_vflag(ra, rb, 0);
-    return 0;
-  }
+        bool handled = false;
 
-  //CMP(1) compare immediate
-  if((inst & 0xF800) == 0x2800)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rn = (inst >> 8) & 0x07;
-    DO_DISS(statusMsg << "cmp r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(rn);
-    rc = ra - rb;
-    //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, ~rb, 1);
-    do_vflag(ra, ~rb, 1);
-    return 0;
-  }
+        switch(configuration)
+        {
+          case ConfigureFor::BUS:
+            // this subroutine interface is used in the BUS driver,
+            // it starts at address 0x000006d8
+            // _SetNote:
+            //   ldr     r4, =NoteStore
+            //   bx      r4   // bx instruction at 0x000006da
+            // _ResetWave:
+            //   ldr     r4, =ResetWaveStore
+            //   bx      r4   // bx instruction at 0x000006de
+            // _GetWavePtr:
+            //   ldr     r4, =WavePtrFetch
+            //   bx      r4   // bx instruction at 0x000006e2
+            // _SetWaveSize:
+            //   ldr     r4, =WaveSizeStore
+            //   bx      r4   // bx instruction at 0x000006e6
+            
+            // address to test for is + 4 due to pipelining
+            
+#define BUS_SetNote     (0x000006da + 4)
+#define BUS_ResetWave   (0x000006de + 4)
+#define BUS_GetWavePtr  (0x000006e2 + 4)
+#define BUS_SetWaveSize (0x000006e6 + 4)
+            
+            if      (pc == BUS_SetNote)
+            {
+              myCartridge->thumbCallback(0, read_register(2), read_register(3));
+              handled = true;
+            }
+            else if (pc == BUS_ResetWave)
+            {
+              myCartridge->thumbCallback(1, read_register(2), 0);
+              handled = true;
+            }
+            else if (pc == BUS_GetWavePtr)
+            {
+              write_register(2, myCartridge->thumbCallback(2, read_register(2), 0));
+              handled = true;
+            }
+            else if (pc == BUS_SetWaveSize)
+            {
+              myCartridge->thumbCallback(3, read_register(2), read_register(3));
+              handled = true;
+            }
+            else if (pc == 0x0000083a)
+            {
+              // exiting Custom ARM code, returning to BUS Driver control
+            }
+            else
+            {
+#if 0  // uncomment this for testing
+              uInt32 r0 = read_register(0);
+              uInt32 r1 = read_register(1);
+              uInt32 r2 = read_register(2);
+              uInt32 r3 = read_register(3);
+              uInt32 r4 = read_register(4);
+#endif
+              myCartridge->thumbCallback(255, 0, 0);
+            }
+            
+            break;
+            
+          case ConfigureFor::CDF:
+            // this subroutine interface is used in the CDF driver,
+            // it starts at address 0x000006e0
+            // _SetNote:
+            //   ldr     r4, =NoteStore
+            //   bx      r4   // bx instruction at 0x000006e2
+            // _ResetWave:
+            //   ldr     r4, =ResetWaveStore
+            //   bx      r4   // bx instruction at 0x000006e6
+            // _GetWavePtr:
+            //   ldr     r4, =WavePtrFetch
+            //   bx      r4   // bx instruction at 0x000006ea
+            // _SetWaveSize:
+            //   ldr     r4, =WaveSizeStore
+            //   bx      r4   // bx instruction at 0x000006ee
+
+            // address to test for is + 4 due to pipelining
+
+          #define CDF_SetNote     (0x000006e2 + 4)
+          #define CDF_ResetWave   (0x000006e6 + 4)
+          #define CDF_GetWavePtr  (0x000006ea + 4)
+          #define CDF_SetWaveSize (0x000006ee + 4)
+
+            if      (pc == CDF_SetNote)
+            {
+              myCartridge->thumbCallback(0, read_register(2), read_register(3));
+              handled = true;
+            }
+            else if (pc == CDF_ResetWave)
+            {
+              myCartridge->thumbCallback(1, read_register(2), 0);
+              handled = true;
+            }
+            else if (pc == CDF_GetWavePtr)
+            {
+              write_register(2, myCartridge->thumbCallback(2, read_register(2), 0));
+              handled = true;
+            }
+            else if (pc == CDF_SetWaveSize)
+            {
+              myCartridge->thumbCallback(3, read_register(2), read_register(3));
+              handled = true;
+            }
+            else if (pc == 0x0000083a)
+            {
+              // exiting Custom ARM code, returning to BUS Driver control
+            }
+            else
+            {
+            #if 0  // uncomment this for testing
+              uInt32 r0 = read_register(0);
+              uInt32 r1 = read_register(1);
+              uInt32 r2 = read_register(2);
+              uInt32 r3 = read_register(3);
+              uInt32 r4 = read_register(4);
+            #endif
+              myCartridge->thumbCallback(255, 0, 0);
+            }
+
+            break;
+
+          case ConfigureFor::DPCplus:
+            // no 32-bit subroutines in DPC+
+            break;
+        }
 
-  //CMP(2) compare register
-  if((inst & 0xFFC0) == 0x4280)
-  {
-    rn = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
-    ra = read_register(rn);
-    rb = read_register(rm);
-    rc = ra - rb;
-    //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, ~rb, 1);
-    do_vflag(ra, ~rb, 1);
-    return 0;
-  }
+        if (handled)
+        {
+          rc = read_register(14); // lr
+          rc += 2;
+          rc &= ~1;
+          write_register(15, rc);
+          return 0;
+        }
 
-  //CMP(3) compare high register
-  if((inst & 0xFF00) == 0x4500)
-  {
-    if(((inst >> 6) & 3) == 0x0)
-    {
-      //UNPREDICTABLE
-    }
-    rn = (inst >> 0) & 0x7;
-    rn |= (inst >> 4) & 0x8;
-    if(rn == 0xF)
-    {
-      //UNPREDICTABLE
-    }
-    rm = (inst >> 3) & 0xF;
-    DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
-    ra = read_register(rn);
-    rb = read_register(rm);
-    rc = ra - rb;
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, ~rb, 1);
-    do_vflag(ra, ~rb, 1);
-    return 0;
-  }
+        return 1;
+      }
+    }
 
-  //CPS
-  if((inst & 0xFFE8) == 0xB660)
-  {
-    DO_DISS(statusMsg << "cps TODO" << endl);
-    return 1;
-  }
+    //CMN
+    case Op::CMN:
+    {
+      rn = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "cmns r" << dec << rn << ",r" << dec << rm << endl);
+      ra = read_register(rn);
+      rb = read_register(rm);
+      rc = ra + rb;
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, rb, 0);
+      do_vflag(ra, rb, 0);
+      return 0;
+    }
 
-  //CPY copy high register
-  if((inst & 0xFFC0) == 0x4600)
-  {
-    //same as mov except you can use both low registers
-    //going to let mov handle high registers
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "cpy r" << dec << rd << ",r" << dec << rm << endl);
-    rc = read_register(rm);
-    write_register(rd, rc);
-    return 0;
-  }
+    //CMP(1) compare immediate
+    case Op::CMP1:
+    {
+      rb = (inst >> 0) & 0xFF;
+      rn = (inst >> 8) & 0x07;
+      DO_DISS(statusMsg << "cmp r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(rn);
+      rc = ra - rb;
+      //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, ~rb, 1);
+      do_vflag(ra, ~rb, 1);
+      return 0;
+    }
 
-  //EOR
-  if((inst & 0xFFC0) == 0x4040)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "eors r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra ^ rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
+    //CMP(2) compare register
+    case Op::CMP2:
+    {
+      rn = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
+      ra = read_register(rn);
+      rb = read_register(rm);
+      rc = ra - rb;
+      //fprintf(stderr,"0x%08X 0x%08X\n",ra,rb);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, ~rb, 1);
+      do_vflag(ra, ~rb, 1);
+      return 0;
+    }
 
-  //LDMIA
-  if((inst & 0xF800) == 0xC800)
-  {
-    rn = (inst >> 8) & 0x7;
-  #if defined(THUMB_DISS)
-    statusMsg << "ldmia r" << dec << rn << "!,{";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //CMP(3) compare high register
+    case Op::CMP3:
     {
-      if(inst&rb)
+      if(((inst >> 6) & 3) == 0x0)
       {
-        if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
+        //UNPREDICTABLE
       }
-    }
-    statusMsg << "}" << endl;
-  #endif
-    sp = read_register(rn);
-    for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
-    {
-      if(inst & rb)
+      rn = (inst >> 0) & 0x7;
+      rn |= (inst >> 4) & 0x8;
+      if(rn == 0xF)
       {
-        write_register(ra, read32(sp));
-        sp += 4;
+        //UNPREDICTABLE
       }
+      rm = (inst >> 3) & 0xF;
+      DO_DISS(statusMsg << "cmps r" << dec << rn << ",r" << dec << rm << endl);
+      ra = read_register(rn);
+      rb = read_register(rm);
+      rc = ra - rb;
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, ~rb, 1);
+      do_vflag(ra, ~rb, 1);
+      return 0;
     }
-    //there is a write back exception.
-    if((inst & (1 << rn)) == 0)
-      write_register(rn, sp);
 
-    return 0;
-  }
+    //CPS
+    case Op::CPS:
+    {
+      DO_DISS(statusMsg << "cps TODO" << endl);
+      return 1;
+    }
 
-  //LDR(1) two register immediate
-  if((inst & 0xF800) == 0x6800)
-  {
-    rd = (inst >> 0) & 0x07;
-    rn = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    rb <<= 2;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb = read_register(rn) + rb;
-    rc = read32(rb);
-    write_register(rd, rc);
-    return 0;
-  }
+    //CPY copy high register
+    case Op::CPY:
+    {
+      //same as mov except you can use both low registers
+      //going to let mov handle high registers
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "cpy r" << dec << rd << ",r" << dec << rm << endl);
+      rc = read_register(rm);
+      write_register(rd, rc);
+      return 0;
+    }
 
-  //LDR(2) three register
-  if((inst & 0xFE00) == 0x5800)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",r" << dec << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read32(rb);
-    write_register(rd, rc);
-    return 0;
-  }
+    //EOR
+    case Op::EOR:
+    {
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "eors r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra ^ rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
+    }
 
-  //LDR(3)
-  if((inst & 0xF800) == 0x4800)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x07;
-    rb <<= 2;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[PC+#0x" << Base::HEX2 << rb << "] ");
-    ra = read_register(15);
-    ra &= ~3;
-    rb += ra;
-    DO_DISS(statusMsg << ";@ 0x" << Base::HEX2 << rb << endl);
-    rc = read32(rb);
-    write_register(rd, rc);
-    return 0;
-  }
+    //LDMIA
+    case Op::LDMIA:
+    {
+      rn = (inst >> 8) & 0x7;
+    #if defined(THUMB_DISS)
+      statusMsg << "ldmia r" << dec << rn << "!,{";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
+      }
+      statusMsg << "}" << endl;
+    #endif
+      sp = read_register(rn);
+      for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
+      {
+        if(inst & rb)
+        {
+          write_register(ra, read32(sp));
+          sp += 4;
+        }
+      }
+      //there is a write back exception.
+      if((inst & (1 << rn)) == 0)
+        write_register(rn, sp);
 
-  //LDR(4)
-  if((inst & 0xF800) == 0x9800)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x07;
-    rb <<= 2;
-    DO_DISS(statusMsg << "ldr r" << dec << rd << ",[SP+#0x" << Base::HEX2 << rb << "]" << endl);
-    ra = read_register(13);
-    //ra&=~3;
-    rb += ra;
-    rc = read32(rb);
-    write_register(rd, rc);
-    return 0;
-  }
+      return 0;
+    }
 
-  //LDRB(1)
-  if((inst & 0xF800) == 0x7800)
-  {
-    rd = (inst >> 0) & 0x07;
-    rn = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb = read_register(rn) + rb;
-    rc = read16(rb & (~1u));
-    if(rb & 1)
+    //LDR(1) two register immediate
+    case Op::LDR1:
     {
-      rc >>= 8;
+      rd = (inst >> 0) & 0x07;
+      rn = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      rb <<= 2;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb = read_register(rn) + rb;
+      rc = read32(rb);
+      write_register(rd, rc);
+      return 0;
     }
-    else
+
+    //LDR(2) three register
+    case Op::LDR2:
     {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",r" << dec << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read32(rb);
+      write_register(rd, rc);
+      return 0;
     }
-    write_register(rd, rc & 0xFF);
-    return 0;
-  }
 
-  //LDRB(2)
-  if((inst & 0xFE00) == 0x5C00)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read16(rb & (~1u));
-    if(rb & 1)
+    //LDR(3)
+    case Op::LDR3:
     {
-      rc >>= 8;
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x07;
+      rb <<= 2;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[PC+#0x" << Base::HEX2 << rb << "] ");
+      ra = read_register(15);
+      ra &= ~3;
+      rb += ra;
+      DO_DISS(statusMsg << ";@ 0x" << Base::HEX2 << rb << endl);
+      rc = read32(rb);
+      write_register(rd, rc);
+      return 0;
     }
-    else
+
+    //LDR(4)
+    case Op::LDR4:
     {
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x07;
+      rb <<= 2;
+      DO_DISS(statusMsg << "ldr r" << dec << rd << ",[SP+#0x" << Base::HEX2 << rb << "]" << endl);
+      ra = read_register(13);
+      //ra&=~3;
+      rb += ra;
+      rc = read32(rb);
+      write_register(rd, rc);
+      return 0;
     }
-    write_register(rd, rc & 0xFF);
-    return 0;
-  }
 
-  //LDRH(1)
-  if((inst & 0xF800) == 0x8800)
-  {
-    rd = (inst >> 0) & 0x07;
-    rn = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    rb <<= 1;
-    DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb=read_register(rn) + rb;
-    rc = read16(rb);
-    write_register(rd, rc & 0xFFFF);
-    return 0;
-  }
+    //LDRB(1)
+    case Op::LDRB1:
+    {
+      rd = (inst >> 0) & 0x07;
+      rn = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb = read_register(rn) + rb;
+      rc = read16(rb & (~1u));
+      if(rb & 1)
+      {
+        rc >>= 8;
+      }
+      else
+      {
+      }
+      write_register(rd, rc & 0xFF);
+      return 0;
+    }
 
-  //LDRH(2)
-  if((inst & 0xFE00) == 0x5A00)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read16(rb);
-    write_register(rd, rc & 0xFFFF);
-    return 0;
-  }
+    //LDRB(2)
+    case Op::LDRB2:
+    {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read16(rb & (~1u));
+      if(rb & 1)
+      {
+        rc >>= 8;
+      }
+      else
+      {
+      }
+      write_register(rd, rc & 0xFF);
+      return 0;
+    }
 
-  //LDRSB
-  if((inst & 0xFE00) == 0x5600)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "ldrsb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read16(rb & (~1u));
-    if(rb & 1)
+    //LDRH(1)
+    case Op::LDRH1:
     {
-      rc >>= 8;
+      rd = (inst >> 0) & 0x07;
+      rn = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      rb <<= 1;
+      DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb=read_register(rn) + rb;
+      rc = read16(rb);
+      write_register(rd, rc & 0xFFFF);
+      return 0;
     }
-    else
+
+    //LDRH(2)
+    case Op::LDRH2:
     {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read16(rb);
+      write_register(rd, rc & 0xFFFF);
+      return 0;
     }
-    rc &= 0xFF;
-    if(rc & 0x80)
-      rc |= ((~0u) << 8);
-    write_register(rd, rc);
-    return 0;
-  }
 
-  //LDRSH
-  if((inst & 0xFE00) == 0x5E00)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "ldrsh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read16(rb);
-    rc &= 0xFFFF;
-    if(rc & 0x8000)
-      rc |= ((~0u) << 16);
-    write_register(rd, rc);
-    return 0;
-  }
+    //LDRSB
+    case Op::LDRSB:
+    {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "ldrsb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read16(rb & (~1u));
+      if(rb & 1)
+      {
+        rc >>= 8;
+      }
+      else
+      {
+      }
+      rc &= 0xFF;
+      if(rc & 0x80)
+        rc |= ((~0u) << 8);
+      write_register(rd, rc);
+      return 0;
+    }
 
-  //LSL(1)
-  if((inst & 0xF800) == 0x0000)
-  {
-    rd = (inst >> 0) & 0x07;
-    rm = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
-    rc = read_register(rm);
-    if(rb == 0)
+    //LDRSH
+    case Op::LDRSH:
     {
-      //if immed_5 == 0
-      //C unaffected
-      //result not shifted
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "ldrsh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read16(rb);
+      rc &= 0xFFFF;
+      if(rc & 0x8000)
+        rc |= ((~0u) << 16);
+      write_register(rd, rc);
+      return 0;
     }
-    else
+
+    //LSL(1)
+    case Op::LSL1:
     {
-      //else immed_5 > 0
-      do_cflag_bit(rc & (1 << (32-rb)));
-      rc <<= rb;
+      rd = (inst >> 0) & 0x07;
+      rm = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
+      rc = read_register(rm);
+      if(rb == 0)
+      {
+        //if immed_5 == 0
+        //C unaffected
+        //result not shifted
+      }
+      else
+      {
+        //else immed_5 > 0
+        do_cflag_bit(rc & (1 << (32-rb)));
+        rc <<= rb;
+      }
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
 
-  //LSL(2) two register
-  if((inst & 0xFFC0) == 0x4080)
-  {
-    rd = (inst >> 0) & 0x07;
-    rs = (inst >> 3) & 0x07;
-    DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rs << endl);
-    rc = read_register(rd);
-    rb = read_register(rs);
-    rb &= 0xFF;
-    if(rb == 0)
+    //LSL(2) two register
+    case Op::LSL2:
     {
+      rd = (inst >> 0) & 0x07;
+      rs = (inst >> 3) & 0x07;
+      DO_DISS(statusMsg << "lsls r" << dec << rd << ",r" << dec << rs << endl);
+      rc = read_register(rd);
+      rb = read_register(rs);
+      rb &= 0xFF;
+      if(rb == 0)
+      {
+      }
+      else if(rb < 32)
+      {
+        do_cflag_bit(rc & (1 << (32-rb)));
+        rc <<= rb;
+      }
+      else if(rb == 32)
+      {
+        do_cflag_bit(rc & 1);
+        rc = 0;
+      }
+      else
+      {
+        do_cflag_bit(0);
+        rc = 0;
+      }
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
+    }
+
+    //LSR(1) two register immediate
+    case Op::LSR1:
+    {
+      rd = (inst >> 0) & 0x07;
+      rm = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
+      rc = read_register(rm);
+      if(rb == 0)
+      {
+        do_cflag_bit(rc & 0x80000000);
+        rc = 0;
+      }
+      else
+      {
+        do_cflag_bit(rc & (1 << (rb-1)));
+        rc >>= rb;
+      }
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    else if(rb < 32)
+
+    //LSR(2) two register
+    case Op::LSR2:
     {
-      do_cflag_bit(rc & (1 << (32-rb)));
-      rc <<= rb;
+      rd = (inst >> 0) & 0x07;
+      rs = (inst >> 3) & 0x07;
+      DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rs << endl);
+      rc = read_register(rd);
+      rb = read_register(rs);
+      rb &= 0xFF;
+      if(rb == 0)
+      {
+      }
+      else if(rb < 32)
+      {
+        do_cflag_bit(rc & (1 << (rb-1)));
+        rc >>= rb;
+      }
+      else if(rb == 32)
+      {
+        do_cflag_bit(rc & 0x80000000);
+        rc = 0;
+      }
+      else
+      {
+        do_cflag_bit(0);
+        rc = 0;
+      }
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    else if(rb == 32)
+
+    //MOV(1) immediate
+    case Op::MOV1:
     {
-      do_cflag_bit(rc & 1);
-      rc = 0;
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x07;
+      DO_DISS(statusMsg << "movs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
+      write_register(rd, rb);
+      do_nflag(rb);
+      do_zflag(rb);
+      return 0;
     }
-    else
+
+    //MOV(2) two low registers
+    case Op::MOV2:
     {
+      rd = (inst >> 0) & 7;
+      rn = (inst >> 3) & 7;
+      DO_DISS(statusMsg << "movs r" << dec << rd << ",r" << dec << rn << endl);
+      rc = read_register(rn);
+      //fprintf(stderr,"0x%08X\n",rc);
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
       do_cflag_bit(0);
-      rc = 0;
+      do_vflag_bit(0);
+      return 0;
     }
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
 
-  //LSR(1) two register immediate
-  if((inst & 0xF800) == 0x0800)
-  {
-    rd = (inst >> 0) & 0x07;
-    rm = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rm << ",#0x" << Base::HEX2 << rb << endl);
-    rc = read_register(rm);
-    if(rb == 0)
+    //MOV(3)
+    case Op::MOV3:
     {
-      do_cflag_bit(rc & 0x80000000);
-      rc = 0;
+      rd  = (inst >> 0) & 0x7;
+      rd |= (inst >> 4) & 0x8;
+      rm  = (inst >> 3) & 0xF;
+      DO_DISS(statusMsg << "mov r" << dec << rd << ",r" << dec << rm << endl);
+      rc = read_register(rm);
+      if((rd == 14) && (rm == 15))
+      {
+        //printf("mov lr,pc warning 0x%08X\n",pc-2);
+        //rc|=1;
+      }
+      if(rd == 15)
+      {
+        rc &= ~1; //write_register may do this as well
+        rc += 2;  //The program counter is special
+      }
+      write_register(rd, rc);
+      return 0;
     }
-    else
+
+    //MUL
+    case Op::MUL:
     {
-      do_cflag_bit(rc & (1 << (rb-1)));
-      rc >>= rb;
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "muls r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra * rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
 
-  //LSR(2) two register
-  if((inst & 0xFFC0) == 0x40C0)
-  {
-    rd = (inst >> 0) & 0x07;
-    rs = (inst >> 3) & 0x07;
-    DO_DISS(statusMsg << "lsrs r" << dec << rd << ",r" << dec << rs << endl);
-    rc = read_register(rd);
-    rb = read_register(rs);
-    rb &= 0xFF;
-    if(rb == 0)
+    //MVN
+    case Op::MVN:
     {
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "mvns r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rm);
+      rc = (~ra);
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    else if(rb < 32)
+
+    //NEG
+    case Op::NEG:
     {
-      do_cflag_bit(rc & (1 << (rb-1)));
-      rc >>= rb;
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "negs r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rm);
+      rc = 0 - ra;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(0, ~ra, 1);
+      do_vflag(0, ~ra, 1);
+      return 0;
     }
-    else if(rb == 32)
+
+    //ORR
+    case Op::ORR:
     {
-      do_cflag_bit(rc & 0x80000000);
-      rc = 0;
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "orrs r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra | rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    else
+
+    //POP
+    case Op::POP:
     {
-      do_cflag_bit(0);
-      rc = 0;
+    #if defined(THUMB_DISS)
+      statusMsg << "pop {";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
+      }
+      if(inst&0x100)
+      {
+        if(rc) statusMsg << ",";
+        statusMsg << "pc";
+      }
+      statusMsg << "}" << endl;
+    #endif
+
+      sp = read_register(13);
+      for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
+      {
+        if(inst & rb)
+        {
+          write_register(ra, read32(sp));
+          sp += 4;
+        }
+      }
+      if(inst & 0x100)
+      {
+        rc = read32(sp);
+        rc += 2;
+        write_register(15, rc);
+        sp += 4;
+      }
+      write_register(13, sp);
+      return 0;
     }
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
 
-  //MOV(1) immediate
-  if((inst & 0xF800) == 0x2000)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x07;
-    DO_DISS(statusMsg << "movs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
-    write_register(rd, rb);
-    do_nflag(rb);
-    do_zflag(rb);
-    return 0;
-  }
+    //PUSH
+    case Op::PUSH:
+    {
+    #if defined(THUMB_DISS)
+      statusMsg << "push {";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+      {
+        if(inst&rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
+      }
+      if(inst&0x100)
+      {
+        if(rc) statusMsg << ",";
+        statusMsg << "lr";
+      }
+      statusMsg << "}" << endl;
+    #endif
 
-  //MOV(2) two low registers
-  if((inst & 0xFFC0) == 0x1C00)
-  {
-    rd = (inst >> 0) & 7;
-    rn = (inst >> 3) & 7;
-    DO_DISS(statusMsg << "movs r" << dec << rd << ",r" << dec << rn << endl);
-    rc = read_register(rn);
-    //fprintf(stderr,"0x%08X\n",rc);
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag_bit(0);
-    do_vflag_bit(0);
-    return 0;
-  }
+      sp = read_register(13);
+      //fprintf(stderr,"sp 0x%08X\n",sp);
+      for(ra = 0, rb = 0x01, rc = 0; rb; rb = (rb << 1) & 0xFF, ra++)
+      {
+        if(inst & rb)
+        {
+          rc++;
+        }
+      }
+      if(inst & 0x100) rc++;
+      rc <<= 2;
+      sp -= rc;
+      rd = sp;
+      for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
+      {
+        if(inst & rb)
+        {
+          write32(rd, read_register(ra));
+          rd += 4;
+        }
+      }
+      if(inst & 0x100)
+      {
+        rc = read_register(14);
+        write32(rd, rc);
+        if((rc & 1) == 0)
+        {
+          // FIXME fprintf(stderr,"push {lr} with an ARM address pc 0x%08X popped 0x%08X\n",pc,rc);
+        }
+      }
+      write_register(13, sp);
+      return 0;
+    }
 
-  //MOV(3)
-  if((inst & 0xFF00) == 0x4600)
-  {
-    rd  = (inst >> 0) & 0x7;
-    rd |= (inst >> 4) & 0x8;
-    rm  = (inst >> 3) & 0xF;
-    DO_DISS(statusMsg << "mov r" << dec << rd << ",r" << dec << rm << endl);
-    rc = read_register(rm);
-    if((rd == 14) && (rm == 15))
+    //REV
+    case Op::REV:
+    {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "rev r" << dec << rd << ",r" << dec << rn << endl);
+      ra = read_register(rn);
+      rc  = ((ra >>  0) & 0xFF) << 24;
+      rc |= ((ra >>  8) & 0xFF) << 16;
+      rc |= ((ra >> 16) & 0xFF) <<  8;
+      rc |= ((ra >> 24) & 0xFF) <<  0;
+      write_register(rd, rc);
+      return 0;
+    }
+
+    //REV16
+    case Op::REV16:
     {
-      //printf("mov lr,pc warning 0x%08X\n",pc-2);
-      //rc|=1;
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "rev16 r" << dec << rd << ",r" << dec << rn << endl);
+      ra = read_register(rn);
+      rc  = ((ra >>  0) & 0xFF) <<  8;
+      rc |= ((ra >>  8) & 0xFF) <<  0;
+      rc |= ((ra >> 16) & 0xFF) << 24;
+      rc |= ((ra >> 24) & 0xFF) << 16;
+      write_register(rd, rc);
+      return 0;
     }
-    if(rd == 15)
+
+    //REVSH
+    case Op::REVSH:
     {
-      rc &= ~1; //write_register may do this as well
-      rc += 2;  //The program counter is special
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "revsh r" << dec << rd << ",r" << dec << rn << endl);
+      ra = read_register(rn);
+      rc  = ((ra >> 0) & 0xFF) << 8;
+      rc |= ((ra >> 8) & 0xFF) << 0;
+      if(rc & 0x8000) rc |= 0xFFFF0000;
+      else            rc &= 0x0000FFFF;
+      write_register(rd, rc);
+      return 0;
     }
-    write_register(rd, rc);
-    return 0;
-  }
-
-  //MUL
-  if((inst & 0xFFC0) == 0x4340)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "muls r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra * rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
-
-  //MVN
-  if((inst & 0xFFC0) == 0x43C0)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "mvns r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rm);
-    rc = (~ra);
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
-
-  //NEG
-  if((inst & 0xFFC0) == 0x4240)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "negs r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rm);
-    rc = 0 - ra;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(0, ~ra, 1);
-    do_vflag(0, ~ra, 1);
-    return 0;
-  }
-
-  //ORR
-  if((inst & 0xFFC0) == 0x4300)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "orrs r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra | rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
 
-  //POP
-  if((inst & 0xFE00) == 0xBC00)
-  {
-  #if defined(THUMB_DISS)
-    statusMsg << "pop {";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //ROR
+    case Op::ROR:
     {
-      if(inst&rb)
+      rd = (inst >> 0) & 0x7;
+      rs = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "rors r" << dec << rd << ",r" << dec << rs << endl);
+      rc = read_register(rd);
+      ra = read_register(rs);
+      ra &= 0xFF;
+      if(ra == 0)
       {
-        if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
       }
+      else
+      {
+        ra &= 0x1F;
+        if(ra == 0)
+        {
+          do_cflag_bit(rc & 0x80000000);
+        }
+        else
+        {
+          do_cflag_bit(rc & (1 << (ra-1)));
+          rb = rc << (32-ra);
+          rc >>= ra;
+          rc |= rb;
+        }
+      }
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    if(inst&0x100)
-    {
-      if(rc) statusMsg << ",";
-      statusMsg << "pc";
-    }
-    statusMsg << "}" << endl;
-  #endif
 
-    sp = read_register(13);
-    for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
+    //SBC
+    case Op::SBC:
     {
-      if(inst & rb)
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "sbc r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rd);
+      rb = read_register(rm);
+      rc = ra - rb;
+      if(!(cpsr & CPSR_C)) rc--;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      if(cpsr & CPSR_C)
       {
-        write_register(ra, read32(sp));
-        sp += 4;
+        do_cflag(ra, ~rb, 1);
+        do_vflag(ra, ~rb, 1);
+      }
+      else
+      {
+        do_cflag(ra, ~rb, 0);
+        do_vflag(ra, ~rb, 0);
       }
+      return 0;
     }
-    if(inst & 0x100)
+
+    //SETEND
+    case Op::SETEND:
     {
-      rc = read32(sp);
-      rc += 2;
-      write_register(15, rc);
-      sp += 4;
+      statusMsg << "setend not implemented" << endl;
+      return 1;
     }
-    write_register(13, sp);
-    return 0;
-  }
 
-  //PUSH
-  if((inst & 0xFE00) == 0xB400)
-  {
-  #if defined(THUMB_DISS)
-    statusMsg << "push {";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //STMIA
+    case Op::STMIA:
     {
-      if(inst&rb)
+      rn = (inst >> 8) & 0x7;
+    #if defined(THUMB_DISS)
+      statusMsg << "stmia r" << dec << rn << "!,{";
+      for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
       {
-        if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
+        if(inst & rb)
+        {
+          if(rc) statusMsg << ",";
+          statusMsg << "r" << dec << ra;
+          rc++;
+        }
+      }
+      statusMsg << "}" << endl;
+    #endif
+
+      sp = read_register(rn);
+      for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
+      {
+        if(inst & rb)
+        {
+          write32(sp, read_register(ra));
+          sp += 4;
+        }
       }
+      write_register(rn, sp);
+      return 0;
     }
-    if(inst&0x100)
+
+    //STR(1)
+    case Op::STR1:
     {
-      if(rc) statusMsg << ",";
-      statusMsg << "lr";
+      rd = (inst >> 0) & 0x07;
+      rn = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      rb <<= 2;
+      DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb = read_register(rn) + rb;
+      rc = read_register(rd);
+      write32(rb, rc);
+      return 0;
     }
-    statusMsg << "}" << endl;
-  #endif
 
-    sp = read_register(13);
-    //fprintf(stderr,"sp 0x%08X\n",sp);
-    for(ra = 0, rb = 0x01, rc = 0; rb; rb = (rb << 1) & 0xFF, ra++)
+    //STR(2)
+    case Op::STR2:
     {
-      if(inst & rb)
-      {
-        rc++;
-      }
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read_register(rd);
+      write32(rb, rc);
+      return 0;
     }
-    if(inst & 0x100) rc++;
-    rc <<= 2;
-    sp -= rc;
-    rd = sp;
-    for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
+
+    //STR(3)
+    case Op::STR3:
     {
-      if(inst & rb)
-      {
-        write32(rd, read_register(ra));
-        rd += 4;
-      }
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x07;
+      rb <<= 2;
+      DO_DISS(statusMsg << "str r" << dec << rd << ",[SP,#0x" << Base::HEX2 << rb << "]" << endl);
+      rb = read_register(13) + rb;
+      //fprintf(stderr,"0x%08X\n",rb);
+      rc = read_register(rd);
+      write32(rb, rc);
+      return 0;
     }
-    if(inst & 0x100)
+
+    //STRB(1)
+    case Op::STRB1:
     {
-      rc = read_register(14);
-      write32(rd, rc);
-      if((rc & 1) == 0)
+      rd = (inst >> 0) & 0x07;
+      rn = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX8 << rb << "]" << endl);
+      rb = read_register(rn) + rb;
+      rc = read_register(rd);
+      ra = read16(rb & (~1u));
+      if(rb & 1)
       {
-        // FIXME fprintf(stderr,"push {lr} with an ARM address pc 0x%08X popped 0x%08X\n",pc,rc);
+        ra &= 0x00FF;
+        ra |= rc << 8;
       }
+      else
+      {
+        ra &= 0xFF00;
+        ra |= rc & 0x00FF;
+      }
+      write16(rb & (~1u), ra & 0xFFFF);
+      return 0;
     }
-    write_register(13, sp);
-    return 0;
-  }
-
-  //REV
-  if((inst & 0xFFC0) == 0xBA00)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "rev r" << dec << rd << ",r" << dec << rn << endl);
-    ra = read_register(rn);
-    rc  = ((ra >>  0) & 0xFF) << 24;
-    rc |= ((ra >>  8) & 0xFF) << 16;
-    rc |= ((ra >> 16) & 0xFF) <<  8;
-    rc |= ((ra >> 24) & 0xFF) <<  0;
-    write_register(rd, rc);
-    return 0;
-  }
 
-  //REV16
-  if((inst & 0xFFC0) == 0xBA40)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "rev16 r" << dec << rd << ",r" << dec << rn << endl);
-    ra = read_register(rn);
-    rc  = ((ra >>  0) & 0xFF) <<  8;
-    rc |= ((ra >>  8) & 0xFF) <<  0;
-    rc |= ((ra >> 16) & 0xFF) << 24;
-    rc |= ((ra >> 24) & 0xFF) << 16;
-    write_register(rd, rc);
-    return 0;
-  }
-
-  //REVSH
-  if((inst & 0xFFC0) == 0xBAC0)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "revsh r" << dec << rd << ",r" << dec << rn << endl);
-    ra = read_register(rn);
-    rc  = ((ra >> 0) & 0xFF) << 8;
-    rc |= ((ra >> 8) & 0xFF) << 0;
-    if(rc & 0x8000) rc |= 0xFFFF0000;
-    else            rc &= 0x0000FFFF;
-    write_register(rd, rc);
-    return 0;
-  }
-
-  //ROR
-  if((inst & 0xFFC0) == 0x41C0)
-  {
-    rd = (inst >> 0) & 0x7;
-    rs = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "rors r" << dec << rd << ",r" << dec << rs << endl);
-    rc = read_register(rd);
-    ra = read_register(rs);
-    ra &= 0xFF;
-    if(ra == 0)
-    {
-    }
-    else
+    //STRB(2)
+    case Op::STRB2:
     {
-      ra &= 0x1F;
-      if(ra == 0)
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",r" << rm << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read_register(rd);
+      ra = read16(rb & (~1u));
+      if(rb & 1)
       {
-        do_cflag_bit(rc & 0x80000000);
+        ra &= 0x00FF;
+        ra |= rc << 8;
       }
       else
       {
-        do_cflag_bit(rc & (1 << (ra-1)));
-        rb = rc << (32-ra);
-        rc >>= ra;
-        rc |= rb;
+        ra &= 0xFF00;
+        ra |= rc & 0x00FF;
       }
+      write16(rb & (~1u), ra & 0xFFFF);
+      return 0;
     }
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
 
-  //SBC
-  if((inst & 0xFFC0) == 0x4180)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "sbc r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rd);
-    rb = read_register(rm);
-    rc = ra - rb;
-    if(!(cpsr & CPSR_C)) rc--;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    if(cpsr & CPSR_C)
+    //STRH(1)
+    case Op::STRH1:
+    {
+      rd = (inst >> 0) & 0x07;
+      rn = (inst >> 3) & 0x07;
+      rb = (inst >> 6) & 0x1F;
+      rb <<= 1;
+      DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
+      rb = read_register(rn) + rb;
+      rc=  read_register(rd);
+      write16(rb, rc & 0xFFFF);
+      return 0;
+    }
+
+    //STRH(2)
+    case Op::STRH2:
+    {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
+      rb = read_register(rn) + read_register(rm);
+      rc = read_register(rd);
+      write16(rb, rc & 0xFFFF);
+      return 0;
+    }
+
+    //SUB(1)
+    case Op::SUB1:
     {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rb = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(rn);
+      rc = ra - rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
       do_cflag(ra, ~rb, 1);
       do_vflag(ra, ~rb, 1);
+      return 0;
     }
-    else
+
+    //SUB(2)
+    case Op::SUB2:
     {
-      do_cflag(ra, ~rb, 0);
-      do_vflag(ra, ~rb, 0);
+      rb = (inst >> 0) & 0xFF;
+      rd = (inst >> 8) & 0x07;
+      DO_DISS(statusMsg << "subs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(rd);
+      rc = ra - rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, ~rb, 1);
+      do_vflag(ra, ~rb, 1);
+      return 0;
     }
-    return 0;
-  }
 
-  //SETEND
-  if((inst & 0xFFF7) == 0xB650)
-  {
-    statusMsg << "setend not implemented" << endl;
-    return 1;
-  }
+    //SUB(3)
+    case Op::SUB3:
+    {
+      rd = (inst >> 0) & 0x7;
+      rn = (inst >> 3) & 0x7;
+      rm = (inst >> 6) & 0x7;
+      DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",r" << dec << rm << endl);
+      ra = read_register(rn);
+      rb = read_register(rm);
+      rc = ra - rb;
+      write_register(rd, rc);
+      do_nflag(rc);
+      do_zflag(rc);
+      do_cflag(ra, ~rb, 1);
+      do_vflag(ra, ~rb, 1);
+      return 0;
+    }
 
-  //STMIA
-  if((inst & 0xF800) == 0xC000)
-  {
-    rn = (inst >> 8) & 0x7;
-  #if defined(THUMB_DISS)
-    statusMsg << "stmia r" << dec << rn << "!,{";
-    for(ra=0,rb=0x01,rc=0;rb;rb=(rb<<1)&0xFF,ra++)
+    //SUB(4)
+    case Op::SUB4:
     {
-      if(inst & rb)
-      {
-        if(rc) statusMsg << ",";
-        statusMsg << "r" << dec << ra;
-        rc++;
-      }
+      rb = inst & 0x7F;
+      rb <<= 2;
+      DO_DISS(statusMsg << "sub SP,#0x" << Base::HEX2 << rb << endl);
+      ra = read_register(13);
+      ra -= rb;
+      write_register(13, ra);
+      return 0;
     }
-    statusMsg << "}" << endl;
-  #endif
 
-    sp = read_register(rn);
-    for(ra = 0, rb = 0x01; rb; rb = (rb << 1) & 0xFF, ra++)
+    //SWI
+    case Op::SWI:
     {
-      if(inst & rb)
+      rb = inst & 0xFF;
+      DO_DISS(statusMsg << "swi 0x" << Base::HEX2 << rb << endl);
+
+      if((inst & 0xFF) == 0xCC)
       {
-        write32(sp, read_register(ra));
-        sp += 4;
+        write_register(0, cpsr);
+        return 0;
+      }
+      else
+      {
+        statusMsg << endl << endl << "swi 0x" << Base::HEX2 << rb << endl;
+        return 1;
       }
     }
-    write_register(rn, sp);
-    return 0;
-  }
-
-  //STR(1)
-  if((inst & 0xF800) == 0x6000)
-  {
-    rd = (inst >> 0) & 0x07;
-    rn = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    rb <<= 2;
-    DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb = read_register(rn) + rb;
-    rc = read_register(rd);
-    write32(rb, rc);
-    return 0;
-  }
 
-  //STR(2)
-  if((inst & 0xFE00) == 0x5000)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read_register(rd);
-    write32(rb, rc);
-    return 0;
-  }
-
-  //STR(3)
-  if((inst & 0xF800) == 0x9000)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x07;
-    rb <<= 2;
-    DO_DISS(statusMsg << "str r" << dec << rd << ",[SP,#0x" << Base::HEX2 << rb << "]" << endl);
-    rb = read_register(13) + rb;
-    //fprintf(stderr,"0x%08X\n",rb);
-    rc = read_register(rd);
-    write32(rb, rc);
-    return 0;
-  }
+    //SXTB
+    case Op::SXTB:
+    {
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "sxtb r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rm);
+      rc = ra & 0xFF;
+      if(rc & 0x80)
+        rc |= (~0u) << 8;
+      write_register(rd, rc);
+      return 0;
+    }
 
-  //STRB(1)
-  if((inst & 0xF800) == 0x7000)
-  {
-    rd = (inst >> 0) & 0x07;
-    rn = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX8 << rb << "]" << endl);
-    rb = read_register(rn) + rb;
-    rc = read_register(rd);
-    ra = read16(rb & (~1u));
-    if(rb & 1)
-    {
-      ra &= 0x00FF;
-      ra |= rc << 8;
+    //SXTH
+    case Op::SXTH:
+    {
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "sxth r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rm);
+      rc = ra & 0xFFFF;
+      if(rc & 0x8000)
+        rc |= (~0u) << 16;
+      write_register(rd, rc);
+      return 0;
     }
-    else
+
+    //TST
+    case Op::TST:
     {
-      ra &= 0xFF00;
-      ra |= rc & 0x00FF;
+      rn = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "tst r" << dec << rn << ",r" << dec << rm << endl);
+      ra = read_register(rn);
+      rb = read_register(rm);
+      rc = ra & rb;
+      do_nflag(rc);
+      do_zflag(rc);
+      return 0;
     }
-    write16(rb & (~1u), ra & 0xFFFF);
-    return 0;
-  }
 
-  //STRB(2)
-  if((inst & 0xFE00) == 0x5400)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "strb r" << dec << rd << ",[r" << dec << rn << ",r" << rm << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read_register(rd);
-    ra = read16(rb & (~1u));
-    if(rb & 1)
-    {
-      ra &= 0x00FF;
-      ra |= rc << 8;
+    //UXTB
+    case Op::UXTB:
+    {
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "uxtb r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rm);
+      rc = ra & 0xFF;
+      write_register(rd, rc);
+      return 0;
     }
-    else
+
+    //UXTH
+    case Op::UXTH:
     {
-      ra &= 0xFF00;
-      ra |= rc & 0x00FF;
+      rd = (inst >> 0) & 0x7;
+      rm = (inst >> 3) & 0x7;
+      DO_DISS(statusMsg << "uxth r" << dec << rd << ",r" << dec << rm << endl);
+      ra = read_register(rm);
+      rc = ra & 0xFFFF;
+      write_register(rd, rc);
+      return 0;
     }
-    write16(rb & (~1u), ra & 0xFFFF);
-    return 0;
-  }
 
-  //STRH(1)
-  if((inst & 0xF800) == 0x8000)
-  {
-    rd = (inst >> 0) & 0x07;
-    rn = (inst >> 3) & 0x07;
-    rb = (inst >> 6) & 0x1F;
-    rb <<= 1;
-    DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
-    rb = read_register(rn) + rb;
-    rc=  read_register(rd);
-    write16(rb, rc & 0xFFFF);
-    return 0;
+    case Op::INVALID:
+      break;
   }
 
-  //STRH(2)
-  if((inst & 0xFE00) == 0x5200)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
-    rb = read_register(rn) + read_register(rm);
-    rc = read_register(rd);
-    write16(rb, rc & 0xFFFF);
-    return 0;
-  }
+  statusMsg << "invalid instruction " << Base::HEX8 << pc << " " << Base::HEX4 << inst << endl;
+  return 1;
+}
 
-  //SUB(1)
-  if((inst & 0xFE00) == 0x1E00)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rb = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(rn);
-    rc = ra - rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, ~rb, 1);
-    do_vflag(ra, ~rb, 1);
-    return 0;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Thumbulator::executeProfiled()
+{
+  const uInt32 addr = read_register(15) - 2;
+  const Region& region = myRegions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
 
-  //SUB(2)
-  if((inst & 0xF800) == 0x3800)
-  {
-    rb = (inst >> 0) & 0xFF;
-    rd = (inst >> 8) & 0x07;
-    DO_DISS(statusMsg << "subs r" << dec << rd << ",#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(rd);
-    rc = ra - rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, ~rb, 1);
-    do_vflag(ra, ~rb, 1);
-    return 0;
-  }
+  // Code that can't be fetched directly can't be in the profile either
+  if(offset - region.fetchStart >= region.fetchSize)
+    return execute();
 
-  //SUB(3)
-  if((inst & 0xFE00) == 0x1A00)
-  {
-    rd = (inst >> 0) & 0x7;
-    rn = (inst >> 3) & 0x7;
-    rm = (inst >> 6) & 0x7;
-    DO_DISS(statusMsg << "subs r" << dec << rd << ",r" << dec << rn << ",r" << dec << rm << endl);
-    ra = read_register(rn);
-    rb = read_register(rm);
-    rc = ra - rb;
-    write_register(rd, rc);
-    do_nflag(rc);
-    do_zflag(rc);
-    do_cflag(ra, ~rb, 1);
-    do_vflag(ra, ~rb, 1);
-    return 0;
-  }
+  const uInt32 inst = CONV_RAMROM(region.read[offset >> 1]);
+  const int result = execute();
 
-  //SUB(4)
-  if((inst & 0xFF80) == 0xB080)
-  {
-    rb = inst & 0x7F;
-    rb <<= 2;
-    DO_DISS(statusMsg << "sub SP,#0x" << Base::HEX2 << rb << endl);
-    ra = read_register(13);
-    ra -= rb;
-    write_register(13, ra);
-    return 0;
-  }
+  uInt32 cycles = instructionCycles(opTable[inst], inst);
+  if(read_register(15) != addr + 4)
+    cycles += 2;
+  myProfiler->count(region.firstHalfword + (offset >> 1), cycles);
+
+  return result;
+}
 
-  //SWI
-  if((inst & 0xFF00) == 0xDF00)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Thumbulator::instructionCycles(Op decoded, uInt32 inst)
+{
+  switch(decoded)
   {
-    rb = inst & 0xFF;
-    DO_DISS(statusMsg << "swi 0x" << Base::HEX2 << rb << endl);
+    case Op::LDR1:  case Op::LDR2:  case Op::LDR3:  case Op::LDR4:
+    case Op::LDRB1: case Op::LDRB2: case Op::LDRH1: case Op::LDRH2:
+    case Op::LDRSB: case Op::LDRSH:
+      return 3;
 
-    if((inst & 0xFF) == 0xCC)
+    case Op::STR1:  case Op::STR2:  case Op::STR3:
+    case Op::STRB1: case Op::STRB2: case Op::STRH1: case Op::STRH2:
+      return 2;
+
+    // One cycle for each register in the list (bit 8 adds LR or PC to
+    // that of a PUSH or POP), plus two more for a load or one for a store
+    case Op::LDMIA:
+    case Op::POP:
+    case Op::STMIA:
+    case Op::PUSH:
     {
-      write_register(0, cpsr);
-      return 0;
+      const bool stack = decoded == Op::PUSH || decoded == Op::POP;
+      uInt32 count = 0;
+      for(uInt32 list = inst & (stack ? 0x1FF : 0xFF); list; list &= list - 1)
+        ++count;
+
+      return decoded == Op::LDMIA || decoded == Op::POP ? count + 2 : count + 1;
     }
-    else
-    {
-      statusMsg << endl << endl << "swi 0x" << Base::HEX2 << rb << endl;
+
+    // The time taken depends on the value multiplied by; this is the
+    // longest it can be
+    case Op::MUL:
+      return 5;
+
+    default:
       return 1;
-    }
   }
+}
 
-  //SXTB
-  if((inst & 0xFFC0) == 0xB240)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int Thumbulator::executeBlock()
+{
+  // Blocks are run one after another, for as long as they can be
+  for(;;)
   {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "sxtb r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rm);
-    rc = ra & 0xFF;
-    if(rc & 0x80)
-      rc |= (~0u) << 8;
-    write_register(rd, rc);
-    return 0;
-  }
+    const uInt32 addr = read_register(15) - 2;
+    const Region& region = myRegions[addr >> 28];
+    const uInt32 offset = addr & 0x0FFFFFFF;
+
+    // Code that can't be fetched directly is left to the checks in fetch16()
+    if(offset - region.fetchStart >= region.fetchSize)
+      return execute();
+
+    const uInt16* code = region.read + (offset >> 1);
+    uInt32& index = myBlockIndex[region.firstHalfword + (offset >> 1)];
+    if(index == 0)
+      index = translate(code,
+                        (region.fetchStart + region.fetchSize - offset) >> 1);
+
+    // The instructions in a block are run without checking the limit in
+    // run(), so the last few before it are run one at a time
+    const Block& block = myBlocks[index - 1];
+    if(instructions + block.count > kMaxInstructions)
+      return execute();
+
+    const Translated* translated = myTranslated.data() + block.first;
+    uInt32 pc = addr + 4;
+    for(uInt32 i = 0; i < block.count; ++i, pc += 2)
+    {
+      // The code may have been written since it was translated, including
+      // by an earlier instruction in this block; it will be translated
+      // again the next time it's reached
+      const uInt32 inst = CONV_RAMROM(code[i]);
+      if(inst != translated[i].inst)
+      {
+        index = 0;
+        return 0;
+      }
 
-  //SXTH
-  if((inst & 0xFFC0) == 0xB200)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "sxth r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rm);
-    rc = ra & 0xFFFF;
-    if(rc & 0x8000)
-      rc |= (~0u) << 16;
-    write_register(rd, rc);
-    return 0;
-  }
+      write_register(15, pc);
+      fetches++;
+      instructions++;
 
-  //TST
-  if((inst & 0xFFC0) == 0x4200)
-  {
-    rn = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "tst r" << dec << rn << ",r" << dec << rm << endl);
-    ra = read_register(rn);
-    rb = read_register(rm);
-    rc = ra & rb;
-    do_nflag(rc);
-    do_zflag(rc);
-    return 0;
-  }
+#if !defined(THUMB_DISS)
+      // The most common instructions, which only use the low registers,
+      // are run here; the results are the same as from execute()
+      uInt32 ra, rb, rc, rd;
+      switch(translated[i].decoded)
+      {
+        case Op::MOV1:
+          rc = inst & 0xFF;
+          reg_norm[(inst >> 8) & 0x7] = rc;
+          do_nflag(rc);
+          do_zflag(rc);
+          continue;
+
+        case Op::ADD2:
+        case Op::SUB2:
+        case Op::CMP1:
+          rd = (inst >> 8) & 0x7;
+          ra = reg_norm[rd];
+          rb = inst & 0xFF;
+          break;
 
-  //UXTB
-  if((inst & 0xFFC0) == 0xB2C0)
-  {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "uxtb r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rm);
-    rc = ra & 0xFF;
-    write_register(rd, rc);
-    return 0;
+        case Op::ADD3:
+        case Op::SUB3:
+          rd = inst & 0x7;
+          ra = reg_norm[(inst >> 3) & 0x7];
+          rb = reg_norm[(inst >> 6) & 0x7];
+          break;
+
+        case Op::LDR1:
+          rb = reg_norm[(inst >> 3) & 0x7] + ((inst >> 4) & 0x7C);
+          reg_norm[inst & 0x7] = read32(rb);
+          continue;
+
+        case Op::STR1:
+          rb = reg_norm[(inst >> 3) & 0x7] + ((inst >> 4) & 0x7C);
+          write32(rb, reg_norm[inst & 0x7]);
+          continue;
+
+        case Op::B1:
+          if(conditionPassed((inst >> 8) & 0xF))
+          {
+            rb = inst & 0xFF;
+            if(rb & 0x80)
+              rb |= (~0u) << 8;
+            write_register(15, pc + (rb << 1) + 2);
+          }
+          continue;
+
+        default:
+          if(execute(translated[i].decoded, inst, pc))
+            return 1;
+          continue;
+      }
+
+      // Addition, subtraction and comparison
+      if(translated[i].decoded == Op::ADD2 || translated[i].decoded == Op::ADD3)
+      {
+        rc = ra + rb;
+        do_cflag(ra, rb, 0);
+        do_vflag(ra, rb, 0);
+      }
+      else
+      {
+        rc = ra - rb;
+        do_cflag(ra, ~rb, 1);
+        do_vflag(ra, ~rb, 1);
+      }
+      if(translated[i].decoded != Op::CMP1)
+        reg_norm[rd] = rc;
+      do_nflag(rc);
+      do_zflag(rc);
+#else
+      DO_DISS(statusMsg << Base::HEX8 << (pc-5) << ": " << Base::HEX4 << inst << " ");
+      if(execute(translated[i].decoded, inst, pc))
+        return 1;
+#endif
+    }
   }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Thumbulator::translate(const uInt16* code, uInt32 size)
+{
+  if(myTranslated.size() >= kMaxTranslated)
+    flushTranslations();
 
-  //UXTH
-  if((inst & 0xFFC0) == 0xB280)
+  Block block = { uInt32(myTranslated.size()), 0 };
+  const uInt32 count = std::min(size, uInt32(kMaxBlockSize));
+  while(block.count < count)
   {
-    rd = (inst >> 0) & 0x7;
-    rm = (inst >> 3) & 0x7;
-    DO_DISS(statusMsg << "uxth r" << dec << rd << ",r" << dec << rm << endl);
-    ra = read_register(rm);
-    rc = ra & 0xFFFF;
-    write_register(rd, rc);
-    return 0;
+    const uInt32 inst = CONV_RAMROM(code[block.count]);
+    const Op decoded = opTable[inst];
+
+    myTranslated.push_back({ uInt16(inst), decoded });
+    ++block.count;
+
+    if(endsBlock(decoded, inst))
+      break;
   }
 
-  statusMsg << "invalid instruction " << Base::HEX8 << pc << " " << Base::HEX4 << inst << endl;
-  return 1;
+  myBlocks.push_back(block);
+  return uInt32(myBlocks.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::flushTranslations()
+{
+  myTranslated.clear();
+  myBlocks.clear();
+  myBlockIndex.assign(translateBlocks ? (ROMSIZE + RAMSIZE) / 2 : 0, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Thumbulator::endsBlock(Op decoded, uInt32 inst)
+{
+  switch(decoded)
+  {
+    // Writes to any register, including the program counter
+    case Op::ADD4:
+    case Op::MOV3:
+      return ((inst & 0x7) | ((inst >> 4) & 0x8)) == 15;
+
+    // Pops the program counter if bit 8 is set
+    case Op::POP:
+      return (inst & 0x100) != 0;
+
+    case Op::B1:
+    case Op::B2:
+    case Op::BL:
+    case Op::BLX2:
+    case Op::BX:
+    case Op::BKPT:
+    case Op::CPS:
+    case Op::SETEND:
+    case Op::SWI:
+    case Op::INVALID:
+      return true;
+
+    default:
+      return false;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -2292,7 +2791,4 @@ int Thumbulator::reset()
   return 0;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Thumbulator::trapOnFatal = true;
-
 #endif
@@ -30,6 +30,7 @@
 #include "bspf.hxx"
 #include "Cart.hxx"
 #include "Console.hxx"
+#include "ThumbProfiler.hxx"
 
 #define ROMADDMASK 0x7FFF
 #define RAMADDMASK 0x1FFF
@@ -79,7 +80,18 @@ class Thumbulator
 
       @param enable  Enable (the default) or disable exceptions on fatal errors
     */
-    static void trapFatalErrors(bool enable) { trapOnFatal = enable; }
+    void trapFatalErrors(bool enable) { trapOnFatal = enable; }
+
+    /**
+      Normally, each straight-line run of instructions is decoded once, the
+      first time it's reached, and the decoded instructions are used from
+      then on (until the code there changes).  This method allows every
+      instruction to be fetched and decoded each time it's run instead.
+      The results are exactly the same either way.
+
+      @param enable  Enable (the default) or disable translation of code
+    */
+    void enableTranslation(bool enable);
 
     /**
       Inform the Thumbulator class about the console currently in use,
@@ -88,7 +100,45 @@ class Thumbulator
     */
     void setConsoleTiming(ConsoleTiming timing);
 
+    /**
+      Answers the number of Thumb instructions executed by the last call
+      to run().
+    */
+    uInt64 instructionCount() const { return instructions; }
+
+    /**
+      Start or stop collecting a profile of the ARM code.  While profiling,
+      every instruction is fetched and decoded each time it's run (as if
+      translation was disabled); the results are the same otherwise.
+      Starting clears any previous profile.
+
+      @param enable  Enable or disable (the default) profiling
+    */
+    void enableProfiling(bool enable);
+
+    /**
+      Answers the profile being collected, or nullptr when not profiling.
+    */
+    ThumbProfiler* profiler() const { return myProfiler.get(); }
+
+    /**
+      Answers a flat profile of the ARM code, as described in
+      ThumbProfiler::report(), or an empty string when not profiling.
+    */
+    string profileReport(uInt32 maxAddresses, bool listFrames) const;
+
   private:
+    // The instructions, as decoded from each 16-bit instruction word
+    enum class Op : uInt8 {
+      ADC, ADD1, ADD2, ADD3, ADD4, ADD5, ADD6, ADD7, AND, ASR1, ASR2, B1, B2,
+      BIC, BKPT, BL, BLX2, BX, CMN, CMP1, CMP2, CMP3, CPS, CPY, EOR, LDMIA,
+      LDR1, LDR2, LDR3, LDR4, LDRB1, LDRB2, LDRH1, LDRH2, LDRSB, LDRSH, LSL1,
+      LSL2, LSR1, LSR2, MOV1, MOV2, MOV3, MUL, MVN, NEG, ORR, POP, PUSH, REV,
+      REV16, REVSH, ROR, SBC, SETEND, STMIA, STR1, STR2, STR3, STRB1, STRB2,
+      STRH1, STRH2, SUB1, SUB2, SUB3, SUB4, SWI, SXTB, SXTH, TST, UXTB, UXTH,
+      INVALID
+    };
+
     uInt32 read_register(uInt32 reg);
     void write_register(uInt32 reg, uInt32 data);
     uInt32 fetch16(uInt32 addr);
@@ -97,6 +147,14 @@ class Thumbulator
     uInt32 read32(uInt32 addr);
     void write16(uInt32 addr, uInt32 data);
     void write32(uInt32 addr, uInt32 data);
+
+    // The above access memory directly whenever they can; these handle all
+    // other accesses, with the checks for errors
+    uInt32 fetch16_checked(uInt32 addr);
+    uInt32 read16_checked(uInt32 addr);
+    uInt32 read32_checked(uInt32 addr);
+    void write16_checked(uInt32 addr, uInt32 data);
+    void write32_checked(uInt32 addr, uInt32 data);
     void updateTimer(uInt32 cycles);
 
     void do_zflag(uInt32 x);
@@ -106,6 +164,9 @@ class Thumbulator
     void do_cflag_bit(uInt32 x);
     void do_vflag_bit(uInt32 x);
 
+    // Answers whether the condition of a conditional branch is met
+    bool conditionPassed(uInt32 cond) const;
+
     // Throw a runtime_error exception containing an error referencing the
     // given message and variables
     // Note that the return value is never used in these methods
@@ -114,13 +175,83 @@ class Thumbulator
 
     void dump_counters();
     void dump_regs();
+
+    // Answers the instruction encoded by the given word, and the table of
+    // the instructions encoded by every word
+    static Op decodeInstructionWord(uInt16 inst);
+    static const Op* decodeTable();
+
     int execute();
+
+    // Run a single instruction, and count it in the profile
+    int executeProfiled();
+
+    // Answers the number of cycles the given instruction takes on an
+    // ARM7TDMI, not counting any wait states, or the two extra cycles to
+    // refill the pipeline when the program counter is changed
+    static uInt32 instructionCycles(Op decoded, uInt32 inst);
+
+    // Run the given instruction, with the program counter as it sees it
+    // (four bytes past the instruction)
+    int execute(Op decoded, uInt32 inst, uInt32 pc);
+
+    // Run the translated block at the program counter (translating it
+    // first if needed), or a single instruction when there's no block
+    int executeBlock();
+
+    // Translate the code at the given host memory, of which there are the
+    // given number of halfwords; answers the number of the new block
+    uInt32 translate(const uInt16* code, uInt32 size);
+    void flushTranslations();
+
+    // Answers whether the given instruction can change the program counter
+    // or stop the emulation, so it must be the last one in a block
+    static bool endsBlock(Op decoded, uInt32 inst);
+
     int reset();
 
+    // The memory in one of the 16 windows selected by the top four bits of
+    // an address, and the offsets within it that can be accessed directly:
+    // those that can never cause an error, or have any other side effects.
+    // The index of the first halfword of the window, in the tables that
+    // cover both ROM and RAM, is also kept here.
+    struct Region {
+      const uInt16* read;
+      uInt16* write;
+      uInt32 fetchStart, fetchSize;
+      uInt32 readSize;
+      uInt32 writeStart, writeSize;
+      uInt32 firstHalfword;
+    };
+
+    // A decoded instruction, as it was when it was translated
+    struct Translated {
+      uInt16 inst;
+      Op decoded;
+    };
+
+    // A straight-line run of translated instructions, ending at the first
+    // one that can branch (or after kMaxBlockSize of them)
+    struct Block {
+      uInt32 first, count;
+    };
+
+    // run() stops with an error after this many instructions
+    static constexpr uInt64 kMaxInstructions = 500000;
+
+    static constexpr uInt32 kMaxBlockSize = 64;
+
+    // All the translations are dropped when they hold this many instructions,
+    // which only happens if code in RAM keeps changing
+    static constexpr uInt32 kMaxTranslated = 65536;
+
   private:
     const uInt16* rom;
     uInt16* ram;
 
+    // Where the ROM and RAM are mapped; the other windows are left empty
+    Region myRegions[16];
+
     uInt32 reg_norm[16]; // normal execution mode, do not have a thread mode
     uInt32 cpsr, mamcr;
     bool handler_mode;
@@ -136,12 +267,25 @@ class Thumbulator
 
     ostringstream statusMsg;
 
-    static bool trapOnFatal;
+    bool trapOnFatal;
 
     ConfigureFor configuration;
 
     Cartridge* myCartridge;
 
+    // The instruction encoded by every 16-bit word, so execute() can
+    // dispatch on it directly
+    const Op* opTable;
+
+    // The translated blocks, and the block (plus one, or zero for none)
+    // starting at each halfword of ROM and RAM
+    bool translateBlocks;
+    vector<Translated> myTranslated;
+    vector<Block> myBlocks;
+    vector<uInt32> myBlockIndex;
+
+    unique_ptr<ThumbProfiler> myProfiler;
+
   private:
     // Following constructors and assignment operators not supported
     Thumbulator() = delete;
@@ -56,6 +56,7 @@ MODULE_OBJS := \
 	src/emucore/FBSurface.o \
 	src/emucore/FSNode.o \
 	src/emucore/Genesis.o \
+	src/emucore/InputMovie.o \
 	src/emucore/Joystick.o \
 	src/emucore/Keyboard.o \
 	src/emucore/KidVid.o \
@@ -66,8 +67,10 @@ MODULE_OBJS := \
 	src/emucore/MD5.o \
 	src/emucore/OSystem.o \
 	src/emucore/Paddles.o \
+	src/emucore/Profiler.o \
 	src/emucore/Props.o \
 	src/emucore/PropsSet.o \
+	src/emucore/RewindBuffer.o \
 	src/emucore/SaveKey.o \
 	src/emucore/Serializer.o \
 	src/emucore/Settings.o \
@@ -79,7 +82,8 @@ MODULE_OBJS := \
 	src/emucore/AmigaMouse.o \
 	src/emucore/AtariMouse.o \
 	src/emucore/TrakBall.o \
-	src/emucore/Thumbulator.o
+	src/emucore/Thumbulator.o \
+	src/emucore/ThumbProfiler.o
 
 MODULE_DIRS += \
 	src/emucore
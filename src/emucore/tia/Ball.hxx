@@ -66,6 +66,8 @@ class Ball : public Serializable
       return (collision & 0x8000) ? myColor : colorIn;
     }
 
+    uInt8 getColor() const { return myColor; }
+
     void shuffleStatus();
 
     uInt8 getPosition() const;
@@ -43,6 +43,23 @@ class DelayQueue : public Serializable
 
     template<class T> void execute(T executor);
 
+    /**
+      Answer the number of clocks until the next write is due (0 if there
+      is one for the current clock), or 0xFF if the queue is empty.
+    */
+    uInt8 nextEvent() const;
+
+    /**
+      Move past the given number of clocks, none of which may have a write.
+    */
+    void skip(uInt32 clocks);
+
+    /**
+      Saves the pending writes in the order they're due, leaving out where
+      the queue happens to be in its cycle.
+    */
+    bool saveFrameStart(Serializer& out) const;
+
     /**
       Serializable methods (see that class for more information).
     */
@@ -120,6 +137,33 @@ void DelayQueue<length, capacity>::execute(T executor)
   myIndex = smartmod<length>(myIndex + 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+uInt8 DelayQueue<length, capacity>::nextEvent() const
+{
+  for (uInt8 i = 0; i < length; i++)
+    if (myMembers[smartmod<length>(myIndex + i)].mySize > 0) return i;
+
+  return 0xFF;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+void DelayQueue<length, capacity>::skip(uInt32 clocks)
+{
+  myIndex = (myIndex + clocks) % length;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+bool DelayQueue<length, capacity>::saveFrameStart(Serializer& out) const
+{
+  for (uInt8 i = 0; i < length; i++)
+    if (!myMembers[smartmod<length>(myIndex + i)].save(out)) return false;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 template<unsigned length, unsigned capacity>
 bool DelayQueue<length, capacity>::save(Serializer& out) const
@@ -380,6 +380,47 @@ bool FrameManager::save(Serializer& out) const
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameManager::saveFrameStart(Serializer& out) const
+{
+  try
+  {
+    if (!myVblankManager.saveFrameStart(out)) return false;
+
+    out.putInt(uInt32(myLayout));
+    out.putBool(myAutodetectLayout);
+    out.putInt(uInt32(myState));
+    out.putInt(myLineInState);
+    out.putInt(myCurrentFrameTotalLines);
+    out.putInt(myCurrentFrameFinalLines);
+    out.putInt(myPreviousFrameFinalLines);
+    out.putInt(myVsyncLines);
+    out.putInt(myY);  out.putInt(myLastY);
+    out.putBool(myFramePending);
+
+    // The number of frames only matters for the first few
+    out.putInt(std::min(myTotalFrames, uInt32(Metrics::initialGarbageFrames) + 1));
+
+    out.putBool(myVsync);
+
+    out.putInt(myVblankLines);
+    out.putInt(myKernelLines);
+    out.putInt(myOverscanLines);
+    out.putInt(myFrameLines);
+    out.putInt(myHeight);
+    out.putInt(myFixedHeight);
+
+    out.putBool(myJitterEnabled);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: TIA_FrameManager::saveFrameStart" << endl;
+    return false;
+  }
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FrameManager::load(Serializer& in)
 {
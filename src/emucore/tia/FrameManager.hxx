@@ -93,6 +93,14 @@ class FrameManager : public Serializable
     bool load(Serializer& in) override;
     string name() const override { return "TIA_FrameManager"; }
 
+    /**
+      Saves the part of the state that decides how the frame that's
+      starting is drawn.  This leaves out the counts (of frames, and of
+      frames in the current layout) and the frame rate, which change from
+      frame to frame but only decide anything after the frame is drawn.
+    */
+    bool saveFrameStart(Serializer& out) const;
+
     void setJitterFactor(uInt8 factor) { myVblankManager.setJitterFactor(factor); }
     bool jitterEnabled() const { return myJitterEnabled; }
     void enableJitter(bool enabled);
@@ -67,6 +67,8 @@ class Missile : public Serializable
       return (collision & 0x8000) ? myColor : colorIn;
     }
 
+    uInt8 getColor() const { return myColor; }
+
     uInt8 getPosition() const;
     void setPosition(uInt8 newPosition);
 
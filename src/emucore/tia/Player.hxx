@@ -68,6 +68,8 @@ class Player : public Serializable
       return (collision & 0x8000) ? myColor : colorIn;
     }
 
+    uInt8 getColor() const { return myColor; }
+
     void shufflePatterns();
 
     uInt8 getRespClock() const;
@@ -64,6 +64,8 @@ class Playfield : public Serializable
       return colorIn;
     }
 
+    uInt8 getColor(uInt32 x) const { return x < 80 ? myColorLeft : myColorRight; }
+
     /**
       Serializable methods (see that class for more information).
     */
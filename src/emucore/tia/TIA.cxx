@@ -20,12 +20,19 @@
 #include "Console.hxx"
 #include "Control.hxx"
 #include "Paddles.hxx"
+#include "Profiler.hxx"
 #include "DelayQueueIteratorImpl.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "CartDebug.hxx"
 #endif
 
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
 enum CollisionMask: uInt32 {
   player0   = 0b0111110000000000,
   player1   = 0b0100001111000000,
@@ -51,12 +58,134 @@ enum Delay: uInt8 {
   vblank = 1
 };
 
+// The color clocks in each line at which the sound circuits are clocked
+enum AudioTick: Int32 {
+  audioTick0 = 37,
+  audioTick1 = 149
+};
+
 enum ResxCounter: uInt8 {
   hblank = 159,
   lateHblank = 158,
   frame = 157
 };
 
+// The objects in the coverage buffers used by renderPendingPixels()
+enum SpanObject: uInt8 {
+  spanP0, spanM0, spanP1, spanM1, spanPF, spanBL
+};
+
+// The order in which renderPendingPixels() draws the objects for each Priority,
+// from the lowest priority to the highest (see renderPixel())
+static constexpr uInt8 spanOrder[3][6] = {
+  { spanM1, spanP1, spanM0, spanP0, spanPF, spanBL },  // pfp
+  { spanBL, spanM1, spanP1, spanPF, spanM0, spanP0 },  // score
+  { spanPF, spanBL, spanM1, spanP1, spanM0, spanP0 }   // normal
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Draw 'count' pixels from the coverage of each object (bit 15 is set where
+// the object is drawn), given in order of increasing priority
+static void composePixels(uInt8* out, const uInt16* const* coverage,
+                          const uInt8* colors, uInt8 background, uInt32 count)
+{
+  uInt32 i = 0;
+
+#if defined(__AVX2__)
+  for (; i + 16 <= count; i += 16) {
+    __m256i color = _mm256_set1_epi16(background);
+
+    for (uInt8 o = 0; o < 6; o++) {
+      const __m256i on = _mm256_srai_epi16(_mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(coverage[o] + i)), 15);
+      color = _mm256_blendv_epi8(color, _mm256_set1_epi16(colors[o]), on);
+    }
+
+    // Packing works within each 128 bit half, so gather the results
+    const __m256i packed =
+      _mm256_permute4x64_epi64(_mm256_packus_epi16(color, color), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                     _mm256_castsi256_si128(packed));
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 8 <= count; i += 8) {
+    __m128i color = _mm_set1_epi16(background);
+
+    for (uInt8 o = 0; o < 6; o++) {
+      const __m128i on = _mm_srai_epi16(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(coverage[o] + i)), 15);
+      color = _mm_or_si128(_mm_and_si128(on, _mm_set1_epi16(colors[o])),
+                           _mm_andnot_si128(on, color));
+    }
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i),
+                     _mm_packus_epi16(color, color));
+  }
+#endif
+
+  for (; i < count; i++) {
+    uInt8 color = background;
+
+    for (uInt8 o = 0; o < 6; o++)
+      if (coverage[o][i] & 0x8000) color = colors[o];
+
+    out[i] = color;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Answer the collisions for 'count' pixels from the coverage of each object,
+// starting at 'start' (the same as TIA::updateCollision() for each of them)
+static uInt16 collidePixels(const uInt16 (*coverage)[228], uInt32 start,
+                            uInt32 count)
+{
+  uInt16 mask = 0;
+  uInt32 i = start;
+
+  count += start;
+
+#if defined(__SSE2__)
+  __m128i acc = _mm_setzero_si128();
+
+  #if defined(__AVX2__)
+    __m256i acc256 = _mm256_setzero_si256();
+
+    for (; i + 16 <= count; i += 16) {
+      __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(coverage[0] + i));
+      for (uInt8 o = 1; o < 6; o++)
+        pixels = _mm256_and_si256(pixels, _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(coverage[o] + i)));
+
+      acc256 = _mm256_or_si256(acc256, pixels);
+    }
+
+    acc = _mm_or_si128(_mm256_castsi256_si128(acc256),
+                       _mm256_extracti128_si256(acc256, 1));
+  #endif
+
+  for (; i + 8 <= count; i += 8) {
+    __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(coverage[0] + i));
+    for (uInt8 o = 1; o < 6; o++)
+      pixels = _mm_and_si128(pixels, _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(coverage[o] + i)));
+
+    acc = _mm_or_si128(acc, pixels);
+  }
+
+  acc = _mm_or_si128(acc, _mm_srli_si128(acc, 8));
+  acc = _mm_or_si128(acc, _mm_srli_si128(acc, 4));
+  acc = _mm_or_si128(acc, _mm_srli_si128(acc, 2));
+  mask = uInt16(_mm_cvtsi128_si32(acc));
+#endif
+
+  for (; i < count; i++)
+    mask |= coverage[0][i] & coverage[1][i] & coverage[2][i] &
+            coverage[3][i] & coverage[4][i] & coverage[5][i];
+
+  return mask;
+}
+
 // This parameter still has room for tuning. If we go lower than 73, long005 will show
 // a slight artifact (still have to crosscheck on real hardware), if we go lower than
 // 70, the G.I. Joe will show an artifact (hole in roof).
@@ -74,7 +203,12 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
     myPlayer1(~CollisionMask::player1 & 0x7FFF),
     myBall(~CollisionMask::ball & 0x7FFF),
     mySpriteEnabledBits(0xFF),
-    myCollisionsEnabledBits(0xFF)
+    myCollisionsEnabledBits(0xFF),
+    myAudioCapture(nullptr),
+    myClockStepping(false),
+    myFrameSkip(0),
+    myFrameCacheEnabled(true),
+    myFrameReused(false)
 {
   myFrameManager.setHandlers(
     [this] () {
@@ -87,6 +221,7 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
 
   myCurrentFrameBuffer  = make_ptr<uInt8[]>(160 * FrameManager::frameBufferHeight);
   myPreviousFrameBuffer = make_ptr<uInt8[]>(160 * FrameManager::frameBufferHeight);
+  myAudioBuffer = make_ptr<Int16[]>(2 * audioBufferSamples);
 
   myTIAPinsDriven = mySettings.getBool("tiadriven");
 
@@ -102,6 +237,8 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
   myFrameManager.setJitterFactor(mySettings.getInt("tv.jitter_recovery"));
 
   reset();
+
+  setFrameSkip(std::max(mySettings.getInt("frameskip"), 0));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -123,6 +260,12 @@ void TIA::reset()
   myLastCycle = 0;
   mySubClock = 0;
   myXDelta = 0;
+  myPendingPixelsStart = myPendingPixelsEnd = 0;
+
+  myFrameSkipPhase = 0;
+  myFrameSkipped = myLastFrameSkipped = false;
+
+  myFramesReused = myFramesDrawn = 0;
 
   memset(myShadowRegisters, 0, 64);
 
@@ -141,6 +284,8 @@ void TIA::reset()
   for (PaddleReader& paddleReader : myPaddleReaders)
     paddleReader.reset(myTimestamp);
 
+  myAudio.reset();
+  myAudioLineTicks = myAudioSamples = 0;
   mySound.reset();
   myDelayQueue.reset();
   myFrameManager.reset();
@@ -163,8 +308,6 @@ void TIA::systemCyclesReset()
   const uInt32 cycles = mySystem->cycles();
 
   myLastCycle -= cycles;
-
-  mySound.adjustCycleCounter(-1 * cycles);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -193,6 +336,8 @@ void TIA::clearBuffers()
 {
   memset(myCurrentFrameBuffer.get(), 0, 160 * FrameManager::frameBufferHeight);
   memset(myPreviousFrameBuffer.get(), 0, 160 * FrameManager::frameBufferHeight);
+
+  resetFrameCache();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -202,7 +347,8 @@ bool TIA::save(Serializer& out) const
   {
     out.putString(name());
 
-    if(!mySound.save(out)) return false;
+    if(!myAudio.save(out)) return false;
+    out.putByte(myAudioLineTicks);
 
     if(!myDelayQueue.save(out))   return false;
     if(!myFrameManager.save(out)) return false;
@@ -266,12 +412,18 @@ bool TIA::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::load(Serializer& in)
 {
+  // Anything still waiting to be drawn belongs to the current frame
+  renderPendingPixels();
+  resetFrameCache();
+
   try
   {
     if(in.getString() != name())
       return false;
 
-    if(!mySound.load(in)) return false;
+    if(!myAudio.load(in)) return false;
+    myAudioLineTicks = in.getByte();
+    myAudioSamples = 0;
 
     if(!myDelayQueue.load(in))   return false;
     if(!myFrameManager.load(in)) return false;
@@ -425,6 +577,8 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
   address &= 0x3F;
 
+  if (myFrameCacheEnabled) recordWrite(address, value);
+
   switch (address)
   {
     case WSYNC:
@@ -448,6 +602,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case VSYNC:
+      renderPendingPixels();
       myFrameManager.setVsync(value & 0x02);
       myShadowRegisters[address] = value;
       break;
@@ -463,44 +618,30 @@ bool TIA::poke(uInt16 address, uInt8 value)
 
       break;
 
-    ////////////////////////////////////////////////////////////
-    // FIXME - rework this when we add the new sound core
     case AUDV0:
-      mySound.set(address, value, mySystem->cycles());
-      myShadowRegisters[address] = value;
-      break;
     case AUDV1:
-      mySound.set(address, value, mySystem->cycles());
-      myShadowRegisters[address] = value;
-      break;
     case AUDF0:
-      mySound.set(address, value, mySystem->cycles());
-      myShadowRegisters[address] = value;
-      break;
     case AUDF1:
-      mySound.set(address, value, mySystem->cycles());
-      myShadowRegisters[address] = value;
-      break;
     case AUDC0:
-      mySound.set(address, value, mySystem->cycles());
-      myShadowRegisters[address] = value;
-      break;
     case AUDC1:
-      mySound.set(address, value, mySystem->cycles());
+      // Everything up to this clock is played with the old value
+      tickAudio(myHctr >= audioTick1 ? 2 : myHctr >= audioTick0 ? 1 : 0);
+      myAudio.set(address, value);
       myShadowRegisters[address] = value;
       break;
-    ////////////////////////////////////////////////////////////
 
     case HMOVE:
       myDelayQueue.push(HMOVE, value, Delay::hmove);
       break;
 
     case COLUBK:
+      renderPendingPixels();
       myBackground.setColor(value & 0xFE);
       myShadowRegisters[address] = value;
       break;
 
     case COLUP0:
+      renderPendingPixels();
       value &= 0xFE;
       myPlayfield.setColorP0(value);
       myMissile0.setColor(value);
@@ -509,6 +650,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case COLUP1:
+      renderPendingPixels();
       value &= 0xFE;
       myPlayfield.setColorP1(value);
       myMissile1.setColor(value);
@@ -517,6 +659,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case CTRLPF:
+      renderPendingPixels();
       flushLineCache();
       myPriority = (value & 0x04) ? Priority::pfp :
                    (value & 0x02) ? Priority::score : Priority::normal;
@@ -526,6 +669,7 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case COLUPF:
+      renderPendingPixels();
       flushLineCache();
       value &= 0xFE;
       myPlayfield.setColor(value);
@@ -715,10 +859,14 @@ bool TIA::poke(uInt16 address, uInt8 value)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool TIA::saveDisplay(Serializer& out) const
+bool TIA::saveDisplay(Serializer& out)
 {
   try
   {
+    // The debugger can stop partway through a frame, with pixels still
+    // queued for drawing
+    renderPendingPixels();
+
     out.putByteArray(myCurrentFrameBuffer.get(), 160*320);
   }
   catch(...)
@@ -761,6 +909,9 @@ bool TIA::enableColorLoss(bool enabled)
   if (consoleTiming() != ConsoleTiming::pal)
     return false;
 
+  renderPendingPixels();
+  resetFrameCache();
+
   if(enabled)
   {
     myColorLossEnabled = true;
@@ -813,6 +964,7 @@ bool TIA::toggleBit(TIABit b, uInt8 mode)
   }
 
   mySpriteEnabledBits = (mySpriteEnabledBits & ~b) | mask;
+  resetFrameCache();
 
   myMissile0.toggleEnabled(mySpriteEnabledBits & TIABit::M0Bit);
   myMissile1.toggleEnabled(mySpriteEnabledBits & TIABit::M1Bit);
@@ -878,6 +1030,9 @@ bool TIA::toggleFixedColors(uInt8 mode)
   // Otherwise, flip the state
   bool on = (mode == 0 || mode == 1) ? bool(mode) : myColorHBlank == 0;
 
+  renderPendingPixels();
+  resetFrameCache();
+
   bool pal = myFrameManager.layout() == FrameLayout::pal;
   myMissile0.setDebugColor(pal ? M0ColorPAL : M0ColorNTSC);
   myMissile1.setDebugColor(pal ? M1ColorPAL : M1ColorNTSC);
@@ -931,6 +1086,7 @@ bool TIA::toggleJitter(uInt8 mode)
     default:
       throw runtime_error("invalid argument for toggleJitter");
   }
+  resetFrameCache();
 
   return myFrameManager.jitterEnabled();
 }
@@ -960,6 +1116,7 @@ TIA& TIA::updateScanlineByStep()
   // Update frame by one CPU instruction/color clock
   mySystem->m6502().execute(1);
   updateEmulation();
+  renderPendingPixels();
 
   return *this;
 }
@@ -987,11 +1144,25 @@ void TIA::updateEmulation()
   if (mySubClock > 2)
     throw runtime_error("subclock exceeds range");
 
-  const uInt32 cyclesToRun = 3 * (systemCycles - myLastCycle) + mySubClock;
+  uInt32 cyclesToRun = 3 * (systemCycles - myLastCycle) + mySubClock;
 
   mySubClock = 0;
   myLastCycle = systemCycles;
 
+  // A frame that's being reused has to make the last frame's next write
+  // at the same clock; if it gets past that clock without it, it's drawn
+  // from there on
+  if (myFrameReused && myNextFrameWrite < myLastFrameWrites.size()) {
+    const uInt32 clock = frameClock();
+    const uInt32 next = uInt32(myLastFrameWrites[myNextFrameWrite] >> 16);
+
+    if (next < clock + cyclesToRun) {
+      cycle(next - clock);
+      cyclesToRun -= next - clock;
+      myFrameReused = false;
+    }
+  }
+
   cycle(cyclesToRun);
 }
 
@@ -1004,11 +1175,12 @@ void TIA::swapBuffers()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::onFrameStart()
 {
-  swapBuffers();
+  // The buffers always hold the last two frames that were drawn
+  if (!myLastFrameSkipped) swapBuffers();
 
   const Int32 x = myHctr - 68;
 
-  if (x > 0)
+  if (x > 0 && !myFrameSkipped)
     memset(myCurrentFrameBuffer.get(), 0, x);
 
   for (uInt8 i = 0; i < 4; i++)
@@ -1032,6 +1204,8 @@ void TIA::onFrameStart()
       myBackground.applyColorLoss();
     }
   }
+
+  if (myFrameCacheEnabled) startFrameCache();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1040,11 +1214,25 @@ void TIA::onFrameComplete()
   mySystem->m6502().stop();
   mySystem->resetCycles();
 
+  flushAudio();
+
   // Blank out any extra lines not drawn this frame
   const uInt32 missingScanlines = myFrameManager.missingScanlines();
-  if (missingScanlines > 0)
+  if (missingScanlines > 0 && !myFrameSkipped && !myFrameReused)
     memset(myCurrentFrameBuffer.get() + 160 * myFrameManager.getY(), 0, missingScanlines * 160);
 
+  if (!myFrameSkipped)
+  {
+    myFramesDrawn++;
+    if (myFrameReused) myFramesReused++;
+  }
+
+  // Decide whether the next frame is drawn; this is done here, since the
+  // first frame is started without one being completed
+  myLastFrameSkipped = myFrameSkipped;
+  myFrameSkipPhase = myFrameSkipPhase < myFrameSkip ? myFrameSkipPhase + 1 : 0;
+  myFrameSkipped = myFrameSkipPhase < myFrameSkip;
+
   // Recalculate framerate, attempting to auto-correct for scanline 'jumps'
   if(myAutoFrameEnabled)
     myConsole.setFramerate(myFrameManager.frameRate());
@@ -1053,30 +1241,137 @@ void TIA::onFrameComplete()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::cycle(uInt32 colorClocks)
 {
-  for (uInt32 i = 0; i < colorClocks; i++)
-  {
-    myDelayQueue.execute(
-      [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
+  // This runs on every TIA access, so it's only timed now and then
+  Profiler::SampledScope profile(Profiler::kTIA);
+
+  if (myClockStepping) {
+    for (uInt32 i = 0; i < colorClocks; i++) tickClock();
+
+    return;
+  }
+
+  while (colorClocks > 0) {
+    // Up to the next queued write and the end of the line, nothing changes
+    // except the objects' counters, so those clocks are run as one span;
+    // a clock with a write is stepped by itself
+    const uInt32 span = std::min(
+      std::min(colorClocks, uInt32(228 - myHctr)),
+      uInt32(myDelayQueue.nextEvent())
     );
 
+    if (span == 0) {
+      tickClock();
+      colorClocks--;
+    }
+    else
+      colorClocks -= tickSpan(span);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::tickClock()
+{
+  myDelayQueue.execute(
+    [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
+  );
+
+  myCollisionUpdateRequired = false;
+
+  if (myLinesSinceChange < 2) {
+    tickMovement();
+
+    if (myHstate == HState::blank)
+      tickHblank();
+    else
+      tickHframe();
+
+    if (myCollisionUpdateRequired) updateCollision();
+  }
+
+  if (++myHctr >= 228)
+    nextLine();
+
+  myTimestamp++;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::tickSpan(uInt32 clocks)
+{
+  // HMOVE ticks every four clocks, and those clocks are stepped by
+  // themselves; movement doesn't change anything in between
+  if (myMovementInProgress && myLinesSinceChange < 2) {
+    if ((myHctr & 0x03) == 0) {
+      tickClock();
+
+      return 1;
+    }
+
+    clocks = std::min(clocks, uInt32(4 - (myHctr & 0x03)));
+  }
+
+  if (myLinesSinceChange >= 2) {
+    // The line is a copy of the last one, so only the position changes
+    myHctr += clocks;
     myCollisionUpdateRequired = false;
+  }
+  else if (myHstate == HState::blank) {
+    if (myHctr == 0) myHblankCtr = 0;
 
-    if (myLinesSinceChange < 2) {
-      tickMovement();
+    if (myHblankCtr >= 68) {
+      tickClock();
 
-      if (myHstate == HState::blank)
-        tickHblank();
-      else
-        tickHframe();
+      return 1;
+    }
+
+    // Stop at the end of HBLANK, since the objects start counting there
+    clocks = std::min(clocks, uInt32(68 - myHblankCtr));
+
+    myHblankCtr += clocks;
+    if (myHblankCtr >= 68) myHstate = HState::frame;
 
-      if (myCollisionUpdateRequired) updateCollision();
+    myHctr += clocks;
+    myCollisionUpdateRequired = false;
+  }
+  else {
+    // Only the object counters are clocked one at a time; the collisions
+    // and pixels are worked out from the coverage of the whole span
+    const uInt32 start = myHctr;
+
+    for (const Int32 end = myHctr + clocks; myHctr < end; myHctr++) {
+      myPlayfield.tick(myHctr - 68 - myXDelta);
+      myMissile0.tick(myHctr);
+      myMissile1.tick(myHctr);
+      myPlayer0.tick();
+      myPlayer1.tick();
+      myBall.tick();
+
+      mySpanCoverage[spanP0][myHctr] = myPlayer0.collision;
+      mySpanCoverage[spanM0][myHctr] = myMissile0.collision;
+      mySpanCoverage[spanP1][myHctr] = myPlayer1.collision;
+      mySpanCoverage[spanM1][myHctr] = myMissile1.collision;
+      mySpanCoverage[spanPF][myHctr] = myPlayfield.collision;
+      mySpanCoverage[spanBL][myHctr] = myBall.collision;
     }
 
-    if (++myHctr >= 228)
-      nextLine();
+    myCollisionMask |= collidePixels(mySpanCoverage, start, clocks);
+    myCollisionUpdateRequired = true;
 
-    myTimestamp++;
+    if (myFrameManager.isRendering() && !myFrameSkipped && !myFrameReused)
+      queuePixels(start, clocks);
   }
+
+  myDelayQueue.skip(clocks);
+
+  // The timestamp for the last clock only advances after the next line
+  // has started, just like in tickClock()
+  myTimestamp += clocks - 1;
+
+  if (myHctr >= 228)
+    nextLine();
+
+  myTimestamp++;
+
+  return clocks;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1127,17 +1422,32 @@ void TIA::tickHframe()
   myPlayer1.tick();
   myBall.tick();
 
-  if (myFrameManager.isRendering())
+  if (!myFrameManager.isRendering() || myFrameSkipped || myFrameReused)
+    return;
+
+  if (myClockStepping)
     renderPixel(x, y);
+  else {
+    mySpanCoverage[spanP0][myHctr] = myPlayer0.collision;
+    mySpanCoverage[spanM0][myHctr] = myMissile0.collision;
+    mySpanCoverage[spanP1][myHctr] = myPlayer1.collision;
+    mySpanCoverage[spanM1][myHctr] = myMissile1.collision;
+    mySpanCoverage[spanPF][myHctr] = myPlayfield.collision;
+    mySpanCoverage[spanBL][myHctr] = myBall.collision;
+
+    queuePixels(myHctr, 1);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::applyRsync()
 {
+  renderPendingPixels();
+
   const uInt32 x = myHctr > 68 ? myHctr - 68 : 0;
 
   myXDelta = 157 - x;
-  if (myFrameManager.isRendering())
+  if (myFrameManager.isRendering() && !myFrameSkipped && !myFrameReused)
     memset(myCurrentFrameBuffer.get() + myFrameManager.getY() * 160 + x, 0, 160 - x);
 
   myHctr = 225;
@@ -1146,6 +1456,11 @@ void TIA::applyRsync()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::nextLine()
 {
+  tickAudio(2);
+  myAudioLineTicks = 0;
+
+  renderPendingPixels();
+
   if (myLinesSinceChange >= 2) {
     cloneLastLine();
   }
@@ -1168,13 +1483,43 @@ void TIA::cloneLastLine()
 {
   const auto y = myFrameManager.getY();
 
-  if (!myFrameManager.isRendering() || y == 0) return;
+  if (!myFrameManager.isRendering() || y == 0 || myFrameSkipped ||
+      myFrameReused) return;
 
   uInt8* buffer = myCurrentFrameBuffer.get();
 
   memcpy(buffer + y * 160, buffer + (y-1) * 160, 160);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::tickAudio(uInt32 ticks)
+{
+  // Clock the sound circuits up to the given tick in this line
+  if (ticks <= myAudioLineTicks) return;
+
+  // This runs twice on every line, so it's only timed now and then
+  Profiler::SampledScope profile(Profiler::kAudio);
+
+  if (myAudioSamples + 2 > audioBufferSamples) flushAudio();
+
+  myAudio.process(myAudioBuffer.get() + 2 * myAudioSamples,
+                  ticks - myAudioLineTicks);
+  myAudioSamples += ticks - myAudioLineTicks;
+  myAudioLineTicks = ticks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::flushAudio()
+{
+  if (myAudioSamples == 0) return;
+
+  Profiler::Scope profile(Profiler::kAudio);
+  mySound.processSamples(myAudioBuffer.get(), myAudioSamples);
+  if (myAudioCapture)
+    myAudioCapture->captureSamples(myAudioBuffer.get(), myAudioSamples);
+  myAudioSamples = 0;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::updateCollision()
 {
@@ -1240,6 +1585,70 @@ void TIA::renderPixel(uInt32 x, uInt32 y)
   myCurrentFrameBuffer.get()[y * 160 + x] = myFrameManager.vblank() ? 0 : color;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::queuePixels(uInt32 hctr, uInt32 count)
+{
+  // The pixels are only drawn once something that changes how they look
+  // is written, or at the end of the line; until then, they're collected
+  // into a single span
+  if (hctr != myPendingPixelsEnd) {
+    renderPendingPixels();
+    myPendingPixelsStart = hctr;
+  }
+
+  myPendingPixelsEnd = hctr + count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderPendingPixels()
+{
+  const uInt32 hctr = myPendingPixelsStart;
+  const uInt32 count = myPendingPixelsEnd - myPendingPixelsStart;
+
+  if (count == 0) return;
+
+  myPendingPixelsStart = myPendingPixelsEnd;
+
+  // Skip the pixels that aren't on the line (after an RSYNC)
+  const uInt32 x = hctr - 68 - myXDelta;
+  uInt32 first = 0;
+  if (x >= 160) {
+    first = 0 - x;
+    if (first >= count) return;
+  }
+  const uInt32 last = std::min(count, 160 - x);
+
+  uInt8* line = myCurrentFrameBuffer.get() + myFrameManager.getY() * 160;
+
+  if (myFrameManager.vblank()) {
+    memset(line + (x + first), 0, last - first);
+    return;
+  }
+
+  const uInt8* order = spanOrder[myPriority];
+  const uInt8 objectColors[6] = {
+    myPlayer0.getColor(), myMissile0.getColor(), myPlayer1.getColor(),
+    myMissile1.getColor(), 0, myBall.getColor()
+  };
+
+  // The playfield only changes colour at the middle of the line
+  for (uInt32 start = first; start < last; ) {
+    const uInt32 end = x + start < 80 ? std::min(last, 80 - x) : last;
+
+    const uInt16* coverage[6];
+    uInt8 colors[6];
+    for (uInt8 o = 0; o < 6; o++) {
+      coverage[o] = mySpanCoverage[order[o]] + hctr + start;
+      colors[o] = order[o] == spanPF ? myPlayfield.getColor(x + start)
+                                     : objectColors[order[o]];
+    }
+
+    composePixels(line + (x + start), coverage, colors,
+                  myBackground.getColor(), end - start);
+    start = end;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::flushLineCache()
 {
@@ -1256,13 +1665,107 @@ void TIA::flushLineCache()
       else
         tickHframe();
     }
+
+    // The start of the line is only queued, so draw it now, before the
+    // write that caused the flush changes how it looks
+    renderPendingPixels();
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setFrameSkip(uInt32 frames)
+{
+  // The frame that's already started counts as the first one
+  myFrameSkip = frames;
+  myFrameSkipPhase = 0;
+  resetFrameCache();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::enableFrameCache(bool enabled)
+{
+  myFrameCacheEnabled = enabled;
+  resetFrameCache();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::recordWrite(uInt8 address, uInt8 value)
+{
+  // WSYNC only stops the CPU, and the sound isn't part of the frame
+  if (address == WSYNC || (address >= AUDC0 && address <= AUDV1)) return;
+
+  const uInt64 write = uInt64(frameClock()) << 16 | address << 8 | value;
+
+  if (myFrameReused) {
+    if (myNextFrameWrite < myLastFrameWrites.size() &&
+        myLastFrameWrites[myNextFrameWrite] == write)
+      myNextFrameWrite++;
+    else
+      myFrameReused = false;
+  }
+
+  myFrameWrites.push_back(write);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::startFrameCache()
+{
+  myLastFrameWrites.swap(myFrameWrites);
+  myFrameWrites.clear();
+  myNextFrameWrite = 0;
+
+  // Everything that decides how the frame is drawn, apart from the writes;
+  // the objects' state is the same as what's saved for them
+  Serializer& out = myFrameStartState;
+  out.reset();
+
+  const bool saved =
+    myDelayQueue.saveFrameStart(out) && myFrameManager.saveFrameStart(out) &&
+    myBackground.save(out) && myPlayfield.save(out) &&
+    myMissile0.save(out) && myMissile1.save(out) &&
+    myPlayer0.save(out) && myPlayer1.save(out) && myBall.save(out);
+
+  out.putInt(int(myHstate));
+  out.putInt(myHblankCtr);
+  out.putInt(myHctr);
+  out.putInt(myXDelta);
+  out.putInt(myMovementClock);
+  out.putBool(myMovementInProgress);
+  out.putBool(myExtendedHblank);
+  out.putInt(myLinesSinceChange);
+  out.putInt(int(myPriority));
+  out.putByte(mySpriteEnabledBits);
+  out.putByte(myColorHBlank);
+  out.putBool(myColorLossActive);
+  out.putInt(myPendingPixelsStart);
+  out.putInt(myPendingPixelsEnd);
+
+  const bool same = saved && out.size() == myLastFrameStartState.size() &&
+    memcmp(out.data(), myLastFrameStartState.data(), out.size()) == 0;
+  myLastFrameStartState.assign(out.data(), out.data() + out.size());
+
+  // The last frame must have been drawn to be reused; it's copied now, so
+  // that if this one turns out to differ, it's already drawn up to there
+  myFrameReused = same && !myFrameSkipped && !myLastFrameSkipped;
+  if (myFrameReused)
+    memcpy(myCurrentFrameBuffer.get(), myPreviousFrameBuffer.get(),
+           160 * FrameManager::frameBufferHeight);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::resetFrameCache()
+{
+  // The current frame is drawn from here on, and the next one can't be
+  // reused, since it's not known how the current one started
+  myFrameReused = false;
+  myLastFrameStartState.clear();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearHmoveComb()
 {
-  if (myFrameManager.isRendering() && myHstate == HState::blank)
+  if (myFrameManager.isRendering() && myHstate == HState::blank &&
+      !myFrameSkipped && !myFrameReused)
     memset(myCurrentFrameBuffer.get() + myFrameManager.getY() * 160,
            myColorHBlank, 8);
 }
@@ -1276,6 +1779,7 @@ void TIA::delayedWrite(uInt8 address, uInt8 value)
   switch (address)
   {
     case VBLANK:
+      renderPendingPixels();
       flushLineCache();
       myFrameManager.setVblank(value & 0x02);
       break;
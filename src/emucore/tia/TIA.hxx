@@ -21,6 +21,8 @@
 #include "bspf.hxx"
 #include "Console.hxx"
 #include "Sound.hxx"
+#include "AudioCapture.hxx"
+#include "TIASnd.hxx"
 #include "Settings.hxx"
 #include "Device.hxx"
 #include "Serializer.hxx"
@@ -145,8 +147,9 @@ class TIA : public Device
       the debugger state save has 'cycle resolution', and hence needs
       more information.  The methods below save/load this extra info,
       and eliminate having to save approx. 50K to normal state files.
+      Any pixels still queued are drawn before the display is saved.
     */
-    bool saveDisplay(Serializer& out) const;
+    bool saveDisplay(Serializer& out);
     bool loadDisplay(Serializer& in);
 
     /**
@@ -175,11 +178,23 @@ class TIA : public Device
       Note that calls to these method(s) must be eventually followed by
       ::frameReset() for the changes to take effect.
     */
-    void setHeight(uInt32 height) { myFrameManager.setFixedHeight(height); }
-    void setYStart(uInt32 ystart) { myFrameManager.setYstart(ystart); }
+    void setHeight(uInt32 height) {
+      myFrameManager.setFixedHeight(height);
+      resetFrameCache();
+    }
+    void setYStart(uInt32 ystart) {
+      myFrameManager.setYstart(ystart);
+      resetFrameCache();
+    }
 
-    void autodetectLayout(bool toggle) { myFrameManager.autodetectLayout(toggle); }
-    void setLayout(FrameLayout layout) { myFrameManager.setLayout(layout); }
+    void autodetectLayout(bool toggle) {
+      myFrameManager.autodetectLayout(toggle);
+      resetFrameCache();
+    }
+    void setLayout(FrameLayout layout) {
+      myFrameManager.setLayout(layout);
+      resetFrameCache();
+    }
     FrameLayout frameLayout() const { return myFrameManager.layout(); }
 
     /**
@@ -195,6 +210,65 @@ class TIA : public Device
     */
     void enableAutoFrame(bool enabled) { myAutoFrameEnabled = enabled; }
 
+    /**
+      Enables/disables stepping through every color clock by itself,
+      instead of running the clocks between register writes as one span.
+      Both give the same results; this is only meant for testing.
+
+      @param enabled  Whether to step through each clock
+    */
+    void enableClockStepping(bool enabled) { myClockStepping = enabled; }
+
+    /**
+      Sets how many frames are emulated without being drawn between each
+      frame that is drawn (0 draws every frame).  The frames that aren't
+      drawn are emulated exactly the same otherwise, and the frame buffers
+      keep the last two frames that were drawn.  The frame that has already
+      started counts as the first one, so after setFrameSkip(n), the last
+      frame of every n+1 is drawn.
+
+      @param frames  The number of frames to skip after each one drawn
+    */
+    void setFrameSkip(uInt32 frames);
+
+    /**
+      Answers whether the last completed frame was skipped by setFrameSkip().
+    */
+    bool frameSkipped() const { return myLastFrameSkipped; }
+
+    /**
+      Enables/disables reusing the previous frame for a frame that starts
+      out the same and makes the same register writes at the same clocks;
+      such a frame isn't drawn, unless it turns out to differ partway
+      through, in which case it's drawn from there on.  Either way the
+      results are exactly the same.  Changes made by the debugger aren't
+      register writes, so it turns this off while it's running.
+
+      @param enabled  Whether to reuse frames (the default)
+    */
+    void enableFrameCache(bool enabled);
+
+    /**
+      Answers how many of the frames drawn since the last reset were
+      reused from the frame before, as described in enableFrameCache().
+
+      @param reused  The number of frames that were reused
+      @param drawn   The number of frames drawn (or reused)
+    */
+    void frameCacheStats(uInt32& reused, uInt32& drawn) const {
+      reused = myFramesReused;
+      drawn = myFramesDrawn;
+    }
+
+    /**
+      Passes a copy of the sound generated from now on to the given object,
+      as well as to the sound device.
+
+      @param capture  The object to pass the sound to (nullptr for none)
+    */
+    void setAudioCapture(AudioCapture* capture) { myAudioCapture = capture; }
+    AudioCapture* audioCapture() const { return myAudioCapture; }
+
     /**
       Enables/disables color-loss for PAL modes only.
 
@@ -233,6 +307,11 @@ class TIA : public Device
     */
     uInt32 scanlinesLastFrame() const { return myFrameManager.scanlinesLastFrame(); }
 
+    /**
+      Answers the number of frames the TIA has generated.
+    */
+    uInt32 frameCount() const { return myFrameManager.frameCount(); }
+
     /**
       Answers whether the TIA is currently in being rendered
       (we're in between the start and end of drawing a frame).
@@ -343,6 +422,12 @@ class TIA : public Device
     */
     void flushLineCache();
 
+    /**
+      Draw the pixels that have been emulated, but are still waiting to be
+      drawn along with the rest of their span
+    */
+    void renderPendingPixels();
+
     /**
       Create a new delayQueueIterator for the debugger.
     */
@@ -405,6 +490,10 @@ class TIA : public Device
 
     void cycle(uInt32 colorClocks);
 
+    void tickClock();
+
+    uInt32 tickSpan(uInt32 clocks);
+
     void tickMovement();
 
     void tickHblank();
@@ -417,12 +506,18 @@ class TIA : public Device
 
     void renderPixel(uInt32 x, uInt32 y);
 
+    void queuePixels(uInt32 hctr, uInt32 count);
+
     void clearHmoveComb();
 
     void nextLine();
 
     void cloneLastLine();
 
+    void tickAudio(uInt32 ticks);
+
+    void flushAudio();
+
     void delayedWrite(uInt8 address, uInt8 value);
 
     void updatePaddle(uInt8 idx);
@@ -431,6 +526,20 @@ class TIA : public Device
 
     void swapBuffers();
 
+    // The frame cache (see enableFrameCache()): record a register write,
+    // and check it against the last frame while reusing it; save the state
+    // at the start of a frame, and decide whether to reuse the last one;
+    // draw the rest of the current frame and forget how it started, after
+    // a change that isn't a register write
+    void recordWrite(uInt8 address, uInt8 value);
+    void startFrameCache();
+    void resetFrameCache();
+
+    // The clock within the current frame
+    uInt32 frameClock() const {
+      return myFrameManager.scanlines() * 228 + myHctr;
+    }
+
     /**
       Get the result of the specified collision register.
     */
@@ -482,6 +591,13 @@ class TIA : public Device
     bool myCollisionUpdateRequired;
     uInt32 myCollisionMask;
 
+    // The collision mask of each object for every clock of the current
+    // line, which the collisions and pixels of each span are worked out from
+    uInt16 mySpanCoverage[6][228];
+
+    // The clocks of the current line whose pixels haven't been drawn yet
+    uInt32 myPendingPixelsStart, myPendingPixelsEnd;
+
     uInt32 myMovementClock;
     bool myMovementInProgress;
     bool myExtendedHblank;
@@ -502,9 +618,45 @@ class TIA : public Device
 
     uInt8 myShadowRegisters[64];
 
+    // The sound circuits, which are clocked twice per line, the samples
+    // generated since they were last passed on to the sound device, and
+    // anything else the samples are passed on to
+    static constexpr uInt32 audioBufferSamples = 1024;
+    TIASound myAudio;
+    uInt32 myAudioLineTicks;
+    unique_ptr<Int16[]> myAudioBuffer;
+    uInt32 myAudioSamples;
+    AudioCapture* myAudioCapture;
+
     // Automatic framerate correction based on number of scanlines
     bool myAutoFrameEnabled;
 
+    // Step through every color clock, rather than running spans of them
+    bool myClockStepping;
+
+    // The number of frames skipped after each one that's drawn, how far
+    // we've got through them, and whether the current and last completed
+    // frames aren't drawn
+    uInt32 myFrameSkip;
+    uInt32 myFrameSkipPhase;
+    bool myFrameSkipped;
+    bool myLastFrameSkipped;
+
+    // The frame cache: the state at the start of the current and last
+    // frames that decides how they're drawn, and the register writes that
+    // change it, each as the clock in the frame, the address and the value.
+    // While the current frame is being reused, it's checked against the
+    // next write of the last frame.
+    bool myFrameCacheEnabled;
+    bool myFrameReused;
+    Serializer myFrameStartState;
+    vector<uInt8> myLastFrameStartState;
+    vector<uInt64> myFrameWrites;
+    vector<uInt64> myLastFrameWrites;
+    uInt32 myNextFrameWrite;
+    uInt32 myFramesReused;
+    uInt32 myFramesDrawn;
+
     // Indicates if color loss should be enabled or disabled.  Color loss
     // occurs on PAL-like systems when the previous frame contains an odd
     // number of scanlines.
@@ -241,6 +241,38 @@ bool VblankManager::save(Serializer& out) const
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VblankManager::saveFrameStart(Serializer& out) const
+{
+  try
+  {
+    out.putInt(myVblankLines);
+    out.putInt(myYstart);
+    out.putBool(myVblank);
+    out.putInt(myCurrentLine);
+
+    out.putInt(int(myMode));
+    out.putInt(myLastVblankLines);
+    out.putByte(myVblankViolations);
+    out.putByte(myStableVblankFrames);
+    out.putBool(myVblankViolated);
+    out.putBool(myMode == VblankMode::locked &&
+                myFramesInLockedMode >= Metrics::framesUntilFinal);
+
+    out.putInt(myJitter);
+    out.putByte(myJitterFactor);
+
+    out.putBool(myIsRunning);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: TIA_VblankManager::saveFrameStart" << endl;
+    return false;
+  }
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool VblankManager::load(Serializer& in)
 {
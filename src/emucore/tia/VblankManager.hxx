@@ -59,6 +59,13 @@ class VblankManager : public Serializable
     bool load(Serializer& in) override;
     string name() const override { return "TIA_VblankManager"; }
 
+    /**
+      Saves the part of the state that decides how the frame that's about
+      to start is drawn.  The number of frames in locked mode only decides
+      whether the next start() leaves that mode, so only that is saved.
+    */
+    bool saveFrameStart(Serializer& out) const;
+
   private:
 
     enum VblankMode {
@@ -124,7 +124,7 @@ void AudioDialog::loadConfig()
   myVolumeLabel->setLabel(instance().settings().getString("volume"));
 
   // Fragsize
-  myFragsizePopup->setSelected(instance().settings().getString("fragsize"), "512");
+  myFragsizePopup->setSelected(instance().settings().getString("fragsize"), "256");
 
   // Output frequency
   myFreqPopup->setSelected(instance().settings().getString("freq"), "31400");
@@ -167,7 +167,7 @@ void AudioDialog::setDefaults()
   myVolumeSlider->setValue(100);
   myVolumeLabel->setLabel("100");
 
-  myFragsizePopup->setSelected("512", "");
+  myFragsizePopup->setSelected("256", "");
   myFreqPopup->setSelected("31400", "");
 
   mySoundEnableCheckbox->setState(true);
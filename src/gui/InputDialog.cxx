@@ -18,8 +18,8 @@
 #include "bspf.hxx"
 
 #include "OSystem.hxx"
-#include "Joystick.hxx"
-#include "Paddles.hxx"
+#include "Console.hxx"
+#include "EventHandler.hxx"
 #include "Settings.hxx"
 #include "EventMappingWidget.hxx"
 #include "EditTextWidget.hxx"
@@ -232,7 +232,7 @@ void InputDialog::loadConfig()
 
   // Joystick deadzone
   myDeadzone->setValue(instance().settings().getInt("joydeadzone"));
-  myDeadzoneLabel->setValue(Joystick::deadzone());
+  myDeadzoneLabel->setValue(instance().eventHandler().joyDeadZone());
 
   // Paddle speed (digital and mouse)
   myDPaddleSpeed->setValue(instance().settings().getInt("dsense"));
@@ -269,15 +269,13 @@ void InputDialog::saveConfig()
   // Joystick deadzone
   int deadzone = myDeadzone->getValue();
   instance().settings().setValue("joydeadzone", deadzone);
-  Joystick::setDeadZone(deadzone);
+  instance().eventHandler().setJoyDeadZone(deadzone);
 
   // Paddle speed (digital and mouse)
-  int sensitivity = myDPaddleSpeed->getValue();
-  instance().settings().setValue("dsense", sensitivity);
-  Paddles::setDigitalSensitivity(sensitivity);
-  sensitivity = myMPaddleSpeed->getValue();
-  instance().settings().setValue("msense", sensitivity);
-  Paddles::setMouseSensitivity(sensitivity);
+  instance().settings().setValue("dsense", myDPaddleSpeed->getValue());
+  instance().settings().setValue("msense", myMPaddleSpeed->getValue());
+  if(instance().hasConsole())
+    instance().console().initializePaddles();
 
   // AtariVox serial port
   instance().settings().setValue("avoxport", myAVoxPort->getText());
@@ -0,0 +1,43 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// libstella is always headless, so it only ever creates the Null video,
+// audio and event objects; this replaces MediaFactory.cxx in the library,
+// so none of the SDL backends are linked into it
+
+#include "MediaFactory.hxx"
+#include "FrameBufferNull.hxx"
+#include "EventHandlerNull.hxx"
+#include "SoundNull.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<FrameBuffer> MediaFactory::createVideo(OSystem& osystem)
+{
+  return make_ptr<FrameBufferNull>(osystem);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Sound> MediaFactory::createAudio(OSystem& osystem)
+{
+  return make_ptr<SoundNull>(osystem);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<EventHandler> MediaFactory::createEventHandler(OSystem& osystem)
+{
+  return make_ptr<EventHandlerNull>(osystem);
+}
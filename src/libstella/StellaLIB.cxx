@@ -0,0 +1,184 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "bspf.hxx"
+
+#include "MediaFactory.hxx"
+#include "Console.hxx"
+#include "Cart.hxx"
+#include "EventHandler.hxx"
+#include "M6532.hxx"
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "StateManager.hxx"
+#include "TIA.hxx"
+
+#include "StellaLIB.hxx"
+
+// The events corresponding to each bit of the input mask
+static constexpr Event::Type ourInputEvents[StellaLIB::kNumInputs] = {
+  Event::JoystickZeroUp, Event::JoystickZeroDown,
+  Event::JoystickZeroLeft, Event::JoystickZeroRight, Event::JoystickZeroFire,
+  Event::JoystickOneUp, Event::JoystickOneDown,
+  Event::JoystickOneLeft, Event::JoystickOneRight, Event::JoystickOneFire,
+  Event::ConsoleReset, Event::ConsoleSelect
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StellaLIB::StellaLIB()
+  : myConsole(nullptr),
+    myInputMask(0)
+{
+  // An embedded system never has a window, renderer or audio device,
+  // and doesn't use (or overwrite) the user's settings file
+  myOSystem = MediaFactory::createOSystem();
+  myOSystem->settings().setValue("headless", true);
+  myOSystem->settings().validate();
+
+  if(!myOSystem->create())
+    throw runtime_error("ERROR: Couldn't create OSystem");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StellaLIB::~StellaLIB()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StellaLIB::loadROM(const uInt8* image, uInt32 size)
+{
+  myConsole = nullptr;
+  myInputMask = 0;
+
+  const string& result = myOSystem->createConsole(image, size);
+  if(result == EmptyString)
+  {
+    myConsole = &myOSystem->console();
+    myConsole->tia().setAudioCapture(&myAudio);
+    myOSystem->eventHandler().clearEvents();
+  }
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIB::step(uInt32 frames, uInt32 inputMask)
+{
+  if(!myConsole)
+    return;
+
+  // Only pass on inputs that have actually changed
+  EventHandler& handler = myOSystem->eventHandler();
+  uInt32 changed = (inputMask ^ myInputMask) & ((1 << kNumInputs) - 1);
+  for(uInt32 i = 0; changed != 0; ++i, changed >>= 1)
+    if(changed & 1)
+      handler.handleEvent(ourInputEvents[i], (inputMask >> i) & 1);
+  myInputMask = inputMask;
+  myAudio.count = 0;
+
+  while(frames--)
+  {
+    handler.poll(0);
+    myConsole->tia().update();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* StellaLIB::frameBuffer() const
+{
+  // The TIA swaps its buffers as the next frame starts, which has already
+  // happened by the time a frame is complete
+  return myConsole ? myConsole->tia().previousFrameBuffer() : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StellaLIB::frameWidth() const
+{
+  return myConsole ? myConsole->tia().width() : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StellaLIB::frameHeight() const
+{
+  return myConsole ? myConsole->tia().height() : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIB::setAudioBuffer(Int16* buffer, uInt32 size)
+{
+  myAudio.buffer = buffer;
+  myAudio.size = buffer ? size : 0;
+  myAudio.count = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StellaLIB::stateHash() const
+{
+  return myConsole ? myOSystem->state().stateHash() : EmptyString;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIB::AudioBuffer::captureSamples(const Int16* samples, uInt32 n)
+{
+  if(count < size)
+    std::copy_n(samples, 2 * std::min(n, size - count), buffer + 2 * count);
+  count += n;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* StellaLIB::riotRAM() const
+{
+  return myConsole ? myConsole->riot().getRAM() : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* StellaLIB::cartRAM(uInt32& size) const
+{
+  size = 0;
+  return myConsole ? myConsole->cartridge().getRAM(size) : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StellaLIB::save(uInt8* buffer, uInt32 size)
+{
+  if(!myConsole)
+    return 0;
+
+  myState.reset();
+  if(!myOSystem->state().saveState(myState))
+    return 0;
+
+  uInt32 used = myState.size();
+  if(used > size)
+    return 0;
+
+  memcpy(buffer, myState.data(), used);
+  return used;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StellaLIB::load(const uInt8* buffer, uInt32 size)
+{
+  if(!myConsole)
+    return false;
+
+  // The state is read directly from the caller's buffer
+  Serializer in(buffer, size);
+
+  return myOSystem->state().loadState(in);
+}
@@ -0,0 +1,206 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef STELLA_LIB_HXX
+#define STELLA_LIB_HXX
+
+class OSystem;
+class Console;
+
+#include "bspf.hxx"
+#include "AudioCapture.hxx"
+#include "Serializer.hxx"
+
+/**
+  This class is the entry point for embedding the Stella emulation core in
+  another application (libstella).  It creates a headless OSystem (no
+  window, renderer or audio device), loads ROMs from memory, and allows
+  the caller to step the emulation and observe its state directly.
+
+  Once a ROM is loaded, step() and the observation methods don't allocate
+  any memory, so they can be called at a very high rate.
+*/
+class StellaLIB
+{
+  public:
+    /**
+      Bits used in the input mask passed to step()
+    */
+    enum Input {
+      kJoy0Up    = 1 << 0,
+      kJoy0Down  = 1 << 1,
+      kJoy0Left  = 1 << 2,
+      kJoy0Right = 1 << 3,
+      kJoy0Fire  = 1 << 4,
+      kJoy1Up    = 1 << 5,
+      kJoy1Down  = 1 << 6,
+      kJoy1Left  = 1 << 7,
+      kJoy1Right = 1 << 8,
+      kJoy1Fire  = 1 << 9,
+      kReset     = 1 << 10,
+      kSelect    = 1 << 11,
+      kNumInputs = 12
+    };
+
+  public:
+    /**
+      Create a new emulator instance.  A runtime_error exception is thrown
+      if the underlying system couldn't be created.
+    */
+    StellaLIB();
+    virtual ~StellaLIB();
+
+  public:
+    /**
+      Create a new console from the given ROM image, replacing any
+      previously loaded one.
+
+      @param image  The ROM image data (a copy is made)
+      @param size   The size of the ROM image data
+
+      @return  String indicating any error message (EmptyString for no errors)
+    */
+    string loadROM(const uInt8* image, uInt32 size);
+
+    /**
+      Answers whether a ROM is currently loaded.
+    */
+    bool hasConsole() const { return myConsole != nullptr; }
+
+    /**
+      Emulate the given number of frames, with the given inputs held
+      for the entire duration.
+
+      @param frames     The number of frames to emulate
+      @param inputMask  The inputs to hold down (bitwise-or of Input values)
+    */
+    void step(uInt32 frames, uInt32 inputMask);
+
+    /**
+      Access the most recently completed frame.  Each byte is a palette
+      index, and each line is frameWidth() bytes long.  When frames are
+      being skipped (see TIA::setFrameSkip()), this is the last one drawn.
+    */
+    const uInt8* frameBuffer() const;
+    uInt32 frameWidth() const;
+    uInt32 frameHeight() const;
+
+    /**
+      Capture the sound generated by each step() into the given buffer.
+      The samples are exactly those generated by the TIA, two per scanline
+      (see Console::audioSampleRate()), with the levels of its two channels interleaved.  Each
+      step() starts again at the start of the buffer, and any samples that
+      don't fit are left out.
+
+      @param buffer  The buffer for the samples (nullptr to stop capturing)
+      @param size    The size of the buffer, in samples (two values each)
+    */
+    void setAudioBuffer(Int16* buffer, uInt32 size);
+
+    /**
+      Answers the number of samples generated by the last step(), whether
+      or not they all fit in the buffer given to setAudioBuffer().
+    */
+    uInt32 audioSamples() const { return myAudio.count; }
+
+    /**
+      Access the 128 bytes of RIOT (M6532) RAM.
+    */
+    const uInt8* riotRAM() const;
+
+    /**
+      Access the cartridge RAM (if any).
+
+      @param size  Set to the size of the cartridge RAM (0 if there is none)
+      @return  A pointer to the cartridge RAM, or nullptr if there is none
+    */
+    const uInt8* cartRAM(uInt32& size) const;
+
+    /**
+      Save the complete state of the console into the given buffer.
+
+      @param buffer  The buffer to save the state into
+      @param size    The size of the buffer
+
+      @return  The number of bytes used, or 0 on any error (including the
+               buffer not being large enough)
+    */
+    uInt32 save(uInt8* buffer, uInt32 size);
+
+    /**
+      Load the complete state of the console from the given buffer
+      (previously filled by save()).
+
+      @param buffer  The buffer to load the state from
+      @param size    The number of bytes of state in the buffer
+
+      @return  False on any errors, else true
+    */
+    bool load(const uInt8* buffer, uInt32 size);
+
+    /**
+      Answers a hash (the MD5 digest) of the complete state of the console,
+      including the last frame.  With the 'seed' setting fixed, the same
+      ROM and input give the same hash after each step(), on any machine.
+
+      @return  The hash, or an empty string if there's no console
+    */
+    string stateHash() const;
+
+    /**
+      Access the underlying objects, for anything not covered above.
+    */
+    OSystem& osystem() const { return *myOSystem; }
+    Console& console() const { return *myConsole; }
+
+  private:
+    // The headless system hosting the console
+    unique_ptr<OSystem> myOSystem;
+
+    // The currently loaded console (owned by myOSystem)
+    Console* myConsole;
+
+    // Reused for every save, so its storage is only allocated once
+    Serializer myState;
+
+    // The last input mask applied, so only changed inputs are updated
+    uInt32 myInputMask;
+
+    // Copies the sound generated by step() into the caller's buffer
+    class AudioBuffer : public AudioCapture
+    {
+      public:
+        AudioBuffer() : buffer(nullptr), size(0), count(0) { }
+
+        void captureSamples(const Int16* samples, uInt32 n) override;
+
+        Int16* buffer;
+        uInt32 size;
+        uInt32 count;
+    };
+    AudioBuffer myAudio;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StellaLIB(const StellaLIB&) = delete;
+    StellaLIB(StellaLIB&&) = delete;
+    StellaLIB& operator=(const StellaLIB&) = delete;
+    StellaLIB& operator=(StellaLIB&&) = delete;
+};
+
+#endif
@@ -0,0 +1,10 @@
+MODULE := src/libstella
+
+# These objects are only used by the libstella target; they are
+# deliberately not added to OBJS, so the application doesn't link them
+LIBSTELLA_OBJS := \
+	src/libstella/MediaFactoryNull.o \
+	src/libstella/StellaLIB.o
+
+MODULE_DIRS += \
+	src/libstella
@@ -0,0 +1,200 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks that the sound generated by the TIA is captured exactly, both into
+// a buffer through StellaLIB, and to a WAV file by WavWriter.  Two consoles
+// run the same program from the same state, one of them capturing each
+// frame into a buffer, and the other writing to a file; the file must hold
+// exactly the samples in the buffers, two for each scanline emulated, and
+// give the console's own sample rate.  This is done for NTSC and PAL.
+//
+// The program changes the sound registers at the start of each frame, and
+// the frequency of the second channel on every line.  It runs long enough
+// for the WAV writer to fill all of its blocks a few times over.
+
+#include <cstdio>
+#include <fstream>
+
+#include "bspf.hxx"
+#include "Console.hxx"
+#include "Settings.hxx"
+#include "TIA.hxx"
+#include "WavWriter.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumFrames = 300;
+  const uInt32 kFrameSamples = 1024;
+  const char* const kFilename = "AudioCapture.wav";
+
+  // The code for each frame, after VSYNC
+  const uInt8 ourFrame[] = {
+    0xa5, 0x80,        // F01A:         LDA COUNT
+    0x85, 0x15,        // F01C:         STA AUDC0
+    0x4a,              // F01E:         LSR
+    0x85, 0x17,        // F01F:         STA AUDF0
+    0xa9, 0x0f,        // F021:         LDA #15
+    0x85, 0x19,        // F023:         STA AUDV0
+    0xa9, 0x04,        // F025:         LDA #4
+    0x85, 0x16,        // F027:         STA AUDC1
+    0xa9, 0x08,        // F029:         LDA #8
+    0x85, 0x1a,        // F02B:         STA AUDV1
+    0xa2, 0x00,        // F02D:         LDX #0
+    0x85, 0x02,        // F02F: LINE    STA WSYNC
+    0x86, 0x18,        // F031:         STX AUDF1
+    0xca,              // F033:         DEX
+    0xd0, 0xf9,        // F034:         BNE LINE
+    0xe6, 0x80,        // F036:         INC COUNT
+  };
+
+  // COUNT = $80
+
+  uInt32 get32(const uInt8* in)
+  {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | (uInt32(in[3]) << 24);
+  }
+
+  // Capture the sound of the program on a console with the given display
+  // format, answering the number of failures
+  uInt32 capture(const string& format, uInt32 expectedRate,
+                 const vector<uInt8>& rom)
+  {
+    uInt32 failed = 0;
+
+    auto configure = [&format](Settings& settings) {
+      settings.setValue("format", format);
+    };
+    unique_ptr<StellaLIB> buffered =
+        TestROM::createConsole(rom, "4K", configure);
+    unique_ptr<StellaLIB> written =
+        TestROM::createConsole(rom, "4K", configure);
+
+    // Two samples for each scanline
+    const uInt32 rate = uInt32(written->console().audioSampleRate());
+    if(rate != expectedRate)
+    {
+      cerr << format << ": the sample rate is " << rate << "Hz" << endl;
+      ++failed;
+    }
+
+    // Start both from exactly the same state
+    TestROM::copyState(*buffered, *written);
+
+    WavWriter writer;
+    if(!writer.open(kFilename, rate))
+      throw runtime_error("couldn't create the WAV file");
+    written->console().tia().setAudioCapture(&writer);
+
+    vector<Int16> frame(2 * kFrameSamples), samples;
+    buffered->setAudioBuffer(frame.data(), kFrameSamples);
+
+    uInt32 lines = 0;
+    for(uInt32 i = 0; i < kNumFrames; ++i)
+    {
+      buffered->step(1, 0);
+      written->step(1, 0);
+
+      const uInt32 count = std::min(buffered->audioSamples(), kFrameSamples);
+      samples.insert(samples.end(), frame.begin(), frame.begin() + 2 * count);
+      lines += buffered->console().tia().scanlinesLastFrame();
+    }
+
+    written->console().tia().setAudioCapture(nullptr);
+    if(!writer.close())
+      throw runtime_error("couldn't write the WAV file");
+
+    // The samples for the line that ends each frame are generated as the
+    // next line starts, so they're passed on with the next frame
+    const uInt32 count = uInt32(samples.size() / 2);
+    if(count + 2 < 2 * lines || count > 2 * lines + 2)
+    {
+      cerr << format << ": " << count << " samples for " << lines
+           << " scanlines" << endl;
+      ++failed;
+    }
+
+    Int16 low = 0, high = 0;
+    for(Int16 sample: samples)
+    {
+      low = std::min(low, sample);
+      high = std::max(high, sample);
+    }
+    if(low == high)
+    {
+      cerr << format << ": no sound was generated" << endl;
+      ++failed;
+    }
+
+    std::ifstream in(kFilename, std::ios::binary);
+    vector<uInt8> file((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+    in.close();
+    std::remove(kFilename);
+
+    const uInt32 dataBytes = count * 4;
+    if(file.size() != 44 + dataBytes ||
+       memcmp(file.data(), "RIFF", 4) != 0 || get32(&file[4]) != 36 + dataBytes ||
+       memcmp(&file[8], "WAVEfmt ", 8) != 0 ||
+       file[22] != 2 || get32(&file[24]) != rate ||  // Channels and rate
+       memcmp(&file[36], "data", 4) != 0 || get32(&file[40]) != dataBytes)
+    {
+      cerr << format << ": the WAV header doesn't match " << count
+           << " samples at " << rate << "Hz" << endl;
+      ++failed;
+    }
+    else
+    {
+      for(uInt32 i = 0; i < 2 * count; ++i)
+      {
+        const Int16 value = Int16(file[44 + 2 * i] | (file[45 + 2 * i] << 8));
+        if(value != samples[i])
+        {
+          cerr << format << ": sample " << i / 2 << " in the WAV file differs"
+               << endl;
+          ++failed;
+          break;
+        }
+      }
+    }
+
+    return failed;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  const vector<uInt8> rom = TestROM::buildROM(ourFrame, sizeof(ourFrame));
+  uInt32 failed = 0;
+
+  try
+  {
+    failed += capture("NTSC", 31440, rom);
+    failed += capture("PAL", 31200, rom);
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  cout << kNumFrames << " frames of NTSC and PAL sound captured to a buffer and a file: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks the resampler used to convert the TIA's samples to the rate of
+// the sound device, for both the NTSC (31440Hz) and PAL (31200Hz) rates of
+// the TIA.  One second of a tone is passed through it, in pieces of
+// different sizes, and the level of the output is measured once the filter
+// has settled:
+//
+//  - a constant level comes out unchanged
+//  - a tone below both Nyquist rates keeps its level, in its own channel
+//  - a tone above the output Nyquist rate is filtered out when downsampling
+//  - the number of samples produced matches the ratio of the rates, and
+//    follows any adjustment of the output rate
+
+#include <cmath>
+
+#include "bspf.hxx"
+#include "AudioResampler.hxx"
+
+namespace {
+  const double kNTSCRate = 2 * 15720.0;
+  const double kPALRate = 2 * 15600.0;
+  const double kPi = 3.14159265358979323846;
+
+  struct Result {
+    uInt32 samples;
+    double rms[2];
+  };
+
+  // Resample one second of a tone with the given level in the left channel
+  // (a frequency of 0 gives a constant level), and silence in the right,
+  // with the output rate adjusted by the given factor
+  Result resample(double inputRate, double outputRate, double frequency,
+                  double level, double adjustment = 1)
+  {
+    const uInt32 count = uInt32(inputRate);
+    vector<Int16> input(2 * count);
+    for(uInt32 i = 0; i < count; ++i)
+    {
+      input[2 * i] = Int16(std::lround(
+          level * std::cos(2 * kPi * frequency * i / inputRate)));
+      input[2 * i + 1] = 0;
+    }
+
+    AudioResampler resampler;
+    resampler.setRates(inputRate, outputRate);
+    resampler.adjustRate(adjustment);
+
+    vector<float> output(2 * resampler.maxOutput(count));
+    uInt32 produced = 0;
+    for(uInt32 i = 0, size = 1; i < count; i += size, size = size * 3 % 1000)
+    {
+      size = std::min(size, count - i);
+      produced += resampler.process(input.data() + 2 * i, size,
+                                    output.data() + 2 * produced);
+    }
+
+    // Skip the first tenth of a second, while the filter settles
+    Result result = { produced, { 0, 0 } };
+    const uInt32 start = uInt32(outputRate / 10);
+    for(uInt32 c = 0; c < 2; ++c)
+    {
+      double sum = 0;
+      for(uInt32 i = start; i < produced; ++i)
+        sum += double(output[2 * i + c]) * output[2 * i + c];
+      result.rms[c] = std::sqrt(sum / (produced - start));
+    }
+
+    return result;
+  }
+
+  bool check(const string& what, bool ok)
+  {
+    if(!ok)
+      cerr << what << " failed" << endl;
+    return ok;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+
+  for(double input: { kNTSCRate, kPALRate })
+  {
+    for(double rate: { 22050.0, 44100.0, 48000.0 })
+    {
+      const string name = std::to_string(int(input)) + "Hz to " +
+                          std::to_string(int(rate)) + "Hz: ";
+
+      const Result dc = resample(input, rate, 0, 10000);
+      failed += !check(name + "constant level",
+                       std::abs(dc.rms[0] - 10000) < 1 && dc.rms[1] < 1);
+      failed += !check(name + "sample count",
+                       std::abs(double(dc.samples) - rate) < 32);
+
+      // A pure tone's RMS level is its peak level over the square root of 2
+      const Result pass = resample(input, rate, 1000, 10000);
+      failed += !check(name + "passband",
+                       std::abs(pass.rms[0] - 10000 / std::sqrt(2.0)) < 70 &&
+                       pass.rms[1] < 1);
+    }
+
+    // 13kHz can be represented at the TIA's rates, but not at 22050Hz
+    const Result stop = resample(input, 22050, 13000, 10000);
+    failed += !check(std::to_string(int(input)) + "Hz: stopband",
+                     stop.rms[0] < 10);
+  }
+
+  // Half a percent more samples, at the same level
+  const Result faster = resample(kNTSCRate, 44100, 0, 10000, 1.005);
+  failed += !check("adjusted sample count",
+                   std::abs(double(faster.samples) - 44100 * 1.005) < 32 &&
+                   std::abs(faster.rms[0] - 10000) < 1);
+
+  cout << "Resampling NTSC and PAL sound to 22050, 44100 and 48000Hz: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
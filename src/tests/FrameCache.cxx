@@ -0,0 +1,200 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks that frames reused by the TIA's frame cache (see
+// TIA::enableFrameCache()) are exactly the same as when they're drawn.
+// Each program is run by two consoles from the same state, one of them
+// with the frame cache turned off, and the frame and the complete saved
+// state are compared after every frame.  The programs are:
+//
+//  - a still picture, which should be reused almost every frame
+//  - TestROM::busyROM(), which changes the background color every frame
+//  - a player moved by the same HMOVE every frame, so that every frame
+//    makes the same writes but is drawn differently, and is never reused
+//  - a still picture with an extra write partway through every fourth
+//    frame, so that frame differs from the one before by an extra write,
+//    and the one after it by a missing write; the other two are reused
+
+#include "bspf.hxx"
+#include "Console.hxx"
+#include "TIA.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumFrames = 200;
+  const uInt32 kStateSize = 65536;
+
+  // The frames after startup that can't be reused, since the frame manager
+  // is still working out where the drawn part of the frame starts
+  const uInt32 kSettleFrames = 16;
+
+  // The code for each frame, after VSYNC
+  const uInt8 ourStillFrame[] = {
+    0xa2, 0x25,        // F01A:         LDX #37
+    0x85, 0x02,        // F01C: VBL     STA WSYNC
+    0xca,              // F01E:         DEX
+    0xd0, 0xfb,        // F01F:         BNE VBL
+    0x86, 0x01,        // F021:         STX VBLANK
+    0xa0, 0xc0,        // F023:         LDY #192
+    0x85, 0x02,        // F025: LINE    STA WSYNC
+    0x84, 0x09,        // F027:         STY COLUBK
+    0x88,              // F029:         DEY
+    0xd0, 0xf9,        // F02A:         BNE LINE
+    0xa9, 0x02,        // F02C:         LDA #2
+    0x85, 0x01,        // F02E:         STA VBLANK
+    0xa2, 0x1e,        // F030:         LDX #30
+    0x85, 0x02,        // F032: OVER    STA WSYNC
+    0xca,              // F034:         DEX
+    0xd0, 0xfb         // F035:         BNE OVER
+  };
+
+  const uInt8 ourMovingFrame[] = {
+    0xa2, 0x25,        // F01A:         LDX #37
+    0x85, 0x02,        // F01C: VBL     STA WSYNC
+    0xca,              // F01E:         DEX
+    0xd0, 0xfb,        // F01F:         BNE VBL
+    0xa9, 0x10,        // F021:         LDA #$10
+    0x85, 0x20,        // F023:         STA HMP0
+    0xa9, 0xff,        // F025:         LDA #$FF
+    0x85, 0x1b,        // F027:         STA GRP0
+    0xa9, 0x0e,        // F029:         LDA #$0E
+    0x85, 0x06,        // F02B:         STA COLUP0
+    0x85, 0x02,        // F02D:         STA WSYNC
+    0x85, 0x2a,        // F02F:         STA HMOVE
+    0x86, 0x01,        // F031:         STX VBLANK
+    0xa0, 0xc0,        // F033:         LDY #192
+    0x85, 0x02,        // F035: LINE    STA WSYNC
+    0x84, 0x09,        // F037:         STY COLUBK
+    0x88,              // F039:         DEY
+    0xd0, 0xf9,        // F03A:         BNE LINE
+    0xa9, 0x02,        // F03C:         LDA #2
+    0x85, 0x01,        // F03E:         STA VBLANK
+    0xa2, 0x1e,        // F040:         LDX #30
+    0x85, 0x02,        // F042: OVER    STA WSYNC
+    0xca,              // F044:         DEX
+    0xd0, 0xfb         // F045:         BNE OVER
+  };
+
+  const uInt8 ourChangingFrame[] = {
+    0xa2, 0x25,        // F01A:         LDX #37
+    0x85, 0x02,        // F01C: VBL     STA WSYNC
+    0xca,              // F01E:         DEX
+    0xd0, 0xfb,        // F01F:         BNE VBL
+    0x86, 0x01,        // F021:         STX VBLANK
+    0xa0, 0xc0,        // F023:         LDY #192
+    0x85, 0x02,        // F025: LINE    STA WSYNC
+    0x84, 0x09,        // F027:         STY COLUBK
+    0xc0, 0x64,        // F029:         CPY #100
+    0xd0, 0x0a,        // F02B:         BNE SKIP
+    0xa5, 0x80,        // F02D:         LDA COUNT
+    0x29, 0x03,        // F02F:         AND #3
+    0xd0, 0x04,        // F031:         BNE SKIP
+    0xa9, 0x44,        // F033:         LDA #$44
+    0x85, 0x09,        // F035:         STA COLUBK
+    0x88,              // F037: SKIP    DEY
+    0xd0, 0xeb,        // F038:         BNE LINE
+    0xa9, 0x02,        // F03A:         LDA #2
+    0x85, 0x01,        // F03C:         STA VBLANK
+    0xa2, 0x1e,        // F03E:         LDX #30
+    0x85, 0x02,        // F040: OVER    STA WSYNC
+    0xca,              // F042:         DEX
+    0xd0, 0xfb,        // F043:         BNE OVER
+    0xe6, 0x80         // F045:         INC COUNT
+  };
+
+  // VBLANK = $01, WSYNC = $02, COLUP0 = $06, COLUBK = $09, GRP0 = $1B,
+  // HMP0 = $20, HMOVE = $2A, COUNT = $80
+
+  // Runs the program with and without the frame cache, comparing every
+  // frame, and answers the number of frames reused (or -1 if they differ)
+  Int32 run(const string& name, const vector<uInt8>& rom)
+  {
+    unique_ptr<StellaLIB> cached = TestROM::createConsole(rom);
+    unique_ptr<StellaLIB> drawn = TestROM::createConsole(rom);
+    drawn->console().tia().enableFrameCache(false);
+
+    const uInt32 size = cached->frameWidth() * cached->frameHeight();
+    vector<uInt8> cachedState(kStateSize), drawnState(kStateSize);
+
+    // Start both from exactly the same state
+    TestROM::copyState(*cached, *drawn);
+
+    for(uInt32 frame = 0; frame < kNumFrames; ++frame)
+    {
+      cached->step(1, 0);
+      drawn->step(1, 0);
+
+      if(memcmp(cached->frameBuffer(), drawn->frameBuffer(), size) != 0)
+      {
+        cerr << name << ": frame " << frame << " differs" << endl;
+        return -1;
+      }
+
+      const uInt32 cachedSize = cached->save(cachedState.data(), kStateSize);
+      const uInt32 drawnSize = drawn->save(drawnState.data(), kStateSize);
+      if(cachedSize == 0 || cachedSize != drawnSize ||
+         memcmp(cachedState.data(), drawnState.data(), cachedSize) != 0)
+      {
+        cerr << name << ": state after frame " << frame << " differs" << endl;
+        return -1;
+      }
+    }
+
+    uInt32 reused, frames;
+    cached->console().tia().frameCacheStats(reused, frames);
+    return reused;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+
+  try
+  {
+    const Int32 still = run("Still",
+        TestROM::buildROM(ourStillFrame, sizeof(ourStillFrame)));
+    failed += !TestROM::check("Reusing a still frame",
+        still >= Int32(kNumFrames - kSettleFrames));
+
+    const Int32 busy = run("Busy", TestROM::busyROM());
+    failed += !TestROM::check("Not reusing a changing frame", busy == 0);
+
+    const Int32 moving = run("Moving",
+        TestROM::buildROM(ourMovingFrame, sizeof(ourMovingFrame)));
+    failed += !TestROM::check("Not reusing a moving player", moving == 0);
+
+    // Two frames out of every four are reused
+    const Int32 changing = run("Changing",
+        TestROM::buildROM(ourChangingFrame, sizeof(ourChangingFrame)));
+    failed += !TestROM::check("Reusing half of the frames",
+        changing >= Int32(kNumFrames - kSettleFrames) / 2 - 1 &&
+        changing <= Int32(kNumFrames) / 2 + 1);
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  cout << kNumFrames << " frames of four programs, with and without "
+       << "reusing frames: " << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
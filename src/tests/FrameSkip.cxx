@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks that frames skipped with TIA::setFrameSkip() are otherwise emulated
+// exactly as usual.  Two consoles run the same program, one of them drawing
+// only one frame out of every kFrameSkip+1, and both are stepped by that
+// many frames at a time; the last frame of each step is drawn by both, so
+// the frame and the complete saved state are compared after every step.
+//
+// The program is TestROM::busyROM(), which changes the player graphics,
+// playfield and object positions all along each line, and changes the
+// background color every frame.
+
+#include "bspf.hxx"
+#include "Console.hxx"
+#include "TIA.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumSteps = 100;
+  const uInt32 kFrameSkip = 3;
+  const uInt32 kStateSize = 65536;
+
+  unique_ptr<StellaLIB> createConsole(const vector<uInt8>& rom, uInt32 skip)
+  {
+    unique_ptr<StellaLIB> lib = TestROM::createConsole(rom);
+    lib->console().tia().setFrameSkip(skip);
+
+    return lib;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  const vector<uInt8> rom = TestROM::busyROM();
+  uInt32 failed = 0;
+
+  try
+  {
+    unique_ptr<StellaLIB> skipped = createConsole(rom, kFrameSkip);
+    unique_ptr<StellaLIB> drawn = createConsole(rom, 0);
+
+    const uInt32 size = skipped->frameWidth() * skipped->frameHeight();
+    vector<uInt8> skipState(kStateSize), drawState(kStateSize);
+
+    // Start both from exactly the same state
+    TestROM::copyState(*skipped, *drawn);
+
+    // Loading a state doesn't touch the frame skip phase, but make sure
+    // the frame in progress is counted as the first one
+    skipped->console().tia().setFrameSkip(kFrameSkip);
+
+    for(uInt32 step = 0; step < kNumSteps && failed == 0; ++step)
+    {
+      skipped->step(kFrameSkip + 1, 0);
+      drawn->step(kFrameSkip + 1, 0);
+
+      if(skipped->console().tia().frameSkipped())
+      {
+        cerr << "Last frame of step " << step << " wasn't drawn" << endl;
+        ++failed;
+      }
+
+      if(memcmp(skipped->frameBuffer(), drawn->frameBuffer(), size) != 0)
+      {
+        cerr << "Frame after step " << step << " differs" << endl;
+        ++failed;
+      }
+
+      const uInt32 skipSize = skipped->save(skipState.data(), kStateSize);
+      const uInt32 drawSize = drawn->save(drawState.data(), kStateSize);
+      if(skipSize == 0 || skipSize != drawSize ||
+         memcmp(skipState.data(), drawState.data(), skipSize) != 0)
+      {
+        cerr << "State after step " << step << " differs" << endl;
+        ++failed;
+      }
+    }
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  cout << kNumSteps * (kFrameSkip + 1) << " frames with frame skipping: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
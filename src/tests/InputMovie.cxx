@@ -0,0 +1,257 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks the recording and playback of movies:
+//
+//  - ten minutes of made-up input (held joystick directions and buttons,
+//    switches, and the mouse moving now and then) play back exactly as
+//    recorded, after being saved and loaded, in a few bytes per frame
+//  - skipping to any frame of the input, forwards or backwards, gives
+//    the input of that frame
+//  - a movie recorded while a ROM reads the joystick plays back to the
+//    same states, whatever input is given during playback, from a file,
+//    and seeking to a frame (from a keyframe) gives the same state as
+//    playing up to it
+//  - a movie can't be played with a different ROM
+
+#include <cstdio>
+
+#include "bspf.hxx"
+#include "OSystem.hxx"
+#include "StateManager.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumFrames = 36000;
+  const uInt32 kNumConsoleFrames = 3000;
+  const uInt32 kStateSize = 65536;
+  const char* const kFilename = "inputmovie-test.tmp";
+
+  // The events changed by the made-up input
+  const Event::Type ourEvents[] = {
+    Event::JoystickZeroUp, Event::JoystickZeroDown, Event::JoystickZeroLeft,
+    Event::JoystickZeroRight, Event::JoystickZeroFire, Event::ConsoleReset,
+    Event::ConsoleSelect, Event::ConsoleLeftDiffA, Event::PaddleOneFire,
+    Event::MouseAxisXValue, Event::MouseAxisYValue, Event::SALeftAxis0Value
+  };
+  const uInt32 kNumEvents = sizeof(ourEvents) / sizeof(ourEvents[0]);
+
+  // The code for each frame, after VSYNC
+  const uInt8 ourFrame[] = {
+    0xe6, 0x80,        // F01A:         INC COUNT
+    0xad, 0x80, 0x02,  // F01C:         LDA SWCHA
+    0x45, 0x0c,        // F01F:         EOR INPT4
+    0x45, 0x80,        // F021:         EOR COUNT
+    0x18,              // F023:         CLC
+    0x65, 0x81,        // F024:         ADC SUM
+    0x85, 0x81,        // F026:         STA SUM
+    0x85, 0x09,        // F028:         STA COLUBK
+    0xa2, 0xff,        // F02A:         LDX #255
+    0x85, 0x02,        // F02C: LINE    STA WSYNC
+    0x86, 0x09,        // F02E:         STX COLUBK
+    0xca,              // F030:         DEX
+    0xd0, 0xf9,        // F031:         BNE LINE
+    0xa2, 0x04,        // F033:         LDX #4
+    0x85, 0x02,        // F035: OVER    STA WSYNC
+    0xca,              // F037:         DEX
+    0xd0, 0xfb,        // F038:         BNE OVER
+  };
+
+  // Each frame adds the joystick and fire button to a sum, so any input
+  // played back differently changes every later state.  COUNT = $80,
+  // SUM = $81
+
+  // The ROM with the given ID, so different ROMs can run the same code
+  vector<uInt8> buildROM(uInt8 id)
+  {
+    vector<uInt8> image = TestROM::buildROM(ourFrame, sizeof(ourFrame));
+    image[0x800] = id;
+
+    return image;
+  }
+
+  // A simple generator, so the input is the same on every platform
+  uInt32 nextRandom(uInt32& seed)
+  {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 16;
+  }
+
+  // Change the made-up input for the next frame: now and then, one of
+  // the events changes, and the mouse moves for a while
+  void changeInput(Event& event, uInt32& seed)
+  {
+    if(nextRandom(seed) % 16 == 0)
+    {
+      const Event::Type type = ourEvents[nextRandom(seed) % kNumEvents];
+      if(type == Event::MouseAxisXValue || type == Event::MouseAxisYValue ||
+         type == Event::SALeftAxis0Value)
+        event.set(type, Int32(nextRandom(seed) % 401) - 200);
+      else
+        event.set(type, !event.get(type));
+    }
+  }
+
+  using TestROM::check;
+
+  // Record made-up input, save and load the movie, and answer whether it
+  // plays back exactly
+  bool playsBack(uInt32& bytes)
+  {
+    Event event, played;
+    InputMovie movie;
+    vector<Int32> values;
+    uInt32 seed = 1;
+
+    for(uInt32 frame = 0; frame < kNumFrames; ++frame)
+    {
+      changeInput(event, seed);
+      movie.record(event);
+      for(uInt32 i = 0; i < Event::LastType; ++i)
+        values.push_back(event.get(Event::Type(i)));
+    }
+    bytes = movie.size();
+
+    Serializer out;
+    if(!movie.save(out))
+      return false;
+    out.reset();
+    InputMovie loaded;
+    if(!loaded.load(out) || loaded.frames() != kNumFrames)
+      return false;
+
+    for(uInt32 frame = 0; frame < kNumFrames; ++frame)
+    {
+      if(!loaded.play(played))
+        return false;
+      for(uInt32 i = 0; i < Event::LastType; ++i)
+        if(played.get(Event::Type(i)) != values[frame * Event::LastType + i])
+          return false;
+    }
+
+    if(loaded.play(played) || loaded.played() != kNumFrames)
+      return false;
+
+    // Skip around the movie
+    for(uInt32 frame: { 12345u, 77u, 35999u, 0u, 20000u })
+    {
+      if(!loaded.seek(frame) || !loaded.play(played))
+        return false;
+      for(uInt32 i = 0; i < Event::LastType; ++i)
+        if(played.get(Event::Type(i)) != values[frame * Event::LastType + i])
+          return false;
+    }
+
+    return !loaded.seek(kNumFrames + 1);
+  }
+
+  vector<uInt8> saveState(StellaLIB& lib)
+  {
+    vector<uInt8> state(kStateSize);
+    state.resize(lib.save(state.data(), kStateSize));
+    return state;
+  }
+
+  // Run the console for the given number of frames, with made-up input,
+  // saving the state every 100 frames
+  void run(StellaLIB& lib, vector<vector<uInt8>>& states)
+  {
+    uInt32 seed = 7;
+    for(uInt32 frame = 1; frame <= kNumConsoleFrames; ++frame)
+    {
+      lib.step(1, (nextRandom(seed) % 8 == 0) ? nextRandom(seed) & 0x1F : 0);
+      if(frame % 100 == 0)
+        states.push_back(saveState(lib));
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+
+  uInt32 bytes = 0;
+  failed += !check("made-up input", playsBack(bytes));
+  failed += !check("size", bytes < kNumFrames * 3);
+
+  // A movie with the input kept in the wrong order can't be loaded
+  Serializer bad;
+  bad.putInt(1);
+  bad.putInt(0);
+  bad.putString("");
+  bad.reset();
+  InputMovie movie;
+  failed += !check("wrong inputs", !movie.load(bad));
+
+  unique_ptr<StellaLIB> console;
+  try
+  {
+    console = TestROM::createConsole(buildROM(0));
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+  StellaLIB& lib = *console;
+
+  // Record the console running, then play it back without any input
+  vector<vector<uInt8>> recorded, played;
+  StateManager& state = lib.osystem().state();
+  std::remove(kFilename);
+  failed += !check("record", state.recordMovie(kFilename));
+  run(lib, recorded);
+  state.stopMovie();
+
+  lib.step(37, 0x1F);
+  failed += !check("play", state.playMovie(kFilename));
+  for(uInt32 frame = 1; frame <= kNumConsoleFrames; ++frame)
+  {
+    lib.step(1, frame & 0x1F);
+    if(frame % 100 == 0)
+      played.push_back(saveState(lib));
+  }
+  failed += !check("played states", played == recorded &&
+                   !recorded.empty() && recorded[0] != recorded[1]);
+  failed += !check("movie playing", state.isPlayingMovie());
+
+  // Seek forwards and backwards, within and across keyframes
+  for(uInt32 frame: { 1700u, 300u, 2500u, 2900u, 1000u, 3000u })
+  {
+    failed += !check("seek to " + std::to_string(frame),
+                     state.seekMovie(frame) && state.movieFrame() == frame &&
+                     saveState(lib) == recorded[frame / 100 - 1]);
+  }
+  failed += !check("seek past end", !state.seekMovie(kNumConsoleFrames + 1));
+
+  lib.step(1, 0);
+  failed += !check("movie ended", !state.isPlayingMovie());
+
+  // Another ROM can't play the movie
+  const vector<uInt8> other = buildROM(1);
+  if(lib.loadROM(other.data(), uInt32(other.size())) == EmptyString)
+    failed += !check("other ROM", !state.playMovie(kFilename));
+  std::remove(kFilename);
+
+  cout << kNumFrames << " frames of input, and " << kNumConsoleFrames
+       << " frames of a movie (" << bytes << " bytes): "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks the clock used by the music data fetchers of the DPC and ARM
+// based carts.  However the cycles are split into updates, the total
+// number of clocks must be exactly 20000Hz worth of the cycles run at
+// 1193191.666...Hz, rounded down; this is also checked across a save and
+// load of the clock in the middle of the run.  Loading a part of a clock
+// that's a whole clock or more must fail.
+
+#include "bspf.hxx"
+#include "Serializer.hxx"
+#include "MusicClock.hxx"
+
+namespace {
+  // About ten minutes of 6507 cycles
+  const uInt64 kNumCycles = 716000000;
+
+  // The exact number of clocks in the given number of cycles
+  uInt64 expectedClocks(uInt64 cycles)
+  {
+    return cycles * 120000 / 7159150;
+  }
+
+  // Run the clock for the given number of cycles, in updates of the given
+  // size (or varying sizes, starting from it), and optionally save and load
+  // it through a second clock halfway
+  uInt64 run(uInt64 cycles, uInt32 size, bool vary, bool reload)
+  {
+    MusicClock clock;
+    uInt64 clocks = 0;
+
+    for(uInt64 done = 0; done < cycles; )
+    {
+      const uInt32 step = uInt32(std::min(uInt64(size), cycles - done));
+      clocks += clock.clocks(step);
+      done += step;
+      if(vary)
+        size = size * 7 % 3001 + 1;
+
+      if(reload && done >= cycles / 2)
+      {
+        reload = false;
+
+        Serializer state;
+        clock.save(state);
+        state.reset();
+
+        MusicClock loaded;
+        loaded.load(state);
+        clock = loaded;
+      }
+    }
+
+    // No time passes in an update of zero (or fewer) cycles
+    clocks += clock.clocks(0) + clock.clocks(-76);
+
+    return clocks;
+  }
+
+  bool check(const string& what, uInt64 clocks, uInt64 expected)
+  {
+    if(clocks != expected)
+      cerr << what << ": " << clocks << " clocks, expected " << expected
+           << endl;
+    return clocks == expected;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+  const uInt64 expected = expectedClocks(kNumCycles);
+
+  failed += !check("one cycle at a time",
+                   run(kNumCycles / 100, 1, false, false),
+                   expectedClocks(kNumCycles / 100));
+  failed += !check("one scanline at a time",
+                   run(kNumCycles, 76, false, false), expected);
+  failed += !check("varying updates",
+                   run(kNumCycles, 1, true, false), expected);
+  failed += !check("saved and loaded",
+                   run(kNumCycles, 1, true, true), expected);
+
+  // The largest part of a clock saved by older versions, in units of 1e-8
+  bool rejected = false;
+  try
+  {
+    Serializer old;
+    old.putInt(99999999);
+    old.reset();
+    MusicClock().load(old);
+  }
+  catch(const runtime_error&)
+  {
+    rejected = true;
+  }
+  if(!rejected)
+  {
+    cerr << "Part of a clock from an older state wasn't rejected" << endl;
+    ++failed;
+  }
+
+  cout << "Music clocks over " << kNumCycles << " cycles: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Runs many consoles at the same time, each on its own thread, and checks
+// that every one of them produces exactly the same frames as it does when
+// run by itself.  The consoles are created on the main thread, each one
+// while those created before it are running, so this also checks that
+// nothing in the emulation depends on the thread that created a console,
+// or is changed for the consoles already running when another is created.
+//
+// Each console runs the same F8SC test program, with its own input.  The
+// program reads from the SC RAM write port on every scanline, which
+// reports to the debugger (when there is one).  It only tests the value
+// read with BIT, since the undriven data bus bits are random.  Every other
+// console has paddles, with its own speed and range from its settings,
+// which the program reads on every scanline.
+
+#include <atomic>
+#include <thread>
+
+#include "bspf.hxx"
+#include "Console.hxx"
+#include "Control.hxx"
+#include "Settings.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumConsoles = 32;
+  const uInt32 kNumFrames   = 120;
+
+  // The code for each frame, after VSYNC.  It's in both 4K banks, after
+  // the SC RAM ports, so the program starts at $F100
+  const uInt16 kCodeStart = 0x100;
+  const uInt8 ourFrame[] = {
+    0xa2, 0x25,            // F11A:        LDX #37
+    0x85, 0x02,            // F11C: VBL    STA WSYNC
+    0xca,                  // F11E:        DEX
+    0xd0, 0xfb,            // F11F:        BNE VBL
+    0x86, 0x01,            // F121:        STX VBLANK
+    0xa0, 0xc0,            // F123:        LDY #192
+    0x85, 0x02,            // F125: LINE   STA WSYNC
+    0x98,                  // F127:        TYA
+    0x18,                  // F128:        CLC
+    0x65, 0x80,            // F129:        ADC COUNT
+    0x85, 0x09,            // F12B:        STA COLUBK
+    0x4d, 0x80, 0x02,      // F12D:        EOR SWCHA
+    0x85, 0x0e,            // F130:        STA PF1
+    0xb9, 0x00, 0xf1,      // F132:        LDA $F100,Y
+    0x85, 0x08,            // F135:        STA COLUPF
+    0xa5, 0x08,            // F137:        LDA INPT0
+    0x85, 0x0f,            // F139:        STA PF2
+    0x2c, 0x00, 0x10,      // F13B:        BIT $1000
+    0x88,                  // F13E:        DEY
+    0xd0, 0xe4,            // F13F:        BNE LINE
+    0xa9, 0x82,            // F141:        LDA #$82
+    0x85, 0x01,            // F143:        STA VBLANK
+    0xa2, 0x1e,            // F145:        LDX #30
+    0x85, 0x02,            // F147: OVER   STA WSYNC
+    0xca,                  // F149:        DEX
+    0xd0, 0xfb,            // F14A:        BNE OVER
+    0xe6, 0x80,            // F14C:        INC COUNT
+    0xa5, 0x80,            // F14E:        LDA COUNT
+    0x29, 0x01,            // F150:        AND #1
+    0xaa,                  // F152:        TAX
+    0xbd, 0xf8, 0x1f,      // F153:        LDA $1FF8,X
+  };
+
+  // VSYNC = $00, VBLANK = $01, WSYNC = $02, COLUPF = $08, INPT0 = $08,
+  // COLUBK = $09, PF1 = $0E, PF2 = $0F, SWCHA = $0280, COUNT = $80
+
+  // The joystick input held down for each frame, which differs between
+  // consoles
+  uInt32 input(uInt32 console, uInt32 frame)
+  {
+    const uInt32 n = (frame / 8 + console * 7) * 2654435761u;
+    return (n >> 24) & (StellaLIB::kJoy0Up | StellaLIB::kJoy0Down |
+                        StellaLIB::kJoy0Left | StellaLIB::kJoy0Right |
+                        StellaLIB::kJoy0Fire);
+  }
+
+  // The settings for each console; every other one has paddles (moved by
+  // the joystick input), with a speed and range that differ between them
+  void configure(uInt32 console, Settings& settings)
+  {
+    if(console % 2 == 0)
+      return;
+
+    settings.setValue("lc", "PADDLES");
+    settings.setValue("dsense", 1 + console % 20);
+    settings.setValue("ma", "AUTO " + std::to_string(20 + console * 2));
+  }
+
+  unique_ptr<StellaLIB> createConsole(const vector<uInt8>& rom,
+                                      uInt32 console)
+  {
+    return TestROM::createConsole(rom, "F8SC",
+        [console](Settings& settings) { configure(console, settings); });
+  }
+
+  struct Result
+  {
+    vector<uInt64> frames;  // hash of each frame
+    vector<uInt8> ram;      // RIOT RAM after the last frame
+  };
+
+  // Runs the console's frames; if it's given a flag, it waits halfway
+  // through until the flag is set
+  void runConsole(StellaLIB& lib, uInt32 console, Result& result,
+                  const std::atomic<bool>* created = nullptr)
+  {
+    const uInt32 size = lib.frameWidth() * lib.frameHeight();
+    for(uInt32 frame = 0; frame < kNumFrames; ++frame)
+    {
+      if(created && frame == kNumFrames / 2)
+        while(!created->load())
+          std::this_thread::yield();
+
+      lib.step(1, input(console, frame));
+
+      // FNV-1a
+      uInt64 hash = 14695981039346656037ull;
+      const uInt8* fb = lib.frameBuffer();
+      for(uInt32 i = 0; i < size; ++i)
+        hash = (hash ^ fb[i]) * 1099511628211ull;
+      result.frames.push_back(hash);
+    }
+    result.ram.assign(lib.riotRAM(), lib.riotRAM() + 128);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  const vector<uInt8> rom =
+      TestROM::buildROM(ourFrame, sizeof(ourFrame), true, 2, kCodeStart);
+  vector<Result> expected(kNumConsoles), actual(kNumConsoles);
+  uInt32 failed = 0;
+
+  try
+  {
+    // First run each console by itself, on this thread
+    for(uInt32 i = 0; i < kNumConsoles; ++i)
+    {
+      unique_ptr<StellaLIB> lib = createConsole(rom, i);
+
+      // The type is reported as 'F8SC (8K) ', so only check the first word
+      const string& type = lib->console().about().BankSwitch;
+      if(type.substr(0, type.find(' ')) != "F8SC")
+      {
+        cerr << "Console " << i << ": bankswitch type is '" << type << "'"
+             << endl;
+        ++failed;
+      }
+      const bool paddles =
+          lib->console().leftController().type() == Controller::Paddles;
+      if(paddles != (i % 2 == 1))
+      {
+        cerr << "Console " << i << ": wrong left controller" << endl;
+        ++failed;
+      }
+      runConsole(*lib, i, expected[i]);
+    }
+
+    // Then run them all at once, creating each one here while those
+    // created before it run; they all wait halfway through until the last
+    // one is created, so that each is created while others are running
+    vector<unique_ptr<StellaLIB>> libs;
+    vector<std::thread> threads;
+    std::atomic<bool> created(false);
+    try
+    {
+      for(uInt32 i = 0; i < kNumConsoles; ++i)
+      {
+        libs.push_back(createConsole(rom, i));
+        threads.emplace_back(runConsole, std::ref(*libs[i]), i,
+                             std::ref(actual[i]), &created);
+      }
+    }
+    catch(...)
+    {
+      created = true;
+      for(auto& thread: threads)
+        thread.join();
+      throw;
+    }
+
+    created = true;
+    for(auto& thread: threads)
+      thread.join();
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  for(uInt32 i = 0; i < kNumConsoles; ++i)
+  {
+    uInt32 frame = 0;
+    while(frame < kNumFrames &&
+          expected[i].frames[frame] == actual[i].frames[frame])
+      ++frame;
+
+    if(frame < kNumFrames)
+      cerr << "Console " << i << ": frame " << frame << " differs" << endl;
+    else if(expected[i].ram != actual[i].ram)
+      cerr << "Console " << i << ": final RAM differs" << endl;
+    else
+      continue;
+    ++failed;
+  }
+
+  // Different input should give different results, otherwise this isn't
+  // testing much
+  if(expected[0].frames == expected[1].frames)
+  {
+    cerr << "Consoles 0 and 1 drew the same frames" << endl;
+    ++failed;
+  }
+
+  cout << kNumConsoles << " consoles, " << kNumFrames << " frames each: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks the history of states kept for rewinding.  A console saves its
+// state every few frames into a RewindBuffer, and also keeps a copy of
+// each; then:
+//
+//  - every state taken back, newest first, must match its copy exactly,
+//    and must run on to the next state captured
+//  - the states must take much less memory than the copies
+//  - with a small budget, only the newest states are kept, within it
+//  - states added after some were taken back (past a keyframe) must also
+//    come back unchanged
+
+#include "bspf.hxx"
+#include "RewindBuffer.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumFrames = 1200;
+  const uInt32 kInterval = 4;
+  const uInt32 kKeyframeInterval = 30;
+  const uInt32 kStateSize = 65536;
+
+  // The code for each frame, after VSYNC
+  const uInt8 ourFrame[] = {
+    0xe6, 0x80,        // F01A:         INC COUNT
+    0xa5, 0x80,        // F01C:         LDA COUNT
+    0x29, 0x3f,        // F01E:         AND #$3F
+    0xaa,              // F020:         TAX
+    0xa5, 0x80,        // F021:         LDA COUNT
+    0x95, 0x90,        // F023:         STA TABLE,X
+    0x85, 0x09,        // F025:         STA COLUBK
+    0xa2, 0xff,        // F027:         LDX #255
+    0x85, 0x02,        // F029: LINE    STA WSYNC
+    0x86, 0x09,        // F02B:         STX COLUBK
+    0xca,              // F02D:         DEX
+    0xd0, 0xf9,        // F02E:         BNE LINE
+    0xa2, 0x04,        // F030:         LDX #4
+    0x85, 0x02,        // F032: OVER    STA WSYNC
+    0xca,              // F034:         DEX
+    0xd0, 0xfb,        // F035:         BNE OVER
+  };
+
+  // Each frame changes the frame count, and one byte of a table that
+  // fills up over 64 frames.  COUNT = $80, TABLE = $90
+
+  using TestROM::check;
+
+  // Answers whether the newest states in the buffer match the given
+  // copies, taking them back until there are only 'keep' left
+  bool takeBack(RewindBuffer& buffer, const vector<vector<uInt8>>& copies,
+                uInt32 keep)
+  {
+    vector<uInt8> state;
+    for(uInt32 i = uInt32(copies.size()); buffer.size() > keep; --i)
+    {
+      if(i == 0 || !buffer.last(state) || state != copies[i - 1])
+        return false;
+      buffer.removeLast();
+    }
+    return true;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+
+  unique_ptr<StellaLIB> console;
+  try
+  {
+    console = TestROM::createConsole(
+        TestROM::buildROM(ourFrame, sizeof(ourFrame)));
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+  StellaLIB& lib = *console;
+
+  // Capture the states, and keep a copy of each
+  RewindBuffer buffer(uInt64(64) << 20, kKeyframeInterval);
+  vector<vector<uInt8>> copies;
+  vector<uInt8> state(kStateSize);
+  for(uInt32 frame = 1; frame <= kNumFrames; ++frame)
+  {
+    lib.step(1, 0);
+    if(frame % kInterval == 0)
+    {
+      const uInt32 size = lib.save(state.data(), kStateSize);
+      buffer.add(state.data(), size);
+      copies.emplace_back(state.begin(), state.begin() + size);
+    }
+  }
+  const uInt32 count = uInt32(copies.size());
+  const uInt64 stateBytes = buffer.stateBytes();
+  failed += !check("state count", buffer.size() == count);
+  failed += !check("compression", buffer.memoryUsed() * 4 < stateBytes);
+
+  // Every state restored runs on to the next one
+  vector<uInt8> restored;
+  for(uInt32 i = 0; i + 1 < count && failed == 0; i += 7)
+  {
+    RewindBuffer single(uInt64(1) << 20, kKeyframeInterval);
+    single.add(copies[i].data(), uInt32(copies[i].size()));
+    single.last(restored);
+    lib.load(restored.data(), uInt32(restored.size()));
+    lib.step(kInterval, 0);
+
+    const uInt32 size = lib.save(state.data(), kStateSize);
+    failed += !check("run on from state " + std::to_string(i),
+        vector<uInt8>(state.begin(), state.begin() + size) == copies[i + 1]);
+  }
+
+  // Take back half of the states, then add them again
+  failed += !check("take back half", takeBack(buffer, copies, count / 2));
+  for(uInt32 i = count / 2; i < count; ++i)
+    buffer.add(copies[i].data(), uInt32(copies[i].size()));
+  failed += !check("take back all", takeBack(buffer, copies, 1) &&
+                   buffer.last(restored) && restored == copies[0]);
+  buffer.removeLast();
+  failed += !check("empty", buffer.size() == 0 && buffer.memoryUsed() == 0 &&
+                   !buffer.last(restored));
+
+  // Only the newest states fit into a smaller buffer
+  const uInt64 budget = stateBytes / 32;
+  RewindBuffer small(budget, kKeyframeInterval);
+  for(const auto& copy: copies)
+    small.add(copy.data(), uInt32(copy.size()));
+  failed += !check("small buffer", small.size() < count &&
+                   small.size() > kKeyframeInterval &&
+                   small.memoryUsed() <= budget &&
+                   takeBack(small, copies, 0));
+
+  cout << count << " states for rewinding: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
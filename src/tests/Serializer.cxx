@@ -0,0 +1,184 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks the Serializer with each kind of storage:
+//
+//  - every type of value written to memory reads back the same, through
+//    enough data that the buffer has to grow a few times
+//  - the same data can be read in place from the caller's memory, which
+//    can't be written to
+//  - reading past the end of the data throws an exception
+//  - a file keeps the contents that aren't overwritten, and can be opened
+//    read-only; flushing writes the data out right away
+
+#include <cstdio>
+
+#include "bspf.hxx"
+#include "Serializer.hxx"
+
+namespace {
+  const uInt32 kNumRecords = 5000;
+  const char* const kFilename = "serializer-test.tmp";
+
+  void write(Serializer& out)
+  {
+    for(uInt32 i = 0; i < kNumRecords; ++i)
+    {
+      const uInt16 shorts[3] = { uInt16(i), uInt16(i * 3), uInt16(~i) };
+      const uInt32 ints[2] = { i * 0x01020304, ~i };
+
+      out.putByte(uInt8(i));
+      out.putShort(uInt16(i * 7));
+      out.putInt(i * 0x9E3779B9);
+      out.putBool(i % 3 == 0);
+      out.putDouble(i / 7.0);
+      out.putString(string(i % 13, char('a' + i % 26)));
+      out.putByteArray(reinterpret_cast<const uInt8*>(ints), 5);
+      out.putShortArray(shorts, 3);
+      out.putIntArray(ints, 2);
+    }
+  }
+
+  // Answers whether the data written by write() reads back correctly
+  bool verify(const Serializer& in)
+  {
+    for(uInt32 i = 0; i < kNumRecords; ++i)
+    {
+      const uInt32 ints[2] = { i * 0x01020304, ~i };
+      uInt16 shorts[3];
+      uInt32 readInts[2];
+      uInt8 bytes[5];
+
+      if(in.getByte() != uInt8(i) || in.getShort() != uInt16(i * 7) ||
+         in.getInt() != i * 0x9E3779B9 || in.getBool() != (i % 3 == 0) ||
+         in.getDouble() != i / 7.0 ||
+         in.getString() != string(i % 13, char('a' + i % 26)))
+        return false;
+
+      in.getByteArray(bytes, 5);
+      in.getShortArray(shorts, 3);
+      in.getIntArray(readInts, 2);
+      if(memcmp(bytes, ints, 5) != 0 || shorts[0] != uInt16(i) ||
+         shorts[1] != uInt16(i * 3) || shorts[2] != uInt16(~i) ||
+         readInts[0] != ints[0] || readInts[1] != ints[1])
+        return false;
+    }
+    return true;
+  }
+
+  // Answers whether the given operation throws an exception
+  template<typename T>
+  bool throws(T operation)
+  {
+    try
+    {
+      operation();
+    }
+    catch(const runtime_error&)
+    {
+      return true;
+    }
+    return false;
+  }
+
+  bool check(const string& what, bool ok)
+  {
+    if(!ok)
+      cerr << what << " failed" << endl;
+    return ok;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+
+  try
+  {
+    Serializer memory;
+    write(memory);
+    const uInt32 size = memory.size();
+    memory.reset();
+    failed += !check("memory", verify(memory));
+    failed += !check("read past end of memory",
+                     throws([&] { memory.getByte(); }));
+
+    // Writing again from the start reuses the buffer
+    memory.reset();
+    write(memory);
+    memory.reset();
+    failed += !check("memory rewritten",
+                     memory.size() == 0 && verify(memory));
+
+    const vector<uInt8> copy(memory.data(), memory.data() + size);
+    Serializer span(copy.data(), size);
+    failed += !check("caller's memory", bool(span) && verify(span));
+    failed += !check("read past end of caller's memory",
+                     throws([&] { span.getByte(); }));
+    span.reset();
+    failed += !check("write to caller's memory",
+                     throws([&] { span.putByte(0); }) &&
+                     throws([&] { span.putString("abc"); }));
+
+    // A string whose length is more than the data left
+    Serializer partial;
+    partial.putInt(100);
+    partial.putByteArray(copy.data(), 99);
+    partial.reset();
+    failed += !check("partial string",
+                     throws([&] { partial.getString(); }));
+
+    std::remove(kFilename);
+    failed += !check("missing read-only file",
+                     !Serializer(kFilename, true));
+    {
+      Serializer file(kFilename);
+      failed += !check("new file", bool(file) && file.size() == 0);
+      write(file);
+      failed += !check("flush", file.flush() &&
+                       verify(Serializer(kFilename, true)));
+    }
+    {
+      // Only the first byte is changed (to the same value), so the rest
+      // must be kept when it's written back
+      Serializer file(kFilename);
+      failed += !check("file", bool(file) && verify(file));
+      file.reset();
+      file.putByte(0);
+    }
+    {
+      Serializer file(kFilename, true);
+      failed += !check("read-only file", bool(file) && verify(file) &&
+                       throws([&] { file.getByte(); }));
+      file.reset();
+      failed += !check("write to read-only file",
+                       throws([&] { file.putByte(0); }));
+    }
+    std::remove(kFilename);
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  cout << "Serializing " << kNumRecords << " records to memory and files: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
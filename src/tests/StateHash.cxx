@@ -0,0 +1,134 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks that the emulation is deterministic with a fixed random seed,
+// using a ROM that adds up random RAM and undriven TIA pins every frame:
+//
+//  - two consoles with the same seed and input give the same state hash
+//    after every frame, and the same frames
+//  - a console with another seed doesn't
+//  - after a state is loaded again, the following frames give the same
+//    hashes as before (so the random numbers are part of the state)
+
+#include "bspf.hxx"
+#include "Settings.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumFrames = 300;
+  const uInt32 kStateSize = 65536;
+
+  // The code for each frame, after VSYNC; RAM isn't cleared
+  const uInt8 ourFrame[] = {
+    0xe6, 0x80,        // F013:         INC COUNT
+    0xa6, 0x80,        // F015:         LDX COUNT
+    0xb5, 0x80,        // F017:         LDA $80,X
+    0x45, 0x00,        // F019:         EOR CXM0P
+    0x18,              // F01B:         CLC
+    0x65, 0x81,        // F01C:         ADC SUM
+    0x85, 0x81,        // F01E:         STA SUM
+    0xa2, 0xff,        // F020:         LDX #255
+    0x85, 0x02,        // F022: LINE    STA WSYNC
+    0x85, 0x09,        // F024:         STA COLUBK
+    0x69, 0x01,        // F026:         ADC #1
+    0xca,              // F028:         DEX
+    0xd0, 0xf7,        // F029:         BNE LINE
+    0xa2, 0x04,        // F02B:         LDX #4
+    0x85, 0x02,        // F02D: OVER    STA WSYNC
+    0xca,              // F02F:         DEX
+    0xd0, 0xfb,        // F030:         BNE OVER
+  };
+
+  // COUNT = $80, SUM = $81; the low six bits of CXM0P aren't driven
+
+  // Load the ROM with random RAM, CPU registers and undriven pins, all
+  // from the given seed
+  unique_ptr<StellaLIB> start(Int32 seed)
+  {
+    return TestROM::createConsole(
+        TestROM::buildROM(ourFrame, sizeof(ourFrame), false), "4K",
+        [seed](Settings& settings) {
+          settings.setValue("ramrandom", true);
+          settings.setValue("cpurandom", "AXYP");
+          settings.setValue("tiadriven", true);
+          settings.setValue("seed", seed);
+        });
+  }
+
+  // Run for the given number of frames, with input that changes now and
+  // then, answering the hash after each frame
+  vector<string> run(StellaLIB& lib, uInt32 first, uInt32 frames)
+  {
+    vector<string> hashes;
+    for(uInt32 frame = first; frame < first + frames; ++frame)
+    {
+      lib.step(1, (frame / 16) % 3 == 0 ? 0x10 : 0);
+      hashes.push_back(lib.stateHash());
+    }
+    return hashes;
+  }
+
+  using TestROM::check;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+
+  unique_ptr<StellaLIB> consoles[3];
+  try
+  {
+    consoles[0] = start(12345);
+    consoles[1] = start(12345);
+    consoles[2] = start(54321);
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+  StellaLIB& one = *consoles[0];
+  StellaLIB& two = *consoles[1];
+  StellaLIB& other = *consoles[2];
+
+  const vector<string>& hashes = run(one, 0, kNumFrames);
+  failed += !check("same seed", run(two, 0, kNumFrames) == hashes &&
+                   hashes[0].size() == 32 && hashes[0] != hashes[1]);
+  failed += !check("same frame", one.frameHeight() == two.frameHeight() &&
+                   memcmp(one.frameBuffer(), two.frameBuffer(),
+                          one.frameWidth() * one.frameHeight()) == 0);
+
+  const vector<string>& others = run(other, 0, kNumFrames);
+  uInt32 same = 0;
+  for(uInt32 i = 0; i < kNumFrames; ++i)
+    same += others[i] == hashes[i];
+  failed += !check("other seed", same == 0);
+
+  // Go back halfway, and run the rest again
+  vector<uInt8> state(kStateSize);
+  const uInt32 size = one.save(state.data(), kStateSize);
+  const vector<string>& after = run(one, kNumFrames, kNumFrames);
+  failed += !check("load", size > 0 && one.load(state.data(), size) &&
+                   run(one, kNumFrames, kNumFrames) == after);
+
+  cout << kNumFrames << " frames with random RAM and pins, from a fixed seed: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks that the TIA gives exactly the same results when it runs spans of
+// color clocks between register writes, as it does when it steps through
+// each clock by itself.  Two consoles run the same program, one of them
+// with clock stepping enabled, and both the frame and the complete saved
+// state are compared after every frame.  Both are then stopped partway
+// through the next frame, as the debugger stops at a breakpoint, and the
+// displays saved for the debugger are compared too.
+//
+// Two programs are run.  TestROM::busyROM() changes most of the registers
+// all along each line, with an HMOVE on every other line.  Its overscan
+// lines don't change at all, so they're handled by the line cache.  The
+// other program draws lines that are all the same, so they're cached too,
+// except for a background color and a VBLANK written partway through one
+// line each, which must only change the rest of that line.
+
+#include "bspf.hxx"
+#include "Console.hxx"
+#include "M6502.hxx"
+#include "Serializer.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "StellaLIB.hxx"
+#include "TestROM.hxx"
+
+namespace {
+  const uInt32 kNumFrames = 300;
+  const uInt32 kStateSize = 65536;
+  const uInt32 kPartialInstructions = 1000;
+
+  // The code for each frame of the second program, after VSYNC
+  const uInt8 ourCachedFrame[] = {
+    0xa2, 0x25,        // F01A:         LDX #37
+    0x85, 0x02,        // F01C: VBL     STA WSYNC
+    0xca,              // F01E:         DEX
+    0xd0, 0xfb,        // F01F:         BNE VBL
+    0x86, 0x01,        // F021:         STX VBLANK
+    0xa0, 0xc0,        // F023:         LDY #192
+    0x85, 0x02,        // F025: LINE    STA WSYNC
+    0xa9, 0x40,        // F027:         LDA #$40
+    0x85, 0x09,        // F029:         STA COLUBK
+    0xc0, 0x96,        // F02B:         CPY #150
+    0xd0, 0x09,        // F02D:         BNE NOCOL
+    0xa2, 0x06,        // F02F:         LDX #6
+    0xca,              // F031: WAIT1   DEX
+    0xd0, 0xfd,        // F032:         BNE WAIT1
+    0xa5, 0x80,        // F034:         LDA COUNT
+    0x85, 0x09,        // F036:         STA COLUBK
+    0xc0, 0x64,        // F038: NOCOL   CPY #100
+    0xd0, 0x0d,        // F03A:         BNE NOVBL
+    0xa2, 0x06,        // F03C:         LDX #6
+    0xca,              // F03E: WAIT2   DEX
+    0xd0, 0xfd,        // F03F:         BNE WAIT2
+    0xa9, 0x02,        // F041:         LDA #2
+    0x85, 0x01,        // F043:         STA VBLANK
+    0x85, 0x02,        // F045:         STA WSYNC
+    0x86, 0x01,        // F047:         STX VBLANK
+    0x88,              // F049: NOVBL   DEY
+    0xd0, 0xd9,        // F04A:         BNE LINE
+    0xa9, 0x02,        // F04C:         LDA #2
+    0x85, 0x01,        // F04E:         STA VBLANK
+    0xa2, 0x1e,        // F050:         LDX #30
+    0x85, 0x02,        // F052: OVER    STA WSYNC
+    0xca,              // F054:         DEX
+    0xd0, 0xfb,        // F055:         BNE OVER
+    0xe6, 0x80,        // F057:         INC COUNT
+  };
+
+  // The background color is written around the middle of the line, and
+  // VBLANK a little later, after more than 40 lines that are the same.
+  // COUNT = $80
+
+  unique_ptr<StellaLIB> createConsole(const vector<uInt8>& rom, bool stepping)
+  {
+    unique_ptr<StellaLIB> lib = TestROM::createConsole(rom);
+    lib->console().tia().enableClockStepping(stepping);
+
+    return lib;
+  }
+
+  // Run the program with spans and with clock stepping, answering the
+  // number of frames that differ
+  uInt32 compare(const string& name, const vector<uInt8>& rom)
+  {
+    unique_ptr<StellaLIB> spans = createConsole(rom, false);
+    unique_ptr<StellaLIB> clocks = createConsole(rom, true);
+
+    const uInt32 size = spans->frameWidth() * spans->frameHeight();
+    vector<uInt8> spanState(kStateSize), clockState(kStateSize);
+
+    // Start both from exactly the same state
+    TestROM::copyState(*spans, *clocks);
+
+    uInt32 failed = 0;
+    for(uInt32 frame = 0; frame < kNumFrames && failed == 0; ++frame)
+    {
+      spans->step(1, 0);
+      clocks->step(1, 0);
+
+      if(memcmp(spans->frameBuffer(), clocks->frameBuffer(), size) != 0)
+      {
+        cerr << name << ": frame " << frame << " differs" << endl;
+        ++failed;
+      }
+
+      const uInt32 spanSize = spans->save(spanState.data(), kStateSize);
+      const uInt32 clockSize = clocks->save(clockState.data(), kStateSize);
+      if(spanSize == 0 || spanSize != clockSize ||
+         memcmp(spanState.data(), clockState.data(), spanSize) != 0)
+      {
+        cerr << name << ": state after frame " << frame << " differs" << endl;
+        ++failed;
+      }
+
+      // Stop a different distance into each frame
+      const uInt32 partial = kPartialInstructions + frame * 7;
+      spans->console().system().m6502().execute(partial);
+      clocks->console().system().m6502().execute(partial);
+
+      Serializer spanDisplay, clockDisplay;
+      if(!spans->console().tia().saveDisplay(spanDisplay) ||
+         !clocks->console().tia().saveDisplay(clockDisplay) ||
+         spanDisplay.size() != clockDisplay.size() ||
+         memcmp(spanDisplay.data(), clockDisplay.data(),
+                spanDisplay.size()) != 0)
+      {
+        cerr << name << ": display partway through frame " << frame + 1
+             << " differs" << endl;
+        ++failed;
+      }
+    }
+    return failed;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  uInt32 failed = 0;
+
+  try
+  {
+    failed += compare("Busy lines", TestROM::busyROM());
+    failed += compare("Cached lines",
+        TestROM::buildROM(ourCachedFrame, sizeof(ourCachedFrame)));
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  cout << kNumFrames << " frames of two programs with spans and clock "
+       << "stepping: " << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef TEST_ROM_HXX
+#define TEST_ROM_HXX
+
+#include <functional>
+
+#include "bspf.hxx"
+#include "OSystem.hxx"
+#include "Settings.hxx"
+#include "StellaLIB.hxx"
+
+/**
+  The ROMs and consoles shared by the tests that run a program.
+
+  Each test only supplies the code for one frame of its program, which
+  is placed after the code that every program starts with, and followed
+  by a jump back to FRAME:
+
+    START   SEI
+            CLD
+            LDX #$FF
+            TXS
+            LDA #0          ; these four are left out when RAM
+    CLEAR   STA $00,X       ; isn't cleared, which moves the frame
+            DEX             ; code from +$1A to +$13
+            BNE CLEAR
+    FRAME   LDA #2
+            STA VSYNC
+            STA WSYNC
+            STA WSYNC
+            STA WSYNC
+            LDA #0
+            STA VSYNC
+            ...             ; the frame code
+            JMP FRAME
+*/
+namespace TestROM {
+
+  /**
+    Answers a ROM image with the given frame code, in every one of the
+    given number of 4K banks.  The program starts at $F000 plus 'start',
+    which is also where the reset vector points.
+  */
+  inline vector<uInt8> buildROM(const uInt8* frame, uInt32 size,
+                                bool clear = true, uInt32 banks = 1,
+                                uInt16 start = 0x000)
+  {
+    vector<uInt8> code = { 0x78, 0xd8, 0xa2, 0xff, 0x9a };
+    if(clear)
+      code.insert(code.end(), { 0xa9, 0x00, 0x95, 0x00, 0xca, 0xd0, 0xfb });
+
+    const uInt16 loop = 0xF000 + start + uInt16(code.size());
+    code.insert(code.end(), { 0xa9, 0x02, 0x85, 0x00, 0x85, 0x02, 0x85, 0x02,
+                              0x85, 0x02, 0xa9, 0x00, 0x85, 0x00 });
+    code.insert(code.end(), frame, frame + size);
+    code.insert(code.end(), { 0x4c, uInt8(loop & 0xff), uInt8(loop >> 8) });
+
+    vector<uInt8> image(banks * 4096, 0);
+    for(uInt32 bank = 0; bank < banks; ++bank)
+    {
+      uInt8* b = image.data() + bank * 4096;
+      std::copy(code.begin(), code.end(), b + start);
+      b[0xFFC] = b[0xFFE] = uInt8(start & 0xff);
+      b[0xFFD] = b[0xFFF] = uInt8(0xF0 | (start >> 8));
+    }
+    return image;
+  }
+
+  /**
+    Answers the ROM that keeps the TIA busy, used by both TIASpans and
+    FrameSkip.  It does an HMOVE on every other line, and changes the
+    player graphics, playfield, priority, sizes and motion registers all
+    along the line, and also repositions the objects partway through some
+    lines.  The overscan lines don't change at all.
+  */
+  inline vector<uInt8> busyROM()
+  {
+    static const uInt8 ourFrame[] = {
+      0x85, 0x2c,        // F01A:         STA CXCLR
+      0xa2, 0x25,        // F01C:         LDX #37
+      0x85, 0x02,        // F01E: VBL     STA WSYNC
+      0xca,              // F020:         DEX
+      0xd0, 0xfb,        // F021:         BNE VBL
+      0x86, 0x01,        // F023:         STX VBLANK
+      0xa5, 0x80,        // F025:         LDA COUNT
+      0x85, 0x09,        // F027:         STA COLUBK
+      0x85, 0x10,        // F029:         STA RESP0
+      0xa0, 0x60,        // F02B:         LDY #96
+      0x85, 0x02,        // F02D: LINE    STA WSYNC
+      0x85, 0x2a,        // F02F:         STA HMOVE
+      0x98,              // F031:         TYA
+      0x45, 0x80,        // F032:         EOR COUNT
+      0x85, 0x1b,        // F034:         STA GRP0
+      0x85, 0x07,        // F036:         STA COLUP1
+      0x4a,              // F038:         LSR
+      0x85, 0x1c,        // F039:         STA GRP1
+      0x85, 0x0e,        // F03B:         STA PF1
+      0x29, 0xf0,        // F03D:         AND #$F0
+      0x85, 0x20,        // F03F:         STA HMP0
+      0x85, 0x24,        // F041:         STA HMBL
+      0x98,              // F043:         TYA
+      0x0a,              // F044:         ASL
+      0x0a,              // F045:         ASL
+      0x0a,              // F046:         ASL
+      0x0a,              // F047:         ASL
+      0x85, 0x21,        // F048:         STA HMP1
+      0x85, 0x22,        // F04A:         STA HMM0
+      0x85, 0x0f,        // F04C:         STA PF2
+      0x98,              // F04E:         TYA
+      0x29, 0x07,        // F04F:         AND #7
+      0xaa,              // F051:         TAX
+      0x85, 0x0a,        // F052:         STA CTRLPF
+      0x86, 0x04,        // F054:         STX NUSIZ0
+      0x85, 0x1f,        // F056:         STA ENABL
+      0x85, 0x1d,        // F058:         STA ENAM0
+      0xe0, 0x03,        // F05A:         CPX #3
+      0xd0, 0x02,        // F05C:         BNE NORESP
+      0x85, 0x11,        // F05E:         STA RESP1
+      0xe0, 0x05,        // F060: NORESP  CPX #5
+      0xd0, 0x04,        // F062:         BNE NORESB
+      0x85, 0x14,        // F064:         STA RESBL
+      0x85, 0x12,        // F066:         STA RESM0
+      0xa5, 0x30,        // F068: NORESB  LDA CXM0P
+      0x05, 0x32,        // F06A:         ORA CXP0FB
+      0x05, 0x37,        // F06C:         ORA CXPPMM
+      0x05, 0x81,        // F06E:         ORA COLL
+      0x85, 0x81,        // F070:         STA COLL
+      0x88,              // F072:         DEY
+      0xd0, 0xb8,        // F073:         BNE LINE
+      0xa9, 0x02,        // F075:         LDA #2
+      0x85, 0x01,        // F077:         STA VBLANK
+      0xa2, 0x1e,        // F079:         LDX #30
+      0x85, 0x02,        // F07B: OVER    STA WSYNC
+      0xca,              // F07D:         DEX
+      0xd0, 0xfb,        // F07E:         BNE OVER
+      0xe6, 0x80,        // F080:         INC COUNT
+    };
+
+    // The kernel takes two scanlines for each pass through LINE, so the
+    // writes land at different places on alternate lines.  The collision
+    // registers are read from the $30 mirror.  COUNT = $80, COLL = $81
+
+    return buildROM(ourFrame, sizeof(ourFrame));
+  }
+
+  /**
+    Answers a new console running the given ROM, with the given
+    bankswitching type and RAM that isn't random.  Any other settings
+    can be changed by 'configure' before the ROM is loaded.
+  */
+  inline unique_ptr<StellaLIB> createConsole(const vector<uInt8>& rom,
+      const string& type = "4K",
+      const std::function<void(Settings&)>& configure = nullptr)
+  {
+    unique_ptr<StellaLIB> lib = make_ptr<StellaLIB>();
+    Settings& settings = lib->osystem().settings();
+    settings.setValue("bs", type);
+    settings.setValue("ramrandom", false);
+    if(configure)
+      configure(settings);
+
+    const string& error = lib->loadROM(rom.data(), uInt32(rom.size()));
+    if(error != EmptyString)
+      throw runtime_error(error);
+
+    return lib;
+  }
+
+  /**
+    Puts the second console in exactly the same state as the first, since
+    parts of it (such as the RIOT timer) are random at startup.
+  */
+  inline void copyState(StellaLIB& from, StellaLIB& to)
+  {
+    vector<uInt8> state(65536);
+    const uInt32 size = from.save(state.data(), uInt32(state.size()));
+    if(size == 0 || !to.load(state.data(), size))
+      throw runtime_error("couldn't copy the initial state");
+  }
+
+  /**
+    Reports the given check when it failed, answering whether it passed.
+  */
+  inline bool check(const string& what, bool ok)
+  {
+    if(!ok)
+      cerr << what << " failed" << endl;
+    return ok;
+  }
+
+}  // Namespace TestROM
+
+#endif
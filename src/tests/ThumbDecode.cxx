@@ -0,0 +1,443 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Checks that the Thumb emulation gives exactly the same results as it did
+// when every instruction was decoded by a chain of mask compares, before
+// the decoding table was added.  The expected values below were recorded
+// with that decoder:
+//
+//  - every one of the 65536 instruction words is run by itself from the
+//    same state, followed by code that saves the registers and the flags;
+//    the number of instructions executed, the RAM and any messages are
+//    combined into one hash
+//  - generated programs loop over random arithmetic, shifts, loads and
+//    stores, stack operations, branches and subroutine calls; the number
+//    of instructions they execute and the contents of the RAM are compared
+//
+// Both are run with and without translation of the code into blocks, and
+// while profiling.  A program in RAM that changes the instruction after
+// the one doing the write is also run, to check that the translation is
+// redone.
+
+#include "bspf.hxx"
+#include "Base.hxx"
+#include "Thumbulator.hxx"
+
+using Common::Base;
+
+namespace {
+  // The DPC+ driver calls the custom code at 0x0C08, and the code returns
+  // when it branches to the (even) address it was called from
+  const uInt32 kStart = 0x0C08;
+  const uInt32 kSubroutine = 0x1000;
+  const uInt32 kRAMBase = 0x40000000;
+
+  // Returns from any address, rather than running on past a branch
+  const uInt16 kExit = 0xDF00;   // swi 0x00
+
+  const uInt64 kOpcodesInstructions = 5290508;
+  const uInt32 kOpcodesHash = 0x058f21db;
+
+  struct Program {
+    uInt32 seed;
+    uInt64 instructions;
+    uInt32 hash;
+  };
+
+  const Program ourPrograms[] = {
+    {  1, 1950, 0xdce3535c },
+    {  2, 1967, 0xd550c229 },
+    {  3, 1871, 0xed0cbf63 },
+    {  4, 1807, 0xe830c64a },
+    {  5, 1903, 0x76fd761e },
+    {  6, 1743, 0x35d9bf64 },
+    {  7, 1888, 0x83b42fef },
+    {  8, 1776, 0x65d00f88 },
+    {  9, 1871, 0x9cb024e7 },
+    { 10, 1646, 0xa6f752b1 },
+    { 11, 1743, 0x1a3e228b },
+    { 12, 1727, 0xb45a0f24 },
+    { 13, 1808, 0xcb4c5abb },
+    { 14, 1743, 0x8e834b54 },
+    { 15, 2121, 0x49554f03 },
+    { 16, 1663, 0x0a052023 },
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  class Hash
+  {
+    public:
+      void add(uInt32 value) { myValue = (myValue ^ value) * 16777619u; }
+      void add(const string& s) { for(char c: s) add(uInt32(uInt8(c))); }
+      void add(const vector<uInt16>& v) { for(uInt16 w: v) add(w); }
+      uInt32 value() const { return myValue; }
+
+    private:
+      uInt32 myValue = 2166136261u;
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Thumb code, written into the ROM image from the given address
+  class Assembler
+  {
+    public:
+      Assembler(vector<uInt16>& rom, uInt32 address, uInt32 seed)
+        : myROM(rom), myAddress(address), myRandom(seed) { }
+
+      uInt32 address() const { return myAddress; }
+
+      void emit(uInt16 inst) { myROM[myAddress >> 1] = inst; myAddress += 2; }
+
+      // BL to the given address, as the usual pair of instructions
+      void call(uInt32 target)
+      {
+        const uInt32 offset = target - (myAddress + 4);
+        emit(0xF000 | ((offset >> 12) & 0x7FF));
+        emit(0xF800 | ((offset >> 1) & 0x7FF));
+      }
+
+      // Conditional branch back to the given address
+      void branchBack(uInt32 cond, uInt32 target)
+      {
+        emit(0xD000 | (cond << 8) | (((target - (myAddress + 4)) >> 1) & 0xFF));
+      }
+
+      // Any instruction that can run anywhere in a program; registers
+      // r0-r5 and r9-r11 hold the data, r6 points to an area of RAM, r7 is
+      // the loop counter and r8 holds the return address
+      void random(bool simple = false)
+      {
+        switch(pick(simple ? 7 : 19))
+        {
+          case 0:   // AND, EOR, LSL, ..., MUL, BIC, MVN
+            emit(0x4000 | (pick(16) << 6) | (pick(8) << 3) | low());
+            break;
+          case 1:   // ADD(1), SUB(1) (with an immediate of 0, this is a MOV)
+            emit(0x1C00 | (pick(2) << 9) | (pick(8) << 6) | (pick(8) << 3) | low());
+            break;
+          case 2:   // ADD(3), SUB(3)
+            emit(0x1800 | (pick(2) << 9) | (pick(8) << 6) | (pick(8) << 3) | low());
+            break;
+          case 3:   // MOV(1), CMP(1), ADD(2), SUB(2)
+            emit(0x2000 | (pick(4) << 11) | (low() << 8) | pick(256));
+            break;
+          case 4:   // LSL(1), LSR(1), ASR(1)
+            emit((pick(3) << 11) | (pick(32) << 6) | (pick(8) << 3) | low());
+            break;
+          case 5:   // ADD(4), CMP(3), MOV(3) (or CPY with two low registers)
+          {
+            const uInt32 rd = data(), rm = data();
+            emit(0x4400 | (pick(3) << 8) | ((rd & 8) << 4) | (rm << 3) | (rd & 7));
+            break;
+          }
+          case 6:   // SXTH, SXTB, UXTH, UXTB, REV, REV16, REVSH
+          {
+            static const uInt16 ops[] = {
+              0xB200, 0xB240, 0xB280, 0xB2C0, 0xBA00, 0xBA40, 0xBAC0
+            };
+            emit(ops[pick(7)] | (pick(8) << 3) | low());
+            break;
+          }
+          case 7:   // STR(1), LDR(1), STRB(1), LDRB(1), STRH(1), LDRH(1)
+            emit(0x6000 | (pick(6) << 11) | (pick(32) << 6) | (6 << 3) | low());
+            break;
+          case 8:   // STR(2) ... LDRSH, offset by the loop counter
+            emit(0x5000 | (pick(8) << 9) | (7 << 6) | (6 << 3) | low());
+            break;
+          case 9:   // STR(3), LDR(4)
+            emit(0x9000 | (pick(2) << 11) | (low() << 8) | pick(5));
+            break;
+          case 10:  // ADD(5), ADD(6), LDR(3)
+            emit((pick(2) ? 0xA000 | (pick(2) << 11) : 0x4800) |
+                 (low() << 8) | pick(256));
+            break;
+          case 11:  // B(1), which skips the next instruction if taken
+            emit(0xD000 | (pick(14) << 8));
+            random(true);
+            break;
+          case 12:  // B(2), which always skips the next instruction
+            emit(0xE000);
+            random(true);
+            break;
+          case 13:  // PUSH, POP, with LR or not, and ADD(7)
+          {
+            const uInt32 mask = 1 + pick(63), lr = pick(2);
+            emit(0xB400 | (lr << 8) | mask);
+            random(true);
+            emit(0xBC00 | mask);
+            if(lr)
+              emit(0xB001);
+            break;
+          }
+          case 14:  // STMIA, LDMIA, through r5
+          {
+            const uInt32 mask = 1 + pick(31);
+            emit(0xAD00);
+            emit(0xC500 | mask);
+            random(true);
+            emit(0xAD00);
+            emit(0xCD00 | mask);
+            break;
+          }
+          case 15:  // SUB(4), ADD(7)
+          {
+            const uInt32 size = 1 + pick(8);
+            emit(0xB080 | size);
+            random(true);
+            emit(0xB000 | size);
+            break;
+          }
+          case 16:  // SWI 0xCC, which reads the flags
+            emit(0xDFCC);
+            break;
+          case 17:  // BL, then BX LR to return
+            call(kSubroutine);
+            break;
+          default:
+            random(true);
+            break;
+        }
+      }
+
+    private:
+      uInt32 pick(uInt32 range)
+      {
+        myRandom = myRandom * 1664525 + 1013904223;
+        return (myRandom >> 8) % range;
+      }
+      uInt32 low() { return pick(6); }
+      uInt32 data() { const uInt32 r = pick(9); return r < 6 ? r : r + 3; }
+
+    private:
+      vector<uInt16>& myROM;
+      uInt32 myAddress;
+      uInt32 myRandom;
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Run the code in the ROM image, and add the results to the hash
+  uInt64 run(Thumbulator& thumb, vector<uInt16>& ram, Hash& hash)
+  {
+    std::fill(ram.begin(), ram.end(), 0);
+
+    string result;
+    try
+    {
+      result = thumb.run();
+    }
+    catch(const runtime_error& e)
+    {
+      result = e.what();
+    }
+
+    hash.add(uInt32(thumb.instructionCount()));
+    hash.add(ram);
+    hash.add(result);
+
+    return thumb.instructionCount();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // The ways the code can be run, which must all give the same results
+  enum class Mode { Interpret, Translate, Profile };
+
+  void setMode(Thumbulator& thumb, Mode mode)
+  {
+    thumb.enableTranslation(mode == Mode::Translate);
+    thumb.enableProfiling(mode == Mode::Profile);
+  }
+
+  const char* modeName(Mode mode)
+  {
+    switch(mode)
+    {
+      case Mode::Translate:  return "Translated: ";
+      case Mode::Profile:    return "Profiled: ";
+      default:               return "";
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  bool checkOpcodes(vector<uInt16>& rom, vector<uInt16>& ram, Mode mode)
+  {
+    // Errors are logged rather than thrown, so everything runs to the end
+    Thumbulator thumb(rom.data(), ram.data(), false,
+                      Thumbulator::ConfigureFor::DPCplus, nullptr);
+    setMode(thumb, mode);
+
+    std::fill(rom.begin(), rom.end(), kExit);
+    Assembler code(rom, kStart + 2, 0);
+    code.emit(0xB5FF);   // push {r0-r7,lr}
+    code.emit(0xDFCC);   // swi 0xCC
+    code.emit(0xB401);   // push {r0}
+
+    // Writes to the 'halt' address print the counters
+    ostringstream discard;
+    std::streambuf* output = cout.rdbuf(discard.rdbuf());
+
+    Hash hash;
+    uInt64 instructions = 0;
+    for(uInt32 inst = 0; inst < 0x10000; ++inst)
+    {
+      rom[kStart >> 1] = uInt16(inst);
+      instructions += run(thumb, ram, hash);
+    }
+    cout.rdbuf(output);
+
+    if(instructions != kOpcodesInstructions || hash.value() != kOpcodesHash)
+    {
+      cerr << modeName(mode)
+           << "All opcodes: " << std::dec << instructions << " instructions, hash "
+           << Base::HEX8 << hash.value() << ", expected "
+           << std::dec << kOpcodesInstructions << ", "
+           << Base::HEX8 << kOpcodesHash << endl;
+      return false;
+    }
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  bool checkProgram(vector<uInt16>& rom, vector<uInt16>& ram,
+                    const Program& program, Mode mode)
+  {
+    Thumbulator thumb(rom.data(), ram.data(), true,
+                      Thumbulator::ConfigureFor::DPCplus, nullptr);
+    setMode(thumb, mode);
+
+    std::fill(rom.begin(), rom.end(), kExit);
+    Assembler code(rom, kStart, program.seed);
+
+    code.emit(0x46F0);   // mov r8,lr
+    code.emit(0x2640);   // movs r6,#0x40
+    code.emit(0x0636);   // lsls r6,r6,#24
+    code.emit(0x2410);   // movs r4,#0x10
+    code.emit(0x0224);   // lsls r4,r4,#8
+    code.emit(0x1936);   // adds r6,r6,r4     ; r6 = 0x40001000
+    code.emit(0x2740);   // movs r7,#64
+
+    const uInt32 loop = code.address();
+    while(code.address() - loop < 200)
+      code.random();
+    code.emit(0x3F04);   // subs r7,#4
+    code.branchBack(0x1, loop);   // bne loop
+
+    code.emit(0xC6BF);   // stmia r6!,{r0-r5,r7}
+    code.emit(0x4649);   // mov r1,r9
+    code.emit(0x4652);   // mov r2,r10
+    code.emit(0x465B);   // mov r3,r11
+    code.emit(0xDFCC);   // swi 0xCC          ; r0 = flags
+    code.emit(0xC60F);   // stmia r6!,{r0-r3}
+    code.emit(0x46C6);   // mov lr,r8
+    code.emit(0x4770);   // bx lr
+
+    Assembler subroutine(rom, kSubroutine, program.seed + 1);
+    for(uInt32 i = 0; i < 4; ++i)
+      subroutine.random(true);
+    subroutine.emit(0x4770);   // bx lr
+
+    Hash hash;
+    const uInt64 instructions = run(thumb, ram, hash);
+
+    if(instructions != program.instructions || hash.value() != program.hash)
+    {
+      cerr << modeName(mode)
+           << "Program " << std::dec << program.seed << ": " << instructions
+           << " instructions, hash " << Base::HEX8 << hash.value()
+           << ", expected " << std::dec << program.instructions << ", "
+           << Base::HEX8 << program.hash << endl;
+      return false;
+    }
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  bool checkSelfModifying(vector<uInt16>& rom, vector<uInt16>& ram,
+                          Mode mode)
+  {
+    Thumbulator thumb(rom.data(), ram.data(), true,
+                      Thumbulator::ConfigureFor::DPCplus, nullptr);
+    setMode(thumb, mode);
+
+    std::fill(rom.begin(), rom.end(), kExit);
+    std::fill(ram.begin(), ram.end(), 0);
+
+    Assembler code(rom, kStart, 0);
+    code.emit(0x46F0);   // mov r8,lr
+    code.emit(0x2240);   // movs r2,#0x40
+    code.emit(0x0612);   // lsls r2,r2,#24
+    code.emit(0x2310);   // movs r3,#0x10
+    code.emit(0x021B);   // lsls r3,r3,#8
+    code.emit(0x18D2);   // adds r2,r2,r3     ; r2 = 0x40001000
+    code.emit(0x1C53);   // adds r3,r2,#1
+    code.emit(0x3206);   // adds r2,#6        ; r2 = PATCH
+    code.emit(0x2180);   // movs r1,#0x80     ; r1 = 'lsls r0,r0,#2'
+    code.emit(0x4718);   // bx r3             ; to the code in RAM
+
+    // The first time through the loop, the write changes the instruction
+    // after it, so the loop multiplies by 4 three times
+    const uInt16 ramCode[] = {
+      0x2001,   // 40001000:        movs r0,#1
+      0x2403,   // 40001002:        movs r4,#3
+      0x8011,   // 40001004: LOOP   strh r1,[r2]
+      0x3001,   // 40001006: PATCH  adds r0,#1
+      0x3C01,   // 40001008:        subs r4,#1
+      0xD1FB,   // 4000100A:        bne LOOP
+      0x8350,   // 4000100C:        strh r0,[r2,#26]   ; to 40001020
+      0x46C6,   // 4000100E:        mov lr,r8
+      0x4770    // 40001010:        bx lr
+    };
+    const uInt32 start = (0x40001000 - kRAMBase) >> 1;
+    std::copy(ramCode, ramCode + sizeof(ramCode) / 2, ram.begin() + start);
+
+    // The second time, the instruction is already changed
+    bool ok = true;
+    for(uInt32 i = 0; i < 2; ++i)
+    {
+      ram[start + 0x10] = 0;
+      thumb.run();
+      ok = ok && ram[start + 0x10] == 64;
+    }
+
+    if(!ok)
+      cerr << modeName(mode)
+           << "Changed code: result is " << std::dec << ram[start + 0x10]
+           << ", expected 64" << endl;
+    return ok;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  vector<uInt16> rom(ROMSIZE / 2), ram(RAMSIZE / 2);
+  uInt32 failed = 0;
+
+  for(Mode mode: { Mode::Interpret, Mode::Translate, Mode::Profile })
+  {
+    failed += !checkOpcodes(rom, ram, mode);
+    for(const Program& program: ourPrograms)
+      failed += !checkProgram(rom, ram, program, mode);
+    failed += !checkSelfModifying(rom, ram, mode);
+  }
+
+  cout << "Decoding all Thumb opcodes, and "
+       << (sizeof(ourPrograms) / sizeof(Program)) << " programs, "
+       << "with and without translation, and profiled: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
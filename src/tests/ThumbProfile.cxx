@@ -0,0 +1,204 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+// Runs a short Thumb program with profiling on, grouped into calls and
+// frames as the cartridges do, and checks the counts for each address,
+// the totals per call and per frame, and the report made from them.
+
+#include "bspf.hxx"
+#include "Thumbulator.hxx"
+
+namespace {
+  const uInt32 kStart = 0x0C08;
+  const uInt16 kExit = 0xDF00;   // swi 0x00
+
+  // Each instruction, with the number of times it runs in each call and
+  // the total cycles it takes (a taken branch takes two more)
+  struct Instruction {
+    uInt16 inst;
+    uInt32 count;
+    uInt32 cycles;
+  };
+
+  const Instruction ourProgram[] = {
+    { 0x2203, 1, 1 },   // 0C08:        movs r2,#3
+    { 0x3A01, 3, 3 },   // 0C0A: LOOP   subs r2,#1
+    { 0xD1FD, 3, 7 },   // 0C0C:        bne LOOP
+    { 0xB401, 1, 2 },   // 0C0E:        push {r0}
+    { 0xBC02, 1, 3 },   // 0C10:        pop {r1}
+    { 0x4348, 1, 5 },   // 0C12:        muls r0,r1
+    { 0x4770, 1, 1 }    // 0C14:        bx lr   ; to the caller, so not taken
+  };
+  const uInt32 kCallInstructions = 11;
+  const uInt32 kCallCycles = 22;
+
+  // The number of calls in each frame, and the 6507 cycles in a frame
+  const uInt32 ourCalls[] = { 2, 1, 3 };
+  const uInt32 kFrameLength = 19912;
+
+  // The ARM cycles per 6507 cycle used for the report
+  const double kCyclesPerCpuCycle = 2.0;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Check the numbers on the line of the report that starts with the given
+  // text; averages are rounded in the report, and any numbers after those
+  // expected (such as percentages) aren't checked
+  bool checkLine(const string& report, const string& start,
+                 const vector<double>& expected)
+  {
+    istringstream lines(report);
+    string line;
+    while(getline(lines, line))
+    {
+      if(line.compare(0, start.size(), start) != 0)
+        continue;
+
+      istringstream in(line.substr(start.size()));
+      vector<double> numbers;
+      double number;
+      while(in >> number)
+        numbers.push_back(number);
+
+      bool ok = numbers.size() >= expected.size();
+      for(uInt32 i = 0; ok && i < expected.size(); ++i)
+        ok = std::abs(numbers[i] - expected[i]) < 0.5;
+      if(!ok)
+        cerr << "Report line '" << line << "' is wrong" << endl;
+      return ok;
+    }
+
+    cerr << "Report has no line starting '" << start << "'" << endl;
+    return false;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main()
+{
+  vector<uInt16> rom(ROMSIZE / 2, kExit), ram(RAMSIZE / 2);
+  const uInt32 length = sizeof(ourProgram) / sizeof(Instruction);
+  for(uInt32 i = 0; i < length; ++i)
+    rom[(kStart >> 1) + i] = ourProgram[i].inst;
+
+  Thumbulator thumb(rom.data(), ram.data(), true,
+                    Thumbulator::ConfigureFor::DPCplus, nullptr);
+  thumb.enableProfiling(true);
+  ThumbProfiler& profiler = *thumb.profiler();
+
+  // The last call starts the frame after them all, which ends the last
+  // frame (but isn't counted itself, as it hasn't ended)
+  const uInt32 frames = sizeof(ourCalls) / sizeof(uInt32);
+  uInt32 calls = 0;
+  try
+  {
+    for(uInt32 frame = 0; frame < frames; ++frame)
+    {
+      for(uInt32 call = 0; call < ourCalls[frame]; ++call, ++calls)
+      {
+        profiler.startCall(frame, frame * kFrameLength + call * 100);
+        thumb.run();
+      }
+    }
+    profiler.startCall(frames, frames * kFrameLength);
+  }
+  catch(const runtime_error& e)
+  {
+    cerr << "ERROR: " << e.what() << endl;
+    return 1;
+  }
+
+  const string report = profiler.report(kCyclesPerCpuCycle, 0, true);
+  uInt32 failed = 0;
+
+  ostringstream header;
+  header << "ARM profile of " << frames << " frames, " << calls << " calls";
+  if(report.compare(0, header.str().size(), header.str()) != 0)
+  {
+    cerr << "Report doesn't start '" << header.str() << "'" << endl;
+    ++failed;
+  }
+
+  // The totals per frame
+  uInt32 peakCalls = 0;
+  for(uInt32 frame = 0; frame < frames; ++frame)
+  {
+    const uInt32 n = ourCalls[frame];
+    peakCalls = std::max(peakCalls, n);
+
+    ostringstream start;
+    start << std::setw(10) << frame;
+    failed += !checkLine(report, start.str(),
+        { double(n), double(n * kCallInstructions), double(n * kCallCycles),
+          n * kCallCycles / kCyclesPerCpuCycle, double(kFrameLength) });
+  }
+
+  const double average = double(calls) / frames;
+  failed += !checkLine(report, "  calls", { average, double(peakCalls) });
+  failed += !checkLine(report, "  instructions",
+      { average * kCallInstructions, double(peakCalls * kCallInstructions) });
+  failed += !checkLine(report, "  ARM cycles",
+      { average * kCallCycles, double(peakCalls * kCallCycles) });
+  failed += !checkLine(report, "  6507 cycles",
+      { average * kCallCycles / kCyclesPerCpuCycle,
+        peakCalls * kCallCycles / kCyclesPerCpuCycle });
+  failed += !checkLine(report, "  frame length",
+      { double(kFrameLength), double(kFrameLength) });
+
+  // The totals for the first, second, ... call in each frame
+  for(uInt32 call = 0; call < peakCalls; ++call)
+  {
+    uInt32 n = 0;
+    for(uInt32 frame = 0; frame < frames; ++frame)
+      n += ourCalls[frame] > call;
+
+    ostringstream start;
+    start << "  " << std::setw(2) << (call + 1);
+    failed += !checkLine(report, start.str(),
+        { double(n), double(kCallInstructions), double(kCallCycles),
+          double(kCallCycles), kCallCycles / kCyclesPerCpuCycle });
+  }
+
+  // The counts for each address
+  uInt32 instructions = 0, cycles = 0;
+  for(uInt32 i = 0; i < length; ++i)
+  {
+    instructions += ourProgram[i].count;
+    cycles += ourProgram[i].cycles;
+
+    ostringstream start;
+    start << "  " << std::hex << std::setfill('0') << std::setw(8)
+          << (kStart + i * 2);
+    failed += !checkLine(report, start.str(),
+        { double(ourProgram[i].count * calls),
+          double(ourProgram[i].cycles * calls) });
+  }
+  if(instructions != kCallInstructions || cycles != kCallCycles)
+  {
+    cerr << "Program takes " << instructions << " instructions, " << cycles
+         << " cycles, expected " << kCallInstructions << ", "
+         << kCallCycles << endl;
+    ++failed;
+  }
+
+  if(failed > 0)
+    cerr << report;
+
+  cout << "Profiling " << calls << " calls in " << frames << " frames: "
+       << (failed == 0 ? "OK" : "FAILED") << endl;
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+MODULE := src/tests
+
+# Each test is a separate program linked against the emulation core; they
+# aren't added to OBJS, and are only built and run by 'make check'
+CHECK_PROGRAMS := \
+	src/tests/AudioCapture$(EXEEXT) \
+	src/tests/AudioResampler$(EXEEXT) \
+	src/tests/FrameCache$(EXEEXT) \
+	src/tests/FrameSkip$(EXEEXT) \
+	src/tests/InputMovie$(EXEEXT) \
+	src/tests/MusicClock$(EXEEXT) \
+	src/tests/ParallelConsoles$(EXEEXT) \
+	src/tests/RewindBuffer$(EXEEXT) \
+	src/tests/Serializer$(EXEEXT) \
+	src/tests/StateHash$(EXEEXT) \
+	src/tests/ThumbDecode$(EXEEXT) \
+	src/tests/ThumbProfile$(EXEEXT) \
+	src/tests/TIASpans$(EXEEXT)
+
+CHECK_OBJS := \
+	src/tests/AudioCapture.o \
+	src/tests/AudioResampler.o \
+	src/tests/FrameCache.o \
+	src/tests/FrameSkip.o \
+	src/tests/InputMovie.o \
+	src/tests/MusicClock.o \
+	src/tests/ParallelConsoles.o \
+	src/tests/RewindBuffer.o \
+	src/tests/Serializer.o \
+	src/tests/StateHash.o \
+	src/tests/ThumbDecode.o \
+	src/tests/ThumbProfile.o \
+	src/tests/TIASpans.o
+
+MODULE_DIRS += \
+	src/tests
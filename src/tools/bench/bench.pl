@@ -0,0 +1,112 @@
+#!/usr/bin/perl
+
+# Runs the benchmark ROMs in this directory with each bankswitch scheme,
+# and prints a table of the frames/sec for each of them.
+#
+# The ROMs are built from the .asm files with DASM, ie:
+#   dasm cpu.asm -f3 -ocpu.bin
+# Each one is a single 1K block, which is repeated here to fill the ROM
+# size used for each scheme.
+
+use File::Basename;
+use File::Spec;
+use File::Temp qw(tempdir);
+
+usage() if @ARGV < 1 || @ARGV > 2;
+
+my $stella = $ARGV[0];
+my $frames = @ARGV > 1 ? $ARGV[1] : 600;
+my $dir    = dirname($0);
+
+my @kernels = ("cpu", "tia", "hmove");
+
+# The ROM size for each scheme; AR isn't included, since it would need
+# a Supercharger load image instead of a plain ROM
+my @schemes = (
+  [ "0840",   8 ], [ "2IN1",   8 ], [ "4IN1",  16 ], [ "8IN1",  32 ],
+  [ "16IN1", 64 ], [ "32IN1", 128 ], [ "64IN1", 256 ], [ "128IN1", 512 ],
+  [ "2K",     2 ], [ "3E",    32 ], [ "3E+",   64 ], [ "3F",    32 ],
+  [ "4A50",  64 ], [ "4K",     4 ], [ "4KSC",   4 ], [ "BF",   256 ],
+  [ "BFSC", 256 ], [ "BUS",   32 ], [ "CDF",   32 ], [ "CM",    16 ],
+  [ "CTY",   32 ], [ "CV",     2 ], [ "CV+",    8 ], [ "DASH",  64 ],
+  [ "DF",   128 ], [ "DFSC", 128 ], [ "DPC",   10 ], [ "DPC+",  32 ],
+  [ "E0",     8 ], [ "E7",    16 ], [ "EF",    64 ], [ "EFSC",  64 ],
+  [ "F0",    64 ], [ "F4",    32 ], [ "F4SC",  32 ], [ "F6",    16 ],
+  [ "F6SC",  16 ], [ "F8",     8 ], [ "F8SC",   8 ], [ "FA",    12 ],
+  [ "FA2",   28 ], [ "FE",     8 ], [ "MC",   128 ], [ "MDM",   64 ],
+  [ "SB",   128 ], [ "UA",     8 ], [ "WD",     8 ], [ "X07",   64 ]
+);
+
+# The Thumb code called by the ROMs for the schemes with an ARM
+# coprocessor, and where it starts in the image.  It runs a loop
+# which loads and stores a word of RAM, 16000 times:
+#         movs  r0, #250
+#         lsls  r0, r0, #6
+#         movs  r2, #0x80
+#         lsls  r2, r2, #23     ; r2 = 0x40001000
+#         movs  r3, #1
+#         lsls  r3, r3, #12
+#         adds  r2, r2, r3
+#   loop: ldr   r1, [r2]
+#         adds  r1, r1, r0
+#         str   r1, [r2]
+#         subs  r0, #1
+#         bne   loop
+#         bx    lr
+my @thumb = ( 0x20FA, 0x0180, 0x2280, 0x05D2, 0x2301, 0x031B, 0x18D2,
+              0x6811, 0x1809, 0x6011, 0x3801, 0xD1FA, 0x4770 );
+my %thumbStart = ( "DPC+" => 0x0C08, "CDF" => 0x0808, "BUS" => 0x0808 );
+
+# Load the ROMs
+my %code = ();
+foreach $kernel (@kernels) {
+  my $file = File::Spec->catfile($dir, "$kernel.bin");
+  open(ROM, "<", $file) or die "Couldn't open $file: $!\n";
+  binmode(ROM);
+  local $/;
+  $code{$kernel} = <ROM>;
+  close(ROM);
+  die "$file isn't 1K in size\n" if length($code{$kernel}) != 1024;
+}
+
+my $tmpdir = tempdir(CLEANUP => 1);
+
+print "Running $frames frames per ROM; results are in frames/sec\n\n";
+printf("%-8s", "Scheme");
+printf("%10s", $_) foreach @kernels;
+print "\n";
+
+foreach $entry (@schemes) {
+  my ($scheme, $size) = @$entry;
+  printf("%-8s", $scheme);
+
+  foreach $kernel (@kernels) {
+    my $image = $code{$kernel} x $size;
+    if (defined $thumbStart{$scheme}) {
+      substr($image, $thumbStart{$scheme}, 2 * @thumb) = pack("v*", @thumb);
+    }
+
+    my $rom = File::Spec->catfile($tmpdir, "$kernel.bin");
+    open(ROM, ">", $rom) or die "Couldn't create $rom: $!\n";
+    binmode(ROM);
+    print ROM $image;
+    close(ROM);
+
+    my $report = `"$stella" -benchmark $frames -bs "$scheme" "$rom" 2>&1`;
+    if ($report =~ /"fps":\s*([0-9.eE+-]+)/) {
+      printf("%10.1f", $1);
+    }
+    else {
+      printf("%10s", "failed");
+    }
+  }
+  print "\n";
+}
+
+sub usage {
+  print "bench.pl <path to stella> [frames]\n";
+  print "\n";
+  print "Runs each benchmark ROM with each bankswitch scheme for the given\n";
+  print "number of frames (default 600), and prints the frames/sec for each.\n";
+  exit 1;
+}
@@ -0,0 +1,79 @@
+;;============================================================================
+;;
+;;   SSSS    tt          lll  lll
+;;  SS  SS   tt           ll   ll
+;;  SS     tttttt  eeee   ll   ll   aaaa
+;;   SSSS    tt   ee  ee  ll   ll      aa
+;;      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+;;  SS  SS   tt   ee      ll   ll  aa  aa
+;;   SSSS     ttt  eeeee llll llll  aaaaa
+;;
+;; Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+;; and the Stella Team
+;;
+;; See the file "License.txt" for information on usage and redistribution of
+;; this file, and for a DISCLAIMER OF ALL WARRANTIES.
+;;============================================================================
+;;
+;; Benchmark ROM for the 6502 core.  Instead of drawing, the visible part
+;; of each frame is spent in a loop using most of the addressing modes,
+;; decimal arithmetic and subroutine calls, with no WSYNC to halt the CPU.
+;;
+;;============================================================================
+
+        include "bench.inc"
+
+kernel  LDA #<table
+        STA ptr
+        LDA #>table
+        STA ptr+1
+        LDA #225
+        STA TIM64T
+        LDY #$00
+
+work    LDX #3
+loop    LDA table,X
+        ADC buf,X
+        STA buf,X
+        EOR (ptr),Y
+        ROL
+        STA buf+15
+        LSR buf+15
+        DEX
+        BPL loop
+        JSR mix
+        BIT TIMINT
+        BPL work
+
+        STA WSYNC
+        RTS
+
+mix     SED
+        LDA frames
+        CLC
+        ADC #$01
+        SBC buf
+        CLD
+        INY
+        TYA
+        AND #$0F
+        TAY
+        INC buf+1
+        ASL buf+2
+        ROR buf+3
+        BIT buf+4
+        PHA
+        PLA
+        LDX #$00
+        LDA (ptr,X)
+        CMP buf+5
+        BCC mixdone
+        STA buf+5
+mixdone RTS
+
+table   .byte $01, $23, $45, $67, $89, $AB, $CD, $EF
+        .byte $FE, $DC, $BA, $98, $76, $54, $32, $10
+
+        org $FFFC
+        .word start
+        .word start
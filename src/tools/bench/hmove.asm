@@ -0,0 +1,74 @@
+;;============================================================================
+;;
+;;   SSSS    tt          lll  lll
+;;  SS  SS   tt           ll   ll
+;;  SS     tttttt  eeee   ll   ll   aaaa
+;;   SSSS    tt   ee  ee  ll   ll      aa
+;;      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+;;  SS  SS   tt   ee      ll   ll  aa  aa
+;;   SSSS     ttt  eeeee llll llll  aaaaa
+;;
+;; Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+;; and the Stella Team
+;;
+;; See the file "License.txt" for information on usage and redistribution of
+;; this file, and for a DISCLAIMER OF ALL WARRANTIES.
+;;============================================================================
+;;
+;; Benchmark ROM for horizontal motion.  Every visible scanline starts
+;; with an HMOVE, and then changes the motion registers of all objects
+;; (within the time where that has unusual effects).  The objects are
+;; also repositioned every 8 scanlines.
+;;
+;;============================================================================
+
+        include "bench.inc"
+
+kernel  LDA #$FF
+        STA GRP0
+        STA GRP1
+        STA ENAM0
+        STA ENAM1
+        STA ENABL
+        LDA #$03
+        STA NUSIZ0
+        LDA #$06
+        STA NUSIZ1
+        LDY #192
+
+line    STA WSYNC
+        STA HMOVE
+        TYA
+        EOR frames
+        STA HMP0
+        ASL
+        STA HMP1
+        ASL
+        STA HMM0
+        ASL
+        STA HMM1
+        ASL
+        STA HMBL
+        STY COLUP0
+        STA COLUP1
+        TYA
+        AND #$07
+        BNE nopos
+        STA RESP1
+        STA RESM0
+        STA RESM1
+        STA RESBL
+        STA HMCLR
+nopos   DEY
+        BNE line
+
+        STY GRP0
+        STY GRP1
+        STY ENAM0
+        STY ENAM1
+        STY ENABL
+        RTS
+
+        org $FFFC
+        .word start
+        .word start
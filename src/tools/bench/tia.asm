@@ -0,0 +1,70 @@
+;;============================================================================
+;;
+;;   SSSS    tt          lll  lll
+;;  SS  SS   tt           ll   ll
+;;  SS     tttttt  eeee   ll   ll   aaaa
+;;   SSSS    tt   ee  ee  ll   ll      aa
+;;      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+;;  SS  SS   tt   ee      ll   ll  aa  aa
+;;   SSSS     ttt  eeeee llll llll  aaaaa
+;;
+;; Copyright (c) 1995-2017 by Bradford W. Mott, Stephen Anthony
+;; and the Stella Team
+;;
+;; See the file "License.txt" for information on usage and redistribution of
+;; this file, and for a DISCLAIMER OF ALL WARRANTIES.
+;;============================================================================
+;;
+;; Benchmark ROM for TIA register writes.  Every visible scanline changes
+;; the colours, playfield, player graphics, missiles, ball and sound
+;; registers, and reads the collision registers.
+;;
+;;============================================================================
+
+        include "bench.inc"
+
+kernel  STA CXCLR
+        LDA #$35
+        STA NUSIZ0
+        STA NUSIZ1
+        STA RESP0
+        STA RESM0
+        STA RESBL
+        LDY #192
+
+line    STA WSYNC
+        STY COLUBK
+        TYA
+        EOR frames
+        STA PF0
+        STA PF1
+        STA PF2
+        STA GRP0
+        STA GRP1
+        STA COLUPF
+        STY COLUP0
+        STA COLUP1
+        STA ENAM0
+        STA ENAM1
+        STA ENABL
+        STA AUDF0
+        STA AUDV0
+        STY PF1
+        STA CTRLPF
+        BIT CXPPMM
+        DEY
+        BNE line
+
+        STY PF0
+        STY PF1
+        STY PF2
+        STY GRP0
+        STY GRP1
+        STY ENAM0
+        STY ENAM1
+        STY ENABL
+        RTS
+
+        org $FFFC
+        .word start
+        .word start